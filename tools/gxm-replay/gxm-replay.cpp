@@ -0,0 +1,142 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+// Replays a GXM capture recorded with --gxm-capture-frames as fast as the renderer goes, and reports frame times.
+
+#include <config/state.h>
+#include <mem/functions.h>
+#include <mem/state.h>
+#include <renderer/capture.h>
+#include <renderer/functions.h>
+#include <renderer/state.h>
+
+#include <SDL.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void usage() {
+    std::cout << "Usage: gxm-replay <capture.gxmcap> [--backend null|opengl] [--loops N]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    const fs::path capture_path = argv[1];
+    renderer::Backend backend = renderer::Backend::Null;
+    int loops = 1;
+
+    for (int i = 2; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--backend") && (i + 1 < argc)) {
+            const std::string name = argv[++i];
+            if (name == "opengl") {
+                backend = renderer::Backend::OpenGL;
+            } else if (name != "null") {
+                usage();
+                return 1;
+            }
+        } else if (!std::strcmp(argv[i], "--loops") && (i + 1 < argc)) {
+            loops = std::max(1, std::atoi(argv[++i]));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    renderer::capture::Capture capture;
+    if (!capture.load(capture_path)) {
+        return 1;
+    }
+
+    MemState mem;
+    if (!init(mem)) {
+        std::cerr << "Failed to initialise guest memory" << std::endl;
+        return 1;
+    }
+
+    // The GL backend needs a context, the window is never shown
+    SDL_Window *window = nullptr;
+    if (backend == renderer::Backend::OpenGL) {
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+            std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
+            return 1;
+        }
+
+        window = SDL_CreateWindow("gxm-replay", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, DEFAULT_RES_WIDTH, DEFAULT_RES_HEIGHT, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+        if (!window) {
+            std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << std::endl;
+            return 1;
+        }
+    }
+
+    Config config;
+    // Builtin shaders are looked up next to the executable, like for the emulator
+    std::string base_path;
+    if (char *sdl_base_path = SDL_GetBasePath()) {
+        base_path = sdl_base_path;
+        SDL_free(sdl_base_path);
+    }
+    std::unique_ptr<renderer::State> state;
+    if (!renderer::init(window, state, backend, config, base_path.c_str())) {
+        std::cerr << "Failed to create the renderer" << std::endl;
+        return 1;
+    }
+
+    renderer::capture::ReplayStats stats;
+    const auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loops; loop++) {
+        if (!capture.replay(*state, mem, config, stats)) {
+            return 1;
+        }
+    }
+    const auto total = std::chrono::steady_clock::now() - start;
+
+    if (stats.frame_times.empty()) {
+        std::cout << "The capture has no frames" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::chrono::nanoseconds> sorted = stats.frame_times;
+    std::sort(sorted.begin(), sorted.end());
+
+    const auto to_ms = [](std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+    const double total_ms = to_ms(std::chrono::duration_cast<std::chrono::nanoseconds>(total));
+    const double average_ms = total_ms / sorted.size();
+
+    std::cout << "Frames: " << sorted.size() << ", command lists: " << stats.command_lists << ", commands: " << stats.commands << std::endl;
+    std::cout << "Frame time min " << to_ms(sorted.front()) << " ms, avg " << average_ms << " ms, p99 "
+              << to_ms(sorted[(sorted.size() - 1) * 99 / 100]) << " ms, max " << to_ms(sorted.back()) << " ms" << std::endl;
+    std::cout << "Average " << (1000.0 / average_ms) << " FPS, " << (stats.commands * 1000.0 / total_ms) << " commands/s" << std::endl;
+
+    state.reset();
+    if (window) {
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+    }
+
+    return 0;
+}
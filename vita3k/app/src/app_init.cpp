@@ -55,6 +55,9 @@ void update_viewport(HostState &state) {
     case renderer::Backend::OpenGL:
         SDL_GL_GetDrawableSize(state.window.get(), &w, &h);
         break;
+    case renderer::Backend::Null:
+        SDL_GetWindowSize(state.window.get(), &w, &h);
+        break;
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         SDL_Vulkan_GetDrawableSize(state.window.get(), &w, &h);
@@ -115,11 +118,13 @@ bool init(HostState &state, Config &cfg, const Root &root_paths) {
         state.pref_path = string_utils::utf_to_wide(state.cfg.pref_path);
     }
 
+    if (string_utils::toupper(state.cfg.backend_renderer) == "NULL")
+        state.backend_renderer = renderer::Backend::Null;
 #ifdef USE_VULKAN
-    if (string_utils::toupper(state.cfg.backend_renderer) == "VULKAN")
+    else if (string_utils::toupper(state.cfg.backend_renderer) == "VULKAN")
         state.backend_renderer = renderer::Backend::Vulkan;
-    else
 #endif
+    else
         state.backend_renderer = renderer::Backend::OpenGL;
 
     int window_type = 0;
@@ -127,6 +132,10 @@ bool init(HostState &state, Config &cfg, const Root &root_paths) {
     case renderer::Backend::OpenGL:
         window_type = SDL_WINDOW_OPENGL;
         break;
+    case renderer::Backend::Null:
+        // Nothing is ever presented, the window only carries input and the GUI state
+        window_type = SDL_WINDOW_HIDDEN;
+        break;
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         window_type = SDL_WINDOW_VULKAN;
@@ -98,6 +98,8 @@ struct H264DecoderState : public DecoderState {
 struct MjpegDecoderState : public DecoderState {
     bool send(const uint8_t *data, uint32_t size) override;
     bool receive(uint8_t *data, DecoderSize *size) override;
+    // Still reports the frame size, but writes nothing and returns false if the YUV444 frame is larger than capacity
+    bool receive(uint8_t *data, DecoderSize *size, size_t capacity);
 
     MjpegDecoderState();
 };
@@ -195,7 +197,8 @@ struct PlayerState {
     bool next_packet(int32_t stream_id);
 
     std::vector<int16_t> receive_audio();
-    std::vector<uint8_t> receive_video();
+    // Decodes the next frame straight into data, fails if nothing was decoded or it doesn't fit in size bytes
+    bool receive_video(uint8_t *data, size_t size);
 
     void queue(const std::string &path);
 
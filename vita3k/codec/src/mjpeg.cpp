@@ -25,6 +25,7 @@ extern "C" {
 #include <util/log.h>
 
 #include <cassert>
+#include <limits>
 
 void convert_yuv_to_rgb(const uint8_t *yuv, uint8_t *rgba, uint32_t width, uint32_t height) {
     SwsContext *context = sws_getContext(width, height, AV_PIX_FMT_YUV444P, width, height, AV_PIX_FMT_RGBA,
@@ -74,6 +75,10 @@ bool MjpegDecoderState::send(const uint8_t *data, uint32_t size) {
 }
 
 bool MjpegDecoderState::receive(uint8_t *data, DecoderSize *size) {
+    return receive(data, size, std::numeric_limits<size_t>::max());
+}
+
+bool MjpegDecoderState::receive(uint8_t *data, DecoderSize *size, size_t capacity) {
     AVFrame *frame = av_frame_alloc();
     int error = avcodec_receive_frame(context, frame);
     if (error < 0) {
@@ -82,6 +87,18 @@ bool MjpegDecoderState::receive(uint8_t *data, DecoderSize *size) {
         return false;
     }
 
+    if (size) {
+        size->width = frame->width;
+        size->height = frame->height;
+    }
+
+    const size_t frame_size = static_cast<size_t>(frame->width) * frame->height * 3;
+    if (data && (frame_size > capacity)) {
+        LOG_WARN("Mjpeg frame of {}x{} doesn't fit in {} bytes.", frame->width, frame->height, capacity);
+        av_frame_free(&frame);
+        return false;
+    }
+
     if (data) {
         uint8_t *channels[] = {
             &data[0], // y
@@ -99,11 +116,6 @@ bool MjpegDecoderState::receive(uint8_t *data, DecoderSize *size) {
         }
     }
 
-    if (size) {
-        size->width = frame->width;
-        size->height = frame->height;
-    }
-
     av_frame_free(&frame);
 
     return true;
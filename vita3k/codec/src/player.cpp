@@ -197,16 +197,16 @@ std::vector<int16_t> PlayerState::receive_audio() {
     return data;
 }
 
-std::vector<uint8_t> PlayerState::receive_video() {
+bool PlayerState::receive_video(uint8_t *data, size_t size) {
     if (video_stream_id < 0)
-        return {};
+        return false;
 
     if (video_playing.empty())
-        return {};
+        return false;
 
     int error;
     AVFrame *frame = av_frame_alloc();
-    std::vector<uint8_t> data;
+    bool received = false;
     while (true) {
         error = avcodec_receive_frame(video_context, frame);
 
@@ -228,15 +228,20 @@ std::vector<uint8_t> PlayerState::receive_video() {
 
         last_timestamp = frame->best_effort_timestamp;
 
-        data.resize(H264DecoderState::buffer_size(
-            { static_cast<uint32_t>(video_context->width), static_cast<uint32_t>(video_context->height) }));
-        copy_yuv_data_from_frame(frame, data.data());
+        const uint32_t frame_size = H264DecoderState::buffer_size(
+            { static_cast<uint32_t>(video_context->width), static_cast<uint32_t>(video_context->height) });
+        if (frame_size > size) {
+            LOG_WARN("Video frame of {} bytes doesn't fit in a {} bytes buffer, dropping it.", frame_size, size);
+            break;
+        }
+        copy_yuv_data_from_frame(frame, data);
+        received = true;
 
         break;
     }
 
     av_frame_free(&frame);
-    return data;
+    return received;
 }
 
 void PlayerState::queue(const std::string &path) {
@@ -115,7 +115,15 @@ enum PerfomanceOverleyPosition {
     code(bool, "shader-cache", true, shader_cache)                                                      \
     code(bool, "spirv-shader", false, spirv_shader)                                                     \
     code(uint64_t, "current-ime-lang", 4, current_ime_lang)                                             \
-    code(bool, "disable-at9-decoder", false, disable_at9_decoder)
+    code(bool, "disable-at9-decoder", false, disable_at9_decoder)                                       \
+    code(float, "clock-speed", 1.0f, clock_speed)                                                       \
+    code(bool, "clock-unlocked", false, clock_unlocked)                                                 \
+    code(float, "vblank-rate", 59.94f, vblank_rate)                                                     \
+    code(bool, "hle-profiler", false, hle_profiler)                                                     \
+    code(int, "gxm-capture-frames", 0, gxm_capture_frames)                                              \
+    code(bool, "async-texture-decode", false, async_texture_decode)                                     \
+    code(bool, "async-texture-decode-wait", false, async_texture_decode_wait)                           \
+    code(bool, "host-thread-priority", true, host_thread_priority)
 
 // Vector members produced in the config file
 // Order is code(option_type, option_name, default_value)
@@ -123,7 +131,8 @@ enum PerfomanceOverleyPosition {
 // When adding in a new macro for generation, ALL options must be stated.
 #define CONFIG_VECTOR(code)                                                                             \
     code(std::vector<std::string>, "lle-modules", std::vector<std::string>{}, lle_modules)              \
-    code(std::vector<uint64_t>, "ime-langs", std::vector<uint64_t>{4}, ime_langs)
+    code(std::vector<uint64_t>, "ime-langs", std::vector<uint64_t>{4}, ime_langs)                       \
+    code(std::vector<std::string>, "host-core-affinity", std::vector<std::string>{}, host_core_affinity)
 
 // Parent macro for easier generation
 #define CONFIG_LIST(code)                                                                               \
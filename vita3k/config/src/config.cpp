@@ -171,9 +171,19 @@ ExitCode init_config(Config &cfg, int argc, char **argv, const Root &root_paths)
     config->add_flag("--" + cfg[e_archive_log] + ",-A", command_line.archive_log, "Makes a duplicate of the log file with TITLE_ID and Game ID as title")
         ->group("Logging");
     config->add_option("--" + cfg[e_backend_renderer] + ",-B", command_line.backend_renderer, "Renderer backend to use")
-        ->ignore_case()->check(CLI::IsMember(std::set<std::string>{ "OpenGL", "Vulkan" }))->group("Vita Emulation");
+        ->ignore_case()->check(CLI::IsMember(std::set<std::string>{ "OpenGL", "Vulkan", "Null" }))->group("Vita Emulation");
     config->add_flag("--" + cfg[e_color_surface_debug] + ",-C", command_line.color_surface_debug, "Save color surfaces")
         ->group("Vita Emulation");
+    config->add_option("--" + cfg[e_clock_speed], command_line.clock_speed, "Guest clock speed multiplier, applied to every guest time source (2 runs time twice as fast)")
+        ->check(CLI::PositiveNumber)->group("Vita Emulation");
+    config->add_option("--" + cfg[e_vblank_rate], command_line.vblank_rate, "Display refresh rate in Hz the vblank thread is paced at")
+        ->check(CLI::PositiveNumber)->group("Vita Emulation");
+    config->add_flag("--" + cfg[e_clock_unlocked], command_line.clock_unlocked, "Unlock the guest clock: guest waits complete immediately and time jumps forward instead")
+        ->group("Vita Emulation");
+    config->add_flag("--" + cfg[e_async_texture_decode], command_line.async_texture_decode, "Decode textures on worker threads, the render thread only uploads them")
+        ->group("Vita Emulation");
+    config->add_flag("--" + cfg[e_async_texture_decode_wait], command_line.async_texture_decode_wait, "With asynchronous texture decoding, draws wait for the decode instead of using the previous texture contents")
+        ->group("Vita Emulation");
     config->add_option("--config-location,-c", command_line.config_path, "Get a configuration file from a given location. If a filename is given, it must end with \".yml\", otherwise it will be assumed to be a directory. \nDefault loaded: <Vita3K>/config.yml \nDefaults: <Vita3K>/data/config/default.yml")
         ->group("YML");
     config->add_flag("!--keep-config,!-w", command_line.overwrite_config, "Do not modify the configuration file after loading.")
@@ -192,6 +202,10 @@ ExitCode init_config(Config &cfg, int argc, char **argv, const Root &root_paths)
         ->group("Logging");
     config->add_flag("--" + cfg[e_log_uniforms] + ",-U", command_line.log_uniforms, "Log Uniforms")
         ->group("Logging");
+    config->add_flag("--" + cfg[e_hle_profiler], command_line.hle_profiler, "Count and time HLE export calls per NID, the profile is written to logs/ as CSV on exit")
+        ->group("Logging");
+    config->add_option("--" + cfg[e_gxm_capture_frames], command_line.gxm_capture_frames, "Capture the GXM commands of the first N rendered frames of the app to gxmcapture/<title id>.gxmcap, for replay with gxm-replay")
+        ->check(CLI::NonNegativeNumber)->group("Logging");
     // clang-format on
 
     // Parse the inputs
@@ -266,6 +280,8 @@ ExitCode init_config(Config &cfg, int argc, char **argv, const Root &root_paths)
         LOG_INFO("{}: {}", cfg[e_log_level], cfg.log_level);
         LOG_INFO_IF(cfg.log_active_shaders, "{}: enabled", cfg[e_log_active_shaders]);
         LOG_INFO_IF(cfg.log_uniforms, "{}: enabled", cfg[e_log_uniforms]);
+        LOG_INFO_IF(cfg.clock_speed != 1.0f, "{}: {}", cfg[e_clock_speed], cfg.clock_speed);
+        LOG_INFO_IF(cfg.clock_unlocked, "{}: enabled", cfg[e_clock_unlocked]);
     }
     // Save any changes made in command-line arguments
     if (cfg.overwrite_config || !fs::exists(check_path(cfg.config_path))) {
@@ -46,7 +46,8 @@ void write_lr(CPUState &state, uint32_t value);
 void write_tpidruro(CPUState &state, uint32_t value);
 bool is_thumb_mode(CPUState &state);
 CPUContext save_context(CPUState &state);
-void load_context(CPUState &state, CPUContext ctx);
+void save_context(CPUState &state, CPUContext &ctx);
+void load_context(CPUState &state, const CPUContext &ctx);
 std::size_t get_processor_id(CPUState &state);
 void invalidate_jit_cache(CPUState &state, Address start, size_t length);
 
@@ -34,10 +34,16 @@ class ArmDynarmicCP15;
 class DynarmicCPU : public CPUInterface {
     friend class ArmDynarmicCallback;
 
-    UnicornCPU fallback;
     CPUState *parent;
 
+    // Both are only built once needed: threads are often created long before they first run,
+    // and most of them never hit an instruction the JIT has to hand over to the interpreter
     std::unique_ptr<Dynarmic::A32::Jit> jit;
+    std::unique_ptr<UnicornCPU> fallback;
+
+    // Registers of a CPU whose JIT isn't built yet, loaded into it on first run
+    CPUContext parked;
+
     std::unique_ptr<ArmDynarmicCallback> cb;
     std::shared_ptr<ArmDynarmicCP15> cp15;
     Dynarmic::ExclusiveMonitor *monitor;
@@ -55,6 +61,8 @@ class DynarmicCPU : public CPUInterface {
     bool cpu_opt;
 
     std::unique_ptr<Dynarmic::A32::Jit> make_jit();
+    Dynarmic::A32::Jit &get_jit();
+    UnicornCPU &get_fallback();
 
 public:
     DynarmicCPU(CPUState *state, std::size_t processor_id, Dynarmic::ExclusiveMonitor *monitor, bool cpu_opt);
@@ -86,8 +94,8 @@ public:
     uint32_t get_fpscr() override;
     void set_fpscr(uint32_t val) override;
 
-    CPUContext save_context() override;
-    void load_context(CPUContext context) override;
+    void save_context(CPUContext &ctx) override;
+    void load_context(const CPUContext &ctx) override;
 
     bool is_thumb_mode() override;
     int step() override;
@@ -53,8 +53,9 @@ struct CPUInterface {
     virtual uint32_t get_fpscr() = 0;
     virtual void set_fpscr(uint32_t val) = 0;
 
-    virtual CPUContext save_context() = 0;
-    virtual void load_context(CPUContext context) = 0;
+    // Copy the register file from/to an existing context, without intermediate allocations
+    virtual void save_context(CPUContext &ctx) = 0;
+    virtual void load_context(const CPUContext &ctx) = 0;
     virtual void invalidate_jit_cache(Address start, size_t length) {}
 
     virtual bool is_thumb_mode() = 0;
@@ -95,8 +95,8 @@ public:
 
     bool is_thumb_mode() override;
 
-    CPUContext save_context() override;
-    void load_context(CPUContext context) override;
+    void save_context(CPUContext &ctx) override;
+    void load_context(const CPUContext &ctx) override;
 
     bool hit_breakpoint() override;
     void trigger_breakpoint() override;
@@ -206,10 +206,16 @@ std::string disassemble(CPUState &state, uint64_t at, uint16_t *insn_size) {
 }
 
 CPUContext save_context(CPUState &state) {
-    return state.cpu->save_context();
+    CPUContext ctx;
+    state.cpu->save_context(ctx);
+    return ctx;
 }
 
-void load_context(CPUState &state, CPUContext ctx) {
+void save_context(CPUState &state, CPUContext &ctx) {
+    state.cpu->save_context(ctx);
+}
+
+void load_context(CPUState &state, const CPUContext &ctx) {
     state.cpu->load_context(ctx);
 }
 
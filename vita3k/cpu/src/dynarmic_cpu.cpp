@@ -204,11 +204,13 @@ public:
         if (cpu->is_thumb_mode())
             addr |= 1;
 
-        CPUContext context = cpu->save_context();
+        CPUContext context;
+        cpu->save_context(context);
         context.set_pc(addr);
-        cpu->fallback.load_context(context);
-        cpu->fallback.execute_instructions_no_check(static_cast<int>(num_insts));
-        context = cpu->fallback.save_context();
+        UnicornCPU &fallback = cpu->get_fallback();
+        fallback.load_context(context);
+        fallback.execute_instructions_no_check(static_cast<int>(num_insts));
+        fallback.save_context(context);
         context.cpsr = cpu->get_cpsr();
         context.fpscr = cpu->get_fpscr();
         cpu->load_context(context);
@@ -281,15 +283,29 @@ std::unique_ptr<Dynarmic::A32::Jit> DynarmicCPU::make_jit() {
     return std::make_unique<Dynarmic::A32::Jit>(config);
 }
 
+Dynarmic::A32::Jit &DynarmicCPU::get_jit() {
+    if (!jit) {
+        jit = make_jit();
+        load_context(parked);
+    }
+    return *jit;
+}
+
+UnicornCPU &DynarmicCPU::get_fallback() {
+    if (!fallback) {
+        fallback = std::make_unique<UnicornCPU>(parent);
+        fallback->set_tpidruro(cp15->get_tpidruro());
+    }
+    return *fallback;
+}
+
 DynarmicCPU::DynarmicCPU(CPUState *state, std::size_t processor_id, Dynarmic::ExclusiveMonitor *monitor, bool cpu_opt)
     : parent(state)
-    , fallback(state)
     , cb(std::make_unique<ArmDynarmicCallback>(*state, *this))
     , cp15(std::make_shared<ArmDynarmicCP15>())
     , monitor(monitor)
     , cpu_opt(cpu_opt)
     , core_id(processor_id) {
-    jit = make_jit();
 }
 
 DynarmicCPU::~DynarmicCPU() {
@@ -299,12 +315,12 @@ int DynarmicCPU::run() {
     halted = false;
     break_ = false;
     exit_request = false;
-    jit->Run();
+    get_jit().Run();
     return halted;
 }
 
 int DynarmicCPU::step() {
-    jit->Step();
+    get_jit().Step();
     return 0;
 }
 
@@ -322,7 +338,8 @@ void DynarmicCPU::set_log_code(bool log) {
         return;
 
     log_code = log;
-    jit = make_jit();
+    if (jit)
+        jit = make_jit();
 }
 
 void DynarmicCPU::set_log_mem(bool log) {
@@ -330,7 +347,8 @@ void DynarmicCPU::set_log_mem(bool log) {
         return;
 
     log_mem = log;
-    jit = make_jit();
+    if (jit)
+        jit = make_jit();
 }
 
 bool DynarmicCPU::get_log_code() {
@@ -346,23 +364,29 @@ void DynarmicCPU::stop() {
 }
 
 uint32_t DynarmicCPU::get_reg(uint8_t idx) {
-    return jit->Regs()[idx];
+    return jit ? jit->Regs()[idx] : parked.cpu_registers[idx];
 }
 
 uint32_t DynarmicCPU::get_sp() {
-    return jit->Regs()[13];
+    return get_reg(13);
 }
 
 uint32_t DynarmicCPU::get_pc() {
-    return jit->Regs()[15];
+    return get_reg(15);
 }
 
 void DynarmicCPU::set_reg(uint8_t idx, uint32_t val) {
-    jit->Regs()[idx] = val;
+    if (jit)
+        jit->Regs()[idx] = val;
+    else
+        parked.cpu_registers[idx] = val;
 }
 
 void DynarmicCPU::set_cpsr(uint32_t val) {
-    jit->SetCpsr(val);
+    if (jit)
+        jit->SetCpsr(val);
+    else
+        parked.cpsr = val;
 }
 
 uint32_t DynarmicCPU::get_tpidruro() {
@@ -371,7 +395,8 @@ uint32_t DynarmicCPU::get_tpidruro() {
 
 void DynarmicCPU::set_tpidruro(uint32_t val) {
     cp15->set_tpidruro(val);
-    fallback.set_tpidruro(val);
+    if (fallback)
+        fallback->set_tpidruro(val);
 }
 
 void DynarmicCPU::set_pc(uint32_t val) {
@@ -382,65 +407,77 @@ void DynarmicCPU::set_pc(uint32_t val) {
         set_cpsr(get_cpsr() & 0xFFFFFFDF);
         val = val & 0xFFFFFFFC;
     }
-    jit->Regs()[15] = val;
+    set_reg(15, val);
 }
 
 void DynarmicCPU::set_lr(uint32_t val) {
-    jit->Regs()[14] = val;
+    set_reg(14, val);
 }
 
 void DynarmicCPU::set_sp(uint32_t val) {
-    jit->Regs()[13] = val;
+    set_reg(13, val);
 }
 
 uint32_t DynarmicCPU::get_cpsr() {
-    return jit->Cpsr();
+    return jit ? jit->Cpsr() : parked.cpsr;
 }
 
 uint32_t DynarmicCPU::get_fpscr() {
-    return jit->Fpscr();
+    return jit ? jit->Fpscr() : parked.fpscr;
 }
 
 void DynarmicCPU::set_fpscr(uint32_t val) {
-    jit->SetFpscr(val);
+    if (jit)
+        jit->SetFpscr(val);
+    else
+        parked.fpscr = val;
 }
 
-CPUContext DynarmicCPU::save_context() {
-    CPUContext ctx;
-    const auto dctx = jit->SaveContext();
-    ctx.cpu_registers = dctx.Regs();
-    static_assert(sizeof(ctx.fpu_registers) == sizeof(dctx.ExtRegs()));
-    memcpy(ctx.fpu_registers.data(), dctx.ExtRegs().data(), sizeof(ctx.fpu_registers));
-    ctx.fpscr = dctx.Fpscr();
-    ctx.cpsr = dctx.Cpsr();
-
-    return ctx;
+// Go straight through the JIT register file: a Dynarmic::A32::Context heap allocates its state,
+// which adds up with fibers switching contexts thousands of times per frame
+void DynarmicCPU::save_context(CPUContext &ctx) {
+    if (!jit) {
+        ctx = parked;
+        return;
+    }
+    ctx.cpu_registers = jit->Regs();
+    static_assert(sizeof(ctx.fpu_registers) == sizeof(jit->ExtRegs()));
+    memcpy(ctx.fpu_registers.data(), jit->ExtRegs().data(), sizeof(ctx.fpu_registers));
+    ctx.fpscr = jit->Fpscr();
+    ctx.cpsr = jit->Cpsr();
 }
 
-void DynarmicCPU::load_context(CPUContext ctx) {
-    Dynarmic::A32::Context dctx;
-    dctx.Regs() = ctx.cpu_registers;
-    static_assert(sizeof(ctx.fpu_registers) == sizeof(dctx.ExtRegs()));
-    memcpy(dctx.ExtRegs().data(), ctx.fpu_registers.data(), sizeof(ctx.fpu_registers));
-    dctx.SetCpsr(ctx.cpsr);
-    dctx.SetFpscr(ctx.fpscr);
-    jit->LoadContext(dctx);
+void DynarmicCPU::load_context(const CPUContext &ctx) {
+    if (!jit) {
+        parked = ctx;
+        return;
+    }
+    jit->Regs() = ctx.cpu_registers;
+    static_assert(sizeof(ctx.fpu_registers) == sizeof(jit->ExtRegs()));
+    memcpy(jit->ExtRegs().data(), ctx.fpu_registers.data(), sizeof(ctx.fpu_registers));
+    jit->SetCpsr(ctx.cpsr);
+    jit->SetFpscr(ctx.fpscr);
 }
 
 uint32_t DynarmicCPU::get_lr() {
-    return jit->Regs()[14];
+    return get_reg(14);
 }
 
 float DynarmicCPU::get_float_reg(uint8_t idx) {
+    if (!jit)
+        return parked.fpu_registers[idx];
     return reinterpret_cast<float &>(jit->ExtRegs()[idx]);
 }
 
 void DynarmicCPU::set_float_reg(uint8_t idx, float val) {
-    jit->ExtRegs()[idx] = reinterpret_cast<uint32_t &>(val);
+    if (jit)
+        jit->ExtRegs()[idx] = reinterpret_cast<uint32_t &>(val);
+    else
+        parked.fpu_registers[idx] = val;
 }
 
 bool DynarmicCPU::is_thumb_mode() {
-    return jit->Cpsr() & 0x20;
+    return get_cpsr() & 0x20;
 }
 
 std::size_t DynarmicCPU::processor_id() const {
@@ -448,7 +485,9 @@ std::size_t DynarmicCPU::processor_id() const {
 }
 
 void DynarmicCPU::invalidate_jit_cache(Address start, size_t length) {
-    jit->InvalidateCacheRange(start, length);
+    // Nothing cached yet when the JIT hasn't been built
+    if (jit)
+        jit->InvalidateCacheRange(start, length);
 }
 
 // TODO: proper abstraction
@@ -354,8 +354,7 @@ bool UnicornCPU::is_thumb_mode() {
     return mode & UC_MODE_THUMB;
 }
 
-CPUContext UnicornCPU::save_context() {
-    CPUContext ctx;
+void UnicornCPU::save_context(CPUContext &ctx) {
     for (size_t i = 0; i < 16; i++) {
         ctx.cpu_registers[i] = get_reg(i);
     }
@@ -370,11 +369,9 @@ CPUContext UnicornCPU::save_context() {
     // Unicorn doesn't like tweaking cpsr
     // ctx.cpsr = get_cpsr();
     // ctx.fpscr = get_fpscr();
-
-    return ctx;
 }
 
-void UnicornCPU::load_context(CPUContext ctx) {
+void UnicornCPU::load_context(const CPUContext &ctx) {
     for (size_t i = 0; i < ctx.fpu_registers.size(); i++) {
         set_float_reg(i, ctx.fpu_registers[i]);
     }
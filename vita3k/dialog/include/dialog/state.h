@@ -53,7 +53,8 @@ struct MsgState {
 };
 
 struct TrophyState {
-    uint32_t tick;
+    // Guest clock time at which the dialog closes, in microseconds
+    uint64_t tick;
 };
 
 struct SavedataState {
@@ -23,4 +23,5 @@
 struct DisplayState;
 struct KernelState;
 
+void start_vblank_thread(DisplayState &display, KernelState &kernel);
 void wait_vblank(DisplayState &display, KernelState &kernel, const SceUID thread_id, const int count, const bool since_last_setbuf, const bool is_cb);
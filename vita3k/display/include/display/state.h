@@ -39,6 +39,13 @@ struct DisplayStateVBlankWaitInfo {
     bool is_cb;
 };
 
+// Measured vblank pacing, refreshed about once per second by the vblank thread
+struct DisplayStateVBlankStats {
+    std::atomic<float> period_us{ 0.f };
+    std::atomic<float> jitter_avg_us{ 0.f };
+    std::atomic<float> jitter_max_us{ 0.f };
+};
+
 struct DisplayState {
     Ptr<const void> base;
     uint32_t pitch = 0;
@@ -51,6 +58,8 @@ struct DisplayState {
     std::atomic<bool> imgui_render{ true };
     std::atomic<bool> fullscreen{ false };
     std::atomic<std::uint64_t> vblank_count{ 0 };
+    double refresh_rate = 59.94;
+    DisplayStateVBlankStats vblank_stats;
     std::vector<DisplayStateVBlankWaitInfo> vblank_wait_infos;
     std::uint64_t last_setframe_vblank_count = 0;
     std::vector<SceUID> vblank_callbacks_id{};
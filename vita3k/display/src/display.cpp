@@ -15,21 +15,60 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <display/functions.h>
 #include <display/state.h>
 #include <kernel/state.h>
+#include <rtc/rtc.h>
 
-#include <chrono>
+#include <algorithm>
+#include <cmath>
 #include <util/find.h>
 #include <util/log.h>
 #include <util/lock_and_find.h>
 
 // Code heavily influenced by PPSSSPP's SceDisplay.cpp
 
-static constexpr int TARGET_FPS = 60;
-static constexpr int TARGET_MS_PER_FRAME = 1000 / TARGET_FPS;
+// Sleep until this long before each vblank, then spin, so ticks do not inherit the host scheduler jitter
+static constexpr std::uint64_t VBLANK_SPIN_US = 1000;
+// When the thread falls further behind than this (debugger break, host suspend...), restart pacing from now
+// instead of firing every missed vblank back to back
+static constexpr std::uint64_t MAX_VBLANK_LATE_FRAMES = 4;
 
 static void vblank_sync_thread(DisplayState &display, KernelState &kernel) {
+    const double period = 1'000'000.0 / (display.refresh_rate > 0.0 ? display.refresh_rate : 59.94);
+    const auto stats_window = static_cast<std::uint64_t>(std::max(1.0, std::round(1'000'000.0 / period)));
+
+    // Deadlines are computed from a fixed origin rather than accumulated, so rounding and loop overhead never drift
+    std::uint64_t origin = rtc_ticks_since_epoch();
+    std::uint64_t frame = 0;
+    std::uint64_t window_start = origin;
+    std::uint64_t window_ticks = 0;
+    double jitter_sum = 0;
+    std::uint64_t jitter_max = 0;
+
     while (!display.abort.load()) {
+        const std::uint64_t deadline = origin + static_cast<std::uint64_t>(std::llround(++frame * period));
+        rtc_sleep_until_precise(deadline, VBLANK_SPIN_US);
+
+        const std::uint64_t now = rtc_ticks_since_epoch();
+        const std::uint64_t jitter = now - deadline;
+        if (jitter > MAX_VBLANK_LATE_FRAMES * period) {
+            origin = now;
+            frame = 0;
+        }
+
+        jitter_sum += static_cast<double>(jitter);
+        jitter_max = std::max(jitter_max, jitter);
+        if (++window_ticks == stats_window) {
+            display.vblank_stats.period_us = static_cast<float>(static_cast<double>(now - window_start) / window_ticks);
+            display.vblank_stats.jitter_avg_us = static_cast<float>(jitter_sum / window_ticks);
+            display.vblank_stats.jitter_max_us = static_cast<float>(jitter_max);
+            window_start = now;
+            window_ticks = 0;
+            jitter_sum = 0;
+            jitter_max = 0;
+        }
+
         {
             const std::lock_guard<std::mutex> guard(display.mutex);
             for (std::size_t i = 0; i < display.vblank_wait_infos.size(); i++) {
@@ -62,14 +101,17 @@ static void vblank_sync_thread(DisplayState &display, KernelState &kernel) {
             }
             display.vblank_count++;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(TARGET_MS_PER_FRAME));
     }
 }
 
-void wait_vblank(DisplayState &display, KernelState &kernel, const SceUID thread_id, int count, const bool since_last_setbuf, const bool is_cb) {
+void start_vblank_thread(DisplayState &display, KernelState &kernel) {
     if (!display.vblank_thread) {
         display.vblank_thread = std::make_unique<std::thread>(vblank_sync_thread, std::ref(display), std::ref(kernel));
     }
+}
+
+void wait_vblank(DisplayState &display, KernelState &kernel, const SceUID thread_id, int count, const bool since_last_setbuf, const bool is_cb) {
+    start_vblank_thread(display, kernel);
 
     const ThreadStatePtr wait_thread = util::find(thread_id, kernel.threads);
     if (!wait_thread) {
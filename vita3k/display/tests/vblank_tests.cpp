@@ -0,0 +1,57 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <display/functions.h>
+#include <display/state.h>
+#include <kernel/state.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+// Runs the vblank thread without any guest attached and checks its pacing against the host clock.
+// A high rate keeps the test short, while the period is still well above the spin window.
+TEST(vblank, average_period_over_1000_ticks) {
+    constexpr double RATE = 240.0;
+    constexpr std::uint64_t TICKS = 1000;
+
+    DisplayState display;
+    display.refresh_rate = RATE;
+    KernelState kernel;
+    start_vblank_thread(display, kernel);
+
+    const auto wait_for_count = [&](std::uint64_t count) {
+        while (display.vblank_count.load() < count)
+            std::this_thread::yield();
+        return std::chrono::steady_clock::now();
+    };
+
+    const auto first = wait_for_count(1);
+    const auto last = wait_for_count(TICKS + 1);
+
+    display.abort = true;
+    display.vblank_thread->join();
+
+    const double expected_us = 1'000'000.0 / RATE;
+    const double average_us = std::chrono::duration<double, std::micro>(last - first).count() / TICKS;
+
+    // Deadlines are absolute, so loop overhead does not add up over the run. The bounds stay loose enough for a
+    // loaded host, where the thread may fall behind and restart its pacing.
+    EXPECT_NEAR(average_us, expected_us, expected_us * 0.1);
+    EXPECT_NEAR(display.vblank_stats.period_us, expected_us, expected_us * 0.1);
+}
@@ -56,8 +56,8 @@ void get_sys_apps_title(GuiState &gui, HostState &host);
 std::string get_sys_lang_name(uint32_t lang_id);
 void init(GuiState &gui, HostState &host);
 void init_app_background(GuiState &gui, HostState &host, const std::string &app_path);
-void init_app_icon(GuiState &gui, HostState &host, const std::string app_path);
 void init_apps_icon(GuiState &gui, HostState &host, const std::vector<gui::App> &app_list);
+void init_apps_icon(GuiState &gui, const AppIndex &index);
 void init_config(GuiState &gui, HostState &host, const std::string &app_path);
 void init_content_manager(GuiState &gui, HostState &host);
 vfs::FileBuffer init_default_icon(GuiState &gui, HostState &host);
@@ -84,6 +84,7 @@ void pre_init(GuiState &gui, HostState &host);
 void pre_load_app(GuiState &gui, HostState &host, bool live_area, const std::string &app_path);
 void pre_run_app(GuiState &gui, HostState &host, const std::string &app_path);
 void save_apps_cache(GuiState &gui, HostState &host);
+void update_apps_cache(GuiState &gui, HostState &host, const std::string &app_path);
 void save_user(GuiState &gui, HostState &host, const std::string &user_id);
 void set_config(GuiState &gui, HostState &host, const std::string &app_path);
 void set_shaders_compiled_display(GuiState &gui, HostState &host);
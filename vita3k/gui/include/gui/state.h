@@ -29,8 +29,11 @@
 #include <gui/imgui_impl_sdl_state.h>
 
 #include <glutil/object.h>
+#include <host/app_index.h>
+#include <util/fs.h>
 
 #include <atomic>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <queue>
@@ -40,6 +43,7 @@
 
 struct GuiState;
 struct HostState;
+class ThreadPool;
 
 namespace gui {
 
@@ -93,7 +97,8 @@ struct IconData {
 struct IconAsyncLoader {
     std::mutex mutex;
 
-    std::unordered_map<std::string, IconData> icon_data;
+    // RGBA pixels of each icon, empty when it could not be decoded
+    std::unordered_map<std::string, std::vector<uint8_t>> icon_data;
 
     std::thread thread;
     std::atomic_bool quit = false;
@@ -101,13 +106,156 @@ struct IconAsyncLoader {
     void commit(GuiState &gui);
 
     IconAsyncLoader(GuiState &gui, HostState &host, const std::vector<gui::App> &app_list);
+    explicit IconAsyncLoader(const AppIndex &index);
     ~IconAsyncLoader();
 };
 
+// Runs jobs on a worker pool and hands what they produce to the UI thread. Every job belongs to a group, cancelling
+// the group drops whatever its jobs have not delivered yet.
+class AsyncJobs {
+public:
+    // Runs on the UI thread from commit()
+    typedef std::function<void(GuiState &gui)> Delivery;
+    // Runs on a worker and returns what to deliver, or an empty function if there is nothing.
+    // Long jobs can stop early once cancelled() is true, their result would be dropped anyway.
+    typedef std::function<Delivery(const std::function<bool()> &cancelled)> Job;
+
+    explicit AsyncJobs(size_t thread_count);
+    ~AsyncJobs();
+
+    void submit(const std::string &group, Job job);
+    void cancel(const std::string &group);
+    void commit(GuiState &gui);
+
+    // Joins the workers, nothing is delivered afterwards
+    void stop();
+    bool stopping() const {
+        return quit;
+    }
+
+private:
+    struct Result {
+        std::string group;
+        Delivery deliver;
+    };
+
+    bool is_current(const std::string &group, uint64_t generation);
+
+    std::unique_ptr<ThreadPool> pool;
+    std::atomic_bool quit = false;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, uint64_t> generations;
+    std::vector<Result> results;
+};
+
+struct DecodedImage {
+    int32_t width = 0;
+    int32_t height = 0;
+
+    // Size of the source image, layouts are computed from it even when the pixels were downscaled
+    int32_t source_width = 0;
+    int32_t source_height = 0;
+
+    std::vector<uint8_t> pixels;
+};
+
+struct ImageRequest {
+    // Used in log messages only
+    std::string name;
+
+    // Runs on a worker thread, returns the encoded file or an empty buffer if not found
+    std::function<std::vector<uint8_t>()> read;
+
+    // Runs on the UI thread from commit(), so it can create the texture
+    std::function<void(GuiState &gui, DecodedImage &image)> done;
+
+    // Longest edge kept after decoding, 0 keeps the source size
+    int32_t max_size = 0;
+
+    bool cache = true;
+};
+
+class ImageAsyncLoader {
+public:
+    ImageAsyncLoader(ImGui_State *imgui_state, const std::string &base_path);
+    ~ImageAsyncLoader();
+
+    void request(const std::string &group, ImageRequest image);
+
+    // Pending images of the group are dropped, their done callback never runs
+    void cancel(const std::string &group);
+
+    void commit(GuiState &gui);
+
+    ImTextureID placeholder() const;
+    ImTextureID or_placeholder(const ImGui_Texture &texture) const;
+
+private:
+    bool load(const ImageRequest &image, DecodedImage &decoded);
+    bool read_cache(uint64_t key, DecodedImage &decoded);
+    void write_cache(uint64_t key, const DecodedImage &decoded);
+
+    AsyncJobs jobs;
+
+    std::mutex cache_mutex;
+    std::string cache_path;
+    std::optional<uint64_t> cache_size;
+    std::atomic<uint32_t> cache_write_count = 0;
+
+    ImGui_Texture placeholder_texture;
+};
+
+// Sums the size of directory trees on a worker pool. Every directory remembers its modification time
+// along with the size of the files directly inside it, so a later scan only lists the directories that
+// changed since. The cache is kept on disk between runs.
+// Files rewritten in place without touching their directory keep their old size until it changes.
+class DirSizeScanner {
+public:
+    explicit DirSizeScanner(const std::string &base_path);
+    ~DirSizeScanner();
+
+    // Sums the sizes of all the paths, missing ones count as empty
+    void request(const std::string &group, std::vector<fs::path> paths, std::function<void(GuiState &gui, uint64_t size)> done);
+
+    // Pending sizes of the group are dropped, their done callback never runs
+    void cancel(const std::string &group);
+
+    void commit(GuiState &gui);
+
+    // Same as request, on the calling thread
+    uint64_t size(const fs::path &path);
+
+private:
+    struct Dir {
+        std::time_t modified;
+        uint64_t files_size;
+        std::vector<std::string> subdirs;
+    };
+
+    uint64_t scan(const fs::path &dir);
+    void load_cache();
+    void save_cache();
+
+    AsyncJobs jobs;
+
+    std::mutex cache_mutex;
+    std::string cache_path;
+    // Keyed by generic path, ordered so that a whole subtree can be dropped at once
+    std::map<std::string, Dir> dirs;
+    bool dirty = false;
+};
+
+struct LiveItemTextures {
+    std::vector<ImGui_Texture> backgrounds;
+    std::vector<ImGui_Texture> images;
+};
+
 struct AppsSelector {
     std::vector<App> sys_apps;
     std::vector<App> user_apps;
     uint32_t apps_cache_lang;
+    std::optional<AppIndex> app_index;
     AppInfo app_info;
     std::optional<IconAsyncLoader> icon_async_loader;
     std::map<std::string, ImGui_Texture> sys_apps_icon;
@@ -150,6 +298,7 @@ struct DebugMenuState {
     bool allocations_dialog = false;
     bool memory_editor_dialog = false;
     bool disassembly_dialog = false;
+    bool hle_profiler_dialog = false;
 };
 
 struct ConfigurationMenuState {
@@ -333,10 +482,14 @@ struct GuiState {
     InfoBarColor information_bar_color;
 
     std::map<std::string, std::map<std::string, ImGui_Texture>> live_area_contents;
-    std::map<std::string, std::map<std::string, std::map<std::string, std::vector<ImGui_Texture>>>> live_items;
+    // Indexed like the frames of the live area of each app
+    std::map<std::string, std::vector<gui::LiveItemTextures>> live_items;
 
     std::vector<ImGui_Texture> manuals;
 
+    std::optional<gui::ImageAsyncLoader> image_async_loader;
+    std::optional<gui::DirSizeScanner> dir_size_scanner;
+
     std::map<ShadersCompiledDisplay, uint64_t> shaders_compiled_display;
 
     SceUID thread_watch_index = -1;
@@ -247,7 +247,7 @@ void delete_app(GuiState &gui, HostState &host, const std::string &app_path) {
 
         gui.app_selector.user_apps.erase(APP_INDEX);
 
-        save_apps_cache(gui, host);
+        update_apps_cache(gui, host, app_path);
     } catch (std::exception &e) {
         LOG_ERROR("Failed to delete '{} [{}]'.\n{}", title_id, APP_INDEX->title, e.what());
     }
@@ -52,7 +52,11 @@ void init_user_apps(GuiState &gui, HostState &host) {
         gui.app_selector.is_app_list_sorted = false;
         init_last_time_apps(gui, host);
 
-        init_apps_icon(gui, host, gui.app_selector.user_apps);
+        // The icons were just decoded into the rebuilt app index, textures are made from its pixels
+        if (gui.app_selector.app_index)
+            init_apps_icon(gui, *gui.app_selector.app_index);
+        else
+            init_apps_icon(gui, host, gui.app_selector.user_apps);
 
         if (app_list_size == gui.app_selector.user_apps.size())
             return false;
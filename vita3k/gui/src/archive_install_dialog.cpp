@@ -239,7 +239,7 @@ void draw_archive_install_dialog(GuiState &gui, HostState &host) {
                                 update_notice_info(gui, host, "content");
                             if (content.category == "gd") {
                                 init_user_app(gui, host, content.title_id);
-                                save_apps_cache(gui, host);
+                                update_apps_cache(gui, host, content.title_id);
                             }
                         }
                     }
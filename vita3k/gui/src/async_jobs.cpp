@@ -0,0 +1,86 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/state.h>
+
+#include <threads/thread_pool.h>
+
+#include <algorithm>
+
+namespace gui {
+
+AsyncJobs::AsyncJobs(size_t thread_count)
+    : pool(std::make_unique<ThreadPool>(thread_count)) {
+}
+
+AsyncJobs::~AsyncJobs() {
+    stop();
+}
+
+void AsyncJobs::stop() {
+    // Jobs still queued see the flag and return right away while the pool joins
+    quit = true;
+    pool.reset();
+}
+
+bool AsyncJobs::is_current(const std::string &group, uint64_t generation) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return generations[group] == generation;
+}
+
+void AsyncJobs::submit(const std::string &group, Job job) {
+    uint64_t generation;
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        generation = generations[group];
+    }
+
+    pool->submit([this, group, generation, job = std::move(job)]() {
+        const auto cancelled = [&]() { return quit || !is_current(group, generation); };
+        if (cancelled())
+            return;
+
+        auto deliver = job(cancelled);
+        if (!deliver)
+            return;
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (generations[group] == generation)
+            results.push_back({ group, std::move(deliver) });
+    });
+}
+
+void AsyncJobs::cancel(const std::string &group) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    ++generations[group];
+    results.erase(std::remove_if(results.begin(), results.end(), [&group](const Result &result) { return result.group == group; }), results.end());
+}
+
+void AsyncJobs::commit(GuiState &gui) {
+    std::vector<Result> ready;
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (results.empty())
+            return;
+        ready.swap(results);
+    }
+
+    for (auto &result : ready)
+        result.deliver(gui);
+}
+
+} // namespace gui
@@ -20,6 +20,7 @@
 #include <gui/functions.h>
 
 #include <gui/imgui_impl_sdl.h>
+#include <rtc/rtc.h>
 #include <util/string_utils.h>
 
 #include <SDL.h>
@@ -126,7 +127,7 @@ static void draw_message_dialog(DialogState &common_dialog, float FONT_SCALE, Im
 }
 
 static void draw_trophy_setup_dialog(DialogState &common_dialog, float FONT_SCALE, ImVec2 SCALE) {
-    int timer = (static_cast<int64_t>(common_dialog.trophy.tick) - static_cast<int64_t>(SDL_GetTicks())) / 1000;
+    int timer = (static_cast<int64_t>(common_dialog.trophy.tick) - static_cast<int64_t>(rtc_ticks_since_epoch())) / VITA_CLOCKS_PER_SEC;
     //if (timer > 0) {
     const auto display_size = ImGui::GetIO().DisplaySize;
     ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
@@ -31,18 +31,6 @@
 #include <util/safe_time.h>
 
 namespace gui {
-namespace {
-template <typename T>
-auto get_recursive_directory_size(const T &path) {
-    const auto &path_list = fs::recursive_directory_iterator(path);
-    const auto pred = [](const auto acc, const auto &app) {
-        if (fs::is_regular_file(app.path()))
-            return acc + fs::file_size(app.path());
-        return acc;
-    };
-    return boost::accumulate(path_list, boost::uintmax_t{}, pred);
-}
-} // namespace
 
 void get_app_info(GuiState &gui, HostState &host, const std::string &app_path) {
     const auto APP_PATH{ fs::path(host.pref_path) / "ux0/app" / app_path };
@@ -57,16 +45,14 @@ void get_app_info(GuiState &gui, HostState &host, const std::string &app_path) {
     }
 }
 
+static std::vector<fs::path> get_app_content_paths(GuiState &gui, HostState &host, const std::string &app_path) {
+    return { fs::path(host.pref_path) / "ux0/app" / app_path, fs::path(host.pref_path) / "ux0/addcont" / get_app_index(gui, app_path)->title_id };
+}
+
 size_t get_app_size(GuiState &gui, HostState &host, const std::string &app_path) {
-    const auto APP_PATH{ fs::path(host.pref_path) / "ux0/app" / app_path };
-    boost::uintmax_t app_size = 0;
-    if (fs::exists(APP_PATH) && !fs::is_empty(APP_PATH)) {
-        app_size += get_recursive_directory_size(APP_PATH);
-    }
-    const auto DLC_PATH{ fs::path(host.pref_path) / "ux0/addcont" / get_app_index(gui, app_path)->title_id };
-    if (fs::exists(DLC_PATH) && !fs::is_empty(DLC_PATH)) {
-        app_size += get_recursive_directory_size(DLC_PATH);
-    }
+    size_t app_size = 0;
+    for (const auto &path : get_app_content_paths(gui, host, app_path))
+        app_size += gui.dir_size_scanner->size(path);
     return app_size;
 }
 
@@ -108,8 +94,7 @@ static void get_save_data_list(GuiState &gui, HostState &host) {
             const auto last_writen = fs::last_write_time(save);
             SAFE_LOCALTIME(&last_writen, &updated_tm);
 
-            const auto size = get_recursive_directory_size(save);
-            save_data_list.push_back({ get_app_index(gui, title_id)->title, title_id, size, updated_tm });
+            save_data_list.push_back({ get_app_index(gui, title_id)->title, title_id, 0, updated_tm });
         }
     }
     std::sort(save_data_list.begin(), save_data_list.end(), [](const SaveData &sa, const SaveData &sb) {
@@ -120,46 +105,54 @@ static void get_save_data_list(GuiState &gui, HostState &host) {
 static std::map<std::string, size_t> apps_size;
 static std::map<std::string, std::string> space;
 
+// Sizes are filled in as the scanner returns them, the totals show a dash until something is found
+static void update_space(const std::string &key, const size_t size) {
+    space[key] = size ? get_unit_size(size) : "-";
+}
+
+static void update_apps_space() {
+    update_space("app", boost::accumulate(apps_size, size_t{}, [](const auto acc, const auto &app) { return acc + app.second; }));
+}
+
+static void update_savedata_space() {
+    update_space("savedata", boost::accumulate(save_data_list, size_t{}, [](const auto acc, const auto &save) { return acc + save.size; }));
+}
+
 void init_content_manager(GuiState &gui, HostState &host) {
+    auto &scanner = *gui.dir_size_scanner;
+    scanner.cancel("content_manager");
     space.clear();
+    apps_size.clear();
 
     const auto free_size{ fs::space(host.pref_path).free };
     space["free"] = get_unit_size(free_size);
 
-    const auto query_app = [&gui, &host] {
-        const auto &directory_list = gui.app_selector.user_apps;
-        const auto pred = [&](const auto acc, const auto &app) {
-            apps_size[app.path] = get_app_size(gui, host, app.path);
-            return acc + apps_size[app.path];
-        };
-        return boost::accumulate(directory_list, boost::uintmax_t{}, pred);
-    };
-
-    const auto query_savedata = [] {
-        const auto &directory_list = save_data_list;
-        const auto pred = [](const auto acc, const auto &save) { return acc + save.size; };
-        return boost::accumulate(directory_list, boost::uintmax_t{}, pred);
-    };
-
-    const auto query_themes = [&host] {
-        const auto THEME_PATH{ fs::path(host.pref_path) / "ux0/theme" };
-        const auto &directory_list = fs::directory_iterator(THEME_PATH);
-        const auto pred = [&](const auto acc, const auto &) { return acc + get_recursive_directory_size(THEME_PATH); };
-        if (fs::exists(THEME_PATH) && !fs::is_empty(THEME_PATH)) {
-            return boost::accumulate(directory_list, boost::uintmax_t{}, pred);
-        }
-        return boost::uintmax_t{};
-    };
-
-    const auto get_list_size_or_dash = [](const auto query) {
-        const auto list_size = query();
-        return list_size ? get_unit_size(list_size) : "-";
-    };
+    update_apps_space();
+    for (const auto &app : gui.app_selector.user_apps) {
+        scanner.request("content_manager", get_app_content_paths(gui, host, app.path), [path = app.path](GuiState &, uint64_t size) {
+            apps_size[path] = size;
+            update_apps_space();
+        });
+    }
 
-    space["app"] = get_list_size_or_dash(query_app);
     get_save_data_list(gui, host);
-    space["savedata"] = get_list_size_or_dash(query_savedata);
-    space["themes"] = get_list_size_or_dash(query_themes);
+    update_savedata_space();
+    const fs::path SAVE_PATH{ fs::path{ host.pref_path } / "ux0/user" / host.io.user_id / "savedata" };
+    for (const auto &save : save_data_list) {
+        scanner.request("content_manager", { SAVE_PATH / save.title_id }, [title_id = save.title_id](GuiState &, uint64_t size) {
+            const auto save_index = std::find_if(save_data_list.begin(), save_data_list.end(), [&](const SaveData &s) {
+                return s.title_id == title_id;
+            });
+            if (save_index != save_data_list.end())
+                save_index->size = size;
+            update_savedata_space();
+        });
+    }
+
+    update_space("themes", 0);
+    scanner.request("content_manager", { fs::path(host.pref_path) / "ux0/theme" }, [](GuiState &, uint64_t size) {
+        update_space("themes", size);
+    });
 }
 
 static std::map<std::string, bool> contents_selected;
@@ -194,10 +187,13 @@ struct Dlc {
 static std::map<std::string, Dlc> dlc_info;
 
 static void get_content_info(GuiState &gui, HostState &host) {
-    const auto APP_PATH{ fs::path(host.pref_path) / "ux0/app" / app_selected };
-    if (fs::exists(APP_PATH) && !fs::is_empty(APP_PATH)) {
-        gui.app_selector.app_info.size = get_recursive_directory_size(APP_PATH);
-    }
+    auto &scanner = *gui.dir_size_scanner;
+    scanner.cancel("content_info");
+
+    gui.app_selector.app_info.size = 0;
+    scanner.request("content_info", { fs::path(host.pref_path) / "ux0/app" / app_selected }, [](GuiState &gui, uint64_t size) {
+        gui.app_selector.app_info.size = size;
+    });
 
     dlc_info.clear();
     const auto DLC_PATH{ fs::path(host.pref_path) / "ux0/addcont" / app_selected };
@@ -210,8 +206,10 @@ static void get_content_info(GuiState &gui, HostState &host) {
             const auto last_writen = fs::last_write_time(dlc);
             SAFE_LOCALTIME(&last_writen, &dlc_info[content_id].date);
 
-            const auto dlc_size = get_recursive_directory_size(dlc);
-            dlc_info[content_id].size = get_unit_size(dlc_size);
+            dlc_info[content_id].size = "-";
+            scanner.request("content_info", { dlc.path() }, [content_id](GuiState &, uint64_t size) {
+                dlc_info[content_id].size = get_unit_size(size);
+            });
 
             const auto content_path{ fs::path("addcont") / app_selected / content_id };
             vfs::FileBuffer params;
@@ -431,7 +429,8 @@ void draw_content_manager(GuiState &gui, HostState &host) {
                     ImGui::TextColored(GUI_COLOR_TEXT, "%s", app.title.c_str());
                     ImGui::SetCursorPosY(Title_POS + (46.f * SCALE.y));
                     ImGui::SetWindowFontScale(0.8f);
-                    ImGui::TextColored(GUI_COLOR_TEXT, "%s", get_unit_size(apps_size[app.path]).c_str());
+                    const auto app_size = apps_size.find(app.path);
+                    ImGui::TextColored(GUI_COLOR_TEXT, "%s", app_size != apps_size.end() ? get_unit_size(app_size->second).c_str() : "-");
                     ImGui::NextColumn();
                     ImGui::SetWindowFontScale(1.2f);
                     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + (15.f * SCALE.y));
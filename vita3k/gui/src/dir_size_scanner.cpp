@@ -0,0 +1,231 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/state.h>
+
+#include <util/fs.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+
+namespace gui {
+
+static constexpr uint32_t DIR_SIZE_CACHE_MAGIC = 0x4B335344; // 'DS3K'
+static constexpr uint32_t DIR_SIZE_CACHE_VERSION = 1;
+// Far more than any real directory holds, a larger count means the cache is corrupt
+static constexpr uint32_t DIR_SIZE_CACHE_MAX_SUBDIRS = 65536;
+
+// Never matches a real modification time, used for directories that may still change within the second they were listed in
+static constexpr std::time_t DIR_SIZE_UNTRUSTED = -1;
+
+struct DirSizeCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+};
+
+template <typename T>
+static bool read_value(std::ifstream &file, T &value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+static bool read_string(std::ifstream &file, std::string &str) {
+    uint32_t length = 0;
+    if (!read_value(file, length) || (length > 4096))
+        return false;
+    str.resize(length);
+    return static_cast<bool>(file.read(str.data(), length));
+}
+
+template <typename T>
+static void write_value(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void write_string(std::ofstream &file, const std::string &str) {
+    write_value(file, static_cast<uint32_t>(str.size()));
+    file.write(str.data(), str.size());
+}
+
+DirSizeScanner::DirSizeScanner(const std::string &base_path)
+    // Mostly waiting on the disk, so more threads than cores still help on network storage
+    : jobs(std::max(4u, std::thread::hardware_concurrency()))
+    , cache_path((fs::path(base_path) / "cache/dir_sizes.dat").string()) {
+    load_cache();
+}
+
+DirSizeScanner::~DirSizeScanner() {
+    jobs.stop();
+    save_cache();
+}
+
+void DirSizeScanner::request(const std::string &group, std::vector<fs::path> paths, std::function<void(GuiState &gui, uint64_t size)> done) {
+    jobs.submit(group, [this, paths = std::move(paths), done = std::move(done)](const std::function<bool()> &cancelled) -> AsyncJobs::Delivery {
+        uint64_t total = 0;
+        for (const auto &path : paths) {
+            if (cancelled())
+                return {};
+            total += scan(path);
+        }
+
+        return [done, total](GuiState &gui) { done(gui, total); };
+    });
+}
+
+void DirSizeScanner::cancel(const std::string &group) {
+    jobs.cancel(group);
+}
+
+void DirSizeScanner::commit(GuiState &gui) {
+    jobs.commit(gui);
+}
+
+uint64_t DirSizeScanner::size(const fs::path &path) {
+    return scan(path);
+}
+
+uint64_t DirSizeScanner::scan(const fs::path &dir) {
+    boost::system::error_code error;
+    const auto modified = fs::last_write_time(dir, error);
+    if (error)
+        return 0;
+
+    const auto key = dir.generic_path().string();
+    Dir entry;
+    std::vector<std::string> old_subdirs;
+    bool cached = false;
+    {
+        const std::lock_guard<std::mutex> lock(cache_mutex);
+        const auto it = dirs.find(key);
+        if (it != dirs.end()) {
+            cached = it->second.modified == modified;
+            if (cached)
+                entry = it->second;
+            else
+                old_subdirs = it->second.subdirs;
+        }
+    }
+
+    if (!cached) {
+        // Listed before anything else, a change made while the listing runs then shows up on the next scan
+        entry.modified = (modified >= std::time(nullptr) - 1) ? DIR_SIZE_UNTRUSTED : modified;
+        entry.files_size = 0;
+        for (fs::directory_iterator it(dir, error), end; !error && (it != end); it.increment(error)) {
+            boost::system::error_code status_error;
+            // Links are not followed, a link to a directory could count a tree twice or loop forever
+            const auto status = it->symlink_status(status_error);
+            if (fs::is_directory(status))
+                entry.subdirs.push_back(it->path().filename().string());
+            else if (fs::is_regular_file(status))
+                entry.files_size += fs::file_size(it->path(), status_error);
+        }
+        std::sort(entry.subdirs.begin(), entry.subdirs.end());
+
+        const std::lock_guard<std::mutex> lock(cache_mutex);
+        // Removed directories take their whole subtree out of the cache
+        for (const auto &subdir : old_subdirs) {
+            if (std::binary_search(entry.subdirs.begin(), entry.subdirs.end(), subdir))
+                continue;
+            const auto prefix = key + "/" + subdir;
+            dirs.erase(prefix);
+            dirs.erase(dirs.lower_bound(prefix + "/"), dirs.lower_bound(prefix + "0"));
+        }
+        dirs[key] = entry;
+        dirty = true;
+    }
+
+    uint64_t size = entry.files_size;
+    for (const auto &subdir : entry.subdirs) {
+        if (jobs.stopping())
+            break;
+        size += scan(dir / subdir);
+    }
+    return size;
+}
+
+void DirSizeScanner::load_cache() {
+    std::ifstream file(cache_path, std::ios::binary);
+    if (!file)
+        return;
+
+    DirSizeCacheHeader header{};
+    if (!read_value(file, header) || (header.magic != DIR_SIZE_CACHE_MAGIC) || (header.version != DIR_SIZE_CACHE_VERSION))
+        return;
+
+    std::map<std::string, Dir> loaded;
+    for (uint32_t i = 0; i < header.count; i++) {
+        std::string key;
+        Dir dir;
+        int64_t modified = 0;
+        uint32_t subdir_count = 0;
+        if (!read_string(file, key) || !read_value(file, modified) || !read_value(file, dir.files_size) || !read_value(file, subdir_count)
+            || (subdir_count > DIR_SIZE_CACHE_MAX_SUBDIRS)) {
+            LOG_WARN("Directory size cache is truncated or damaged, starting over");
+            return;
+        }
+        dir.modified = static_cast<std::time_t>(modified);
+        dir.subdirs.resize(subdir_count);
+        for (auto &subdir : dir.subdirs) {
+            if (!read_string(file, subdir)) {
+                LOG_WARN("Directory size cache is truncated, starting over");
+                return;
+            }
+        }
+        loaded.emplace(std::move(key), std::move(dir));
+    }
+
+    dirs = std::move(loaded);
+}
+
+void DirSizeScanner::save_cache() {
+    const std::lock_guard<std::mutex> lock(cache_mutex);
+    if (!dirty)
+        return;
+
+    boost::system::error_code error;
+    fs::create_directories(fs::path(cache_path).parent_path(), error);
+
+    // Written aside then renamed, a crash never leaves a partial cache behind
+    const auto temp_path = fs::path(cache_path + ".tmp");
+    {
+        std::ofstream file(temp_path.string(), std::ios::binary);
+        write_value(file, DirSizeCacheHeader{ DIR_SIZE_CACHE_MAGIC, DIR_SIZE_CACHE_VERSION, static_cast<uint32_t>(dirs.size()) });
+        for (const auto &[key, dir] : dirs) {
+            write_string(file, key);
+            write_value(file, static_cast<int64_t>(dir.modified));
+            write_value(file, dir.files_size);
+            write_value(file, static_cast<uint32_t>(dir.subdirs.size()));
+            for (const auto &subdir : dir.subdirs)
+                write_string(file, subdir);
+        }
+        if (!file) {
+            file.close();
+            fs::remove(temp_path, error);
+            return;
+        }
+    }
+
+    fs::rename(temp_path, cache_path, error);
+    if (error)
+        fs::remove(temp_path, error);
+    else
+        dirty = false;
+}
+
+} // namespace gui
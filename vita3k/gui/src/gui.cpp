@@ -28,6 +28,7 @@
 #include <io/VitaIoDevice.h>
 #include <io/vfs.h>
 #include <lang/functions.h>
+#include <renderer/state.h>
 #include <util/fs.h>
 #include <util/log.h>
 #include <util/string_utils.h>
@@ -38,6 +39,7 @@
 #include <stb_image.h>
 
 #include <fstream>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -250,10 +252,19 @@ static IconData load_app_icon(GuiState &gui, HostState &host, const std::string
     return std::move(image);
 }
 
-void init_app_icon(GuiState &gui, HostState &host, const std::string app_path) {
-    IconData data = load_app_icon(gui, host, app_path);
+static std::vector<uint8_t> load_app_icon_pixels(GuiState &gui, HostState &host, const std::string &app_path) {
+    const IconData icon = load_app_icon(gui, host, app_path);
+    if (!icon.data || (icon.width != AppIndex::ICON_SIZE) || (icon.height != AppIndex::ICON_SIZE))
+        return {};
+
+    const auto pixels = static_cast<const uint8_t *>(icon.data.get());
+    return std::vector<uint8_t>(pixels, pixels + AppIndex::ICON_BYTES);
+}
 
-    gui.app_selector.user_apps_icon[app_path].init(gui.imgui_state.get(), data.data.get(), data.width, data.height);
+static void init_app_icon(GuiState &gui, const std::string &app_path, std::vector<uint8_t> &pixels) {
+    const int size = pixels.empty() ? 0 : AppIndex::ICON_SIZE;
+    gui.app_selector.user_apps_icon.erase(app_path);
+    gui.app_selector.user_apps_icon[app_path].init(gui.imgui_state.get(), pixels.empty() ? nullptr : pixels.data(), size, size);
 }
 
 IconData::IconData()
@@ -262,8 +273,8 @@ IconData::IconData()
 void IconAsyncLoader::commit(GuiState &gui) {
     std::lock_guard<std::mutex> lock(mutex);
 
-    for (const auto &pair : icon_data)
-        gui.app_selector.user_apps_icon[pair.first].init(gui.imgui_state.get(), pair.second.data.get(), pair.second.width, pair.second.height);
+    for (auto &pair : icon_data)
+        init_app_icon(gui, pair.first, pair.second);
 
     icon_data.clear();
 }
@@ -285,26 +296,36 @@ IconAsyncLoader::IconAsyncLoader(GuiState &gui, HostState &host, const std::vect
                 return;
 
             // load the actual texture
-            IconData data = load_app_icon(gui, host, path);
+            auto pixels = load_app_icon_pixels(gui, host, path);
 
-            // Duplicate code here from init_app_icon
             {
                 std::lock_guard<std::mutex> lock(mutex);
-                icon_data[path] = std::move(data);
+                icon_data[path] = std::move(pixels);
             }
         }
     });
 }
 
+IconAsyncLoader::IconAsyncLoader(const AppIndex &index) {
+    // The index already holds the decoded icons, only the textures are left to make on the UI thread
+    for (const auto &entry : index.entries())
+        icon_data[std::string(entry.path)] = entry.icon ? std::vector<uint8_t>(entry.icon, entry.icon + AppIndex::ICON_BYTES) : std::vector<uint8_t>();
+}
+
 IconAsyncLoader::~IconAsyncLoader() {
     quit = true;
-    thread.join();
+    if (thread.joinable())
+        thread.join();
 }
 
 void init_apps_icon(GuiState &gui, HostState &host, const std::vector<gui::App> &app_list) {
     gui.app_selector.icon_async_loader.emplace(gui, host, app_list);
 }
 
+void init_apps_icon(GuiState &gui, const AppIndex &index) {
+    gui.app_selector.icon_async_loader.emplace(index);
+}
+
 void init_app_background(GuiState &gui, HostState &host, const std::string &app_path) {
     if (gui.apps_background.find(app_path) != gui.apps_background.end())
         return;
@@ -342,106 +363,109 @@ std::string get_sys_lang_name(uint32_t lang_id) {
     return current_sys_lang->second;
 }
 
-static bool get_user_apps(GuiState &gui, HostState &host) {
-    const auto apps_cache_path{ fs::path(host.pref_path) / "ux0/temp/apps.dat" };
-    fs::ifstream apps_cache(apps_cache_path, std::ios::in | std::ios::binary);
-    if (apps_cache.is_open()) {
-        gui.app_selector.user_apps.clear();
-        // Read size of apps list
-        size_t size;
-        apps_cache.read((char *)&size, sizeof(size));
-
-        // Check version of cache
-        uint32_t versionInFile;
-        apps_cache.read((char *)&versionInFile, sizeof(uint32_t));
-        if (versionInFile != 1) {
-            LOG_WARN("Current version of cache: {}, is outdated, recreate it.", versionInFile);
-            return false;
-        }
-
-        // Read language of cache
-        apps_cache.read((char *)&gui.app_selector.apps_cache_lang, sizeof(uint32_t));
-        if (gui.app_selector.apps_cache_lang != host.cfg.sys_lang) {
-            LOG_WARN("Current lang of cache: {}, is diferent config: {}, recreate it.", get_sys_lang_name(gui.app_selector.apps_cache_lang), get_sys_lang_name(host.cfg.sys_lang));
-            return false;
-        }
+static fs::path get_app_index_path(HostState &host) {
+    return fs::path(host.pref_path) / "ux0/temp/app_index.dat";
+}
 
-        // Read App info value
-        for (size_t a = 0; a < size; a++) {
-            auto read = [&apps_cache]() {
-                size_t size;
+static AppIndex::Record get_app_record(GuiState &gui, HostState &host, const App &app) {
+    AppIndex::Record record{ app.app_ver, app.category, app.content_id, app.addcont, app.savedata, app.parental_level, app.stitle, app.title, app.title_id, app.path };
 
-                apps_cache.read((char *)&size, sizeof(size));
+    boost::system::error_code error;
+    record.modified = fs::last_write_time(fs::path(host.pref_path) / "ux0/app" / app.path, error);
 
-                std::vector<char> buffer(size); // dont trust std::string to hold buffer enough
-                apps_cache.read(buffer.data(), size);
+    record.icon = load_app_icon_pixels(gui, host, app.path);
 
-                return std::string(buffer.begin(), buffer.end());
-            };
+    return record;
+}
 
-            App app;
+static bool get_user_apps(GuiState &gui, HostState &host) {
+    auto &index = gui.app_selector.app_index.emplace(get_app_index_path(host));
+    if (!index.open(host.cfg.sys_lang))
+        return false;
 
-            app.app_ver = read();
-            app.category = read();
-            app.content_id = read();
-            app.addcont = read();
-            app.savedata = read();
-            app.parental_level = read();
-            app.stitle = read();
-            app.title = read();
-            app.title_id = read();
-            app.path = read();
+    gui.app_selector.apps_cache_lang = host.cfg.sys_lang;
+    gui.app_selector.user_apps.clear();
 
-            gui.app_selector.user_apps.push_back(app);
+    // Only titles whose directory changed since they were indexed get their param.sfo and icon read again
+    const fs::path APP_PATH{ fs::path(host.pref_path) / "ux0/app" };
+    std::set<std::string> indexed;
+    std::vector<std::string> changed, removed;
+    std::vector<App> unindexed_icons;
+    for (const auto &entry : index.entries()) {
+        const std::string path(entry.path);
+        indexed.insert(path);
+
+        boost::system::error_code error;
+        const auto modified = fs::last_write_time(APP_PATH / path, error);
+        if (error) {
+            removed.push_back(path);
+            continue;
+        }
+        if (modified != entry.modified) {
+            changed.push_back(path);
+            continue;
         }
 
-        init_apps_icon(gui, host, gui.app_selector.user_apps);
+        gui.app_selector.user_apps.push_back({ std::string(entry.app_ver), std::string(entry.category), std::string(entry.content_id), std::string(entry.addcont),
+            std::string(entry.savedata), std::string(entry.parental_level), std::string(entry.stitle), std::string(entry.title), std::string(entry.title_id), path });
+        if (entry.icon)
+            gui.app_selector.user_apps_icon[path].init(gui.imgui_state.get(), const_cast<uint8_t *>(entry.icon), AppIndex::ICON_SIZE, AppIndex::ICON_SIZE);
+        else
+            unindexed_icons.push_back(gui.app_selector.user_apps.back());
+    }
+
+    boost::system::error_code error;
+    for (fs::directory_iterator it(APP_PATH, error), end; !error && (it != end); it.increment(error)) {
+        const auto path = it->path().filename().generic_string();
+        if (fs::is_directory(it->status()) && !indexed.count(path))
+            changed.push_back(path);
     }
 
+    for (const auto &path : removed)
+        index.remove(path);
+    for (const auto &path : changed) {
+        init_user_app(gui, host, path);
+        update_apps_cache(gui, host, path);
+    }
+
+    if (!unindexed_icons.empty())
+        init_apps_icon(gui, host, unindexed_icons);
+
     return !gui.app_selector.user_apps.empty();
 }
 
 void save_apps_cache(GuiState &gui, HostState &host) {
-    const auto temp_path{ fs::path(host.pref_path) / "ux0/temp" };
-    if (!fs::exists(temp_path))
-        fs::create_directory(temp_path);
-
-    fs::ofstream apps_cache(temp_path / "apps.dat", std::ios::out | std::ios::binary);
-    if (apps_cache.is_open()) {
-        // Write Size of apps list
-        const auto size = gui.app_selector.user_apps.size();
-        apps_cache.write((char *)&size, sizeof(size));
-
-        // Write version of cache
-        const uint32_t versionInFile = 1;
-        apps_cache.write((char *)&versionInFile, sizeof(uint32_t));
-
-        // Write language of cache
-        gui.app_selector.apps_cache_lang = host.cfg.sys_lang;
-        apps_cache.write((char *)&gui.app_selector.apps_cache_lang, sizeof(uint32_t));
-
-        // Write Apps list
-        for (const App &app : gui.app_selector.user_apps) {
-            auto write = [&apps_cache](const std::string &i) {
-                const auto size = i.length();
-
-                apps_cache.write((char *)&size, sizeof(size));
-                apps_cache.write(i.c_str(), size);
-            };
-
-            write(app.app_ver);
-            write(app.category);
-            write(app.content_id);
-            write(app.addcont);
-            write(app.savedata);
-            write(app.parental_level);
-            write(app.stitle);
-            write(app.title);
-            write(app.title_id);
-            write(app.path);
-        }
-        apps_cache.close();
+    std::vector<AppIndex::Record> records;
+    records.reserve(gui.app_selector.user_apps.size());
+    for (const App &app : gui.app_selector.user_apps)
+        records.push_back(get_app_record(gui, host, app));
+
+    gui.app_selector.apps_cache_lang = host.cfg.sys_lang;
+    auto &index = gui.app_selector.app_index ? *gui.app_selector.app_index : gui.app_selector.app_index.emplace(get_app_index_path(host));
+    // Dropped when it could not be written, so that nothing takes the icons from an empty index
+    if (!index.rebuild(host.cfg.sys_lang, records))
+        gui.app_selector.app_index.reset();
+
+    // Replaced by the app index
+    boost::system::error_code error;
+    fs::remove(fs::path(host.pref_path) / "ux0/temp/apps.dat", error);
+}
+
+void update_apps_cache(GuiState &gui, HostState &host, const std::string &app_path) {
+    const auto app = get_app_index(gui, app_path);
+    if (app == gui.app_selector.user_apps.end()) {
+        if (gui.app_selector.app_index)
+            gui.app_selector.app_index->remove(app_path);
+        return;
     }
+
+    // The icon is decoded once for the record and its texture made from the same pixels
+    auto record = get_app_record(gui, host, *app);
+    init_app_icon(gui, app_path, record.icon);
+
+    // Falls back to writing the whole index when none could be opened yet
+    if (!gui.app_selector.app_index || !gui.app_selector.app_index->put(record))
+        save_apps_cache(gui, host);
 }
 
 void init_home(GuiState &gui, HostState &host) {
@@ -471,8 +495,8 @@ void init_user_app(GuiState &gui, HostState &host, const std::string app_path) {
             gui.app_selector.user_apps_icon.erase(app_path);
     }
 
+    // The icon texture is made by update_apps_cache, which decodes it for the app index anyway
     get_app_param(gui, host, app_path);
-    init_app_icon(gui, host, app_path);
 
     const auto TIME_APP_INDEX = get_time_app_index(gui, host, app_path);
     if (TIME_APP_INDEX != gui.time_apps[host.io.user_id].end())
@@ -632,6 +656,9 @@ void pre_init(GuiState &gui, HostState &host) {
 }
 
 void init(GuiState &gui, HostState &host) {
+    gui.image_async_loader.emplace(gui.imgui_state.get(), host.base_path);
+    gui.dir_size_scanner.emplace(host.base_path);
+
     get_notice_list(host);
     get_users_list(gui, host);
     get_time_apps(gui, host);
@@ -658,12 +685,17 @@ void draw_begin(GuiState &gui, HostState &host) {
     // cant bind opengl context outside main thread on macos now
     if (gui.app_selector.icon_async_loader)
         gui.app_selector.icon_async_loader->commit(gui);
+    if (gui.image_async_loader)
+        gui.image_async_loader->commit(gui);
+    if (gui.dir_size_scanner)
+        gui.dir_size_scanner->commit(gui);
 }
 
 void draw_end(GuiState &gui, SDL_Window *window) {
     ImGui::Render();
     ImGui_ImplSdl_RenderDrawData(gui.imgui_state.get());
-    SDL_GL_SwapWindow(window);
+    if (gui.imgui_state->renderer->current_backend != renderer::Backend::Null)
+        SDL_GL_SwapWindow(window);
 }
 
 void draw_live_area(GuiState &gui, HostState &host) {
@@ -750,6 +782,8 @@ void draw_ui(GuiState &gui, HostState &host) {
         draw_allocations_dialog(gui, host);
     if (gui.debug_menu.disassembly_dialog)
         draw_disassembly_dialog(gui, host);
+    if (gui.debug_menu.hle_profiler_dialog)
+        draw_hle_profiler_dialog(gui, host);
 
     if (gui.configuration_menu.custom_settings_dialog || gui.configuration_menu.settings_dialog)
         draw_settings_dialog(gui, host);
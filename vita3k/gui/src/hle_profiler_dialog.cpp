@@ -0,0 +1,64 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include "private.h"
+
+#include <kernel/hle_profiler.h>
+#include <nids/functions.h>
+
+#include <spdlog/fmt/fmt.h>
+
+namespace gui {
+
+void draw_hle_profiler_dialog(GuiState &gui, HostState &host) {
+    static int top_count = 25;
+
+    HleProfiler &profiler = host.kernel.hle_profiler;
+
+    ImGui::Begin("HLE Profiler", &gui.debug_menu.hle_profiler_dialog);
+    bool enabled = profiler.enabled;
+    if (ImGui::Checkbox("Enabled", &enabled))
+        profiler.enabled = enabled;
+    ImGui::SameLine();
+    if (ImGui::Button("Reset"))
+        profiler.reset();
+    ImGui::SameLine();
+    if (ImGui::Button("Dump CSV"))
+        profiler.dump_csv(fs::path(host.base_path) / "logs" / fmt::format("hle_profile - {}.csv", host.io.title_id));
+    ImGui::SameLine();
+    ImGui::PushItemWidth(120.f);
+    ImGui::SliderInt("Top", &top_count, 5, 100);
+    ImGui::PopItemWidth();
+    ImGui::Separator();
+
+    const HleProfile profile = profiler.snapshot();
+    const double us_per_tick = profiler.ticks_to_us(1'000'000) / 1'000'000.0;
+
+    ImGui::TextColored(GUI_COLOR_TEXT_TITLE,
+        "%-40s   %-10s   %-10s   %-12s   %-10s   %-10s", "Export", "NID", "Calls", "Total (ms)", "Avg (us)", "Max (us)");
+    const size_t count = std::min(profile.size(), static_cast<size_t>(top_count));
+    for (size_t i = 0; i < count; i++) {
+        const auto &[nid, stats] = profile[i];
+        ImGui::Text("%s", fmt::format("{:<40.40}   {:0>8X}     {:<10}   {:<12.3f}   {:<10.2f}   {:<10.2f}",
+            import_name(nid), nid, stats.count, stats.total_ticks * us_per_tick / 1000.0,
+            stats.total_ticks * us_per_tick / stats.count, stats.max_ticks * us_per_tick)
+                              .c_str());
+    }
+    ImGui::End();
+}
+
+} // namespace gui
@@ -0,0 +1,261 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <gui/state.h>
+
+#include <util/fs.h>
+#include <util/log.h>
+
+#include <stb_image.h>
+#include <xxh3.h>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+
+namespace gui {
+
+// Decoded images kept on disk, the oldest ones are removed once the cache grows past this
+static constexpr uint64_t IMAGE_CACHE_LIMIT = 256ull * 1024 * 1024;
+static constexpr uint32_t IMAGE_CACHE_MAGIC = 0x4B334D49; // 'IM3K'
+static constexpr uint32_t IMAGE_CACHE_VERSION = 1;
+
+struct ImageCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t source_width;
+    int32_t source_height;
+};
+
+static fs::path cache_file(const std::string &cache_path, uint64_t key) {
+    return fs::path(cache_path) / fmt::format("{:016X}.img", key);
+}
+
+// Box filter, each destination pixel averages the source area it covers
+static void downscale(const uint8_t *src, int32_t src_width, int32_t src_height, DecodedImage &image) {
+    image.pixels.resize(size_t(image.width) * image.height * 4);
+    for (int32_t y = 0; y < image.height; y++) {
+        const int32_t y0 = int32_t(int64_t(y) * src_height / image.height);
+        const int32_t y1 = std::max(y0 + 1, int32_t(int64_t(y + 1) * src_height / image.height));
+        for (int32_t x = 0; x < image.width; x++) {
+            const int32_t x0 = int32_t(int64_t(x) * src_width / image.width);
+            const int32_t x1 = std::max(x0 + 1, int32_t(int64_t(x + 1) * src_width / image.width));
+            uint32_t sum[4] = {};
+            for (int32_t sy = y0; sy < y1; sy++) {
+                const uint8_t *row = src + (size_t(sy) * src_width + x0) * 4;
+                for (int32_t sx = x0; sx < x1; sx++, row += 4) {
+                    for (int c = 0; c < 4; c++)
+                        sum[c] += row[c];
+                }
+            }
+            const uint32_t count = uint32_t(y1 - y0) * uint32_t(x1 - x0);
+            uint8_t *dst = &image.pixels[(size_t(y) * image.width + x) * 4];
+            for (int c = 0; c < 4; c++)
+                dst[c] = uint8_t((sum[c] + count / 2) / count);
+        }
+    }
+}
+
+static bool decode(const std::vector<uint8_t> &buffer, int32_t max_size, DecodedImage &image) {
+    int32_t width = 0;
+    int32_t height = 0;
+    stbi_uc *data = stbi_load_from_memory(buffer.data(), static_cast<int>(buffer.size()), &width, &height, nullptr, STBI_rgb_alpha);
+    if (!data)
+        return false;
+
+    image.source_width = width;
+    image.source_height = height;
+
+    const auto longest = std::max(width, height);
+    if ((max_size > 0) && (longest > max_size)) {
+        image.width = std::max(1, int32_t(int64_t(width) * max_size / longest));
+        image.height = std::max(1, int32_t(int64_t(height) * max_size / longest));
+        downscale(data, width, height, image);
+    } else {
+        image.width = width;
+        image.height = height;
+        image.pixels.assign(data, data + size_t(width) * height * 4);
+    }
+
+    stbi_image_free(data);
+    return true;
+}
+
+ImageAsyncLoader::ImageAsyncLoader(ImGui_State *imgui_state, const std::string &base_path)
+    : jobs(std::max(1u, std::thread::hardware_concurrency() / 2))
+    , cache_path((fs::path(base_path) / "cache/images").string()) {
+    const uint8_t gray[4] = { 128, 128, 128, 64 };
+    placeholder_texture.init(imgui_state, const_cast<uint8_t *>(gray), 1, 1);
+}
+
+ImageAsyncLoader::~ImageAsyncLoader() {
+    jobs.stop();
+}
+
+void ImageAsyncLoader::request(const std::string &group, ImageRequest image) {
+    jobs.submit(group, [this, image = std::move(image)](const std::function<bool()> &) -> AsyncJobs::Delivery {
+        DecodedImage decoded;
+        if (!load(image, decoded))
+            return {};
+
+        return [done = image.done, decoded = std::move(decoded)](GuiState &gui) mutable { done(gui, decoded); };
+    });
+}
+
+void ImageAsyncLoader::cancel(const std::string &group) {
+    jobs.cancel(group);
+}
+
+void ImageAsyncLoader::commit(GuiState &gui) {
+    jobs.commit(gui);
+}
+
+ImTextureID ImageAsyncLoader::placeholder() const {
+    return placeholder_texture;
+}
+
+ImTextureID ImageAsyncLoader::or_placeholder(const ImGui_Texture &texture) const {
+    return texture ? static_cast<ImTextureID>(texture) : placeholder();
+}
+
+bool ImageAsyncLoader::load(const ImageRequest &image, DecodedImage &decoded) {
+    const auto buffer = image.read();
+    if (buffer.empty())
+        return false;
+
+    // Same file with a different size limit gives another entry
+    const uint64_t key = image.cache ? XXH_INLINE_XXH3_64bits(buffer.data(), buffer.size()) ^ (uint64_t(image.max_size) * 0x9E3779B97F4A7C15ull) : 0;
+    if (image.cache && read_cache(key, decoded))
+        return true;
+
+    if (!decode(buffer, image.max_size, decoded)) {
+        LOG_ERROR("Invalid image: {}.", image.name);
+        return false;
+    }
+
+    if (image.cache)
+        write_cache(key, decoded);
+
+    return true;
+}
+
+bool ImageAsyncLoader::read_cache(uint64_t key, DecodedImage &decoded) {
+    const auto path = cache_file(cache_path, key);
+    std::ifstream file(path.string(), std::ios::binary);
+    if (!file)
+        return false;
+
+    ImageCacheHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || (header.magic != IMAGE_CACHE_MAGIC) || (header.version != IMAGE_CACHE_VERSION)
+        || (header.width <= 0) || (header.height <= 0))
+        return false;
+
+    decoded.width = header.width;
+    decoded.height = header.height;
+    decoded.source_width = header.source_width;
+    decoded.source_height = header.source_height;
+    decoded.pixels.resize(size_t(header.width) * header.height * 4);
+    if (!file.read(reinterpret_cast<char *>(decoded.pixels.data()), decoded.pixels.size()))
+        return false;
+
+    file.close();
+
+    // Eviction goes by write time, so a hit marks the entry as recently used
+    boost::system::error_code error;
+    fs::last_write_time(path, std::time(nullptr), error);
+
+    return true;
+}
+
+void ImageAsyncLoader::write_cache(uint64_t key, const DecodedImage &decoded) {
+    const auto path = cache_file(cache_path, key);
+    boost::system::error_code error;
+    fs::create_directories(path.parent_path(), error);
+
+    // Written aside then renamed, a reader never sees a partial entry
+    const auto temp_path = fs::path(path).replace_extension(fmt::format("{}.tmp", cache_write_count++));
+    {
+        std::ofstream file(temp_path.string(), std::ios::binary);
+        const ImageCacheHeader header{ IMAGE_CACHE_MAGIC, IMAGE_CACHE_VERSION, decoded.width, decoded.height, decoded.source_width, decoded.source_height };
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(decoded.pixels.data()), decoded.pixels.size());
+        if (!file) {
+            file.close();
+            fs::remove(temp_path, error);
+            return;
+        }
+    }
+
+    fs::rename(temp_path, path, error);
+    if (error) {
+        fs::remove(temp_path, error);
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(cache_mutex);
+
+    struct Entry {
+        std::time_t time;
+        uint64_t size;
+        fs::path path;
+    };
+
+    // The cache directory is only listed on the first write and whenever it has to be trimmed
+    const auto list_entries = [this]() {
+        std::vector<Entry> entries;
+        boost::system::error_code error;
+        for (fs::directory_iterator it(cache_path, error), end; !error && (it != end); it.increment(error)) {
+            if (it->path().extension() == ".img")
+                entries.push_back({ fs::last_write_time(it->path(), error), fs::file_size(it->path(), error), it->path() });
+        }
+        return entries;
+    };
+
+    if (!cache_size) {
+        auto entries = list_entries();
+        cache_size = 0;
+        for (const auto &entry : entries)
+            *cache_size += entry.size;
+    } else
+        *cache_size += sizeof(ImageCacheHeader) + decoded.pixels.size();
+
+    if (*cache_size <= IMAGE_CACHE_LIMIT)
+        return;
+
+    auto entries = list_entries();
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.time < b.time; });
+
+    uint64_t total = 0;
+    for (const auto &entry : entries)
+        total += entry.size;
+
+    // Trimmed below the limit so the next few writes do not list the directory again
+    for (const auto &entry : entries) {
+        if (total <= IMAGE_CACHE_LIMIT / 4 * 3)
+            break;
+        if (fs::remove(entry.path, error))
+            total -= entry.size;
+    }
+
+    LOG_INFO("Image cache trimmed to {} KiB.", total / 1024);
+    cache_size = total;
+}
+
+} // namespace gui
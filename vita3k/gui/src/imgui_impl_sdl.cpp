@@ -33,6 +33,13 @@ IMGUI_API ImGui_State *ImGui_ImplSdl_Init(renderer::State *renderer, SDL_Window
     switch (renderer->current_backend) {
     case renderer::Backend::OpenGL:
         return dynamic_cast<ImGui_State *>(ImGui_ImplSdlGL3_Init(renderer, window, nullptr));
+    case renderer::Backend::Null: {
+        // Nothing is drawn: the frames are still built so the GUI code runs as usual
+        auto *state = new ImGui_State;
+        state->renderer = renderer;
+        state->window = window;
+        return state;
+    }
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         return dynamic_cast<ImGui_State *>(ImGui_ImplSdlVulkan_Init(renderer, window, base_path));
@@ -46,6 +53,8 @@ IMGUI_API void ImGui_ImplSdl_Shutdown(ImGui_State *state) {
     switch (state->renderer->current_backend) {
     case renderer::Backend::OpenGL:
         return ImGui_ImplSdlGL3_Shutdown(dynamic_cast<ImGui_GLState &>(*state));
+    case renderer::Backend::Null:
+        return;
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_Shutdown(dynamic_cast<ImGui_VulkanState &>(*state));
@@ -118,6 +127,8 @@ IMGUI_API void ImGui_ImplSdl_RenderDrawData(ImGui_State *state) {
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_RenderDrawData(dynamic_cast<ImGui_VulkanState &>(*state));
 #endif
+    case renderer::Backend::Null:
+        return;
     }
 }
 
@@ -173,6 +184,9 @@ IMGUI_API void ImGui_ImplSdl_GetDrawableSize(ImGui_State *state, int &width, int
     case renderer::Backend::OpenGL:
         SDL_GL_GetDrawableSize(state->window, &width, &height);
         break;
+    case renderer::Backend::Null:
+        SDL_GetWindowSize(state->window, &width, &height);
+        break;
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         SDL_Vulkan_GetDrawableSize(state->window, &width, &height);
@@ -187,6 +201,8 @@ IMGUI_API ImTextureID ImGui_ImplSdl_CreateTexture(ImGui_State *state, void *data
     switch (state->renderer->current_backend) {
     case renderer::Backend::OpenGL:
         return ImGui_ImplSdlGL3_CreateTexture(data, width, height);
+    case renderer::Backend::Null:
+        return nullptr;
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_CreateTexture(dynamic_cast<ImGui_VulkanState &>(*state), data, width, height);
@@ -201,6 +217,8 @@ IMGUI_API void ImGui_ImplSdl_DeleteTexture(ImGui_State *state, ImTextureID textu
     switch (state->renderer->current_backend) {
     case renderer::Backend::OpenGL:
         return ImGui_ImplSdlGL3_DeleteTexture(texture);
+    case renderer::Backend::Null:
+        return;
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_DeleteTexture(dynamic_cast<ImGui_VulkanState &>(*state), texture);
@@ -215,6 +233,8 @@ IMGUI_API void ImGui_ImplSdl_InvalidateDeviceObjects(ImGui_State *state) {
     switch (state->renderer->current_backend) {
     case renderer::Backend::OpenGL:
         return ImGui_ImplSdlGL3_InvalidateDeviceObjects(dynamic_cast<ImGui_GLState &>(*state));
+    case renderer::Backend::Null:
+        return;
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_InvalidateDeviceObjects(dynamic_cast<ImGui_VulkanState &>(*state));
@@ -227,6 +247,13 @@ IMGUI_API bool ImGui_ImplSdl_CreateDeviceObjects(ImGui_State *state) {
     switch (state->renderer->current_backend) {
     case renderer::Backend::OpenGL:
         return ImGui_ImplSdlGL3_CreateDeviceObjects(dynamic_cast<ImGui_GLState &>(*state));
+    case renderer::Backend::Null: {
+        // ImGui still needs a built font atlas to lay out frames
+        unsigned char *pixels;
+        int width, height;
+        ImGui::GetIO().Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        return true;
+    }
 #ifdef USE_VULKAN
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_CreateDeviceObjects(dynamic_cast<ImGui_VulkanState &>(*state));
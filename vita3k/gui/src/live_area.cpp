@@ -37,28 +37,107 @@ bool get_sys_apps_state(GuiState &gui) {
     return !gui.live_area.content_manager && !gui.live_area.settings && !gui.live_area.trophy_collection && !gui.live_area.manual && !gui.live_area.user_management;
 }
 
+struct STR {
+    std::string color;
+    float size;
+    std::string text;
+};
+
+struct LiveItem {
+    SceInt32 x = 0;
+    SceInt32 y = 0;
+    std::string align;
+    std::string valign;
+    std::string origin;
+
+    // Source size of the picture, known once it is decoded
+    ImVec2 size;
+};
+
+struct LiveItemText {
+    SceInt32 width = 0;
+    SceInt32 height = 0;
+    SceInt32 x = 0;
+    SceInt32 y = 0;
+    SceInt32 margin_top = 0;
+    SceInt32 margin_bottom = 0;
+    SceInt32 margin_left = 0;
+    SceInt32 margin_right = 0;
+    std::string align;
+    std::string valign;
+    std::string origin;
+    std::string line_align;
+    std::string text_align;
+    std::string text_valign;
+    std::string word_wrap;
+    std::string word_scroll;
+    std::string ellipsis;
+};
+
+// Everything the draw needs about a frame, resolved when the live area is loaded
 struct FRAME {
     std::string id;
     std::string multi;
     SceUInt64 autoflip;
+
+    ImVec2 pos;
+    ImVec2 size;
+
+    LiveItem background;
+    LiveItem image;
+    LiveItemText text;
+    std::vector<STR> str;
+    std::string target;
+
+    uint64_t current_item = 0;
+    uint64_t last_time = 0;
 };
 
-struct STR {
-    std::string color;
-    float size;
-    std::string text;
+struct LiveArea {
+    std::string type;
+    ImVec2 gate_pos;
+    std::vector<FRAME> frames;
 };
 
-static std::map<std::string, std::vector<FRAME>> frames;
-static std::map<std::string, std::map<std::string, std::vector<STR>>> str;
-static std::map<std::string, std::map<std::string, std::map<std::string, std::map<std::string, std::pair<SceInt32, std::string>>>>> liveitem;
-static std::map<std::string, std::map<std::string, std::map<std::string, std::map<std::string, ImVec2>>>> items;
 static std::map<std::string, std::map<std::string, std::map<std::string, ImVec2>>> items_pos;
-static std::map<std::string, std::map<std::string, std::string>> target;
-static std::map<std::string, std::map<std::string, uint64_t>> current_item, last_time;
-static std::map<std::string, std::string> type;
+static std::map<std::string, LiveArea> live_areas;
 static std::map<std::string, int32_t> sku_flag;
 
+// Live area pictures never need more than the size of the screen
+static constexpr int32_t LIVE_AREA_IMAGE_MAX_SIZE = 1024;
+
+static void request_contents(GuiState &gui, HostState &host, const std::string &app_path, const VitaIoDevice device, const fs::path &file_path,
+    const std::string &not_found, std::function<void(GuiState &, DecodedImage &)> done) {
+    const auto read = [pref_path = host.pref_path, device, file_path, not_found]() {
+        vfs::FileBuffer buffer;
+        vfs::read_file(device, buffer, pref_path, file_path);
+        if (buffer.empty() && !not_found.empty())
+            LOG_WARN("{}", not_found);
+        return buffer;
+    };
+
+    gui.image_async_loader->request("live_area/" + app_path, { fmt::format("Live Area Contents '{}' for title: {}", file_path.string(), app_path), read, std::move(done), LIVE_AREA_IMAGE_MAX_SIZE });
+}
+
+static void set_layout(LiveArea &live_area, const std::string &app_path) {
+    if (live_area.type.empty())
+        live_area.type = "a1";
+
+    auto &style = items_pos[live_area.type];
+    live_area.gate_pos = style["gate"]["pos"];
+    for (auto &frame : live_area.frames) {
+        const auto frame_pos = style.find(frame.id);
+        if (frame_pos == style.end()) {
+            LOG_WARN_IF(live_area.type == "psmobile", "Info not found for {}, with {}, on title: {}", live_area.type, frame.id, app_path);
+            frame.pos = frame.size = ImVec2(0.f, 0.f);
+            continue;
+        }
+
+        frame.pos = frame_pos->second["pos"];
+        frame.size = frame_pos->second["size"];
+    }
+}
+
 void init_live_area(GuiState &gui, HostState &host, const std::string app_path) {
     // Init type
     if (items_pos.empty()) {
@@ -137,6 +216,7 @@ void init_live_area(GuiState &gui, HostState &host, const std::string app_path)
     const auto is_ps_app = app_path.find("PCS") != std::string::npos;
     const VitaIoDevice app_device = is_sys_app ? VitaIoDevice::vs0 : VitaIoDevice::ux0;
     const auto APP_INDEX = get_app_index(gui, app_path);
+    auto &live_area = live_areas[app_path];
 
     if (is_ps_app && (sku_flag.find(app_path) == sku_flag.end()))
         sku_flag[app_path] = get_license_sku_flag(host, APP_INDEX->content_id);
@@ -159,7 +239,9 @@ void init_live_area(GuiState &gui, HostState &host, const std::string app_path)
                 default_contents = true;
                 LOG_INFO("Using default firmware contents.");
             } else {
-                type[app_path] = "a1";
+                live_area.type = "a1";
+                live_area.frames.clear();
+                set_layout(live_area, app_path);
                 LOG_WARN("Default firmware contents is corrupted or missing, install firmware for fix it.");
                 return;
             }
@@ -168,8 +250,11 @@ void init_live_area(GuiState &gui, HostState &host, const std::string app_path)
         if (doc.load_file(template_xml.c_str())) {
             std::map<std::string, std::string> name;
 
-            type[app_path].clear();
-            type[app_path] = doc.child("livearea").attribute("style").as_string();
+            // Pictures of a previous load of this live area are not wanted anymore
+            gui.image_async_loader->cancel("live_area/" + app_path);
+            gui.live_area_contents[app_path].clear();
+
+            live_area.type = doc.child("livearea").attribute("style").as_string();
 
             if (!doc.child("livearea").child("livearea-background").child("image").child("lang").text().empty()) {
                 for (const auto &livearea_background : doc.child("livearea").child("livearea-background")) {
@@ -222,127 +307,99 @@ void init_live_area(GuiState &gui, HostState &host, const std::string app_path)
                 name["livearea-background"].erase(remove(name["livearea-background"].begin(), name["livearea-background"].end(), '\n'), name["livearea-background"].end());
             name["livearea-background"].erase(remove_if(name["livearea-background"].begin(), name["livearea-background"].end(), isspace), name["livearea-background"].end());
 
-            for (const auto &contents : name) {
-                int32_t width = 0;
-                int32_t height = 0;
-                vfs::FileBuffer buffer;
-
-                if (default_contents)
-                    vfs::read_file(VitaIoDevice::vs0, buffer, host.pref_path, "data/internal/livearea/default/sce_sys/livearea/contents/" + contents.second);
-                else if (app_device == VitaIoDevice::vs0)
-                    vfs::read_file(VitaIoDevice::vs0, buffer, host.pref_path, "app/" + app_path + "/sce_sys/livearea/contents/" + contents.second);
-                else
-                    vfs::read_app_file(buffer, host.pref_path, app_path, live_area_path.string() + "/contents/" + contents.second);
-
-                if (buffer.empty()) {
-                    if (is_ps_app || is_sys_app)
-                        LOG_WARN("Contents {} '{}' Not found for title {} [{}].", contents.first, contents.second, app_path, APP_INDEX->title);
-                    continue;
-                }
-                stbi_uc *data = stbi_load_from_memory(&buffer[0], static_cast<int>(buffer.size()), &width, &height, nullptr, STBI_rgb_alpha);
-                if (!data) {
-                    LOG_ERROR("Invalid Live Area Contents for title {} [{}].", app_path, APP_INDEX->title);
-                    continue;
-                }
+            // Contents of the app, default ones come from the firmware
+            const auto items_path = app_device == VitaIoDevice::vs0 ? fs::path("app") / app_path / "sce_sys/livearea/contents" : fs::path("app") / app_path / live_area_path / "contents";
+            const auto contents_path = default_contents ? fs::path("data/internal/livearea/default/sce_sys/livearea/contents") : items_path;
+            const auto contents_device = default_contents ? VitaIoDevice(VitaIoDevice::vs0) : app_device;
 
-                gui.live_area_contents[app_path][contents.first].init(gui.imgui_state.get(), data, width, height);
-                stbi_image_free(data);
+            for (const auto &contents : name) {
+                const auto not_found = (is_ps_app || is_sys_app) ? fmt::format("Contents {} '{}' Not found for title {} [{}].", contents.first, contents.second, app_path, APP_INDEX->title) : std::string();
+                request_contents(gui, host, app_path, contents_device, contents_path / contents.second, not_found, [app_path, key = contents.first](GuiState &gui, DecodedImage &image) {
+                    const auto app_contents = gui.live_area_contents.find(app_path);
+                    if (app_contents != gui.live_area_contents.end())
+                        app_contents->second[key].init(gui.imgui_state.get(), image.pixels.data(), image.width, image.height);
+                });
             }
 
-            std::map<std::string, std::map<std::string, std::vector<std::string>>> items_name;
+            struct ItemsName {
+                std::vector<std::string> background;
+                std::vector<std::string> image;
+            };
 
-            frames[app_path].clear();
-            liveitem[app_path].clear();
-            str[app_path].clear();
-            target[app_path].clear();
+            std::vector<ItemsName> items_name;
+
+            live_area.frames.clear();
 
             for (const auto &livearea : doc.child("livearea")) {
                 if (!livearea.attribute("id").empty()) {
-                    frames[app_path].push_back({ livearea.attribute("id").as_string(), livearea.attribute("multi").as_string(), livearea.attribute("autoflip").as_uint() });
+                    live_area.frames.push_back({ livearea.attribute("id").as_string(), livearea.attribute("multi").as_string(), livearea.attribute("autoflip").as_uint() });
+                    items_name.push_back({});
 
-                    std::string frame = frames[app_path].back().id;
+                    auto &frame = live_area.frames.back();
+                    auto &frame_items_name = items_name.back();
 
                     // Position background
-                    if (!livearea.child("liveitem").child("background").empty()) {
-                        if (!livearea.child("liveitem").child("background").attribute("x").empty())
-                            liveitem[app_path][frame]["background"]["x"].first = livearea.child("liveitem").child("background").attribute("x").as_int();
-                        if (!livearea.child("liveitem").child("background").attribute("y").empty())
-                            liveitem[app_path][frame]["background"]["y"].first = livearea.child("liveitem").child("background").attribute("y").as_int();
-                        if (!livearea.child("liveitem").child("background").attribute("align").empty())
-                            liveitem[app_path][frame]["background"]["align"].second = livearea.child("liveitem").child("background").attribute("align").as_string();
-                        if (!livearea.child("liveitem").child("background").attribute("valign").empty())
-                            liveitem[app_path][frame]["background"]["valign"].second = livearea.child("liveitem").child("background").attribute("valign").as_string();
+                    const auto background = livearea.child("liveitem").child("background");
+                    if (!background.empty()) {
+                        frame.background.x = background.attribute("x").as_int();
+                        frame.background.y = background.attribute("y").as_int();
+                        frame.background.align = background.attribute("align").as_string();
+                        frame.background.valign = background.attribute("valign").as_string();
                     }
 
                     // Position image
-                    if (!livearea.child("liveitem").child("image").empty()) {
-                        if (!livearea.child("liveitem").child("image").attribute("x").empty())
-                            liveitem[app_path][frame]["image"]["x"].first = livearea.child("liveitem").child("image").attribute("x").as_int();
-                        if (!livearea.child("liveitem").child("image").attribute("y").empty())
-                            liveitem[app_path][frame]["image"]["y"].first = livearea.child("liveitem").child("image").attribute("y").as_int();
-                        if (!livearea.child("liveitem").child("image").attribute("align").empty())
-                            liveitem[app_path][frame]["image"]["align"].second = livearea.child("liveitem").child("image").attribute("align").as_string();
-                        if (!livearea.child("liveitem").child("image").attribute("valign").empty())
-                            liveitem[app_path][frame]["image"]["valign"].second = livearea.child("liveitem").child("image").attribute("valign").as_string();
-                        if (!livearea.child("liveitem").child("image").attribute("origin").empty())
-                            liveitem[app_path][frame]["image"]["origin"].second = livearea.child("liveitem").child("image").attribute("origin").as_string();
+                    const auto image = livearea.child("liveitem").child("image");
+                    if (!image.empty()) {
+                        frame.image.x = image.attribute("x").as_int();
+                        frame.image.y = image.attribute("y").as_int();
+                        frame.image.align = image.attribute("align").as_string();
+                        frame.image.valign = image.attribute("valign").as_string();
+                        frame.image.origin = image.attribute("origin").as_string();
                     }
 
-                    if (!livearea.child("liveitem").child("text").empty()) {
+                    const auto text = livearea.child("liveitem").child("text");
+                    if (!text.empty()) {
                         // SceInt32
-                        if (!livearea.child("liveitem").child("text").attribute("width").empty())
-                            liveitem[app_path][frame]["text"]["width"].first = livearea.child("liveitem").child("text").attribute("width").as_int();
-                        if (!livearea.child("liveitem").child("text").attribute("height").empty())
-                            liveitem[app_path][frame]["text"]["height"].first = livearea.child("liveitem").child("text").attribute("height").as_int();
-                        if (!livearea.child("liveitem").child("text").attribute("x").empty())
-                            liveitem[app_path][frame]["text"]["x"].first = livearea.child("liveitem").child("text").attribute("x").as_int();
-                        if (!livearea.child("liveitem").child("text").attribute("y").empty())
-                            liveitem[app_path][frame]["text"]["y"].first = livearea.child("liveitem").child("text").attribute("y").as_int();
-                        if (!livearea.child("liveitem").child("text").attribute("margin-top").empty())
-                            liveitem[app_path][frame]["text"]["margin-top"].first = livearea.child("liveitem").child("text").attribute("margin-top").as_int();
-                        if (!livearea.child("liveitem").child("text").attribute("margin-buttom").empty())
-                            liveitem[app_path][frame]["text"]["margin-buttom"].first = livearea.child("liveitem").child("text").attribute("margin-buttom").as_int();
-                        if (!livearea.child("liveitem").child("text").attribute("margin-left").empty())
-                            liveitem[app_path][frame]["text"]["margin-left"].first = livearea.child("liveitem").child("text").attribute("margin-left").as_int();
-                        if (!livearea.child("liveitem").child("text").attribute("margin-right").empty())
-                            liveitem[app_path][frame]["text"]["margin-right"].first = livearea.child("liveitem").child("text").attribute("margin-right").as_int();
+                        frame.text.width = text.attribute("width").as_int();
+                        frame.text.height = text.attribute("height").as_int();
+                        frame.text.x = text.attribute("x").as_int();
+                        frame.text.y = text.attribute("y").as_int();
+                        frame.text.margin_top = text.attribute("margin-top").as_int();
+                        frame.text.margin_bottom = text.attribute("margin-buttom").as_int();
+                        frame.text.margin_left = text.attribute("margin-left").as_int();
+                        frame.text.margin_right = text.attribute("margin-right").as_int();
 
                         // String
-                        if (!livearea.child("liveitem").child("text").attribute("align").empty())
-                            liveitem[app_path][frame]["text"]["align"].second = livearea.child("liveitem").child("text").attribute("align").as_string();
-                        if (!livearea.child("liveitem").child("text").attribute("valign").empty())
-                            liveitem[app_path][frame]["text"]["valign"].second = livearea.child("liveitem").child("text").attribute("valign").as_string();
-                        if (!livearea.child("liveitem").child("text").attribute("origin").empty())
-                            liveitem[app_path][frame]["text"]["origin"].second = livearea.child("liveitem").child("text").attribute("origin").as_string();
-                        if (!livearea.child("liveitem").child("text").attribute("line-align").empty())
-                            liveitem[app_path][frame]["text"]["line-align"].second = livearea.child("liveitem").child("text").attribute("line-align").as_string();
-                        if (!livearea.child("liveitem").child("text").attribute("text-align").empty())
-                            liveitem[app_path][frame]["text"]["text-align"].second = livearea.child("liveitem").child("text").attribute("text-align").as_string();
-                        if (!livearea.child("liveitem").child("text").attribute("text-valign").empty())
-                            liveitem[app_path][frame]["text"]["text-valign"].second = livearea.child("liveitem").child("text").attribute("text-valign").as_string();
-                        if (!livearea.child("liveitem").child("text").attribute("word-wrap").empty())
-                            liveitem[app_path][frame]["text"]["word-wrap"].second = livearea.child("liveitem").child("text").attribute("word-wrap").as_string();
-                        if (!livearea.child("liveitem").child("text").attribute("word-scroll").empty())
-                            liveitem[app_path][frame]["text"]["word-scroll"].second = livearea.child("liveitem").child("text").attribute("word-scroll").as_string();
-                        if (!livearea.child("liveitem").child("text").attribute("ellipsis").empty())
-                            liveitem[app_path][frame]["text"]["ellipsis"].second = livearea.child("liveitem").child("text").attribute("ellipsis").as_string();
+                        frame.text.align = text.attribute("align").as_string();
+                        frame.text.valign = text.attribute("valign").as_string();
+                        frame.text.origin = text.attribute("origin").as_string();
+                        frame.text.line_align = text.attribute("line-align").as_string();
+                        frame.text.text_align = text.attribute("text-align").as_string();
+                        frame.text.text_valign = text.attribute("text-valign").as_string();
+                        frame.text.word_wrap = text.attribute("word-wrap").as_string();
+                        frame.text.word_scroll = text.attribute("word-scroll").as_string();
+                        frame.text.ellipsis = text.attribute("ellipsis").as_string();
                     }
 
+                    const auto add_liveitem = [&](const pugi::xml_node &item) {
+                        if (!item.child("background").text().empty())
+                            frame_items_name.background.push_back(item.child("background").text().as_string());
+                        if (!item.child("image").text().empty())
+                            frame_items_name.image.push_back(item.child("image").text().as_string());
+                        if (!item.child("target").text().empty())
+                            frame.target = item.child("target").text().as_string();
+                        if (!item.child("text").child("str").text().empty()) {
+                            for (const auto &str_child : item.child("text"))
+                                frame.str.push_back({ str_child.attribute("color").as_string(), str_child.attribute("size").as_float(), str_child.text().as_string() });
+                        }
+                    };
+
                     for (const auto &frame_id : livearea) {
                         if (frame_id.name() == std::string("liveitem")) {
                             if (!frame_id.child("cntry").empty()) {
                                 for (const auto &cntry : frame_id) {
                                     if ((cntry.name() == std::string("cntry")) && (cntry.attribute("lang").as_string() == live_area_lang)) {
-                                        if (!frame_id.child("background").text().empty())
-                                            items_name[frame]["background"].push_back({ frame_id.child("background").text().as_string() });
-                                        if (!frame_id.child("image").text().empty())
-                                            items_name[frame]["image"].push_back({ frame_id.child("image").text().as_string() });
-                                        if (!frame_id.child("target").text().empty())
-                                            target[app_path][frame] = frame_id.child("target").text().as_string();
-                                        if (!frame_id.child("text").child("str").text().empty()) {
-                                            for (const auto &str_child : frame_id.child("text"))
-                                                str[app_path][frame].push_back({ str_child.attribute("color").as_string(), str_child.attribute("size").as_float(), str_child.text().as_string() });
-                                        }
+                                        add_liveitem(frame_id);
                                         break;
                                     }
                                 }
@@ -354,29 +411,11 @@ void init_live_area(GuiState &gui, HostState &host, const std::string app_path)
                                         break;
                                     }
                                 if (!exclude_lang) {
-                                    if (!frame_id.child("background").text().empty())
-                                        items_name[frame]["background"].push_back({ frame_id.child("background").text().as_string() });
-                                    if (!frame_id.child("image").text().empty())
-                                        items_name[frame]["image"].push_back({ frame_id.child("image").text().as_string() });
-                                    if (!frame_id.child("target").text().empty())
-                                        target[app_path][frame] = frame_id.child("target").text().as_string();
-                                    if (!frame_id.child("text").child("str").text().empty()) {
-                                        for (const auto &str_child : frame_id.child("text"))
-                                            str[app_path][frame].push_back({ str_child.attribute("color").as_string(), str_child.attribute("size").as_float(), str_child.text().as_string() });
-                                    }
+                                    add_liveitem(frame_id);
                                     break;
                                 }
                             } else if (frame_id.child("lang").text().as_string() == live_area_lang) {
-                                if (!frame_id.child("background").text().empty())
-                                    items_name[frame]["background"].push_back({ frame_id.child("background").text().as_string() });
-                                if (!frame_id.child("image").text().empty())
-                                    items_name[frame]["image"].push_back({ frame_id.child("image").text().as_string() });
-                                if (!frame_id.child("target").text().empty())
-                                    target[app_path][frame] = frame_id.child("target").text().as_string();
-                                if (!frame_id.child("text").child("str").text().empty()) {
-                                    for (const auto &str_child : frame_id.child("text"))
-                                        str[app_path][frame].push_back({ str_child.attribute("color").as_string(), str_child.attribute("size").as_float(), str_child.text().as_string() });
-                                }
+                                add_liveitem(frame_id);
                                 break;
                             }
                         }
@@ -384,123 +423,77 @@ void init_live_area(GuiState &gui, HostState &host, const std::string app_path)
 
                     // if empty
                     const auto liveitem = livearea.child("liveitem");
-                    if (items_name[frame]["background"].empty() && !liveitem.child("background").text().empty())
-                        items_name[frame]["background"].push_back({ liveitem.child("background").text().as_string() });
-                    if (items_name[frame]["image"].empty() && !liveitem.child("image").text().empty())
-                        items_name[frame]["image"].push_back({ liveitem.child("image").text().as_string() });
-                    if (target[app_path][frame].empty() && !liveitem.child("target").text().empty())
-                        target[app_path][frame] = liveitem.child("target").text().as_string();
-                    if (str[app_path][frame].empty() && !liveitem.child("text").child("str").text().empty()) {
+                    if (frame_items_name.background.empty() && !liveitem.child("background").text().empty())
+                        frame_items_name.background.push_back(liveitem.child("background").text().as_string());
+                    if (frame_items_name.image.empty() && !liveitem.child("image").text().empty())
+                        frame_items_name.image.push_back(liveitem.child("image").text().as_string());
+                    if (frame.target.empty() && !liveitem.child("target").text().empty())
+                        frame.target = liveitem.child("target").text().as_string();
+                    if (frame.str.empty() && !liveitem.child("text").child("str").text().empty()) {
                         for (const auto &str_child : liveitem.child("text"))
-                            str[app_path][frame].push_back({ str_child.attribute("color").as_string(), str_child.attribute("size").as_float(), str_child.text().as_string() });
+                            frame.str.push_back({ str_child.attribute("color").as_string(), str_child.attribute("size").as_float(), str_child.text().as_string() });
                     }
 
                     // Remove space or return line if exist on target
-                    if (!target[app_path][frame].empty()) {
-                        if (target[app_path][frame].find('\n') != std::string::npos)
-                            target[app_path][frame].erase(remove(target[app_path][frame].begin(), target[app_path][frame].end(), '\n'), target[app_path][frame].end());
-                        target[app_path][frame].erase(remove_if(target[app_path][frame].begin(), target[app_path][frame].end(), isspace), target[app_path][frame].end());
+                    if (!frame.target.empty()) {
+                        if (frame.target.find('\n') != std::string::npos)
+                            frame.target.erase(remove(frame.target.begin(), frame.target.end(), '\n'), frame.target.end());
+                        frame.target.erase(remove_if(frame.target.begin(), frame.target.end(), isspace), frame.target.end());
                     }
                 }
             }
 
-            for (auto &item : items_name) {
-                current_item[app_path][item.first] = 0;
-                if (!item.second["background"].empty()) {
-                    for (auto &bg_name : item.second["background"])
-                        gui.live_items[app_path][item.first]["background"].push_back({});
-                }
-                if (!item.second["image"].empty()) {
-                    for (auto &img_name : item.second["image"])
-                        gui.live_items[app_path][item.first]["image"].push_back({});
+            auto &live_items = gui.live_items[app_path];
+            live_items.clear();
+            live_items.resize(live_area.frames.size());
+
+            for (size_t index = 0; index < items_name.size(); index++) {
+                const auto &frame_id = live_area.frames[index].id;
+                live_items[index].backgrounds.resize(items_name[index].background.size());
+                live_items[index].images.resize(items_name[index].image.size());
+
+                for (size_t pos = 0; pos < items_name[index].background.size(); pos++) {
+                    auto &bg_name = items_name[index].background[pos];
+                    if (bg_name.find('\n') != std::string::npos)
+                        bg_name.erase(remove(bg_name.begin(), bg_name.end(), '\n'), bg_name.end());
+                    bg_name.erase(remove_if(bg_name.begin(), bg_name.end(), isspace), bg_name.end());
+                    if (bg_name.empty())
+                        continue;
+
+                    const auto not_found = (is_ps_app || is_sys_app) ? fmt::format("background, Id: {}, Name: '{}', Not found for title: {} [{}].", frame_id, bg_name, app_path, APP_INDEX->title) : std::string();
+                    request_contents(gui, host, app_path, app_device, items_path / bg_name, not_found, [app_path, index, pos](GuiState &gui, DecodedImage &image) {
+                        const auto app_items = gui.live_items.find(app_path);
+                        if ((app_items == gui.live_items.end()) || (index >= app_items->second.size()) || (pos >= app_items->second[index].backgrounds.size()))
+                            return;
+
+                        app_items->second[index].backgrounds[pos].init(gui.imgui_state.get(), image.pixels.data(), image.width, image.height);
+                        live_areas[app_path].frames[index].background.size = ImVec2(float(image.source_width), float(image.source_height));
+                    });
                 }
-            }
-
-            auto pos = 0;
-            std::map<std::string, std::string> current_frame;
-            for (auto &item : items_name) {
-                if (!item.second.empty()) {
-                    for (auto &bg_name : item.second["background"]) {
-                        if (!bg_name.empty()) {
-                            if (current_frame["background"] != item.first) {
-                                current_frame["background"] = item.first;
-                                pos = 0;
-                            } else
-                                ++pos;
-
-                            if (bg_name.find('\n') != std::string::npos)
-                                bg_name.erase(remove(bg_name.begin(), bg_name.end(), '\n'), bg_name.end());
-                            bg_name.erase(remove_if(bg_name.begin(), bg_name.end(), isspace), bg_name.end());
-
-                            int32_t width = 0;
-                            int32_t height = 0;
-                            vfs::FileBuffer buffer;
-
-                            if (app_device == VitaIoDevice::vs0)
-                                vfs::read_file(VitaIoDevice::vs0, buffer, host.pref_path, "app/" + app_path + "/sce_sys/livearea/contents/" + bg_name);
-                            else
-                                vfs::read_app_file(buffer, host.pref_path, app_path, live_area_path.string() + "/contents/" + bg_name);
-
-                            if (buffer.empty()) {
-                                if (is_ps_app || is_sys_app)
-                                    LOG_WARN("background, Id: {}, Name: '{}', Not found for title: {} [{}].", item.first, bg_name, app_path, APP_INDEX->title);
-                                continue;
-                            }
-                            stbi_uc *data = stbi_load_from_memory(&buffer[0], static_cast<int>(buffer.size()), &width, &height, nullptr, STBI_rgb_alpha);
-                            if (!data) {
-                                LOG_ERROR("Frame: {}, Invalid Live Area Contents for title: {} [{}].", item.first, app_path, APP_INDEX->title);
-                                continue;
-                            }
-
-                            items[app_path][item.first]["background"]["size"] = ImVec2(float(width), float(height));
-                            gui.live_items[app_path][item.first]["background"][pos].init(gui.imgui_state.get(), data, width, height);
-                            stbi_image_free(data);
-                        }
-                    }
-
-                    for (auto &img_name : item.second["image"]) {
-                        if (!img_name.empty()) {
-                            if (current_frame["image"] != item.first) {
-                                current_frame["image"] = item.first;
-                                pos = 0;
-                            } else
-                                ++pos;
-
-                            if (img_name.find('\n') != std::string::npos)
-                                img_name.erase(remove(img_name.begin(), img_name.end(), '\n'), img_name.end());
-                            img_name.erase(remove_if(img_name.begin(), img_name.end(), isspace), img_name.end());
-
-                            int32_t width = 0;
-                            int32_t height = 0;
-                            vfs::FileBuffer buffer;
-
-                            if (app_device == VitaIoDevice::vs0)
-                                vfs::read_file(VitaIoDevice::vs0, buffer, host.pref_path, "app/" + app_path + "/sce_sys/livearea/contents/" + img_name);
-                            else
-                                vfs::read_app_file(buffer, host.pref_path, app_path, live_area_path.string() + "/contents/" + img_name);
-
-                            if (buffer.empty()) {
-                                if (is_ps_app || is_sys_app)
-                                    LOG_WARN("Image, Id: {} Name: '{}', Not found for title {} [{}].", item.first, img_name, app_path, APP_INDEX->title);
-                                continue;
-                            }
-                            stbi_uc *data = stbi_load_from_memory(&buffer[0], static_cast<int>(buffer.size()), &width, &height, nullptr, STBI_rgb_alpha);
-                            if (!data) {
-                                LOG_ERROR("Frame: {}, Invalid Live Area Contents for title: {} [{}].", item.first, app_path, APP_INDEX->title);
-                                continue;
-                            }
 
-                            items[app_path][item.first]["image"]["size"] = ImVec2(float(width), float(height));
-                            gui.live_items[app_path][item.first]["image"][pos].init(gui.imgui_state.get(), data, width, height);
-                            stbi_image_free(data);
-                        }
-                    }
+                for (size_t pos = 0; pos < items_name[index].image.size(); pos++) {
+                    auto &img_name = items_name[index].image[pos];
+                    if (img_name.find('\n') != std::string::npos)
+                        img_name.erase(remove(img_name.begin(), img_name.end(), '\n'), img_name.end());
+                    img_name.erase(remove_if(img_name.begin(), img_name.end(), isspace), img_name.end());
+                    if (img_name.empty())
+                        continue;
+
+                    const auto not_found = (is_ps_app || is_sys_app) ? fmt::format("Image, Id: {} Name: '{}', Not found for title {} [{}].", frame_id, img_name, app_path, APP_INDEX->title) : std::string();
+                    request_contents(gui, host, app_path, app_device, items_path / img_name, not_found, [app_path, index, pos](GuiState &gui, DecodedImage &image) {
+                        const auto app_items = gui.live_items.find(app_path);
+                        if ((app_items == gui.live_items.end()) || (index >= app_items->second.size()) || (pos >= app_items->second[index].images.size()))
+                            return;
+
+                        app_items->second[index].images[pos].init(gui.imgui_state.get(), image.pixels.data(), image.width, image.height);
+                        live_areas[app_path].frames[index].image.size = ImVec2(float(image.source_width), float(image.source_height));
+                    });
                 }
             }
         }
     }
-    if (type[app_path].empty())
-        type[app_path] = "a1";
+
+    set_layout(live_area, app_path);
 }
 
 inline uint64_t current_time() {
@@ -522,7 +515,7 @@ void update_app(GuiState &gui, HostState &host, const std::string app_path) {
         gui.live_items.erase(app_path);
 
     init_user_app(gui, host, app_path);
-    save_apps_cache(gui, host);
+    update_apps_cache(gui, host, app_path);
 
     if (get_app_open_list_index(gui, app_path) != gui.apps_list_opened.end())
         init_live_area(gui, host, app_path);
@@ -561,39 +554,40 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
     else
         ImGui::GetWindowDrawList()->AddRectFilled(pos_bg, ImVec2(pos_bg.x + background_size.x, pos_bg.y + background_size.y), IM_COL32(148.f, 164.f, 173.f, 255.f), 0.f, ImDrawFlags_RoundCornersAll);
 
-    for (const auto &frame : frames[app_path]) {
+    auto &live_area = live_areas[app_path];
+    const auto app_items = gui.live_items.find(app_path);
+    for (size_t index = 0; index < live_area.frames.size(); index++) {
+        auto &frame = live_area.frames[index];
+        const auto textures = ((app_items != gui.live_items.end()) && (index < app_items->second.size())) ? &app_items->second[index] : nullptr;
+        const auto has_background = textures && !textures->backgrounds.empty();
+        const auto has_image = textures && !textures->images.empty();
+
         if (frame.autoflip != 0) {
-            if (last_time[app_path][frame.id] == 0)
-                last_time[app_path][frame.id] = current_time();
+            if (frame.last_time == 0)
+                frame.last_time = current_time();
 
-            while (last_time[app_path][frame.id] + frame.autoflip < current_time()) {
-                last_time[app_path][frame.id] += frame.autoflip;
+            while (frame.last_time + frame.autoflip < current_time()) {
+                frame.last_time += frame.autoflip;
 
-                if (gui.live_items[app_path][frame.id].find("background") != gui.live_items[app_path][frame.id].end()) {
-                    if (current_item[app_path][frame.id] != int(gui.live_items[app_path][frame.id]["background"].size()) - 1)
-                        ++current_item[app_path][frame.id];
+                if (has_background) {
+                    if (frame.current_item != textures->backgrounds.size() - 1)
+                        ++frame.current_item;
                     else
-                        current_item[app_path][frame.id] = 0;
-                } else if (gui.live_items[app_path][frame.id].find("image") != gui.live_items[app_path][frame.id].end()) {
-                    if (current_item[app_path][frame.id] != int(gui.live_items[app_path][frame.id]["image"].size()) - 1)
-                        ++current_item[app_path][frame.id];
+                        frame.current_item = 0;
+                } else if (has_image) {
+                    if (frame.current_item != textures->images.size() - 1)
+                        ++frame.current_item;
                     else
-                        current_item[app_path][frame.id] = 0;
+                        frame.current_item = 0;
                 }
             }
         }
 
-        if (type[app_path] == "psmobile") {
-            LOG_WARN_IF(items_pos[type[app_path]][frame.id].empty(), "Info not found for {}, with {}, on title: {}",
-                type[app_path], frame.id, app_path);
-        }
-
-        const auto FRAME_SIZE = items_pos[type[app_path]][frame.id]["size"];
+        const auto FRAME_SIZE = frame.size;
 
-        auto FRAME_POS = ImVec2(items_pos[type[app_path]][frame.id]["pos"].x * SCALE.x,
-            items_pos[type[app_path]][frame.id]["pos"].y * SCALE.y);
+        auto FRAME_POS = ImVec2(frame.pos.x * SCALE.x, frame.pos.y * SCALE.y);
 
-        auto bg_size = items[app_path][frame.id]["background"]["size"];
+        auto bg_size = frame.background.size;
 
         // Resize items
         const auto bg_resize = ImVec2(bg_size.x / FRAME_SIZE.x, bg_size.y / FRAME_SIZE.y);
@@ -602,7 +596,7 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
         if (bg_size.y > FRAME_SIZE.y)
             bg_size.y /= bg_resize.y;
 
-        auto img_size = items[app_path][frame.id]["image"]["size"];
+        auto img_size = frame.image.size;
         const auto img_resize = ImVec2(img_size.x / FRAME_SIZE.x, img_size.y / FRAME_SIZE.y);
         if (img_size.x > FRAME_SIZE.x)
             img_size.x /= img_resize.x;
@@ -614,34 +608,34 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
         auto img_pos_init = ImVec2((FRAME_SIZE.x - img_size.x) / 2.f, (FRAME_SIZE.y - img_size.y) / 2.f);
 
         // Allign items
-        if ((liveitem[app_path][frame.id]["background"]["align"].second == "left") && (liveitem[app_path][frame.id]["background"]["x"].first >= 0))
+        if ((frame.background.align == "left") && (frame.background.x >= 0))
             bg_pos_init.x = 0.0f;
-        else if ((liveitem[app_path][frame.id]["background"]["align"].second == "right") && (liveitem[app_path][frame.id]["background"]["x"].first <= 0))
+        else if ((frame.background.align == "right") && (frame.background.x <= 0))
             bg_pos_init.x = FRAME_SIZE.x - bg_size.x;
         else
-            bg_pos_init.x += liveitem[app_path][frame.id]["background"]["x"].first;
+            bg_pos_init.x += frame.background.x;
 
-        if ((liveitem[app_path][frame.id]["image"]["align"].second == "left") && (liveitem[app_path][frame.id]["image"]["x"].first >= 0))
+        if ((frame.image.align == "left") && (frame.image.x >= 0))
             img_pos_init.x = 0.0f;
-        else if ((liveitem[app_path][frame.id]["image"]["align"].second == "right") && (liveitem[app_path][frame.id]["image"]["x"].first <= 0))
+        else if ((frame.image.align == "right") && (frame.image.x <= 0))
             img_pos_init.x = FRAME_SIZE.x - img_size.x;
         else
-            img_pos_init.x += liveitem[app_path][frame.id]["image"]["x"].first;
+            img_pos_init.x += frame.image.x;
 
         // Valign items
-        if ((liveitem[app_path][frame.id]["background"]["valign"].second == "top") && (liveitem[app_path][frame.id]["background"]["y"].first <= 0))
+        if ((frame.background.valign == "top") && (frame.background.y <= 0))
             bg_pos_init.y = 0.0f;
-        else if ((liveitem[app_path][frame.id]["background"]["valign"].second == "bottom") && (liveitem[app_path][frame.id]["background"]["y"].first >= 0))
+        else if ((frame.background.valign == "bottom") && (frame.background.y >= 0))
             bg_pos_init.y = FRAME_SIZE.y - bg_size.y;
         else
-            bg_pos_init.y -= liveitem[app_path][frame.id]["background"]["y"].first;
+            bg_pos_init.y -= frame.background.y;
 
-        if ((liveitem[app_path][frame.id]["image"]["valign"].second == "top") && (liveitem[app_path][frame.id]["image"]["y"].first <= 0))
+        if ((frame.image.valign == "top") && (frame.image.y <= 0))
             img_pos_init.y = 0.0f;
-        else if ((liveitem[app_path][frame.id]["image"]["valign"].second == "bottom") && (liveitem[app_path][frame.id]["image"]["y"].first >= 0))
+        else if ((frame.image.valign == "bottom") && (frame.image.y >= 0))
             img_pos_init.y = FRAME_SIZE.y - img_size.y;
         else
-            img_pos_init.y -= liveitem[app_path][frame.id]["image"]["y"].first;
+            img_pos_init.y -= frame.image.y;
 
         // Set items pos
         auto bg_pos = ImVec2((display_size.x - FRAME_POS.x) + (bg_pos_init.x * SCALE.x), (display_size.y - FRAME_POS.y) + (bg_pos_init.y * SCALE.y));
@@ -689,26 +683,26 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
             img_pos.y += pos_frame.y - img_pos.y;
 
         // Display items
-        if (gui.live_items[app_path][frame.id].find("background") != gui.live_items[app_path][frame.id].end()) {
+        if (has_background) {
             ImGui::SetCursorPos(bg_pos);
-            ImGui::Image(gui.live_items[app_path][frame.id]["background"][current_item[app_path][frame.id]], bg_scal_size);
+            ImGui::Image(gui.image_async_loader->or_placeholder(textures->backgrounds[std::min<size_t>(frame.current_item, textures->backgrounds.size() - 1)]), bg_scal_size);
         }
-        if (gui.live_items[app_path][frame.id].find("image") != gui.live_items[app_path][frame.id].end()) {
+        if (has_image) {
             ImGui::SetCursorPos(img_pos);
-            ImGui::Image(gui.live_items[app_path][frame.id]["image"][current_item[app_path][frame.id]], img_scal_size);
+            ImGui::Image(gui.image_async_loader->or_placeholder(textures->images[std::min<size_t>(frame.current_item, textures->images.size() - 1)]), img_scal_size);
         }
 
         // Target link
-        if (!target[app_path][frame.id].empty() && (target[app_path][frame.id].find("psts:") == std::string::npos)) {
+        if (!frame.target.empty() && (frame.target.find("psts:") == std::string::npos)) {
             ImGui::SetCursorPos(pos_frame);
             ImGui::PushID(frame.id.c_str());
             if (ImGui::Selectable("##target_link", false, ImGuiSelectableFlags_None, scal_size_frame))
-                open_path(target[app_path][frame.id]);
+                open_path(frame.target);
             ImGui::PopID();
         }
 
         // Text
-        for (const auto &str_tag : str[app_path][frame.id]) {
+        for (const auto &str_tag : frame.str) {
             if (!str_tag.text.empty()) {
                 std::vector<ImVec4> str_color;
 
@@ -716,7 +710,7 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
                     int color;
 
                     if (frame.autoflip)
-                        sscanf(str[app_path][frame.id][current_item[app_path][frame.id]].color.c_str(), "#%x", &color);
+                        sscanf(frame.str[frame.current_item].color.c_str(), "#%x", &color);
                     else
                         sscanf(str_tag.color.c_str(), "#%x", &color);
 
@@ -727,33 +721,31 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
                 auto str_size = scal_size_frame, text_pos = pos_frame;
 
                 // Origin
-                if (liveitem[app_path][frame.id]["text"]["origin"].second.empty() || (liveitem[app_path][frame.id]["text"]["origin"].second == "background")) {
-                    if (gui.live_items[app_path][frame.id].find("background") != gui.live_items[app_path][frame.id].end())
+                if (frame.text.origin.empty() || (frame.text.origin == "background")) {
+                    if (has_background)
                         str_size = bg_scal_size, text_pos = bg_pos;
-                    else if (!liveitem[app_path][frame.id]["text"]["origin"].second.empty() && (gui.live_items[app_path][frame.id].find("image") != gui.live_items[app_path][frame.id].end()))
+                    else if (!frame.text.origin.empty() && (has_image))
                         str_size = img_scal_size, text_pos = img_pos;
-                } else if (liveitem[app_path][frame.id]["text"]["origin"].second == "image") {
-                    if (gui.live_items[app_path][frame.id].find("image") != gui.live_items[app_path][frame.id].end())
+                } else if (frame.text.origin == "image") {
+                    if (has_image)
                         str_size = img_scal_size, text_pos = img_pos;
-                    else if (gui.live_items[app_path][frame.id].find("background") != gui.live_items[app_path][frame.id].end())
+                    else if (has_background)
                         str_size = bg_scal_size, text_pos = bg_pos;
                 }
 
                 auto str_wrap = scal_size_frame.x;
-                if (liveitem[app_path][frame.id]["text"]["allign"].second == "outside-right")
-                    str_wrap = str_size.x;
-
-                if (liveitem[app_path][frame.id]["text"]["width"].first > 0) {
-                    if (liveitem[app_path][frame.id]["text"]["word-wrap"].second != "off")
-                        str_wrap = float(liveitem[app_path][frame.id]["text"]["width"].first) * SCALE.x;
-                    text_pos.x += (str_size.x - (float(liveitem[app_path][frame.id]["text"]["width"].first) * SCALE.x)) / 2.f;
-                    str_size.x = float(liveitem[app_path][frame.id]["text"]["width"].first) * SCALE.x;
+
+                if (frame.text.width > 0) {
+                    if (frame.text.word_wrap != "off")
+                        str_wrap = float(frame.text.width) * SCALE.x;
+                    text_pos.x += (str_size.x - (float(frame.text.width) * SCALE.x)) / 2.f;
+                    str_size.x = float(frame.text.width) * SCALE.x;
                 }
 
-                if ((liveitem[app_path][frame.id]["text"]["height"].first > 0)
-                    && ((liveitem[app_path][frame.id]["text"]["word-scroll"].second == "on" || liveitem[app_path][frame.id]["text"]["height"].first <= FRAME_SIZE.y))) {
-                    text_pos.y += (str_size.y - (float(liveitem[app_path][frame.id]["text"]["height"].first) * SCALE.y)) / 2.f;
-                    str_size.y = float(liveitem[app_path][frame.id]["text"]["height"].first) * SCALE.y;
+                if ((frame.text.height > 0)
+                    && ((frame.text.word_scroll == "on" || frame.text.height <= FRAME_SIZE.y))) {
+                    text_pos.y += (str_size.y - (float(frame.text.height) * SCALE.y)) / 2.f;
+                    str_size.y = float(frame.text.height) * SCALE.y;
                 }
 
                 const auto size_text_scale = str_tag.size != 0 ? str_tag.size / 19.2f : 1.f;
@@ -762,34 +754,34 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
                 // Calcule text pixel size
                 ImVec2 calc_text_size;
                 if (frame.autoflip > 0) {
-                    if (liveitem[app_path][frame.id]["text"]["word-wrap"].second != "off")
-                        calc_text_size = ImGui::CalcTextSize(str[app_path][frame.id][current_item[app_path][frame.id]].text.c_str(), 0, false, str_wrap);
+                    if (frame.text.word_wrap != "off")
+                        calc_text_size = ImGui::CalcTextSize(frame.str[frame.current_item].text.c_str(), 0, false, str_wrap);
                     else
-                        calc_text_size = ImGui::CalcTextSize(str[app_path][frame.id][current_item[app_path][frame.id]].text.c_str());
+                        calc_text_size = ImGui::CalcTextSize(frame.str[frame.current_item].text.c_str());
                 } else {
-                    if (liveitem[app_path][frame.id]["text"]["word-wrap"].second != "off")
+                    if (frame.text.word_wrap != "off")
                         calc_text_size = ImGui::CalcTextSize(str_tag.text.c_str(), 0, false, str_wrap);
                     else
                         calc_text_size = ImGui::CalcTextSize(str_tag.text.c_str());
                 }
 
-                /*if (liveitem[app_path][frame.id]["text"]["ellipsis"].second == "on") {
+                /*if (frame.text.ellipsis == "on") {
                     // TODO ellipsis
                 }*/
 
                 ImVec2 str_pos_init;
 
                 // Allign
-                if (liveitem[app_path][frame.id]["text"]["align"].second.empty()) {
-                    if (liveitem[app_path][frame.id]["text"]["text-align"].second.empty()) {
-                        if (liveitem[app_path][frame.id]["text"]["line-align"].second == "left")
+                if (frame.text.align.empty()) {
+                    if (frame.text.text_align.empty()) {
+                        if (frame.text.line_align == "left")
                             str_pos_init.x = 0.f;
-                        else if (liveitem[app_path][frame.id]["text"]["line-align"].second == "right")
+                        else if (frame.text.line_align == "right")
                             str_pos_init.x = str_size.x - calc_text_size.x;
-                        else if (liveitem[app_path][frame.id]["text"]["line-align"].second == "outside-right") {
+                        else if (frame.text.line_align == "outside-right") {
                             text_pos.x += str_size.x;
-                            if (liveitem[app_path][frame.id]["text"]["origin"].second == "image") {
-                                if (gui.live_items[app_path][frame.id].find("background") != gui.live_items[app_path][frame.id].end())
+                            if (frame.text.origin == "image") {
+                                if (has_background)
                                     str_size.x = bg_scal_size.x - img_scal_size.x - (img_pos.x - bg_pos.x);
                                 else
                                     str_size = scal_size_frame, text_pos = pos_frame;
@@ -797,17 +789,17 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
                         } else
                             str_pos_init.x = (str_size.x - calc_text_size.x) / 2.0f;
                     } else {
-                        if ((liveitem[app_path][frame.id]["text"]["text-align"].second == "center")
-                            || ((liveitem[app_path][frame.id]["text"]["text-align"].second == "left") && (liveitem[app_path][frame.id]["text"]["x"].first < 0)))
+                        if ((frame.text.text_align == "center")
+                            || ((frame.text.text_align == "left") && (frame.text.x < 0)))
                             str_pos_init.x = (str_size.x - calc_text_size.x) / 2.0f;
-                        else if (liveitem[app_path][frame.id]["text"]["text-align"].second == "left")
+                        else if (frame.text.text_align == "left")
                             str_pos_init.x = 0.f;
-                        else if (liveitem[app_path][frame.id]["text"]["text-align"].second == "right")
+                        else if (frame.text.text_align == "right")
                             str_pos_init.x = str_size.x - calc_text_size.x;
-                        else if (liveitem[app_path][frame.id]["text"]["text-align"].second == "outside-right") {
+                        else if (frame.text.text_align == "outside-right") {
                             text_pos.x += str_size.x;
-                            if (liveitem[app_path][frame.id]["text"]["origin"].second == "image") {
-                                if (gui.live_items[app_path][frame.id].find("background") != gui.live_items[app_path][frame.id].end())
+                            if (frame.text.origin == "image") {
+                                if (has_background)
                                     str_size.x = bg_scal_size.x - img_scal_size.x - (img_pos.x - bg_pos.x);
                                 else
                                     str_size = scal_size_frame, text_pos = pos_frame;
@@ -815,16 +807,16 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
                         }
                     }
                 } else {
-                    if (liveitem[app_path][frame.id]["text"]["align"].second == "center")
+                    if (frame.text.align == "center")
                         str_pos_init.x = (str_size.x - calc_text_size.x) / 2.0f;
-                    else if (liveitem[app_path][frame.id]["text"]["align"].second == "left")
+                    else if (frame.text.align == "left")
                         str_pos_init.x = 0.f;
-                    else if (liveitem[app_path][frame.id]["text"]["align"].second == "right")
+                    else if (frame.text.align == "right")
                         str_pos_init.x = str_size.x - calc_text_size.x;
-                    else if (liveitem[app_path][frame.id]["text"]["align"].second == "outside-right") {
+                    else if (frame.text.align == "outside-right") {
                         text_pos.x += str_size.x;
-                        if (liveitem[app_path][frame.id]["text"]["origin"].second == "image") {
-                            if (gui.live_items[app_path][frame.id].find("background") != gui.live_items[app_path][frame.id].end())
+                        if (frame.text.origin == "image") {
+                            if (has_background)
                                 str_size.x = bg_scal_size.x - img_scal_size.x - (img_pos.x - bg_pos.x);
                             else
                                 str_size = scal_size_frame, text_pos = pos_frame;
@@ -833,45 +825,45 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
                 }
 
                 // Valign
-                if (liveitem[app_path][frame.id]["text"]["valign"].second.empty()) {
-                    if (liveitem[app_path][frame.id]["text"]["text-valign"].second.empty() || (liveitem[app_path][frame.id]["text"]["text-valign"].second == "center"))
+                if (frame.text.valign.empty()) {
+                    if (frame.text.text_valign.empty() || (frame.text.text_valign == "center"))
                         str_pos_init.y = (str_size.y - calc_text_size.y) / 2.f;
-                    else if (liveitem[app_path][frame.id]["text"]["text-valign"].second == "bottom")
+                    else if (frame.text.text_valign == "bottom")
                         str_pos_init.y = str_size.y - calc_text_size.y;
-                    else if (liveitem[app_path][frame.id]["text"]["text-valign"].second == "top")
+                    else if (frame.text.text_valign == "top")
                         str_pos_init.y = 0.f;
                 } else {
-                    if ((liveitem[app_path][frame.id]["text"]["valign"].second == "center")
-                        || ((liveitem[app_path][frame.id]["text"]["valign"].second == "bottom") && (liveitem[app_path][frame.id]["text"]["y"].first != 0))
-                        || ((liveitem[app_path][frame.id]["text"]["valign"].second == "top") && (liveitem[app_path][frame.id]["text"]["y"].first != 0)))
+                    if ((frame.text.valign == "center")
+                        || ((frame.text.valign == "bottom") && (frame.text.y != 0))
+                        || ((frame.text.valign == "top") && (frame.text.y != 0)))
                         str_pos_init.y = (str_size.y - calc_text_size.y) / 2.f;
-                    else if (liveitem[app_path][frame.id]["text"]["valign"].second == "bottom")
+                    else if (frame.text.valign == "bottom")
                         str_pos_init.y = str_size.y - calc_text_size.y;
-                    else if (liveitem[app_path][frame.id]["text"]["valign"].second == "top") {
+                    else if (frame.text.valign == "top") {
                         str_pos_init.y = 0.f;
-                    } else if (liveitem[app_path][frame.id]["text"]["valign"].second == "outside-top") {
+                    } else if (frame.text.valign == "outside-top") {
                         str_pos_init.y = 0.f;
                     }
                 }
 
-                auto pos_str = ImVec2(str_pos_init.x, str_pos_init.y - (liveitem[app_path][frame.id]["text"]["y"].first * SCALE.y));
+                auto pos_str = ImVec2(str_pos_init.x, str_pos_init.y - (frame.text.y * SCALE.y));
 
-                if (liveitem[app_path][frame.id]["text"]["x"].first > 0) {
-                    text_pos.x += liveitem[app_path][frame.id]["text"]["x"].first * SCALE.x;
-                    str_size.x -= liveitem[app_path][frame.id]["text"]["x"].first * SCALE.x;
+                if (frame.text.x > 0) {
+                    text_pos.x += frame.text.x * SCALE.x;
+                    str_size.x -= frame.text.x * SCALE.x;
                 }
 
-                if ((liveitem[app_path][frame.id]["text"]["margin-left"].first > 0) && !liveitem[app_path][frame.id]["text"]["width"].first) {
-                    text_pos.x += liveitem[app_path][frame.id]["text"]["margin-left"].first * SCALE.x;
-                    str_size.x -= liveitem[app_path][frame.id]["text"]["margin-left"].first * SCALE.x;
+                if ((frame.text.margin_left > 0) && !frame.text.width) {
+                    text_pos.x += frame.text.margin_left * SCALE.x;
+                    str_size.x -= frame.text.margin_left * SCALE.x;
                 }
 
-                if (liveitem[app_path][frame.id]["text"]["margin-right"].first > 0)
-                    str_size.x -= liveitem[app_path][frame.id]["text"]["margin-right"].first * SCALE.x;
+                if (frame.text.margin_right > 0)
+                    str_size.x -= frame.text.margin_right * SCALE.x;
 
-                if (liveitem[app_path][frame.id]["text"]["margin-top"].first > 0) {
-                    text_pos.y += liveitem[app_path][frame.id]["text"]["margin-top"].first * SCALE.y;
-                    str_size.y -= liveitem[app_path][frame.id]["text"]["margin-top"].first * SCALE.y;
+                if (frame.text.margin_top > 0) {
+                    text_pos.y += frame.text.margin_top * SCALE.y;
+                    str_size.y -= frame.text.margin_top * SCALE.y;
                 }
 
                 // Text Display
@@ -879,11 +871,11 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
                 // TODO Correct display few line on same frame, used by eg: Asphalt: Injection
                 ImGui::SetNextWindowPos(text_pos);
                 ImGui::BeginChild(frame.id.c_str(), str_size, false, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoSavedSettings);
-                if (liveitem[app_path][frame.id]["text"]["word-wrap"].second != "off")
+                if (frame.text.word_wrap != "off")
                     ImGui::PushTextWrapPos(str_wrap);
-                if (liveitem[app_path][frame.id]["text"]["word-scroll"].second == "on") {
+                if (frame.text.word_scroll == "on") {
                     static std::map<std::string, std::map<std::string, std::pair<bool, float>>> scroll;
-                    if (liveitem[app_path][frame.id]["text"]["word-wrap"].second == "off") {
+                    if (frame.text.word_wrap == "off") {
                         if (scroll[app_path][frame.id].first) {
                             if (scroll[app_path][frame.id].second >= 0.f)
                                 scroll[app_path][frame.id].second -= 0.5f;
@@ -913,10 +905,10 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
                 }
                 ImGui::SetCursorPos(pos_str);
                 if (frame.autoflip > 0)
-                    ImGui::TextColored(str_color[0], "%s", str[app_path][frame.id][current_item[app_path][frame.id]].text.c_str());
+                    ImGui::TextColored(str_color[0], "%s", frame.str[frame.current_item].text.c_str());
                 else
                     ImGui::TextColored(str_color[0], "%s", str_tag.text.c_str());
-                if (liveitem[app_path][frame.id]["text"]["word-wrap"].second != "off")
+                if (frame.text.word_wrap != "off")
                     ImGui::PopTextWrapPos();
                 ImGui::EndChild();
                 ImGui::SetWindowFontScale(RES_SCALE.x);
@@ -930,7 +922,7 @@ void draw_live_area_screen(GuiState &gui, HostState &host) {
 
     const std::string BUTTON_STR = app_path == host.io.app_path ? gui.lang.live_area[CONTINUE] : gui.lang.live_area[START];
     const auto GATE_SIZE = ImVec2(280.0f * SCALE.x, 158.0f * SCALE.y);
-    const auto GATE_POS = ImVec2(display_size.x - (items_pos[type[app_path]]["gate"]["pos"].x * SCALE.x), display_size.y - (items_pos[type[app_path]]["gate"]["pos"].y * SCALE.y));
+    const auto GATE_POS = ImVec2(display_size.x - (live_area.gate_pos.x * SCALE.x), display_size.y - (live_area.gate_pos.y * SCALE.y));
     const auto START_SIZE = ImVec2((ImGui::CalcTextSize(BUTTON_STR.c_str()).x * font_size_scale), (ImGui::CalcTextSize(BUTTON_STR.c_str()).y * font_size_scale));
     const auto START_BUTTON_SIZE = ImVec2(START_SIZE.x + 26.0f * SCALE.x, START_SIZE.y + 5.0f * SCALE.y);
     const auto POS_BUTTON = ImVec2((GATE_POS.x + (GATE_SIZE.x - START_BUTTON_SIZE.x) / 2.0f), (GATE_POS.y + (GATE_SIZE.y - START_BUTTON_SIZE.y) / 1.08f));
@@ -69,6 +69,7 @@ static void draw_debug_menu(DebugMenuState &state) {
         ImGui::MenuItem("Event Flags", nullptr, &state.eventflags_dialog);
         ImGui::MenuItem("Memory Allocations", nullptr, &state.allocations_dialog);
         ImGui::MenuItem("Disassembly", nullptr, &state.disassembly_dialog);
+        ImGui::MenuItem("HLE Profiler", nullptr, &state.hle_profiler_dialog);
         ImGui::EndMenu();
     }
 }
@@ -23,8 +23,6 @@
 
 #include <util/log.h>
 
-#include <stb_image.h>
-
 namespace gui {
 
 static int32_t current_page;
@@ -40,8 +38,15 @@ void open_manual(GuiState &gui, HostState &host, const std::string app_path) {
         LOG_ERROR("Error opening Manual");
 }
 
+static void set_page_size(const int32_t width, const int32_t height) {
+    size_page["mini"] = size_page["current"] = height < width ? ImVec2(float(width), float(height)) : ImVec2(float(width * (width / 960.f)), float(height / (height / 544.f)));
+    size_page["max"] = ImVec2(float(width), float(height));
+    zoom = { height > width, false };
+}
+
 bool init_manual(GuiState &gui, HostState &host, const std::string app_path) {
     current_page = 0;
+    gui.image_async_loader->cancel("manual");
     gui.manuals.clear();
     size_page.clear();
     zoom = {};
@@ -56,33 +61,36 @@ bool init_manual(GuiState &gui, HostState &host, const std::string app_path) {
         manual_path /= lang;
 
     if (fs::exists(APP_PATH / manual_path) && !fs::is_empty(APP_PATH / manual_path)) {
-        int32_t width, height;
+        // Layout of a Vita screen until the pages are decoded
+        set_page_size(960, 544);
+
         for (const auto &manual : fs::directory_iterator(APP_PATH / manual_path)) {
             if (manual.path().extension() == ".png") {
                 const auto page_path = manual_path / manual.path().filename().string();
-
-                vfs::FileBuffer buffer;
-                vfs::read_app_file(buffer, host.pref_path, app_path, page_path);
-
-                if (buffer.empty()) {
-                    LOG_WARN("Manual not found for title: {} [{}].", app_path, APP_INDEX->title);
-                    return false;
-                }
-                stbi_uc *data = stbi_load_from_memory(&buffer[0], static_cast<int>(buffer.size()), &width, &height, nullptr, STBI_rgb_alpha);
-                if (!data) {
-                    LOG_ERROR("Invalid manual image for title: {} [{}] in path: {}.", app_path, APP_INDEX->title, page_path.string());
-                    return false;
-                }
+                const auto read = [pref_path = host.pref_path, app_path, page_path, title = APP_INDEX->title]() {
+                    vfs::FileBuffer buffer;
+                    vfs::read_app_file(buffer, pref_path, app_path, page_path);
+                    if (buffer.empty())
+                        LOG_WARN("Manual not found for title: {} [{}].", app_path, title);
+                    return buffer;
+                };
+
+                const auto page = gui.manuals.size();
+                const auto done = [page](GuiState &gui, DecodedImage &image) {
+                    if (page >= gui.manuals.size())
+                        return;
+
+                    gui.manuals[page].init(gui.imgui_state.get(), image.pixels.data(), image.width, image.height);
+                    if (page == 0)
+                        set_page_size(image.source_width, image.source_height);
+                };
 
                 gui.manuals.push_back({});
-                gui.manuals.back().init(gui.imgui_state.get(), data, width, height);
-                stbi_image_free(data);
+
+                // Pages are seldom read again, caching them would only push live area pictures out of the cache
+                gui.image_async_loader->request("manual", { fmt::format("manual page for title: {} [{}] in path: {}", app_path, APP_INDEX->title, page_path.string()), read, done, 0, false });
             }
         }
-        size_page["mini"] = size_page["current"] = height < width ? ImVec2(float(width), float(height)) : ImVec2(float(width * (width / 960.f)), float(height / (height / 544.f)));
-        size_page["max"] = ImVec2(float(width), float(height));
-        if (height > width)
-            zoom.first = true;
     }
 
     return !gui.manuals.empty();
@@ -108,7 +116,7 @@ void draw_manual(GuiState &gui, HostState &host) {
     ImGui::BeginChild("##manual_child", size_child, false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings | (zoom.second ? ImGuiWindowFlags_AlwaysVerticalScrollbar : ImGuiWindowFlags_NoScrollbar));
     ImGui::SetWindowFontScale(RES_SCALE.x);
     if (!gui.manuals.empty())
-        ImGui::Image(gui.manuals[current_page], ImVec2(size_page["current"].x * SCALE.x, size_page["current"].y * SCALE.y));
+        ImGui::Image(gui.image_async_loader->or_placeholder(gui.manuals[current_page]), ImVec2(size_page["current"].x * SCALE.x, size_page["current"].y * SCALE.y));
 
     if (ImGui::IsMouseClicked(1))
         hidden_button = !hidden_button;
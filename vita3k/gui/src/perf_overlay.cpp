@@ -43,8 +43,8 @@ static ImVec2 get_perf_pos(ImVec2 window_size, HostState &host) {
 
 static float get_perf_height(HostState &host) {
     switch (host.cfg.performance_overlay_detail) {
-    case MAXIMUM: return 138.f;
-    case MEDIUM: return 80.f;
+    case MAXIMUM: return 178.f;
+    case MEDIUM: return 120.f;
     case LOW:
     case MINIMUM:
     default: break;
@@ -56,7 +56,7 @@ static float get_perf_height(HostState &host) {
 void draw_perf_overlay(GuiState &gui, HostState &host) {
     const auto MAIN_WINDOW_SIZE = ImVec2((host.cfg.performance_overlay_detail == MINIMUM ? 95.5f : 152.f) * host.dpi_scale, get_perf_height(host) * host.dpi_scale);
     const auto WINDOW_POS = get_perf_pos(MAIN_WINDOW_SIZE, host);
-    const auto WINDOW_SIZE = ImVec2((host.cfg.performance_overlay_detail == MINIMUM ? 72.5f : 130.f) * host.dpi_scale, (host.cfg.performance_overlay_detail <= LOW ? 35.f : 58.f) * host.dpi_scale);
+    const auto WINDOW_SIZE = ImVec2((host.cfg.performance_overlay_detail == MINIMUM ? 72.5f : 130.f) * host.dpi_scale, (host.cfg.performance_overlay_detail <= LOW ? 35.f : 98.f) * host.dpi_scale);
 
     ImGui::SetNextWindowSize(MAIN_WINDOW_SIZE);
     ImGui::SetNextWindowPos(WINDOW_POS);
@@ -72,6 +72,9 @@ void draw_perf_overlay(GuiState &gui, HostState &host) {
     if (host.cfg.performance_overlay_detail >= PerfomanceOverleyDetail::MEDIUM) {
         ImGui::Separator();
         ImGui::Text("Min: %d Max: %d", host.min_fps, host.max_fps);
+        ImGui::Separator();
+        ImGui::Text("VBlank: %.2f ms", host.display.vblank_stats.period_us.load() / 1000.f);
+        ImGui::Text("Jitter: %.0f/%.0f us", host.display.vblank_stats.jitter_avg_us.load(), host.display.vblank_stats.jitter_max_us.load());
     }
     ImGui::EndChild();
     ImGui::PopStyleVar();
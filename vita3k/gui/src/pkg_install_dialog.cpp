@@ -155,7 +155,7 @@ void draw_pkg_install_dialog(GuiState &gui, HostState &host) {
                 }
                 if ((host.app_category.find("gd") != std::string::npos) || (host.app_category.find("gp") != std::string::npos)) {
                     init_user_app(gui, host, host.app_title_id);
-                    save_apps_cache(gui, host);
+                    update_apps_cache(gui, host, host.app_title_id);
                 }
                 update_notice_info(gui, host, "content");
                 pkg_path = nullptr;
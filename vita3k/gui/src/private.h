@@ -59,6 +59,7 @@ void draw_condvars_dialog(GuiState &gui, HostState &host);
 void draw_event_flags_dialog(GuiState &gui, HostState &host);
 void draw_allocations_dialog(GuiState &gui, HostState &host);
 void draw_disassembly_dialog(GuiState &gui, HostState &host);
+void draw_hle_profiler_dialog(GuiState &gui, HostState &host);
 void draw_settings_dialog(GuiState &gui, HostState &host);
 void draw_controls_dialog(GuiState &gui, HostState &host);
 void draw_controllers_dialog(GuiState &gui, HostState &host);
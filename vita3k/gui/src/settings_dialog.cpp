@@ -363,7 +363,7 @@ void draw_settings_dialog(GuiState &gui, HostState &host) {
         ImGui::PopStyleColor();
         ImGui::Spacing();
 #ifdef USE_VULKAN
-        static const char *LIST_BACKEND_RENDERER[] = { "OpenGL", "Vulkan" };
+        static const char *LIST_BACKEND_RENDERER[] = { "OpenGL", "Vulkan", "Null" };
         if (ImGui::Combo("Backend Renderer (Reboot for apply)", reinterpret_cast<int *>(&host.backend_renderer), LIST_BACKEND_RENDERER, IM_ARRAYSIZE(LIST_BACKEND_RENDERER)))
             host.cfg.backend_renderer = LIST_BACKEND_RENDERER[int(host.backend_renderer)];
         if (ImGui::IsItemHovered())
@@ -434,9 +434,21 @@ void draw_settings_dialog(GuiState &gui, HostState &host) {
         if (ImGui::IsItemHovered())
             ImGui::SetTooltip("Enables Discord Rich Presence to show what application you're running on Discord");
 #endif
+        ImGui::Checkbox("Host Thread Priorities", &host.cfg.host_thread_priority);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Check the box to run low priority guest threads at a lower host priority.\nGuest cores can be pinned to host CPUs per app with host-core-affinity in config.yml. (Reboot for apply)");
         ImGui::Checkbox("Texture Cache", &host.cfg.texture_cache);
         if (ImGui::IsItemHovered())
             ImGui::SetTooltip("Uncheck the box to disable texture cache.");
+        ImGui::Checkbox("Asynchronous Texture Decoding", &host.cfg.async_texture_decode);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Check the box to decode textures on worker threads.\nDraws use the previous texture contents until the decode is done. (Reboot for apply)");
+        if (host.cfg.async_texture_decode) {
+            ImGui::SameLine();
+            ImGui::Checkbox("Wait For Decode", &host.cfg.async_texture_decode_wait);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Check the box to make draws wait for texture decodes instead of using the previous contents. (Reboot for apply)");
+        }
         ImGui::Separator();
         const auto perfomance_overley_size = ImGui::CalcTextSize("Performance Overlay").x;
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() / 2.f) - (perfomance_overley_size / 2.f));
@@ -633,6 +645,9 @@ void draw_settings_dialog(GuiState &gui, HostState &host) {
         ImGui::Checkbox("Dump elfs", &host.kernel.debugger.dump_elfs);
         if (ImGui::IsItemHovered())
             ImGui::SetTooltip("Dump loaded code as elfs");
+        ImGui::Checkbox("Fill stacks", &host.kernel.debugger.fill_stacks);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Fill new thread stacks with 0xCC to spot reads of uninitialized stack, slows down thread creation.");
         ImGui::Spacing();
         if (ImGui::Button(host.kernel.debugger.watch_code ? "Unwatch code" : "Watch code")) {
             host.kernel.debugger.watch_code = !host.kernel.debugger.watch_code;
@@ -58,7 +58,7 @@ void draw_thread_details_dialog(GuiState &gui, HostState &host) {
 void draw_threads_dialog(GuiState &gui, HostState &host) {
     ImGui::Begin("Threads", &gui.debug_menu.threads_dialog);
     ImGui::TextColored(GUI_COLOR_TEXT_TITLE,
-        "%-16s %-32s   %-16s   %-16s", "ID", "Thread Name", "Status", "Stack Pointer");
+        "%-16s %-32s   %-16s   %-16s   %-16s", "ID", "Thread Name", "Status", "Stack Pointer", "Host Scheduling");
 
     const std::lock_guard<std::mutex> lock(host.kernel.mutex);
 
@@ -76,8 +76,8 @@ void draw_threads_dialog(GuiState &gui, HostState &host) {
             run_state = "Dormant";
             break;
         }
-        if (ImGui::Selectable(fmt::format("{:0>8X}         {:<32}   {:<16}   {:0>8X}",
-                thread.first, th_state->name, run_state, th_state->stack.get())
+        if (ImGui::Selectable(fmt::format("{:0>8X}         {:<32}   {:<16}   {:0>8X}           {}",
+                thread.first, th_state->name, run_state, th_state->stack.get(), to_string(th_state->host_policy))
                                   .c_str())) {
             gui.thread_watch_index = thread.first;
             gui.debug_menu.thread_details_dialog = true;
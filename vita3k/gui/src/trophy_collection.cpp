@@ -27,7 +27,6 @@
 
 #include <nfd.h>
 #include <pugixml.hpp>
-#include <stb_image.h>
 
 namespace gui {
 using namespace np::trophy;
@@ -123,10 +122,24 @@ static bool load_trophy_progress(IOState &io, const SceUID &progress_input_file,
 
 static std::string np_com_id_sort;
 
+// Trophy icons are drawn at most at 160x88, with room left for high resolution displays
+static constexpr int32_t TROPHY_ICON_MAX_SIZE = 320;
+
+static void request_icon(GuiState &gui, HostState &host, const std::string &group, const std::string &icon_path, const std::string &name, std::function<void(GuiState &, DecodedImage &)> done) {
+    const auto read = [pref_path = host.pref_path, icon_path]() {
+        vfs::FileBuffer buffer;
+        vfs::read_file(VitaIoDevice::ux0, buffer, pref_path, icon_path);
+        return buffer;
+    };
+
+    gui.image_async_loader->request(group, { name, read, std::move(done), TROPHY_ICON_MAX_SIZE });
+}
+
 void init_trophy_collection(GuiState &gui, HostState &host) {
     const auto TROPHY_PATH{ fs::path(host.pref_path) / "ux0/user" / host.io.user_id / "trophy" };
     const auto TROPHY_CONF_PATH = TROPHY_PATH / "conf";
 
+    gui.image_async_loader->cancel("trophy_collection");
     gui.trophy_np_com_id_list_icons.clear(), np_com_id_info.clear(), np_com_id_list.clear();
 
     if (fs::exists(TROPHY_CONF_PATH) && !fs::is_empty(TROPHY_CONF_PATH)) {
@@ -231,25 +244,19 @@ void init_trophy_collection(GuiState &gui, HostState &host) {
                 np_com_id_list.push_back({ np_com_id, np_com_id_info[np_com_id].name["000"], progress, updated });
 
                 for (const auto &group : np_com_list_name_icons) {
-                    int32_t width = 0;
-                    int32_t height = 0;
-                    vfs::FileBuffer buffer;
-
-                    vfs::read_file(VitaIoDevice::ux0, buffer, host.pref_path, "user/" + host.io.user_id + "/trophy/conf/" + np_com_id + "/" + group.second);
-
-                    if (buffer.empty()) {
+                    if (!fs::exists(trophy_conf_np_com_id_path / group.second)) {
                         LOG_WARN("Icon: '{}', Not found for NPComId: {}.", group.second, np_com_id);
                         continue;
                     }
 
-                    stbi_uc *data = stbi_load_from_memory(&buffer[0], static_cast<int>(buffer.size()), &width, &height, nullptr, STBI_rgb_alpha);
-                    if (!data) {
-                        LOG_ERROR("Invalid icon: '{}' for NPComId: {}.", group.second, np_com_id);
-                        continue;
-                    }
-
-                    gui.trophy_np_com_id_list_icons[np_com_id][group.first].init(gui.imgui_state.get(), data, width, height);
-                    stbi_image_free(data);
+                    // Drawn with the placeholder until decoded
+                    gui.trophy_np_com_id_list_icons[np_com_id][group.first] = {};
+                    request_icon(gui, host, "trophy_collection", "user/" + host.io.user_id + "/trophy/conf/" + np_com_id + "/" + group.second,
+                        fmt::format("icon: '{}' for NPComId: {}", group.second, np_com_id), [np_com_id, group_id = group.first](GuiState &gui, DecodedImage &image) {
+                            const auto icons = gui.trophy_np_com_id_list_icons.find(np_com_id);
+                            if ((icons != gui.trophy_np_com_id_list_icons.end()) && (icons->second.find(group_id) != icons->second.end()))
+                                icons->second[group_id].init(gui.imgui_state.get(), image.pixels.data(), image.width, image.height);
+                        });
                 }
             }
         }
@@ -290,6 +297,7 @@ static void get_trophy_list(GuiState &gui, HostState &host, const std::string &n
         return;
     }
 
+    gui.image_async_loader->cancel("trophy_list");
     gui.trophy_list.clear(), trophy_info.clear(), trophy_list.clear();
 
     const std::string sfm_name = fs::exists(trophy_conf_id_path / fmt::format("TROP_{:0>2d}.SFM", host.cfg.sys_lang)) ? fmt::format("TROP_{:0>2d}.SFM", host.cfg.sys_lang) : "TROP.SFM";
@@ -312,25 +320,21 @@ static void get_trophy_list(GuiState &gui, HostState &host, const std::string &n
     }
 
     for (const auto &trophy : trophy_info) {
-        int32_t width = 0;
-        int32_t height = 0;
-        vfs::FileBuffer buffer;
         const std::string trophy_id = trophy.first;
         const std::string icon_name = fmt::format("TROP{}.PNG", trophy_id);
 
-        vfs::read_file(VitaIoDevice::ux0, buffer, host.pref_path, "user/" + host.io.user_id + "/trophy/conf/" + np_com_id + "/" + icon_name);
-        if (buffer.empty()) {
+        if (!fs::exists(trophy_conf_id_path / icon_name)) {
             LOG_WARN("Trophy icon, Name: '{}', Not found for trophy id: {}.", icon_name, trophy.first);
             continue;
         }
-        stbi_uc *data = stbi_load_from_memory(&buffer[0], static_cast<int>(buffer.size()), &width, &height, nullptr, STBI_rgb_alpha);
-        if (!data) {
-            LOG_ERROR("Invalid trophy icon for trophy id {} [{}].", icon_name, trophy_id);
-            continue;
-        }
 
-        gui.trophy_list[trophy_id].init(gui.imgui_state.get(), data, width, height);
-        stbi_image_free(data);
+        gui.trophy_list[trophy_id] = {};
+        request_icon(gui, host, "trophy_list", "user/" + host.io.user_id + "/trophy/conf/" + np_com_id + "/" + icon_name,
+            fmt::format("trophy icon for trophy id {} [{}]", icon_name, trophy_id), [trophy_id](GuiState &gui, DecodedImage &image) {
+                const auto icon = gui.trophy_list.find(trophy_id);
+                if (icon != gui.trophy_list.end())
+                    icon->second.init(gui.imgui_state.get(), image.pixels.data(), image.width, image.height);
+            });
 
         auto common = gui.lang.common.main;
         const auto trophy_type = np_com_id_info[np_com_id].context.trophy_kinds[std::stoi(trophy_id)];
@@ -463,7 +467,7 @@ void draw_trophy_collection(GuiState &gui, HostState &host) {
                 ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 10.f * SCALE.x);
                 ImGui::SetCursorPos(ImVec2(48.f * SCALE.x, 28.f * SCALE.y));
                 if (gui.trophy_np_com_id_list_icons[delete_np_com_id].find("000") != gui.trophy_np_com_id_list_icons[delete_np_com_id].end())
-                    ImGui::Image(gui.trophy_np_com_id_list_icons[delete_np_com_id]["000"], SIZE_ICON_LIST);
+                    ImGui::Image(gui.image_async_loader->or_placeholder(gui.trophy_np_com_id_list_icons[delete_np_com_id]["000"]), SIZE_ICON_LIST);
                 ImGui::SameLine();
                 ImGui::SetWindowFontScale(1.5f * RES_SCALE.x);
                 const auto CALC_TITLE = ImGui::CalcTextSize(np_com_id_info[delete_np_com_id].name["000"].c_str(), nullptr, false, POPUP_SIZE.x - SIZE_ICON_LIST.x - 48.f).y / 2.f;
@@ -505,7 +509,7 @@ void draw_trophy_collection(GuiState &gui, HostState &host) {
                 if (!search_bar.PassFilter(np_com.name.c_str()))
                     continue;
                 if (gui.trophy_np_com_id_list_icons[np_com.id].find("000") != gui.trophy_np_com_id_list_icons[np_com.id].end())
-                    ImGui::Image(gui.trophy_np_com_id_list_icons[np_com.id]["000"], SIZE_ICON_LIST);
+                    ImGui::Image(gui.image_async_loader->or_placeholder(gui.trophy_np_com_id_list_icons[np_com.id]["000"]), SIZE_ICON_LIST);
                 ImGui::NextColumn();
                 ImGui::SetWindowFontScale(1.3f * RES_SCALE.x);
                 ImGui::PushStyleVar(ImGuiStyleVar_SelectableTextAlign, ImVec2(0.f, 0.2f));
@@ -549,7 +553,7 @@ void draw_trophy_collection(GuiState &gui, HostState &host) {
             // Select Group ID
             if (group_id_selected.empty()) {
                 if (gui.trophy_np_com_id_list_icons[np_com_id_selected].find("000") != gui.trophy_np_com_id_list_icons[np_com_id_selected].end())
-                    ImGui::Image(gui.trophy_np_com_id_list_icons[np_com_id_selected]["000"], SIZE_ICON_LIST);
+                    ImGui::Image(gui.image_async_loader->or_placeholder(gui.trophy_np_com_id_list_icons[np_com_id_selected]["000"]), SIZE_ICON_LIST);
                 ImGui::SameLine();
                 ImGui::SetWindowFontScale(1.3f * RES_SCALE.x);
                 ImGui::PushStyleVar(ImGuiStyleVar_SelectableTextAlign, ImVec2(0.f, 0.5f));
@@ -567,7 +571,7 @@ void draw_trophy_collection(GuiState &gui, HostState &host) {
                     ImGui::TextColored(GUI_COLOR_TEXT, "%s", group_id != "000" ? "+" : "");
                     ImGui::NextColumn();
                     if (gui.trophy_np_com_id_list_icons[np_com_id_selected].find(group_id) != gui.trophy_np_com_id_list_icons[np_com_id_selected].end())
-                        ImGui::Image(gui.trophy_np_com_id_list_icons[np_com_id_selected][group_id], SIZE_ICON_LIST);
+                        ImGui::Image(gui.image_async_loader->or_placeholder(gui.trophy_np_com_id_list_icons[np_com_id_selected][group_id]), SIZE_ICON_LIST);
                     ImGui::NextColumn();
                     ImGui::PushStyleVar(ImGuiStyleVar_SelectableTextAlign, ImVec2(0.f, 0.2f));
                     const auto Title_POS = ImGui::GetCursorPosY();
@@ -601,7 +605,7 @@ void draw_trophy_collection(GuiState &gui, HostState &host) {
             } else if (detail_np_com_id) {
                 ImGui::SetWindowFontScale(1.5f * RES_SCALE.x);
                 if (gui.trophy_np_com_id_list_icons[np_com_id_selected].find(group_id_selected == "global" ? "000" : group_id_selected) != gui.trophy_np_com_id_list_icons[np_com_id_selected].end())
-                    ImGui::Image(gui.trophy_np_com_id_list_icons[np_com_id_selected][group_id_selected == "global" ? "000" : group_id_selected], SIZE_ICON_LIST);
+                    ImGui::Image(gui.image_async_loader->or_placeholder(gui.trophy_np_com_id_list_icons[np_com_id_selected][group_id_selected == "global" ? "000" : group_id_selected]), SIZE_ICON_LIST);
                 const auto CALC_NAME = ImGui::CalcTextSize(np_com_id_info[np_com_id_selected].name[group_id_selected == "global" ? "000" : group_id_selected].c_str(), nullptr, false, SIZE_INFO.x - SIZE_ICON_LIST.x - 48.f).y / 2.f;
                 ImGui::SetCursorPos(ImVec2(SIZE_ICON_LIST.x + 20.f, (SIZE_ICON_LIST.y / 2.f) - CALC_NAME));
                 ImGui::PushTextWrapPos(ImGui::GetCursorPosX() + SIZE_INFO.x - SIZE_ICON_LIST.x - 48.f);
@@ -638,7 +642,7 @@ void draw_trophy_collection(GuiState &gui, HostState &host) {
                 // Select Trophy
             } else if (trophy_id_selected.empty()) {
                 if (gui.trophy_np_com_id_list_icons[np_com_id_selected].find(group_id_selected) != gui.trophy_np_com_id_list_icons[np_com_id_selected].end())
-                    ImGui::Image(gui.trophy_np_com_id_list_icons[np_com_id_selected][group_id_selected], SIZE_ICON_LIST);
+                    ImGui::Image(gui.image_async_loader->or_placeholder(gui.trophy_np_com_id_list_icons[np_com_id_selected][group_id_selected]), SIZE_ICON_LIST);
                 ImGui::SameLine();
                 ImGui::SetWindowFontScale(1.6f * RES_SCALE.x);
                 ImGui::PushStyleVar(ImGuiStyleVar_SelectableTextAlign, ImVec2(0.f, 0.5f));
@@ -653,7 +657,7 @@ void draw_trophy_collection(GuiState &gui, HostState &host) {
                     ImGui::NextColumn();
                     ImGui::SetWindowFontScale(1.2f * RES_SCALE.x);
                     if (trophy_info[trophy.id].earned)
-                        ImGui::Image(gui.trophy_list[trophy.id], SIZE_TROPHY_LIST);
+                        ImGui::Image(gui.image_async_loader->or_placeholder(gui.trophy_list[trophy.id]), SIZE_TROPHY_LIST);
                     else {
                         ImGui::PushStyleVar(ImGuiStyleVar_SelectableTextAlign, ImVec2(0.f, 0.5f));
                         ImGui::PushID(trophy.id.c_str());
@@ -686,7 +690,7 @@ void draw_trophy_collection(GuiState &gui, HostState &host) {
                 // Detail Trophy
                 ImGui::SetWindowFontScale(1.5f * RES_SCALE.x);
                 if (trophy_info[trophy_id_selected].earned)
-                    ImGui::Image(gui.trophy_list[trophy_id_selected], SIZE_TROPHY_LIST);
+                    ImGui::Image(gui.image_async_loader->or_placeholder(gui.trophy_list[trophy_id_selected]), SIZE_TROPHY_LIST);
                 else {
                     ImGui::SetCursorPosY((SIZE_TROPHY_LIST.y / 2.f) - (15.f * SCALE.y));
                     ImGui::TextColored(GUI_COLOR_TEXT, "Lock");
@@ -0,0 +1,119 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <util/fs.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Installed applications, kept in a file that is mapped and used in place so the library is ready
+// without reading any param.sfo or decoding any icon. Records are only ever appended: removing a title
+// flags its record, updating one flags it and appends the new one, and the file is compacted once
+// removed records take most of it.
+class AppIndex {
+public:
+    static constexpr uint32_t ICON_SIZE = 128;
+    static constexpr size_t ICON_BYTES = ICON_SIZE * ICON_SIZE * 4;
+
+    // Mapped entry, valid until the index changes or is closed
+    struct Entry {
+        std::string_view app_ver;
+        std::string_view category;
+        std::string_view content_id;
+        std::string_view addcont;
+        std::string_view savedata;
+        std::string_view parental_level;
+        std::string_view stitle;
+        std::string_view title;
+        std::string_view title_id;
+        std::string_view path;
+
+        // Modification time of the application directory when the record was written
+        int64_t modified;
+        // RGBA pixels of the 128x128 icon, null when the title has none
+        const uint8_t *icon;
+
+        uint64_t offset;
+    };
+
+    struct Record {
+        std::string app_ver;
+        std::string category;
+        std::string content_id;
+        std::string addcont;
+        std::string savedata;
+        std::string parental_level;
+        std::string stitle;
+        std::string title;
+        std::string title_id;
+        std::string path;
+
+        int64_t modified = 0;
+        // Empty or ICON_BYTES long
+        std::vector<uint8_t> icon;
+    };
+
+    explicit AppIndex(const fs::path &file);
+    ~AppIndex();
+
+    AppIndex(const AppIndex &) = delete;
+    AppIndex &operator=(const AppIndex &) = delete;
+
+    // Maps the index, fails when it is missing, from another version or written for another language
+    bool open(uint32_t sys_lang);
+    void close();
+
+    const std::vector<Entry> &entries() const {
+        return mapped_entries;
+    }
+
+    // Replaces the whole index
+    bool rebuild(uint32_t sys_lang, const std::vector<Record> &records);
+
+    // Adds the record, or replaces the one with the same path
+    bool put(const Record &record);
+
+    // Returns false when there was no such entry
+    bool remove(const std::string &path);
+
+private:
+    bool map();
+    void unmap();
+    bool append(const Record &record, uint64_t offset);
+    bool flag_removed(uint64_t offset);
+    bool compact();
+
+    fs::path file_path;
+    uint32_t lang = 0;
+
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+#ifdef WIN32
+    void *file_handle = nullptr;
+    void *mapping_handle = nullptr;
+#endif
+
+    std::vector<Entry> mapped_entries;
+    // End of the last whole record
+    uint64_t valid_size = 0;
+    // Bytes taken by removed records, the file is compacted once they outweigh the live ones
+    uint64_t removed_size = 0;
+};
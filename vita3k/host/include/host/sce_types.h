@@ -22,6 +22,8 @@
 
 // Credits to TeamMolecule for their original work on this https://github.com/TeamMolecule/sceutils
 
+class ThreadPool;
+
 #define SCE_MAGIC 0x00454353
 #define HEADER_LENGTH 0x1000
 
@@ -651,7 +653,8 @@ public:
 void register_keys(KeyStore &SCE_KEYS, int type);
 void extract_fat(const std::wstring &partition_path, const std::string &partition, const std::wstring &pref_path);
 std::string decompress_segments(const std::vector<uint8_t> &decrypted_data, const uint64_t &size);
-void self2elf(const std::string &infile, const std::string &outfile, KeyStore &SCE_KEYS, unsigned char *klictxt);
+std::vector<uint8_t> decode_segment(const SceSegment &seg, std::vector<uint8_t> data, bool encrypted);
+void self2elf(const std::string &infile, const std::string &outfile, KeyStore &SCE_KEYS, unsigned char *klictxt, ThreadPool *pool = nullptr);
 void make_fself(const std::string &input_file, const std::string &output_file);
 std::tuple<uint64_t, SelfType> get_key_type(std::ifstream &file, const SceHeader &sce_hdr);
 std::vector<SceSegment> get_segments(std::ifstream &file, const SceHeader &sce_hdr, KeyStore &SCE_KEYS, uint64_t sysver = -1, SelfType self_type = static_cast<SelfType>(0), int keytype = 0, unsigned char *klictxt = 0);
@@ -0,0 +1,357 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <host/app_index.h>
+
+#include <util/log.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr uint32_t APP_INDEX_MAGIC = 0x58444941; // 'AIDX'
+static constexpr uint32_t APP_INDEX_VERSION = 1;
+static constexpr uint32_t APP_RECORD_MAGIC = 0x43455241; // 'AREC'
+static constexpr uint32_t APP_RECORD_REMOVED = 1;
+static constexpr size_t APP_RECORD_ALIGN = 8;
+static constexpr size_t APP_STRING_COUNT = 10;
+
+struct AppIndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sys_lang;
+    uint32_t reserved;
+};
+
+// Followed by the strings back to back, then by the icon at icon_offset
+struct AppIndexRecord {
+    uint32_t magic;
+    // Whole record, padded to APP_RECORD_ALIGN
+    uint32_t size;
+    uint32_t flags;
+    // From the start of the record, 0 without icon
+    uint32_t icon_offset;
+    int64_t modified;
+    uint16_t string_sizes[APP_STRING_COUNT];
+    uint32_t reserved;
+};
+
+static_assert(sizeof(AppIndexRecord) % APP_RECORD_ALIGN == 0);
+
+// Order of the strings in a record
+static constexpr std::string AppIndex::Record::*RECORD_STRINGS[APP_STRING_COUNT] = {
+    &AppIndex::Record::app_ver, &AppIndex::Record::category, &AppIndex::Record::content_id, &AppIndex::Record::addcont, &AppIndex::Record::savedata,
+    &AppIndex::Record::parental_level, &AppIndex::Record::stitle, &AppIndex::Record::title, &AppIndex::Record::title_id, &AppIndex::Record::path
+};
+static constexpr std::string_view AppIndex::Entry::*ENTRY_STRINGS[APP_STRING_COUNT] = {
+    &AppIndex::Entry::app_ver, &AppIndex::Entry::category, &AppIndex::Entry::content_id, &AppIndex::Entry::addcont, &AppIndex::Entry::savedata,
+    &AppIndex::Entry::parental_level, &AppIndex::Entry::stitle, &AppIndex::Entry::title, &AppIndex::Entry::title_id, &AppIndex::Entry::path
+};
+
+static FILE *open_index_file(const fs::path &path, const char *mode) {
+#ifdef WIN32
+    return _wfopen(path.wstring().c_str(), std::wstring(mode, mode + strlen(mode)).c_str());
+#else
+    return fopen(path.string().c_str(), mode);
+#endif
+}
+
+static void pad(std::vector<uint8_t> &buffer) {
+    buffer.resize((buffer.size() + APP_RECORD_ALIGN - 1) & ~(APP_RECORD_ALIGN - 1));
+}
+
+static std::vector<uint8_t> serialize(const AppIndex::Record &record) {
+    AppIndexRecord header{};
+    header.magic = APP_RECORD_MAGIC;
+    header.modified = record.modified;
+
+    std::vector<uint8_t> buffer(sizeof(header));
+    for (size_t i = 0; i < APP_STRING_COUNT; i++) {
+        const auto &str = record.*RECORD_STRINGS[i];
+        header.string_sizes[i] = static_cast<uint16_t>(std::min<size_t>(str.size(), UINT16_MAX));
+        buffer.insert(buffer.end(), str.begin(), str.begin() + header.string_sizes[i]);
+    }
+
+    if (record.icon.size() == AppIndex::ICON_BYTES) {
+        pad(buffer);
+        header.icon_offset = static_cast<uint32_t>(buffer.size());
+        buffer.insert(buffer.end(), record.icon.begin(), record.icon.end());
+    }
+
+    pad(buffer);
+    header.size = static_cast<uint32_t>(buffer.size());
+    memcpy(buffer.data(), &header, sizeof(header));
+    return buffer;
+}
+
+static AppIndex::Record to_record(const AppIndex::Entry &entry) {
+    AppIndex::Record record;
+    for (size_t i = 0; i < APP_STRING_COUNT; i++)
+        record.*RECORD_STRINGS[i] = std::string(entry.*ENTRY_STRINGS[i]);
+    record.modified = entry.modified;
+    if (entry.icon)
+        record.icon.assign(entry.icon, entry.icon + AppIndex::ICON_BYTES);
+    return record;
+}
+
+AppIndex::AppIndex(const fs::path &file)
+    : file_path(file) {
+}
+
+AppIndex::~AppIndex() {
+    unmap();
+}
+
+bool AppIndex::open(const uint32_t sys_lang) {
+    if (!map())
+        return false;
+
+    if (lang != sys_lang) {
+        LOG_INFO("App index was built for language {}, rebuilding it for {}", lang, sys_lang);
+        unmap();
+        return false;
+    }
+
+    return true;
+}
+
+void AppIndex::close() {
+    unmap();
+}
+
+bool AppIndex::map() {
+    unmap();
+
+#ifdef WIN32
+    file_handle = CreateFileW(file_path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        file_handle = nullptr;
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size) || (file_size.QuadPart < static_cast<LONGLONG>(sizeof(AppIndexHeader)))) {
+        unmap();
+        return false;
+    }
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_handle) {
+        unmap();
+        return false;
+    }
+    data = static_cast<const uint8_t *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    size = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int fd = ::open(file_path.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat file_stat;
+    if ((fstat(fd, &file_stat) < 0) || (file_stat.st_size < static_cast<off_t>(sizeof(AppIndexHeader)))) {
+        ::close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    data = (mapped == MAP_FAILED) ? nullptr : static_cast<const uint8_t *>(mapped);
+    size = static_cast<size_t>(file_stat.st_size);
+#endif
+    if (!data) {
+        unmap();
+        return false;
+    }
+
+    AppIndexHeader header;
+    memcpy(&header, data, sizeof(header));
+    if ((header.magic != APP_INDEX_MAGIC) || (header.version != APP_INDEX_VERSION)) {
+        LOG_WARN("App index at {} is from another version, rebuilding it", file_path.string());
+        unmap();
+        return false;
+    }
+    lang = header.sys_lang;
+
+    size_t pos = sizeof(header);
+    while (pos + sizeof(AppIndexRecord) <= size) {
+        AppIndexRecord record;
+        memcpy(&record, data + pos, sizeof(record));
+        // Stops at a record cut short by a crash, the next write goes over it
+        if ((record.magic != APP_RECORD_MAGIC) || (record.size < sizeof(record)) || (record.size > size - pos))
+            break;
+
+        size_t strings_size = 0;
+        for (const auto string_size : record.string_sizes)
+            strings_size += string_size;
+        const bool has_icon = record.icon_offset != 0;
+        if ((sizeof(record) + strings_size > record.size) || (has_icon && (record.icon_offset + ICON_BYTES > record.size)))
+            break;
+
+        if (record.flags & APP_RECORD_REMOVED) {
+            removed_size += record.size;
+        } else {
+            Entry entry;
+            const char *str = reinterpret_cast<const char *>(data + pos + sizeof(record));
+            for (size_t i = 0; i < APP_STRING_COUNT; i++) {
+                entry.*ENTRY_STRINGS[i] = std::string_view(str, record.string_sizes[i]);
+                str += record.string_sizes[i];
+            }
+            entry.modified = record.modified;
+            entry.icon = has_icon ? data + pos + record.icon_offset : nullptr;
+            entry.offset = pos;
+            mapped_entries.push_back(entry);
+        }
+        pos += record.size;
+    }
+    valid_size = pos;
+
+    return true;
+}
+
+void AppIndex::unmap() {
+    mapped_entries.clear();
+    removed_size = 0;
+    valid_size = 0;
+#ifdef WIN32
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping_handle)
+        CloseHandle(mapping_handle);
+    if (file_handle)
+        CloseHandle(file_handle);
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+#else
+    if (data)
+        munmap(const_cast<uint8_t *>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+bool AppIndex::rebuild(const uint32_t sys_lang, const std::vector<Record> &records) {
+    unmap();
+
+    boost::system::error_code error;
+    fs::create_directories(file_path.parent_path(), error);
+
+    // Written aside then renamed, a crash leaves the previous index intact
+    fs::path temp_path = file_path;
+    temp_path += ".tmp";
+    FILE *file = open_index_file(temp_path, "wb");
+    if (!file) {
+        LOG_ERROR("Failed to create app index at {}", temp_path.string());
+        return false;
+    }
+
+    const AppIndexHeader header{ APP_INDEX_MAGIC, APP_INDEX_VERSION, sys_lang, 0 };
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const auto &record : records) {
+        const auto buffer = serialize(record);
+        written = written && (fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+    }
+    written = (fclose(file) == 0) && written;
+
+    if (written)
+        fs::rename(temp_path, file_path, error);
+    if (!written || error) {
+        LOG_ERROR("Failed to write app index at {}", file_path.string());
+        fs::remove(temp_path, error);
+        return false;
+    }
+
+    lang = sys_lang;
+    return map();
+}
+
+bool AppIndex::put(const Record &record) {
+    if (!data)
+        return false;
+
+    const auto existing = std::find_if(mapped_entries.begin(), mapped_entries.end(), [&](const Entry &entry) { return entry.path == record.path; });
+    const auto existing_offset = (existing != mapped_entries.end()) ? existing->offset : 0;
+    const auto append_offset = valid_size;
+
+    unmap();
+    // Flagged first, a crash in between loses the title until its directory is seen again, never duplicates it
+    const bool updated = (!existing_offset || flag_removed(existing_offset)) && append(record, append_offset);
+    if (!map() || !updated)
+        return false;
+
+    return compact();
+}
+
+bool AppIndex::remove(const std::string &path) {
+    if (!data)
+        return false;
+
+    const auto existing = std::find_if(mapped_entries.begin(), mapped_entries.end(), [&](const Entry &entry) { return entry.path == path; });
+    if (existing == mapped_entries.end())
+        return false;
+    const auto offset = existing->offset;
+
+    unmap();
+    const bool removed = flag_removed(offset);
+    if (!map() || !removed)
+        return false;
+
+    return compact();
+}
+
+bool AppIndex::append(const Record &record, const uint64_t offset) {
+    // Anything past the last whole record is what is left of an interrupted append
+    boost::system::error_code error;
+    fs::resize_file(file_path, offset, error);
+    if (error)
+        return false;
+
+    FILE *file = open_index_file(file_path, "ab");
+    if (!file)
+        return false;
+
+    const auto buffer = serialize(record);
+    const bool written = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    return (fclose(file) == 0) && written;
+}
+
+bool AppIndex::flag_removed(const uint64_t offset) {
+    FILE *file = open_index_file(file_path, "rb+");
+    if (!file)
+        return false;
+
+    const uint32_t flags = APP_RECORD_REMOVED;
+    const bool written = (fseek(file, static_cast<long>(offset + offsetof(AppIndexRecord, flags)), SEEK_SET) == 0) && (fwrite(&flags, sizeof(flags), 1, file) == 1);
+    return (fclose(file) == 0) && written;
+}
+
+bool AppIndex::compact() {
+    if (removed_size * 2 < size)
+        return true;
+
+    std::vector<Record> records;
+    records.reserve(mapped_entries.size());
+    for (const auto &entry : mapped_entries)
+        records.push_back(to_record(entry));
+
+    return rebuild(lang, records);
+}
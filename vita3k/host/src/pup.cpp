@@ -18,11 +18,14 @@
 #include <crypto/aes.h>
 #include <host/sce_types.h>
 #include <util/fs.h>
+#include <threads/thread_pool.h>
 #include <util/string_utils.h>
 
 #include <fmt/xchar.h>
 
+#include <atomic>
 #include <fstream>
+#include <future>
 
 // Credits to TeamMolecule for their original work on this https://github.com/TeamMolecule/sceutils
 
@@ -170,20 +173,10 @@ static void decrypt_segments(std::ifstream &infile, const std::wstring &outdir,
     for (const auto &sceseg : scesegs) {
         fs::ofstream outfile(fmt::format(L"{}/{}.seg02", outdir, filename), std::ios::binary);
         infile.seekg(sceseg.offset);
-        std::vector<unsigned char> encrypted_data(sceseg.size);
+        std::vector<uint8_t> encrypted_data(sceseg.size);
         infile.read((char *)&encrypted_data[0], sceseg.size);
-        aes_context aes_ctx;
-        aes_setkey_enc(&aes_ctx, (unsigned char *)sceseg.key.c_str(), 128);
-        size_t ctr_nc_off = 0;
-        unsigned char ctr_stream_block[0x10];
-        std::vector<unsigned char> decrypted_data(sceseg.size);
-        aes_crypt_ctr(&aes_ctx, sceseg.size, &ctr_nc_off, (unsigned char *)sceseg.iv.c_str(), ctr_stream_block, &encrypted_data[0], &decrypted_data[0]);
-        if (sceseg.compressed) {
-            const std::string decompressed_data = decompress_segments(decrypted_data, sceseg.size);
-            outfile.write(decompressed_data.c_str(), decompressed_data.size());
-        } else {
-            outfile.write((char *)&decrypted_data[0], sceseg.size);
-        }
+        const std::vector<uint8_t> data = decode_segment(sceseg, std::move(encrypted_data), true);
+        outfile.write((const char *)data.data(), data.size());
         outfile.close();
     }
 };
@@ -211,7 +204,7 @@ static void join_files(const std::wstring &path, const std::string &filename, co
     fileout.close();
 }
 
-static void decrypt_pup_packages(const std::wstring &src, const std::wstring &dest, KeyStore &SCE_KEYS) {
+static void decrypt_pup_packages(const std::wstring &src, const std::wstring &dest, KeyStore &SCE_KEYS, ThreadPool &pool) {
     std::vector<std::wstring> pkgfiles;
 
     for (const auto &p : fs::directory_iterator(src)) {
@@ -219,12 +212,18 @@ static void decrypt_pup_packages(const std::wstring &src, const std::wstring &de
             pkgfiles.push_back(p.path().filename().generic_wstring());
     }
 
+    // Every package decrypts into its own output file, so they can all be processed at once
+    std::vector<std::future<void>> pending;
     for (const auto &filename : pkgfiles) {
-        const std::wstring &filepath = fmt::format(L"{}/{}", src, filename);
-        fs::ifstream infile(filepath, std::ios::binary);
-        decrypt_segments(infile, dest, filename, SCE_KEYS);
-        infile.close();
+        pending.push_back(pool.submit([&src, &dest, &SCE_KEYS, filename]() {
+            const std::wstring &filepath = fmt::format(L"{}/{}", src, filename);
+            fs::ifstream infile(filepath, std::ios::binary);
+            decrypt_segments(infile, dest, filename, SCE_KEYS);
+            infile.close();
+        }));
     }
+    for (auto &package : pending)
+        pool.wait(package);
 
     join_files(dest, "os0-", dest + L"/os0.img");
     join_files(dest, "pd0-", dest + L"/pd0.img");
@@ -232,6 +231,12 @@ static void decrypt_pup_packages(const std::wstring &src, const std::wstring &de
     join_files(dest, "sa0-", dest + L"/sa0.img");
 }
 
+static bool is_self_to_convert(const fs::path &path, bool include_eboot) {
+    const auto extension = path.filename().extension();
+    const auto is_self = ((extension == ".suprx") || (extension == ".skprx") || (extension == ".self"));
+    return is_self || (include_eboot && (path.filename() == "eboot.bin"));
+}
+
 void install_pup(const std::wstring &pref_path, const std::string &pup_path, const std::function<void(uint32_t)> &progress_callback) {
     if (fs::exists(pref_path + L"/PUP_DEC")) {
         LOG_WARN("Path already exists, deleting it and reinstalling");
@@ -254,60 +259,61 @@ void install_pup(const std::wstring &pref_path, const std::string &pup_path, con
     register_keys(SCE_KEYS, 0);
 
     progress_callback(30);
-    decrypt_pup_packages(pup_dest, pup_dec, SCE_KEYS);
+    ThreadPool pool;
+    decrypt_pup_packages(pup_dest, pup_dec, SCE_KEYS, pool);
+
+    progress_callback(60);
+    // The partition images are independent, so extract them concurrently
+    struct Partition {
+        std::string image;
+        bool convert_selfs;
+        bool include_eboot;
+    };
+    const std::vector<Partition> partitions = {
+        { "os0.img", true, false },
+        { "pd0.img", true, true },
+        { "sa0.img", false, false },
+        { "vs0.img", true, true },
+    };
+    std::vector<std::future<void>> extractions;
+    std::vector<std::string> extracted;
+    for (const auto &partition : partitions) {
+        if (fs::file_size(pup_dec + L"/" + string_utils::utf_to_wide(partition.image)) > 0) {
+            extractions.push_back(pool.submit([&, image = partition.image]() {
+                extract_fat(pup_dec, image, pref_path);
+            }));
+            extracted.push_back(partition.image);
+        }
+    }
+    for (auto &extraction : extractions)
+        pool.wait(extraction);
 
     progress_callback(70);
-    if (fs::file_size(pup_dec + L"/os0.img") > 0) {
-        extract_fat(pup_dec, "os0.img", pref_path);
-        for (const auto &file : fs::recursive_directory_iterator(pref_path + L"/os0")) {
-            if (fs::is_regular_file(file.path())) {
-                const auto filePathString = file.path().string();
-                const auto extension = file.path().filename().extension();
-                const auto is_self = ((extension == ".suprx") || (extension == ".skprx") || (extension == ".self"));
-                if (is_self) {
-                    self2elf(filePathString, filePathString + "elf", SCE_KEYS, 0);
-                    fs::rename(filePathString + "elf", filePathString);
-                    make_fself(filePathString, filePathString + "fself");
-                    fs::rename(filePathString + "fself", filePathString);
-                }
-            }
+    std::vector<std::string> selfs;
+    for (const auto &partition : partitions) {
+        if (!partition.convert_selfs || std::find(extracted.begin(), extracted.end(), partition.image) == extracted.end())
+            continue;
+        for (const auto &file : fs::recursive_directory_iterator(pref_path + string_utils::utf_to_wide(partition.image.substr(0, 3)))) {
+            if (fs::is_regular_file(file.path()) && is_self_to_convert(file.path(), partition.include_eboot))
+                selfs.push_back(file.path().string());
         }
     }
-    if (fs::file_size(pup_dec + L"/pd0.img") > 0) {
-        LOG_DEBUG("Extract fat");
-        extract_fat(pup_dec, "pd0.img", pref_path);
-        for (const auto &file : fs::recursive_directory_iterator(pref_path + L"/pd0")) {
-            if (fs::is_regular_file(file.path())) {
-                const auto filePathString = file.path().string();
-                LOG_DEBUG("file: {}", file.path().string());
-                const auto extension = file.path().filename().extension();
-                const auto is_self = ((extension == ".suprx") || (extension == ".skprx") || (extension == ".self"));
-                if ((file.path().filename() == "eboot.bin") || is_self) {
-                    self2elf(filePathString, filePathString + "elf", SCE_KEYS, 0);
-                    fs::rename(filePathString + "elf", filePathString);
-                    make_fself(filePathString, filePathString + "fself");
-                    fs::rename(filePathString + "fself", filePathString);
-                }
-            }
-        }
+
+    // Each module is converted on its own task, and self2elf fans its segments out on the same pool
+    std::atomic<uint32_t> converted{ 0 };
+    std::vector<std::future<void>> conversions;
+    for (const auto &self : selfs) {
+        conversions.push_back(pool.submit([&, self]() {
+            self2elf(self, self + "elf", SCE_KEYS, 0, &pool);
+            fs::rename(self + "elf", self);
+            make_fself(self, self + "fself");
+            fs::rename(self + "fself", self);
+            converted++;
+        }));
     }
-    if (fs::file_size(pup_dec + L"/sa0.img") > 0)
-        extract_fat(pup_dec, "sa0.img", pref_path);
-    if (fs::file_size(pup_dec + L"/vs0.img") > 0) {
-        extract_fat(pup_dec, "vs0.img", pref_path);
-        for (const auto &file : fs::recursive_directory_iterator(pref_path + L"/vs0")) {
-            if (fs::is_regular_file(file.path())) {
-                const auto filePathString = file.path().string();
-                const auto extension = file.path().filename().extension();
-                const auto is_self = ((extension == ".suprx") || (extension == ".skprx") || (extension == ".self"));
-                if ((file.path().filename() == "eboot.bin") || is_self) {
-                    self2elf(filePathString, filePathString + "elf", SCE_KEYS, 0);
-                    fs::rename(filePathString + "elf", filePathString);
-                    make_fself(filePathString, filePathString + "fself");
-                    fs::rename(filePathString + "fself", filePathString);
-                }
-            }
-        }
+    for (auto &conversion : conversions) {
+        pool.wait(conversion);
+        progress_callback(70 + (30 * converted) / static_cast<uint32_t>(selfs.size()));
     }
     progress_callback(100);
 }
@@ -19,11 +19,13 @@
 #include <fat16/fat16.h>
 #include <host/sce_types.h>
 #include <miniz.h>
+#include <threads/thread_pool.h>
 #include <util/string_utils.h>
 
 #include <self.h>
 
 #include <fstream>
+#include <future>
 
 // Credits to TeamMolecule for their original work on this https://github.com/TeamMolecule/sceutils
 
@@ -717,7 +719,27 @@ std::string decompress_segments(const std::vector<uint8_t> &decrypted_data, cons
     return decompressed_data;
 }
 
-void self2elf(const std::string &infile, const std::string &outfile, KeyStore &SCE_KEYS, unsigned char *klictxt) {
+std::vector<uint8_t> decode_segment(const SceSegment &seg, std::vector<uint8_t> data, bool encrypted) {
+    if (encrypted) {
+        std::vector<uint8_t> decrypted_data(data.size());
+        aes_context aes_ctx;
+        aes_setkey_enc(&aes_ctx, (unsigned char *)seg.key.c_str(), 128);
+        size_t ctr_nc_off = 0;
+        unsigned char ctr_stream_block[0x10];
+        std::string iv = seg.iv;
+        aes_crypt_ctr(&aes_ctx, data.size(), &ctr_nc_off, (unsigned char *)iv.data(), ctr_stream_block, data.data(), decrypted_data.data());
+        data = std::move(decrypted_data);
+    }
+
+    if (seg.compressed) {
+        const std::string decompressed_data = decompress_segments(data, data.size());
+        return std::vector<uint8_t>(decompressed_data.begin(), decompressed_data.end());
+    }
+
+    return data;
+}
+
+void self2elf(const std::string &infile, const std::string &outfile, KeyStore &SCE_KEYS, unsigned char *klictxt, ThreadPool *pool) {
     std::ifstream filein(infile, std::ios::binary);
     std::ofstream fileout(outfile, std::ios::binary);
 
@@ -808,13 +830,35 @@ void self2elf(const std::string &infile, const std::string &outfile, KeyStore &S
         scesegs = get_segments(filein, sce_hdr, SCE_KEYS, appinfo_hdr.sys_version, appinfo_hdr.self_type, npdrmtype, klictxt);
     }
 
+    // Reading stays sequential, but decryption and inflation of each segment are independent
+    // and run as separate tasks. Results are written back in program header order.
+    std::vector<std::future<std::vector<uint8_t>>> segments(elf_hdr.e_phnum);
     for (uint16_t i = 0; i < elf_hdr.e_phnum; i++) {
-        int idx = 0;
+        const int idx = scesegs.empty() ? i : scesegs[i].idx;
+        if (elf_phdrs[idx].p_filesz == 0)
+            continue;
 
-        if (!scesegs.empty())
-            idx = scesegs[i].idx;
+        std::vector<uint8_t> dat(segment_infos[idx].size);
+        filein.seekg(segment_infos[idx].offset);
+        filein.read((char *)dat.data(), segment_infos[idx].size);
+
+        const bool is_encrypted = segment_infos[idx].plaintext == SecureBool::NO;
+        const bool is_compressed = segment_infos[idx].compressed == SecureBool::YES;
+        SceSegment seg = is_encrypted ? scesegs[i] : SceSegment{ segment_infos[idx].offset, idx, segment_infos[idx].size, is_compressed, "", "" };
+        seg.compressed = is_compressed;
+
+        auto task = [seg = std::move(seg), dat = std::move(dat), is_encrypted]() mutable {
+            return decode_segment(seg, std::move(dat), is_encrypted);
+        };
+        if (pool)
+            segments[i] = pool->submit(std::move(task));
         else
-            idx = i;
+            segments[i] = std::async(std::launch::deferred, std::move(task));
+    }
+    filein.close();
+
+    for (uint16_t i = 0; i < elf_hdr.e_phnum; i++) {
+        const int idx = scesegs.empty() ? i : scesegs[i].idx;
         if (elf_phdrs[idx].p_filesz == 0)
             continue;
 
@@ -822,39 +866,16 @@ void self2elf(const std::string &infile, const std::string &outfile, KeyStore &S
         if (pad_len < 0)
             LOG_ERROR("ELF p_offset Invalid");
 
-        std::vector<char> padding;
-        for (int i = 0; i < pad_len; i++) {
-            padding.push_back('\0');
-        }
-
-        fileout.write(padding.data(), pad_len);
-
-        at += pad_len;
-
-        filein.seekg(segment_infos[idx].offset);
-        std::vector<unsigned char> dat(segment_infos[idx].size);
-        filein.read((char *)&dat[0], segment_infos[idx].size);
-
-        std::vector<unsigned char> decrypted_data(segment_infos[idx].size);
-        if (segment_infos[idx].plaintext == SecureBool::NO) {
-            aes_context aes_ctx;
-            aes_setkey_enc(&aes_ctx, (unsigned char *)scesegs[i].key.c_str(), 128);
-            size_t ctr_nc_off = 0;
-            unsigned char ctr_stream_block[0x10];
-            aes_crypt_ctr(&aes_ctx, segment_infos[idx].size, &ctr_nc_off, (unsigned char *)scesegs[i].iv.c_str(), ctr_stream_block, &dat[0], &decrypted_data[0]);
+        if (pad_len > 0) {
+            const std::vector<char> padding(pad_len, '\0');
+            fileout.write(padding.data(), pad_len);
+            at += pad_len;
         }
 
-        if (segment_infos[idx].compressed == SecureBool::YES) {
-            const std::string decompressed_data = decompress_segments(decrypted_data, segment_infos[idx].size);
-            segment_infos[idx].compressed = SecureBool::NO;
-            fileout.write(decompressed_data.c_str(), decompressed_data.length());
-            at += decompressed_data.length();
-        } else {
-            fileout.write((char *)&decrypted_data[0], segment_infos[idx].size);
-            at += segment_infos[idx].size;
-        }
+        const std::vector<uint8_t> data = pool ? pool->wait(segments[i]) : segments[i].get();
+        fileout.write((const char *)data.data(), data.size());
+        at += data.size();
     }
-    filein.close();
     fileout.close();
 }
 
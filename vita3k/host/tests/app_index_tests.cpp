@@ -0,0 +1,186 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <host/app_index.h>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+
+namespace {
+
+struct AppIndexTest : public testing::Test {
+    fs::path dir;
+    fs::path index_path;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() / fs::unique_path("app-index-%%%%-%%%%");
+        fs::create_directories(dir);
+        index_path = dir / "app_index.dat";
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+};
+
+AppIndex::Record make_record(const std::string &title_id, bool with_icon = true) {
+    AppIndex::Record record;
+    record.app_ver = "1.00";
+    record.category = "gd";
+    record.content_id = "EP0000-" + title_id + "_00-0000000000000000";
+    record.addcont = record.savedata = record.title_id = record.path = title_id;
+    record.parental_level = "1";
+    record.stitle = "Game " + title_id;
+    record.title = "The Game " + title_id;
+    record.modified = 1234567890;
+    if (with_icon)
+        record.icon.assign(AppIndex::ICON_BYTES, static_cast<uint8_t>(title_id.back()));
+    return record;
+}
+
+} // namespace
+
+TEST_F(AppIndexTest, round_trip) {
+    {
+        AppIndex index(index_path);
+        ASSERT_TRUE(index.rebuild(1, { make_record("PCSE00001"), make_record("PCSE00002", false) }));
+    }
+
+    AppIndex index(index_path);
+    ASSERT_TRUE(index.open(1));
+    ASSERT_EQ(index.entries().size(), 2u);
+
+    const auto &first = index.entries()[0];
+    EXPECT_EQ(first.path, "PCSE00001");
+    EXPECT_EQ(first.title, "The Game PCSE00001");
+    EXPECT_EQ(first.content_id, "EP0000-PCSE00001_00-0000000000000000");
+    EXPECT_EQ(first.modified, 1234567890);
+    ASSERT_NE(first.icon, nullptr);
+    EXPECT_EQ(first.icon[0], '1');
+    EXPECT_EQ(first.icon[AppIndex::ICON_BYTES - 1], '1');
+    EXPECT_EQ(index.entries()[1].icon, nullptr);
+}
+
+TEST_F(AppIndexTest, rejects_other_language_and_garbage) {
+    AppIndex index(index_path);
+    EXPECT_FALSE(index.open(1));
+
+    ASSERT_TRUE(index.rebuild(1, { make_record("PCSE00001") }));
+    EXPECT_FALSE(index.open(2));
+
+    std::ofstream(index_path.string(), std::ios::binary) << "not an app index at all";
+    EXPECT_FALSE(index.open(1));
+}
+
+TEST_F(AppIndexTest, incremental_updates) {
+    AppIndex index(index_path);
+    ASSERT_TRUE(index.rebuild(1, { make_record("PCSE00001"), make_record("PCSE00002") }));
+
+    auto updated = make_record("PCSE00002");
+    updated.app_ver = "1.01";
+    ASSERT_TRUE(index.put(updated));
+    ASSERT_TRUE(index.put(make_record("PCSE00003")));
+    ASSERT_TRUE(index.remove("PCSE00001"));
+    EXPECT_FALSE(index.remove("PCSE00001"));
+
+    AppIndex reopened(index_path);
+    ASSERT_TRUE(reopened.open(1));
+    ASSERT_EQ(reopened.entries().size(), 2u);
+    EXPECT_EQ(reopened.entries()[0].path, "PCSE00002");
+    EXPECT_EQ(reopened.entries()[0].app_ver, "1.01");
+    EXPECT_EQ(reopened.entries()[1].path, "PCSE00003");
+}
+
+TEST_F(AppIndexTest, survives_interrupted_append) {
+    AppIndex index(index_path);
+    ASSERT_TRUE(index.rebuild(1, { make_record("PCSE00001") }));
+    index.close();
+
+    // Start of a record that never got finished
+    {
+        std::ofstream file(index_path.string(), std::ios::binary | std::ios::app);
+        const uint32_t magic = 0x43455241;
+        file.write(reinterpret_cast<const char *>(&magic), sizeof(magic));
+        file << "cut";
+    }
+
+    ASSERT_TRUE(index.open(1));
+    ASSERT_EQ(index.entries().size(), 1u);
+    ASSERT_TRUE(index.put(make_record("PCSE00002")));
+
+    AppIndex reopened(index_path);
+    ASSERT_TRUE(reopened.open(1));
+    ASSERT_EQ(reopened.entries().size(), 2u);
+    EXPECT_EQ(reopened.entries()[1].path, "PCSE00002");
+}
+
+TEST_F(AppIndexTest, compacts_removed_records) {
+    AppIndex index(index_path);
+    ASSERT_TRUE(index.rebuild(1, { make_record("PCSE00001"), make_record("PCSE00002") }));
+    const auto initial_size = fs::file_size(index_path);
+
+    for (int i = 0; i < 10; i++)
+        ASSERT_TRUE(index.put(make_record("PCSE00002")));
+
+    EXPECT_LE(fs::file_size(index_path), initial_size * 2);
+    ASSERT_EQ(index.entries().size(), 2u);
+}
+
+// Cold start of a 1000 title library: map the index and check every title directory for changes.
+// The time it takes and the index size are recorded as test properties, see --gtest_output=xml.
+TEST_F(AppIndexTest, cold_start_of_a_large_library) {
+    constexpr int TITLE_COUNT = 1000;
+    const auto app_path = dir / "ux0/app";
+
+    std::vector<AppIndex::Record> records;
+    for (int i = 0; i < TITLE_COUNT; i++) {
+        const auto title_id = fmt::format("PCSE{:05}", i);
+        fs::create_directories(app_path / title_id / "sce_sys");
+        auto record = make_record(title_id);
+        record.modified = fs::last_write_time(app_path / title_id);
+        records.push_back(std::move(record));
+    }
+    {
+        AppIndex index(index_path);
+        ASSERT_TRUE(index.rebuild(1, records));
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    AppIndex index(index_path);
+    ASSERT_TRUE(index.open(1));
+    int changed = 0;
+    uint64_t icon_sum = 0;
+    for (const auto &entry : index.entries()) {
+        boost::system::error_code error;
+        if (fs::last_write_time(app_path / std::string(entry.path), error) != entry.modified)
+            changed++;
+        icon_sum += entry.icon[0];
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    RecordProperty("cold_start_us", static_cast<int>(elapsed));
+    RecordProperty("index_kib", static_cast<int>(fs::file_size(index_path) / 1024));
+
+    EXPECT_EQ(index.entries().size(), static_cast<size_t>(TITLE_COUNT));
+    EXPECT_EQ(changed, 0);
+    EXPECT_GT(icon_sum, 0u);
+}
@@ -0,0 +1,145 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <host/sce_types.h>
+#include <threads/thread_pool.h>
+#include <util/fs.h>
+
+#include <gtest/gtest.h>
+#include <miniz.h>
+
+#include <fstream>
+
+namespace {
+
+constexpr uint16_t SEGMENT_COUNT = 8;
+constexpr uint32_t SEGMENT_SIZE = 4 * 1024 * 1024;
+constexpr uint32_t ELF_DATA_OFFSET = 0x1000;
+
+template <typename T>
+void put(std::vector<char> &buf, size_t offset, T value) {
+    memcpy(&buf[offset], &value, sizeof(T));
+}
+
+// Deterministic, mildly compressible payload so inflation has real work to do.
+std::vector<uint8_t> make_segment_data(uint32_t seed) {
+    std::vector<uint8_t> data(SEGMENT_SIZE);
+    uint32_t state = seed * 2654435761u + 1;
+    for (uint32_t i = 0; i < SEGMENT_SIZE; i++) {
+        state = state * 1103515245u + 12345u;
+        data[i] = static_cast<uint8_t>((state >> 16) & 0x3F);
+    }
+    return data;
+}
+
+// Builds a plaintext SELF with deflated segments, and the ELF self2elf is expected to produce from it.
+void build_self(const fs::path &self_path, std::vector<char> &expected_elf) {
+    std::vector<std::vector<uint8_t>> segments;
+    std::vector<std::vector<uint8_t>> compressed;
+    for (uint16_t i = 0; i < SEGMENT_COUNT; i++) {
+        segments.push_back(make_segment_data(i));
+        mz_ulong compressed_size = mz_compressBound(SEGMENT_SIZE);
+        std::vector<uint8_t> out(compressed_size);
+        ASSERT_EQ(mz_compress(out.data(), &compressed_size, segments.back().data(), SEGMENT_SIZE), MZ_OK);
+        out.resize(compressed_size);
+        compressed.push_back(std::move(out));
+    }
+
+    constexpr size_t self_hdr_offset = SceHeader::Size;
+    constexpr size_t appinfo_offset = self_hdr_offset + SelfHeader::Size;
+    constexpr size_t elf_offset = appinfo_offset + AppInfoHeader::Size;
+    constexpr size_t phdr_offset = elf_offset + ElfHeader::Size;
+    constexpr size_t segment_info_offset = phdr_offset + SEGMENT_COUNT * ElfPhdr::Size;
+    constexpr size_t sceversion_offset = segment_info_offset + SEGMENT_COUNT * SegmentInfo::Size;
+    constexpr size_t controlinfo_offset = sceversion_offset + SceVersionInfo::Size;
+    constexpr size_t data_offset = controlinfo_offset + 2 * SceControlInfo::Size;
+
+    std::vector<char> self(data_offset);
+    put<uint32_t>(self, 0, SCE_MAGIC);
+    put<uint32_t>(self, 4, 3);
+    put<uint16_t>(self, 10, static_cast<uint16_t>(SceType::SELF));
+    put<uint64_t>(self, 16, data_offset);
+
+    put<uint64_t>(self, self_hdr_offset + 24, appinfo_offset);
+    put<uint64_t>(self, self_hdr_offset + 32, elf_offset);
+    put<uint64_t>(self, self_hdr_offset + 40, phdr_offset);
+    put<uint64_t>(self, self_hdr_offset + 56, segment_info_offset);
+    put<uint64_t>(self, self_hdr_offset + 64, sceversion_offset);
+    put<uint64_t>(self, self_hdr_offset + 72, controlinfo_offset);
+
+    put<uint32_t>(self, controlinfo_offset, static_cast<uint32_t>(ControlType::CONTROL_FLAGS));
+    put<uint32_t>(self, controlinfo_offset + SceControlInfo::Size, static_cast<uint32_t>(ControlType::CONTROL_FLAGS));
+
+    put<uint32_t>(self, elf_offset, 0x464C457F);
+    put<uint16_t>(self, elf_offset + 44, SEGMENT_COUNT);
+
+    expected_elf.assign(ELF_DATA_OFFSET + SEGMENT_COUNT * SEGMENT_SIZE, 0);
+    memcpy(&expected_elf[0], &self[elf_offset], ElfHeader::Size);
+
+    uint64_t payload_offset = data_offset;
+    for (uint16_t i = 0; i < SEGMENT_COUNT; i++) {
+        const uint32_t p_offset = ELF_DATA_OFFSET + i * SEGMENT_SIZE;
+        const size_t phdr = phdr_offset + i * ElfPhdr::Size;
+        put<uint32_t>(self, phdr, 1);
+        put<uint32_t>(self, phdr + 4, p_offset);
+        put<uint32_t>(self, phdr + 16, SEGMENT_SIZE);
+        put<uint32_t>(self, phdr + 20, SEGMENT_SIZE);
+        memcpy(&expected_elf[ElfHeader::Size + i * ElfPhdr::Size], &self[phdr], ElfPhdr::Size);
+
+        const size_t info = segment_info_offset + i * SegmentInfo::Size;
+        put<uint64_t>(self, info, payload_offset);
+        put<uint64_t>(self, info + 8, compressed[i].size());
+        put<uint32_t>(self, info + 16, static_cast<uint32_t>(SecureBool::YES));
+        put<uint32_t>(self, info + 24, static_cast<uint32_t>(SecureBool::YES));
+        payload_offset += compressed[i].size();
+
+        memcpy(&expected_elf[p_offset], segments[i].data(), SEGMENT_SIZE);
+    }
+
+    std::ofstream out(self_path.string(), std::ios::binary);
+    out.write(self.data(), self.size());
+    for (const auto &payload : compressed)
+        out.write(reinterpret_cast<const char *>(payload.data()), payload.size());
+}
+
+std::vector<char> read_file(const fs::path &path) {
+    std::ifstream in(path.string(), std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+TEST(self2elf, parallel_segments_match_serial_output) {
+    const fs::path dir = fs::temp_directory_path() / fs::unique_path("vita3k-self2elf-%%%%-%%%%");
+    fs::create_directories(dir);
+    const fs::path self_path = dir / "synthetic.self";
+
+    std::vector<char> expected_elf;
+    build_self(self_path, expected_elf);
+
+    KeyStore keys;
+
+    self2elf(self_path.string(), (dir / "serial.elf").string(), keys, nullptr);
+
+    ThreadPool pool;
+    self2elf(self_path.string(), (dir / "parallel.elf").string(), keys, nullptr, &pool);
+
+    EXPECT_EQ(read_file(dir / "serial.elf"), expected_elf);
+    EXPECT_EQ(read_file(dir / "parallel.elf"), expected_elf);
+
+    fs::remove_all(dir);
+}
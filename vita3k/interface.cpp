@@ -28,6 +28,7 @@
 #include <kernel/load_self.h>
 
 #include <modules/module_parent.h>
+#include <rtc/rtc.h>
 #include <touch/functions.h>
 #include <touch/touch.h>
 #include <util/find.h>
@@ -139,18 +140,23 @@ bool install_archive_content(HostState &host, GuiState *gui, const fs::path &arc
             fs::remove_all(output_path);
         } else if (!gui->file_menu.archive_install_dialog) {
             gui::GenericDialogState status = gui::UNK_STATE;
+            // The null backend has no GL context to draw into
+            const bool has_gl_context = host.renderer->current_backend != renderer::Backend::Null;
 
             while (handle_events(host, *gui) && (status == gui::UNK_STATE)) {
                 ImGui_ImplSdl_NewFrame(gui->imgui_state.get());
-                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                if (has_gl_context)
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
                 gui::draw_ui(*gui, host);
                 ImGui::PushFont(gui->vita_font);
                 gui::draw_reinstall_dialog(&status, host);
                 ImGui::PopFont();
-                glViewport(0, 0, static_cast<int>(ImGui::GetIO().DisplaySize.x), static_cast<int>(ImGui::GetIO().DisplaySize.y));
+                if (has_gl_context)
+                    glViewport(0, 0, static_cast<int>(ImGui::GetIO().DisplaySize.x), static_cast<int>(ImGui::GetIO().DisplaySize.y));
                 ImGui::Render();
                 ImGui_ImplSdl_RenderDrawData(gui->imgui_state.get());
-                SDL_GL_SwapWindow(host.window.get());
+                if (has_gl_context)
+                    SDL_GL_SwapWindow(host.window.get());
             }
             switch (status) {
             case gui::CANCEL_STATE:
@@ -229,7 +235,7 @@ bool install_archive_content(HostState &host, GuiState *gui, const fs::path &arc
         gui::update_notice_info(*gui, host, "content");
         if ((host.app_category.find("gd") != std::string::npos) || (host.app_category.find("gp") != std::string::npos)) {
             gui::init_user_app(*gui, host, host.app_title_id);
-            gui::save_apps_cache(*gui, host);
+            gui::update_apps_cache(*gui, host, host.app_title_id);
         }
     }
 
@@ -417,7 +423,7 @@ static bool install_content(HostState &host, GuiState *gui, const fs::path &cont
 
     if ((host.app_category.find("gd") != std::string::npos) || (host.app_category.find("gp") != std::string::npos)) {
         gui::init_user_app(*gui, host, host.app_title_id);
-        gui::save_apps_cache(*gui, host);
+        gui::update_apps_cache(*gui, host, host.app_title_id);
     }
 
     if (host.app_category != "theme")
@@ -446,32 +452,38 @@ uint32_t install_contents(HostState &host, GuiState *gui, const fs::path &path)
 }
 
 static auto pre_load_module(HostState &host, const std::vector<std::string> &lib_load_list, const VitaIoDevice &device) {
-    for (const auto &module_path : lib_load_list) {
-        vfs::FileBuffer module_buffer;
-        Ptr<const void> lib_entry_point;
+    std::vector<vfs::FileBuffer> module_buffers(lib_load_list.size());
+    std::vector<SelfToLoad> selfs;
+    bool missing = false;
+    for (size_t i = 0; i < lib_load_list.size(); i++) {
+        const auto &module_path = lib_load_list[i];
         bool res;
-        const auto MODULE_PATH_ABS = fmt::format("{}:{}", device._to_string(), module_path);
 
         if (device == VitaIoDevice::app0)
-            res = vfs::read_app_file(module_buffer, host.pref_path, host.io.app_path, module_path);
+            res = vfs::read_app_file(module_buffers[i], host.pref_path, host.io.app_path, module_path);
         else
-            res = vfs::read_file(device, module_buffer, host.pref_path, module_path);
-
-        if (res) {
-            SceUID module_id = load_self(lib_entry_point, host.kernel, host.mem, module_buffer.data(), MODULE_PATH_ABS);
-            if (module_id >= 0) {
-                const auto module = host.kernel.loaded_modules[module_id];
+            res = vfs::read_file(device, module_buffers[i], host.pref_path, module_path);
 
-                LOG_INFO("Pre-load module {} (at \"{}\") loaded", module->module_name, module_path);
-            } else
-                return FileNotFound;
-        } else {
+        if (!res) {
             LOG_DEBUG("Pre-load module at \"{}\" not present", module_path);
-            return FileNotFound;
+            missing = true;
+            break;
         }
+
+        selfs.push_back({ module_buffers[i].data(), fmt::format("{}:{}", device._to_string(), module_path) });
     }
 
-    return Success;
+    std::vector<Ptr<const void>> lib_entry_points;
+    const std::vector<SceUID> module_ids = load_selfs(lib_entry_points, host.kernel, host.mem, selfs);
+    for (size_t i = 0; i < module_ids.size(); i++) {
+        if (module_ids[i] < 0)
+            return FileNotFound;
+
+        const auto module = host.kernel.loaded_modules[module_ids[i]];
+        LOG_INFO("Pre-load module {} (at \"{}\") loaded", module->module_name, lib_load_list[i]);
+    }
+
+    return missing ? FileNotFound : Success;
 }
 
 static ExitCode load_app_impl(Ptr<const void> &entry_point, HostState &host, const std::wstring &path) {
@@ -481,6 +493,7 @@ static ExitCode load_app_impl(Ptr<const void> &entry_point, HostState &host, con
     const auto call_import = [&host](CPUState &cpu, uint32_t nid, SceUID thread_id) {
         ::call_import(host, cpu, nid, thread_id);
     };
+    configure_host_scheduling(host.kernel.host_scheduling, host.cfg.host_thread_priority, host.cfg.host_core_affinity, host.io.title_id);
     if (!host.kernel.init(host.mem, call_import, host.kernel.cpu_backend, host.kernel.cpu_opt)) {
         LOG_WARN("Failed to init kernel!");
         return KernelInitFailed;
@@ -500,6 +513,14 @@ static ExitCode load_app_impl(Ptr<const void> &entry_point, HostState &host, con
     LOG_INFO("at9 audio decoder state: {}", !host.cfg.current_config.disable_at9_decoder);
     LOG_INFO("ngs experimental state: {}", !host.cfg.current_config.disable_ngs);
     LOG_INFO("video player state: {}", host.cfg.current_config.video_playing);
+    rtc_set_clock_speed(host.cfg.clock_speed);
+    rtc_set_clock_unlocked(host.cfg.clock_unlocked);
+    LOG_INFO("guest clock speed: {}{}", host.cfg.clock_speed, host.cfg.clock_unlocked ? " (unlocked)" : "");
+    host.display.refresh_rate = host.cfg.vblank_rate;
+    host.kernel.hle_profiler.enabled = host.cfg.hle_profiler;
+    LOG_INFO_IF(host.cfg.hle_profiler, "HLE profiler enabled");
+    LOG_INFO("host thread priorities: {}, host core affinity: {}", host.kernel.host_scheduling.priorities,
+        host_affinity_enabled(host.kernel.host_scheduling) ? "per guest core" : "any");
     refresh_controllers(host.ctrl);
     if (host.ctrl.controllers_num) {
         LOG_INFO("{} Controllers Connected", host.ctrl.controllers_num);
@@ -612,7 +633,11 @@ bool handle_events(HostState &host, GuiState &gui) {
                 gui::update_time_app_used(gui, host, host.io.app_path);
             host.kernel.exit_delete_all_threads();
             host.gxm.display_queue.abort();
+            if (host.renderer)
+                host.renderer->notification_waiters.abort();
             host.display.abort.exchange(true);
+            if (host.kernel.hle_profiler.enabled)
+                host.kernel.hle_profiler.dump_csv(fs::path(host.base_path) / "logs" / fmt::format("hle_profile - {}.csv", host.io.title_id));
             return false;
 
         case SDL_KEYDOWN:
@@ -732,6 +757,10 @@ ExitCode run_app(HostState &host, Ptr<const void> &entry_point) {
         return ::resolve_nid_name(host.kernel, addr);
     };
 
+    // Waits aborted while closing a previous app must block again for this one
+    if (host.renderer)
+        host.renderer->notification_waiters.reset();
+
     const ThreadStatePtr thread = host.kernel.create_thread(host.mem, host.io.title_id.c_str(), entry_point, SCE_KERNEL_DEFAULT_PRIORITY_USER, static_cast<int>(SCE_KERNEL_STACK_SIZE_USER_MAIN), nullptr);
     if (!thread) {
         app::error_dialog("Failed to init main thread.", host.window.get());
@@ -54,6 +54,10 @@ int stat_file_by_fd(IOState &io, const SceUID fd, SceIoStat *statp, const std::w
 int close_file(IOState &io, SceUID fd, const char *export_name);
 int remove_file(IOState &io, const char *file, const std::wstring &pref_path, const char *export_name);
 
+// Staged in memory and committed in the background, see SaveDataWriter
+int stage_write_file(IOState &io, const char *path, SceOff offset, const void *data, SceSize size, const std::wstring &pref_path, const char *export_name);
+int stage_truncate_file(IOState &io, const char *path, SceOff size, const std::wstring &pref_path, const char *export_name);
+
 SceUID open_dir(IOState &io, const char *path, const std::wstring &pref_path, const char *export_name);
 SceUID read_dir(IOState &io, SceUID fd, SceIoDirent *dent, const std::wstring &pref_path, const char *export_name);
 int create_dir(IOState &io, const char *dir, int mode, const std::wstring &pref_path, const char *export_name, const bool recursive = false);
@@ -0,0 +1,89 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <util/fs.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Stages savedata writes in memory and commits them from a background thread, so titles saving
+// every few seconds don't wait on the disk. Writes landing close together are coalesced into one
+// commit per file, and each file is replaced with a single rename: a crash leaves either the old
+// or the new content behind, never a mix of both.
+class SaveDataWriter {
+public:
+    // Runs between writing the temporary file of a commit and renaming it over the file, returning false
+    // drops the commit there as if the emulator crashed. Tests use it to check what such a crash leaves.
+    typedef std::function<bool(const fs::path &temp_path)> BeforeRenameFunc;
+
+    SaveDataWriter() = default;
+    ~SaveDataWriter();
+
+    SaveDataWriter(const SaveDataWriter &) = delete;
+    SaveDataWriter &operator=(const SaveDataWriter &) = delete;
+
+    void write(const fs::path &path, uint64_t offset, const void *data, size_t size);
+    void truncate(const fs::path &path, uint64_t size);
+
+    // Blocks until everything staged for path is on disk, returns at once when nothing is
+    void flush(const fs::path &path);
+    // Blocks until everything staged is on disk
+    void flush();
+
+    void set_before_rename(BeforeRenameFunc func);
+
+    // Files replaced on disk, and files left alone because their content did not change
+    uint64_t commit_count() const {
+        return commits;
+    }
+    uint64_t skip_count() const {
+        return skips;
+    }
+
+private:
+    struct Op {
+        uint64_t offset;
+        std::vector<uint8_t> data;
+        bool truncate;
+    };
+    typedef std::map<fs::path, std::vector<Op>> Batch;
+
+    void stage(const fs::path &path, Op op);
+    void run();
+    void commit(const fs::path &path, const std::vector<Op> &ops);
+
+    std::mutex mutex;
+    std::condition_variable staged_cond;
+    std::condition_variable committed_cond;
+    Batch staged;
+    Batch committing;
+    bool urgent = false;
+    bool stop = false;
+    BeforeRenameFunc before_rename;
+    std::thread worker;
+
+    std::atomic<uint64_t> commits = 0;
+    std::atomic<uint64_t> skips = 0;
+};
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <io/filesystem.h>
+#include <io/savedata_writer.h>
 #include <io/util.h>
 
 #include <map>
@@ -121,4 +122,6 @@ struct IOState {
 
     std::unordered_map<std::string, std::string> cachemap;
     bool case_isens_find_enabled = false;
+
+    SaveDataWriter savedata_writer;
 };
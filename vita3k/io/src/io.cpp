@@ -300,6 +300,7 @@ SceUID open_file(IOState &io, const char *path, const int flags, const std::wstr
     }
 
     auto system_path = device::construct_emulated_path(device, translated_path, pref_path, io.redirect_stdio);
+    io.savedata_writer.flush(system_path);
     // Do not allow any new files if they do not have a write flag.
     if (!fs::exists(system_path) && !can_write(flags)) {
         if (io.case_isens_find_enabled) {
@@ -481,6 +482,7 @@ int stat_file(IOState &io, const char *file, SceIoStat *statp, const std::wstrin
 
         const auto translated_path = translate_path(file_str.c_str(), device, io.device_paths);
         file_path = device::construct_emulated_path(device, translated_path, pref_path, io.redirect_stdio);
+        io.savedata_writer.flush(file_path);
 
         if (!fs::exists(file_path)) {
             if (io.case_isens_find_enabled) {
@@ -599,6 +601,7 @@ int remove_file(IOState &io, const char *file, const std::wstring &pref_path, co
     }
 
     const auto emulated_path = device::construct_emulated_path(device, translated_path, pref_path, io.redirect_stdio);
+    io.savedata_writer.flush(emulated_path);
     if (!fs::exists(emulated_path) || fs::is_directory(emulated_path)) {
         LOG_ERROR("File does not exist at path: {} (target path: {})", emulated_path.string(), file);
     }
@@ -613,11 +616,49 @@ int remove_file(IOState &io, const char *file, const std::wstring &pref_path, co
     return 0;
 }
 
+static fs::path staged_file_path(IOState &io, const char *path, const std::wstring &pref_path) {
+    auto device = device::get_device(path);
+    if (device == VitaIoDevice::_INVALID) {
+        LOG_ERROR("Cannot find device for path: {}", path);
+        return {};
+    }
+
+    const auto translated_path = translate_path(path, device, io.device_paths);
+    if (translated_path.empty()) {
+        LOG_ERROR("Cannot translate path: {}", path);
+        return {};
+    }
+
+    return device::construct_emulated_path(device, translated_path, pref_path, io.redirect_stdio);
+}
+
+int stage_write_file(IOState &io, const char *path, const SceOff offset, const void *data, const SceSize size, const std::wstring &pref_path, const char *export_name) {
+    const auto system_path = staged_file_path(io, path, pref_path);
+    if (system_path.empty() || offset < 0)
+        return IO_ERROR(SCE_ERROR_ERRNO_ENOENT);
+
+    LOG_TRACE_IF(log_file_op, "{}: Staging write of {} bytes at {} to file {}", export_name, size, offset, path);
+    io.savedata_writer.write(system_path, offset, data, size);
+    return size;
+}
+
+int stage_truncate_file(IOState &io, const char *path, const SceOff size, const std::wstring &pref_path, const char *export_name) {
+    const auto system_path = staged_file_path(io, path, pref_path);
+    if (system_path.empty() || size < 0)
+        return IO_ERROR(SCE_ERROR_ERRNO_ENOENT);
+
+    LOG_TRACE_IF(log_file_op, "{}: Staging truncate of file {} to {} bytes", export_name, path, size);
+    io.savedata_writer.truncate(system_path, size);
+    return 0;
+}
+
 SceUID open_dir(IOState &io, const char *path, const std::wstring &pref_path, const char *export_name) {
     auto device = device::get_device(path);
     auto device_for_icase = device;
     const auto translated_path = translate_path(path, device, io.device_paths);
 
+    // Files still being staged would be missing from the listing
+    io.savedata_writer.flush();
     auto dir_path = device::construct_emulated_path(device, translated_path, pref_path, io.redirect_stdio) / "/";
     if (!fs::exists(dir_path)) {
         if (io.case_isens_find_enabled) {
@@ -751,6 +792,9 @@ int remove_dir(IOState &io, const char *dir, const std::wstring &pref_path, cons
 
     LOG_TRACE_IF(log_file_op, "{}: Removing dir {} ({})", export_name, dir, device::construct_normalized_path(device, translated_path));
 
+    // A commit landing afterwards would bring the directory back
+    io.savedata_writer.flush();
+
     if (!fs::remove_all(device::construct_emulated_path(device, translated_path, pref_path, io.redirect_stdio))) {
         LOG_ERROR("Cannot remove dir: {} ({})", dir, device::construct_normalized_path(device, translated_path));
         return IO_ERROR(SCE_ERROR_ERRNO_ENOENT);
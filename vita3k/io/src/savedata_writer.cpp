@@ -0,0 +1,215 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <io/filesystem.h>
+#include <io/savedata_writer.h>
+
+#include <util/log.h>
+
+#include <xxh3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// How long staged writes wait for more to come, titles usually save several items in a row
+constexpr auto COALESCE_DELAY = std::chrono::milliseconds(50);
+
+// Windows refuses to rename over a file something has open, readers usually only keep it open for a moment
+constexpr int RENAME_ATTEMPTS = 10;
+constexpr auto RENAME_RETRY_DELAY = std::chrono::milliseconds(5);
+
+static FilePtr open_host_file(const fs::path &path, const bool write) {
+#ifdef WIN32
+    const auto file = _wfopen(path.generic_path().wstring().c_str(), write ? L"wb" : L"rb");
+#else
+    const auto file = fopen(path.generic_path().string().c_str(), write ? "wb" : "rb");
+#endif
+    return file ? FilePtr(file, std::fclose) : FilePtr();
+}
+
+static bool sync_host_file(FILE *file) {
+    if (fflush(file) != 0)
+        return false;
+#ifdef WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+static bool write_host_file(const fs::path &path, const std::vector<uint8_t> &content) {
+    const auto file = open_host_file(path, true);
+    return file && fwrite(content.data(), 1, content.size(), file.get()) == content.size() && sync_host_file(file.get());
+}
+
+static bool replace_host_file(const fs::path &temp_path, const fs::path &path, const std::vector<uint8_t> &content) {
+    boost::system::error_code error;
+    for (int attempt = 0; attempt < RENAME_ATTEMPTS; attempt++) {
+        if (attempt > 0)
+            std::this_thread::sleep_for(RENAME_RETRY_DELAY);
+        fs::rename(temp_path, path, error);
+        if (!error)
+            return true;
+    }
+
+    // Still held open, so write it in place rather than lose the save, even though a crash now could tear it
+    LOG_WARN("Failed to rename over savedata file {}: {}, writing it in place", path.string(), error.message());
+    const bool written = write_host_file(path, content);
+    fs::remove(temp_path, error);
+    return written;
+}
+
+SaveDataWriter::~SaveDataWriter() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    staged_cond.notify_one();
+    if (worker.joinable())
+        worker.join();
+}
+
+void SaveDataWriter::write(const fs::path &path, const uint64_t offset, const void *data, const size_t size) {
+    const auto bytes = static_cast<const uint8_t *>(data);
+    stage(path, Op{ offset, std::vector<uint8_t>(bytes, bytes + size), false });
+}
+
+void SaveDataWriter::truncate(const fs::path &path, const uint64_t size) {
+    stage(path, Op{ size, {}, true });
+}
+
+void SaveDataWriter::stage(const fs::path &path, Op op) {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        staged[path].push_back(std::move(op));
+        if (!worker.joinable())
+            worker = std::thread(&SaveDataWriter::run, this);
+    }
+    staged_cond.notify_one();
+}
+
+void SaveDataWriter::flush(const fs::path &path) {
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto pending = [&]() { return staged.count(path) || committing.count(path); };
+    if (!pending())
+        return;
+
+    urgent = true;
+    staged_cond.notify_one();
+    committed_cond.wait(lock, [&]() { return !pending(); });
+}
+
+void SaveDataWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto pending = [&]() { return !staged.empty() || !committing.empty(); };
+    if (!pending())
+        return;
+
+    urgent = true;
+    staged_cond.notify_one();
+    committed_cond.wait(lock, [&]() { return !pending(); });
+}
+
+void SaveDataWriter::set_before_rename(BeforeRenameFunc func) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    before_rename = std::move(func);
+}
+
+void SaveDataWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        staged_cond.wait(lock, [&]() { return stop || !staged.empty(); });
+        if (staged.empty())
+            return;
+
+        staged_cond.wait_for(lock, COALESCE_DELAY, [&]() { return stop || urgent; });
+        urgent = false;
+        committing = std::move(staged);
+        staged.clear();
+
+        lock.unlock();
+        for (const auto &[path, ops] : committing)
+            commit(path, ops);
+        lock.lock();
+
+        committing.clear();
+        committed_cond.notify_all();
+    }
+}
+
+void SaveDataWriter::commit(const fs::path &path, const std::vector<Op> &ops) {
+    // Staged writes only cover parts of the file, the new content is built on top of the old one
+    std::vector<uint8_t> content;
+    bool existed = false;
+    if (const auto old_file = open_host_file(path, false)) {
+        existed = true;
+        fseek(old_file.get(), 0, SEEK_END);
+        content.resize(static_cast<size_t>(std::max<long>(ftell(old_file.get()), 0)));
+        fseek(old_file.get(), 0, SEEK_SET);
+        content.resize(fread(content.data(), 1, content.size(), old_file.get()));
+    }
+    const size_t old_size = content.size();
+    const uint64_t old_hash = XXH3_64bits(content.data(), content.size());
+
+    for (const auto &op : ops) {
+        if (op.truncate) {
+            content.resize(op.offset);
+        } else if (!op.data.empty()) {
+            content.resize(std::max<size_t>(content.size(), op.offset + op.data.size()));
+            std::copy(op.data.begin(), op.data.end(), content.begin() + op.offset);
+        }
+    }
+
+    if (existed && content.size() == old_size && XXH3_64bits(content.data(), content.size()) == old_hash) {
+        skips++;
+        return;
+    }
+
+    boost::system::error_code error;
+    fs::create_directories(path.parent_path(), error);
+
+    // Written next to the file and renamed over it once it is fully on disk
+    fs::path temp_path = path;
+    temp_path += ".tmp";
+    if (!write_host_file(temp_path, content)) {
+        LOG_ERROR("Failed to write savedata file {}", temp_path.string());
+        fs::remove(temp_path, error);
+        return;
+    }
+
+    BeforeRenameFunc hook;
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        hook = before_rename;
+    }
+    if (hook && !hook(temp_path))
+        return;
+
+    if (!replace_host_file(temp_path, path, content)) {
+        LOG_ERROR("Failed to replace savedata file {}", path.string());
+        return;
+    }
+
+    commits++;
+}
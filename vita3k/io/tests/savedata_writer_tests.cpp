@@ -0,0 +1,170 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <io/savedata_writer.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct SaveDataWriterTest : public testing::Test {
+    fs::path dir;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() / fs::unique_path("savedata-%%%%-%%%%");
+        fs::create_directories(dir);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+
+    static std::string read(const fs::path &path) {
+        std::ifstream file(path.string(), std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    static void write(const fs::path &path, const std::string &content) {
+        std::ofstream file(path.string(), std::ios::binary);
+        file << content;
+    }
+};
+
+} // namespace
+
+TEST_F(SaveDataWriterTest, reads_after_flush_see_the_latest_data) {
+    SaveDataWriter writer;
+    const auto path = dir / "sce_sys" / "data.bin";
+    writer.write(path, 0, "hello world", 11);
+    writer.write(path, 6, "vita!", 5);
+    writer.flush(path);
+
+    EXPECT_EQ(read(path), "hello vita!");
+}
+
+TEST_F(SaveDataWriterTest, writes_patch_the_existing_file) {
+    const auto path = dir / "data.bin";
+    write(path, "0123456789");
+
+    SaveDataWriter writer;
+    writer.write(path, 2, "ab", 2);
+    writer.truncate(path, 6);
+    writer.write(path, 8, "z", 1);
+    writer.flush();
+
+    EXPECT_EQ(read(path), std::string("01ab45\0\0z", 9));
+}
+
+TEST_F(SaveDataWriterTest, coalesces_writes_to_one_commit) {
+    SaveDataWriter writer;
+    const auto path = dir / "data.bin";
+    for (int i = 0; i < 100; i++)
+        writer.write(path, i, "x", 1);
+    writer.flush();
+
+    EXPECT_EQ(read(path), std::string(100, 'x'));
+    EXPECT_EQ(writer.commit_count(), 1u);
+}
+
+TEST_F(SaveDataWriterTest, skips_unchanged_data) {
+    SaveDataWriter writer;
+    const auto path = dir / "data.bin";
+    writer.write(path, 0, "same", 4);
+    writer.flush();
+    const auto modified = fs::last_write_time(path);
+
+    writer.write(path, 0, "same", 4);
+    writer.flush();
+
+    EXPECT_EQ(writer.commit_count(), 1u);
+    EXPECT_EQ(writer.skip_count(), 1u);
+    EXPECT_EQ(fs::last_write_time(path), modified);
+}
+
+TEST_F(SaveDataWriterTest, destruction_commits_staged_writes) {
+    const auto path = dir / "data.bin";
+    {
+        SaveDataWriter writer;
+        writer.write(path, 0, "saved", 5);
+    }
+    EXPECT_EQ(read(path), "saved");
+}
+
+// A commit cut short by a crash only ever leaves the temporary file behind, the old save stays intact
+// and the next commit goes through over the leftover
+TEST_F(SaveDataWriterTest, interrupted_commit_keeps_the_old_file) {
+    const auto path = dir / "data.bin";
+    write(path, "old save");
+
+    {
+        SaveDataWriter writer;
+        writer.set_before_rename([](const fs::path &) { return false; });
+        writer.write(path, 0, "new save", 8);
+        writer.flush();
+
+        EXPECT_EQ(writer.commit_count(), 0u);
+    }
+    EXPECT_EQ(read(path), "old save");
+    EXPECT_EQ(read(dir / "data.bin.tmp"), "new save");
+
+    SaveDataWriter writer;
+    writer.write(path, 0, "newer save", 10);
+    writer.flush();
+
+    EXPECT_EQ(read(path), "newer save");
+    EXPECT_FALSE(fs::exists(dir / "data.bin.tmp"));
+}
+
+// Readers racing with commits must see one whole version or the other, never a torn file
+TEST_F(SaveDataWriterTest, commits_replace_files_atomically) {
+    const auto path = dir / "data.bin";
+    const std::string first(64 * 1024, 'a');
+    const std::string second(32 * 1024, 'b');
+    write(path, first);
+
+    std::atomic<bool> done = false;
+    std::atomic<int> torn = 0;
+    std::thread reader([&]() {
+        while (!done) {
+            const auto content = read(path);
+            if (content != first && content != second)
+                torn++;
+            // Windows can't rename over the file while it is open, leave the commits a gap to land in
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    SaveDataWriter writer;
+    for (int i = 0; i < 50; i++) {
+        const auto &content = (i % 2) ? first : second;
+        writer.write(path, 0, content.data(), content.size());
+        writer.truncate(path, content.size());
+        writer.flush();
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(writer.commit_count(), 50u);
+}
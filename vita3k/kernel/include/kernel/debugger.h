@@ -64,6 +64,7 @@ struct Debugger {
     bool log_imports = false;
     bool log_exports = false;
     bool dump_elfs = false;
+    bool fill_stacks = false;
 
     void add_watch_memory_addr(Address addr, size_t size);
     void remove_watch_memory_addr(KernelState &state, Address addr);
@@ -0,0 +1,87 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <util/fs.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Latency histogram buckets, bucket i counts calls that took [2^i, 2^(i+1)) cycle counter ticks
+constexpr size_t HLE_PROFILER_BUCKETS = 40;
+
+struct HleCallStats {
+    uint64_t count = 0;
+    uint64_t total_ticks = 0;
+    uint64_t min_ticks = UINT64_MAX;
+    uint64_t max_ticks = 0;
+    std::array<uint64_t, HLE_PROFILER_BUCKETS> histogram{};
+
+    void add(uint64_t ticks);
+    void merge(const HleCallStats &other);
+};
+
+using HleProfile = std::vector<std::pair<uint32_t, HleCallStats>>;
+
+/**
+ * \brief Per-NID call counters and latency histograms for HLE exports.
+ *
+ * Every host thread records into its own table, so recording only ever takes an uncontended lock.
+ * Tables are merged when the profile is read.
+ */
+class HleProfiler {
+public:
+    HleProfiler();
+
+    std::atomic<bool> enabled{ false };
+
+    // Cycle counter when the host has one, steady clock otherwise
+    static uint64_t timestamp();
+
+    void record(uint32_t nid, uint64_t start, uint64_t end);
+    void reset();
+
+    // Merged profile of all threads, sorted by total time spent
+    HleProfile snapshot() const;
+    double ticks_to_us(uint64_t ticks) const;
+
+    bool dump_csv(const fs::path &path) const;
+
+private:
+    struct ThreadCounters {
+        std::thread::id thread;
+        std::mutex mutex;
+        std::unordered_map<uint32_t, HleCallStats> stats;
+    };
+
+    ThreadCounters &local_counters();
+
+    const uint64_t id;
+    const uint64_t start_ticks;
+    const std::chrono::steady_clock::time_point start_time;
+
+    mutable std::mutex threads_mutex;
+    std::vector<std::shared_ptr<ThreadCounters>> threads;
+};
@@ -0,0 +1,82 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Guest user cores a thread may be pinned to through its affinity mask
+constexpr size_t GUEST_USER_CORE_COUNT = 3;
+
+// Bands of guest priorities, from the highest guest priority down
+enum class HostThreadPriority {
+    High,
+    Normal,
+    Low,
+    Lowest,
+};
+
+struct HostSchedulingConfig {
+    // Move guest threads to host priorities matching their guest priority band
+    bool priorities = false;
+    // Host CPUs each guest user core maps to, in a host affinity mask. 0 lets the guest core run anywhere.
+    std::array<std::uint64_t, GUEST_USER_CORE_COUNT> core_affinity{};
+};
+
+// Native handle of the host thread running a guest thread, taken by the thread itself when it starts
+struct HostThreadHandle {
+    std::uintptr_t native = 0;
+};
+
+/**
+ * \brief How a guest thread was mapped onto host scheduling, and whether the host accepted it.
+ */
+struct HostThreadPolicy {
+    HostThreadPriority priority = HostThreadPriority::Normal;
+    std::uint64_t affinity = 0; // Host CPU mask, 0 for any CPU
+    bool priority_applied = false;
+    bool affinity_applied = false;
+};
+
+bool host_affinity_enabled(const HostSchedulingConfig &config);
+HostThreadPriority host_priority_for(int guest_priority);
+std::uint64_t host_affinity_for(const HostSchedulingConfig &config, int guest_affinity_mask);
+HostThreadPolicy map_guest_thread(const HostSchedulingConfig &config, int guest_priority, int guest_affinity_mask);
+
+HostThreadHandle current_host_thread();
+void release_host_thread(HostThreadHandle &thread);
+// Apply the policy to a host thread, updating its applied flags
+void apply_host_policy(const HostSchedulingConfig &config, HostThreadPolicy &policy, const HostThreadHandle &thread);
+
+/**
+ * \brief Build the scheduling config of an app.
+ *
+ * \param config         Config to fill.
+ * \param priorities     Map guest priorities onto host ones.
+ * \param affinity_rules Entries of the host-core-affinity option, "<title id>=<host CPUs of guest core 0>;<core 1>;<core 2>"
+ *                       with CPUs written as "0-3,6". A "*" title applies to every app without an entry of its own.
+ * \param title_id       Title ID of the app.
+ */
+void configure_host_scheduling(HostSchedulingConfig &config, bool priorities, const std::vector<std::string> &affinity_rules, const std::string &title_id);
+bool parse_host_cpus(const std::string &cpus, std::uint64_t &mask);
+
+std::string to_string(HostThreadPriority priority);
+std::string to_string(const HostThreadPolicy &policy);
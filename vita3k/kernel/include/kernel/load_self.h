@@ -20,6 +20,7 @@
 #include <util/types.h>
 
 #include <string>
+#include <vector>
 
 struct Config;
 struct KernelState;
@@ -27,4 +28,16 @@ struct MemState;
 template <class T>
 class Ptr;
 
+struct SelfToLoad {
+    const void *self;
+    std::string path;
+};
+
 SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const void *self, const std::string &path);
+
+/**
+ * \brief Loads several independent modules at once.
+ * Segments of every module are decompressed and relocated concurrently, then modules are linked in the given order.
+ * \return One module id per SELF, negative for the ones that failed to load
+ */
+std::vector<SceUID> load_selfs(std::vector<Ptr<const void>> &entry_points, KernelState &kernel, MemState &mem, const std::vector<SelfToLoad> &selfs);
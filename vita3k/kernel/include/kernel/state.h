@@ -21,7 +21,10 @@
 #include <kernel/callback.h>
 #include <kernel/cpu_protocol.h>
 #include <kernel/debugger.h>
+#include <kernel/host_scheduling.h>
+#include <kernel/hle_profiler.h>
 #include <kernel/sync_primitives.h>
+#include <kernel/timer_wheel.h>
 #include <kernel/types.h>
 #include <mem/allocator.h>
 #include <mem/ptr.h>
@@ -97,6 +100,15 @@ struct TimerState {
     bool is_started = false;
     bool repeats = false;
     uint64_t time = 0;
+
+    // Timer event armed with sceKernelSetTimerEvent, it only runs while the timer is started
+    uint64_t event_interval = 0;
+    TimerHandle event = 0;
+
+    // Guards the event state below, fired from the timer wheel thread
+    std::mutex mutex;
+    uint32_t event_count = 0; // Events fired that no waiter consumed yet
+    WaitingThreadQueuePtr waiting_threads = std::make_unique<FIFOThreadDataQueue<WaitingThreadData>>();
 };
 
 typedef std::shared_ptr<TimerState> TimerPtr;
@@ -159,6 +171,10 @@ struct KernelState {
     NotFoundVars not_found_vars;
 
     Debugger debugger;
+    HleProfiler hle_profiler;
+    HostSchedulingConfig host_scheduling;
+    // Drives timer events, wait timeouts and delayed callbacks. Declared after what its callbacks touch, so it stops first.
+    TimerWheel timer_wheel;
 
     SceUID get_next_uid() {
         return next_uid++;
@@ -167,7 +183,9 @@ struct KernelState {
     bool init(MemState &mem, CallImportFunc call_import, CPUBackend cpu_backend, bool cpu_opt);
     void load_process_param(MemState &mem, Ptr<uint32_t> ptr);
     ThreadStatePtr create_thread(MemState &mem, const char *name);
-    ThreadStatePtr create_thread(MemState &mem, const char *name, Ptr<const void> entry_point, int init_priority, int stack_size, const SceKernelThreadOptParam *option);
+    ThreadStatePtr create_thread(MemState &mem, const char *name, Ptr<const void> entry_point, int init_priority, int stack_size, const SceKernelThreadOptParam *option, int affinity_mask = 0);
+    // Map the guest priority and affinity of a thread onto its host thread. The thread mutex must be held.
+    void update_host_scheduling(ThreadState &thread);
     void exit_thread(ThreadStatePtr thread);
     void exit_delete_thread(ThreadStatePtr thread);
 
@@ -23,6 +23,7 @@
 #include <util/byte_ring_buffer.h>
 
 struct KernelState;
+struct TimerState;
 
 struct WaitingThreadData {
     ThreadStatePtr thread;
@@ -44,6 +45,9 @@ struct WaitingThreadData {
         struct { // msgpipe
             SceSize request_size;
         } mp;
+        struct { // timer event, the waker stores the result of the wait here
+            SceInt32 *result;
+        } timer;
     };
 
     bool operator<(const WaitingThreadData &rhs) const {
@@ -198,3 +202,12 @@ SceUID msgpipe_find(KernelState &kernel, const char *export_name, const char *na
 int msgpipe_recv(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID msgpipe_id, SceUInt32 wait_mode, char *recv_buf, SceSize msg_size, SceUInt32 *timeout);
 int msgpipe_send(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID msgpipe_id, SceUInt32 wait_mode, char *send_buf, SceSize msg_size, SceUInt32 *timeout);
 SceUID msgpipe_delete(KernelState &kernel, const char *export_name, const char *name, SceUID thread_id, SceUID msgpipe_id);
+
+// Timer Event
+// Pattern a timer event reports to the threads it wakes
+constexpr SceUInt32 SCE_KERNEL_EVENT_TIMER = 0x1;
+
+void timer_event_fire(TimerState &timer);
+SceInt32 timer_event_wait(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID timer_id, SceUInt32 *pResultPattern, SceUInt32 *pTimeout);
+SceInt32 timer_event_poll(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID timer_id, SceUInt32 *pResultPattern);
+SceInt32 timer_event_cancel(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID timer_id, SceUInt32 *pNumWaitThreads);
@@ -20,6 +20,7 @@
 #include <condition_variable>
 #include <cpu/state.h>
 #include <kernel/callback.h>
+#include <kernel/host_scheduling.h>
 #include <kernel/types.h>
 #include <list>
 #include <mem/block.h>
@@ -97,8 +98,13 @@ struct ThreadState {
     Block tls;
 
     int priority;
+    int affinity_mask = 0;
     uint64_t start_tick;
 
+    // Host thread running this guest thread, and how it is scheduled
+    HostThreadHandle host_thread;
+    HostThreadPolicy host_policy;
+
     CPUStatePtr cpu;
     ThreadStatus status = ThreadStatus::dormant;
     RunQueue run_queue;
@@ -106,9 +112,16 @@ struct ThreadState {
     ThreadSignal signal;
     std::vector<CallbackPtr> callbacks;
     std::condition_variable status_cond;
+    // Bumped for every wait with a timeout, the timer wheel only times out the wait it was armed for
+    uint32_t wait_serial = 0;
+    bool wait_timed_out = false;
     std::vector<std::shared_ptr<ThreadState>> waiting_threads;
     int returned_value = 0;
 
+    // SceFiber state. Only the thread itself touches it, so it needs no locking.
+    Address fiber = 0; // Running fiber, 0 when the thread runs its own context
+    CPUContext fiber_thread_context; // Context sceFiberReturnToThread goes back to
+
     ThreadState() = delete;
     explicit ThreadState(SceUID id, MemState &mem);
 
@@ -143,3 +156,7 @@ private:
 };
 
 typedef std::shared_ptr<ThreadState> ThreadStatePtr;
+
+// Guest thread running on the calling host thread, nullptr outside of guest threads.
+// Lets HLE functions reach their own thread without locking the kernel thread map.
+ThreadState *get_current_thread();
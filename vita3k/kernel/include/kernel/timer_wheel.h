@@ -0,0 +1,113 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Names a scheduled timer, 0 never names one
+typedef uint64_t TimerHandle;
+typedef std::function<void()> TimerCallback;
+
+/**
+ * \brief Hierarchical timer wheel driving kernel timer events, wait timeouts and delayed callbacks.
+ *
+ * Timers are kept in slots of five 64 slot levels of 100us ticks, so inserting and cancelling is O(1)
+ * and timers up to about 29 hours away are placed without sorting. Timers further away are parked in
+ * the last slot of the top level and placed again when it comes around.
+ *
+ * Times are microseconds of the guest clock (rtc_ticks_since_epoch), so timers follow its speed
+ * multiplier. A single host thread sleeps until the next occupied slot and runs the callbacks that
+ * are due, without holding the wheel lock so callbacks may schedule or cancel timers themselves.
+ */
+class TimerWheel {
+public:
+    static constexpr uint64_t TICK_US = 100;
+    static constexpr uint32_t LEVEL_BITS = 6;
+    static constexpr uint32_t SLOTS = 1 << LEVEL_BITS;
+    static constexpr uint32_t LEVELS = 5;
+
+    // When threaded is false nothing fires until poll is called, which is what the tests use
+    explicit TimerWheel(bool threaded = true);
+    ~TimerWheel();
+
+    TimerHandle schedule(uint64_t delay_us, TimerCallback callback, uint64_t period_us = 0);
+    TimerHandle schedule_at(uint64_t when_us, TimerCallback callback, uint64_t period_us = 0);
+
+    // Returns false when the timer already fired (a one-shot one may still be running its callback) or was cancelled
+    bool cancel(TimerHandle handle);
+    std::optional<uint64_t> remaining_us(TimerHandle handle);
+    size_t pending();
+
+    // Run the callbacks of every timer due at now_us, returns how many ran
+    size_t poll(uint64_t now_us);
+    void stop();
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Timer {
+        uint64_t expiry = 0; // In ticks since the wheel was created
+        uint64_t period = 0; // In ticks, 0 for one-shot timers
+        TimerCallback callback;
+        uint32_t generation = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        uint32_t slot = NONE; // Level * SLOTS + slot, NONE when not linked
+    };
+
+    struct Level {
+        std::array<uint32_t, SLOTS> heads;
+        uint64_t occupied = 0; // One bit per non empty slot
+    };
+
+    uint64_t to_tick(uint64_t time_us) const;
+    uint64_t to_time(uint64_t tick) const;
+
+    TimerHandle insert(uint64_t expiry, uint64_t period, TimerCallback callback);
+    Timer *find(TimerHandle handle);
+    void release(uint32_t index);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void advance(uint64_t tick, std::vector<uint32_t> &due);
+    std::optional<uint64_t> next_tick() const;
+    void run();
+
+    const uint64_t start; // Guest time the wheel was created at, in microseconds
+    const bool threaded;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool quit = false;
+    uint64_t current = 0; // Last tick that was processed
+    uint64_t wake_tick = 0; // Tick the wheel thread sleeps until, 0 while it is busy
+
+    std::vector<Timer> timers;
+    std::vector<uint32_t> free_timers;
+    std::array<Level, LEVELS> levels;
+    size_t count = 0;
+
+    std::thread thread;
+};
@@ -30,6 +30,11 @@
 #define SCE_KERNEL_HIGHEST_PRIORITY_USER 64
 #define SCE_KERNEL_LOWEST_PRIORITY_USER 191
 
+#define SCE_KERNEL_CPU_MASK_USER_0 0x00010000
+#define SCE_KERNEL_CPU_MASK_USER_1 0x00020000
+#define SCE_KERNEL_CPU_MASK_USER_2 0x00040000
+#define SCE_KERNEL_CPU_MASK_USER_ALL (SCE_KERNEL_CPU_MASK_USER_0 | SCE_KERNEL_CPU_MASK_USER_1 | SCE_KERNEL_CPU_MASK_USER_2)
+
 #define SCE_KERNEL_STACK_SIZE_USER_MAIN KB(256)
 #define SCE_KERNEL_STACK_SIZE_USER_DEFAULT KB(4)
 
@@ -0,0 +1,159 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/hle_profiler.h>
+
+#include <nids/functions.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <fstream>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define HLE_PROFILER_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HLE_PROFILER_RDTSC
+#endif
+
+static std::atomic<uint64_t> next_profiler_id{ 0 };
+
+void HleCallStats::add(uint64_t ticks) {
+    count++;
+    total_ticks += ticks;
+    min_ticks = std::min(min_ticks, ticks);
+    max_ticks = std::max(max_ticks, ticks);
+
+    size_t bucket = 0;
+    while ((ticks >> (bucket + 1)) != 0 && bucket < HLE_PROFILER_BUCKETS - 1)
+        bucket++;
+    histogram[bucket]++;
+}
+
+void HleCallStats::merge(const HleCallStats &other) {
+    count += other.count;
+    total_ticks += other.total_ticks;
+    min_ticks = std::min(min_ticks, other.min_ticks);
+    max_ticks = std::max(max_ticks, other.max_ticks);
+    for (size_t i = 0; i < HLE_PROFILER_BUCKETS; i++)
+        histogram[i] += other.histogram[i];
+}
+
+HleProfiler::HleProfiler()
+    : id(next_profiler_id++)
+    , start_ticks(timestamp())
+    , start_time(std::chrono::steady_clock::now()) {
+}
+
+uint64_t HleProfiler::timestamp() {
+#ifdef HLE_PROFILER_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+HleProfiler::ThreadCounters &HleProfiler::local_counters() {
+    // Most recently used table of this thread. The profiler id, unlike its address, is never reused.
+    thread_local uint64_t cached_owner = UINT64_MAX;
+    thread_local ThreadCounters *cached_counters = nullptr;
+    if (cached_owner == id)
+        return *cached_counters;
+
+    const std::lock_guard<std::mutex> lock(threads_mutex);
+    const auto this_thread = std::this_thread::get_id();
+    auto it = std::find_if(threads.begin(), threads.end(), [&](const auto &counters) { return counters->thread == this_thread; });
+    if (it == threads.end()) {
+        threads.push_back(std::make_shared<ThreadCounters>());
+        threads.back()->thread = this_thread;
+        it = threads.end() - 1;
+    }
+
+    cached_owner = id;
+    cached_counters = it->get();
+    return *cached_counters;
+}
+
+void HleProfiler::record(uint32_t nid, uint64_t start, uint64_t end) {
+    ThreadCounters &counters = local_counters();
+    const std::lock_guard<std::mutex> lock(counters.mutex);
+    counters.stats[nid].add(end > start ? end - start : 0);
+}
+
+void HleProfiler::reset() {
+    const std::lock_guard<std::mutex> lock(threads_mutex);
+    for (const auto &counters : threads) {
+        const std::lock_guard<std::mutex> counters_lock(counters->mutex);
+        counters->stats.clear();
+    }
+}
+
+HleProfile HleProfiler::snapshot() const {
+    std::unordered_map<uint32_t, HleCallStats> merged;
+    {
+        const std::lock_guard<std::mutex> lock(threads_mutex);
+        for (const auto &counters : threads) {
+            const std::lock_guard<std::mutex> counters_lock(counters->mutex);
+            for (const auto &[nid, stats] : counters->stats)
+                merged[nid].merge(stats);
+        }
+    }
+
+    HleProfile profile(merged.begin(), merged.end());
+    std::sort(profile.begin(), profile.end(), [](const auto &a, const auto &b) { return a.second.total_ticks > b.second.total_ticks; });
+    return profile;
+}
+
+double HleProfiler::ticks_to_us(uint64_t ticks) const {
+    // Calibrated against the steady clock over the whole profiler lifetime, which gets more accurate the longer it runs
+    const double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count();
+    const uint64_t elapsed_ticks = timestamp() - start_ticks;
+    if (elapsed_ticks == 0)
+        return 0.0;
+    return static_cast<double>(ticks) * elapsed_us / static_cast<double>(elapsed_ticks);
+}
+
+bool HleProfiler::dump_csv(const fs::path &path) const {
+    if (path.has_parent_path())
+        fs::create_directories(path.parent_path());
+    std::ofstream out(path.string());
+    if (!out) {
+        LOG_ERROR("Failed to open HLE profile file {}", path.string());
+        return false;
+    }
+
+    const HleProfile profile = snapshot();
+    const double us_per_tick = ticks_to_us(1'000'000) / 1'000'000.0;
+
+    out << "nid,name,count,total_us,avg_us,min_us,max_us";
+    for (size_t i = 0; i < HLE_PROFILER_BUCKETS; i++)
+        out << ",lt_" << static_cast<uint64_t>(static_cast<double>(2ULL << i) * us_per_tick * 1000.0) << "ns";
+    out << '\n';
+
+    for (const auto &[nid, stats] : profile) {
+        out << log_hex(nid) << ',' << import_name(nid) << ',' << stats.count << ','
+            << stats.total_ticks * us_per_tick << ',' << stats.total_ticks * us_per_tick / stats.count << ','
+            << stats.min_ticks * us_per_tick << ',' << stats.max_ticks * us_per_tick;
+        for (const uint64_t bucket : stats.histogram)
+            out << ',' << bucket;
+        out << '\n';
+    }
+
+    LOG_INFO("HLE profile of {} exports written to {}", profile.size(), path.string());
+    return true;
+}
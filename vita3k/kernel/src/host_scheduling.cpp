@@ -0,0 +1,307 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <kernel/host_scheduling.h>
+#include <kernel/types.h>
+
+#include <util/log.h>
+#include <util/string_utils.h>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#else
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Guest priorities are 64 (highest) to 191 (lowest), games run at 160 by default
+static constexpr int HIGH_PRIORITY_BAND_END = 128;
+static constexpr int NORMAL_PRIORITY_BAND_END = 168;
+static constexpr int LOW_PRIORITY_BAND_END = 184;
+
+static constexpr std::size_t MAX_HOST_CPUS = 64;
+
+bool host_affinity_enabled(const HostSchedulingConfig &config) {
+    return std::any_of(config.core_affinity.begin(), config.core_affinity.end(), [](std::uint64_t mask) { return mask != 0; });
+}
+
+HostThreadPriority host_priority_for(int guest_priority) {
+    // Priorities relative to the default one
+    if (guest_priority > SCE_KERNEL_LOWEST_PRIORITY_USER)
+        guest_priority = guest_priority - SCE_KERNEL_DEFAULT_PRIORITY + SCE_KERNEL_GAME_DEFAULT_PRIORITY_ACTUAL;
+
+    if (guest_priority < HIGH_PRIORITY_BAND_END)
+        return HostThreadPriority::High;
+    if (guest_priority < NORMAL_PRIORITY_BAND_END)
+        return HostThreadPriority::Normal;
+    if (guest_priority < LOW_PRIORITY_BAND_END)
+        return HostThreadPriority::Low;
+    return HostThreadPriority::Lowest;
+}
+
+std::uint64_t host_affinity_for(const HostSchedulingConfig &config, int guest_affinity_mask) {
+    std::uint64_t affinity = 0;
+    for (std::size_t core = 0; core < GUEST_USER_CORE_COUNT; core++) {
+        // No core in the mask means any core
+        const bool in_mask = !(guest_affinity_mask & SCE_KERNEL_CPU_MASK_USER_ALL) || (guest_affinity_mask & (SCE_KERNEL_CPU_MASK_USER_0 << core));
+        if (!in_mask)
+            continue;
+
+        // A guest core that may run anywhere makes the whole thread run anywhere
+        if (!config.core_affinity[core])
+            return 0;
+        affinity |= config.core_affinity[core];
+    }
+
+    return affinity;
+}
+
+HostThreadPolicy map_guest_thread(const HostSchedulingConfig &config, int guest_priority, int guest_affinity_mask) {
+    HostThreadPolicy policy;
+    policy.priority = host_priority_for(guest_priority);
+    policy.affinity = host_affinity_for(config, guest_affinity_mask);
+    return policy;
+}
+
+HostThreadHandle current_host_thread() {
+    HostThreadHandle thread;
+#ifdef _WIN32
+    HANDLE handle = nullptr;
+    DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &handle, 0, FALSE, DUPLICATE_SAME_ACCESS);
+    thread.native = reinterpret_cast<std::uintptr_t>(handle);
+#elif defined(__APPLE__)
+    thread.native = reinterpret_cast<std::uintptr_t>(pthread_self());
+#else
+    thread.native = static_cast<std::uintptr_t>(syscall(SYS_gettid));
+#endif
+    return thread;
+}
+
+void release_host_thread(HostThreadHandle &thread) {
+#ifdef _WIN32
+    if (thread.native)
+        CloseHandle(reinterpret_cast<HANDLE>(thread.native));
+#endif
+    thread.native = 0;
+}
+
+// Affinity to go back to when a thread may run anywhere again
+static std::uint64_t all_host_cpus() {
+    const std::size_t count = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), MAX_HOST_CPUS);
+    return count == MAX_HOST_CPUS ? ~0ull : (1ull << count) - 1;
+}
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+// Raising a nice value is always allowed but lowering it back is not, unless the process may use lower values. Tried
+// on a thread of its own.
+static bool nice_is_reversible(int base) {
+    bool reversible = false;
+    std::thread([base, &reversible]() {
+        const id_t tid = static_cast<id_t>(syscall(SYS_gettid));
+        reversible = (setpriority(PRIO_PROCESS, tid, std::min(base + 1, 19)) == 0) && (setpriority(PRIO_PROCESS, tid, base) == 0);
+    }).join();
+
+    if (!reversible)
+        LOG_WARN("Host thread priorities are not applied, lowering a nice value back needs CAP_SYS_NICE or a higher RLIMIT_NICE");
+    return reversible;
+}
+#endif
+
+static bool apply_priority(const HostThreadHandle &thread, HostThreadPriority priority) {
+#ifdef _WIN32
+    static constexpr int priorities[] = { THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_LOWEST };
+    return SetThreadPriority(reinterpret_cast<HANDLE>(thread.native), priorities[static_cast<int>(priority)]);
+#elif defined(__APPLE__)
+    // Offsets from the default SCHED_OTHER priority
+    static constexpr int offsets[] = { 6, 0, -6, -12 };
+    sched_param param{};
+    int policy = 0;
+    const pthread_t native = reinterpret_cast<pthread_t>(thread.native);
+    if (pthread_getschedparam(native, &policy, &param) != 0)
+        return false;
+    param.sched_priority = (sched_get_priority_min(SCHED_OTHER) + sched_get_priority_max(SCHED_OTHER)) / 2 + offsets[static_cast<int>(priority)];
+    return pthread_setschedparam(native, SCHED_OTHER, &param) == 0;
+#else
+    // Offsets from the nice value of the emulator. The highest band stays at it, so nothing ever needs privileges to go
+    // below the value threads start with.
+    static constexpr int nice_offsets[] = { 0, 2, 6, 10 };
+    static const int base = getpriority(PRIO_PROCESS, 0);
+    static const bool reversible = nice_is_reversible(base);
+    // A thread demoted once would keep the lower priority after the guest raises it again
+    if (!reversible)
+        return false;
+
+    const int nice = std::min(base + nice_offsets[static_cast<int>(priority)], 19);
+    return setpriority(PRIO_PROCESS, static_cast<id_t>(thread.native), nice) == 0;
+#endif
+}
+
+static bool apply_affinity(const HostThreadHandle &thread, std::uint64_t affinity) {
+    if (!affinity)
+        affinity = all_host_cpus();
+
+#ifdef _WIN32
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+        return false;
+    const DWORD_PTR mask = static_cast<DWORD_PTR>(affinity) & process_mask;
+    return mask && SetThreadAffinityMask(reinterpret_cast<HANDLE>(thread.native), mask);
+#elif defined(__APPLE__)
+    // Threads can't be pinned to CPUs on macOS
+    return false;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (std::size_t cpu = 0; cpu < MAX_HOST_CPUS; cpu++) {
+        if (affinity & (1ull << cpu))
+            CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(static_cast<pid_t>(thread.native), sizeof(set), &set) == 0;
+#endif
+}
+
+void apply_host_policy(const HostSchedulingConfig &config, HostThreadPolicy &policy, const HostThreadHandle &thread) {
+    if (!thread.native)
+        return;
+
+    if (config.priorities)
+        policy.priority_applied = apply_priority(thread, policy.priority);
+
+    // Nothing to undo when no guest core was ever given host CPUs
+    if (host_affinity_enabled(config))
+        policy.affinity_applied = apply_affinity(thread, policy.affinity);
+}
+
+bool parse_host_cpus(const std::string &cpus, std::uint64_t &mask) {
+    mask = 0;
+    for (const auto &range : string_utils::split_string(cpus, ',')) {
+        if (range.empty())
+            continue;
+
+        std::size_t first = 0;
+        std::size_t last = 0;
+        try {
+            const auto dash = range.find('-');
+            first = std::stoul(range.substr(0, dash));
+            last = (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+        } catch (const std::exception &) {
+            return false;
+        }
+
+        if (first > last || last >= MAX_HOST_CPUS)
+            return false;
+        for (std::size_t cpu = first; cpu <= last; cpu++)
+            mask |= 1ull << cpu;
+    }
+
+    return true;
+}
+
+// Parse "<host CPUs of guest core 0>;<core 1>;<core 2>"
+static bool parse_core_affinity(const std::string &cores, std::array<std::uint64_t, GUEST_USER_CORE_COUNT> &core_affinity) {
+    const auto core_cpus = string_utils::split_string(cores, ';');
+    if (core_cpus.size() > GUEST_USER_CORE_COUNT)
+        return false;
+
+    std::array<std::uint64_t, GUEST_USER_CORE_COUNT> parsed{};
+    for (std::size_t core = 0; core < core_cpus.size(); core++) {
+        if (!parse_host_cpus(core_cpus[core], parsed[core]))
+            return false;
+    }
+
+    core_affinity = parsed;
+    return true;
+}
+
+void configure_host_scheduling(HostSchedulingConfig &config, bool priorities, const std::vector<std::string> &affinity_rules, const std::string &title_id) {
+    config = {};
+    config.priorities = priorities;
+
+    std::string cores;
+    bool title_rule = false;
+    for (const auto &rule : affinity_rules) {
+        const auto equal = rule.find('=');
+        if (equal == std::string::npos) {
+            LOG_WARN("Ignoring host core affinity rule without a title: {}", rule);
+            continue;
+        }
+
+        const std::string title = rule.substr(0, equal);
+        if (title == title_id) {
+            cores = rule.substr(equal + 1);
+            title_rule = true;
+        } else if ((title == "*") && !title_rule) {
+            cores = rule.substr(equal + 1);
+        }
+    }
+
+    if (!cores.empty() && !parse_core_affinity(cores, config.core_affinity))
+        LOG_WARN("Ignoring invalid host core affinity for {}: {}", title_id, cores);
+}
+
+std::string to_string(HostThreadPriority priority) {
+    switch (priority) {
+    case HostThreadPriority::High:
+        return "high";
+    case HostThreadPriority::Normal:
+        return "normal";
+    case HostThreadPriority::Low:
+        return "low";
+    case HostThreadPriority::Lowest:
+        return "lowest";
+    }
+
+    return "unknown";
+}
+
+static std::string host_cpus_to_string(std::uint64_t mask) {
+    if (!mask)
+        return "any";
+
+    std::string cpus;
+    for (std::size_t cpu = 0; cpu < MAX_HOST_CPUS; cpu++) {
+        if (!(mask & (1ull << cpu)))
+            continue;
+
+        std::size_t last = cpu;
+        while ((last + 1 < MAX_HOST_CPUS) && (mask & (1ull << (last + 1))))
+            last++;
+
+        if (!cpus.empty())
+            cpus += ',';
+        cpus += (last == cpu) ? std::to_string(cpu) : fmt::format("{}-{}", cpu, last);
+        cpu = last;
+    }
+
+    return cpus;
+}
+
+std::string to_string(const HostThreadPolicy &policy) {
+    return fmt::format("{} priority{}, CPUs {}{}", to_string(policy.priority), policy.priority_applied ? "" : " (not applied)",
+        host_cpus_to_string(policy.affinity), (policy.affinity && !policy.affinity_applied) ? " (not applied)" : "");
+}
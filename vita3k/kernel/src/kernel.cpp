@@ -59,7 +59,16 @@ static int SDLCALL thread_function(void *data) {
     const ThreadParams params = *static_cast<const ThreadParams *>(data);
     SDL_SemPost(params.host_may_destroy_params.get());
     const ThreadStatePtr thread = lock_and_find(params.thid, params.kernel->threads, params.kernel->mutex);
+    {
+        const std::lock_guard<std::mutex> thread_lock(thread->mutex);
+        thread->host_thread = current_host_thread();
+        params.kernel->update_host_scheduling(*thread);
+    }
     thread->run_loop();
+    {
+        const std::lock_guard<std::mutex> thread_lock(thread->mutex);
+        release_host_thread(thread->host_thread);
+    }
     const uint32_t r0 = read_reg(*thread->cpu, 0);
     thread->returned_value = r0;
 
@@ -128,10 +137,11 @@ ThreadStatePtr KernelState::create_thread(MemState &mem, const char *name) {
     return create_thread(mem, name, Ptr<void>(0), SCE_KERNEL_DEFAULT_PRIORITY, DEFAULT_STACK_SIZE, nullptr);
 }
 
-ThreadStatePtr KernelState::create_thread(MemState &mem, const char *name, Ptr<const void> entry_point, int init_priority, int stack_size, const SceKernelThreadOptParam *option) {
+ThreadStatePtr KernelState::create_thread(MemState &mem, const char *name, Ptr<const void> entry_point, int init_priority, int stack_size, const SceKernelThreadOptParam *option, int affinity_mask) {
     ThreadStatePtr thread = std::make_shared<ThreadState>(get_next_uid(), mem);
     if (thread->init(*this, name, entry_point, init_priority, stack_size, option) < 0)
         return nullptr;
+    thread->affinity_mask = affinity_mask;
     const auto lock = std::lock_guard(mutex);
     threads.emplace(thread->id, thread);
 
@@ -144,6 +154,16 @@ ThreadStatePtr KernelState::create_thread(MemState &mem, const char *name, Ptr<c
     return thread;
 }
 
+void KernelState::update_host_scheduling(ThreadState &thread) {
+    thread.host_policy = map_guest_thread(host_scheduling, thread.priority, thread.affinity_mask);
+    if (!host_scheduling.priorities && !host_affinity_enabled(host_scheduling))
+        return;
+
+    apply_host_policy(host_scheduling, thread.host_policy, thread.host_thread);
+    LOG_INFO("Thread {} (#{}) with priority {} and affinity mask {}: {}", thread.name, thread.id, thread.priority, log_hex(thread.affinity_mask),
+        to_string(thread.host_policy));
+}
+
 void KernelState::exit_thread(ThreadStatePtr thread) {
     thread->clear_run_queue();
     stop(*thread->cpu);
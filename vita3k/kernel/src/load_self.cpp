@@ -22,6 +22,7 @@
 #include <kernel/types.h>
 
 #include <nids/functions.h>
+#include <threads/thread_pool.h>
 #include <util/arm.h>
 #include <util/fs.h>
 #include <util/log.h>
@@ -39,6 +40,7 @@
 #include <cassert>
 #include <cstring>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <iostream>
 
@@ -300,32 +302,53 @@ static bool load_exports(Ptr<const void> &entry_point, const sce_module_info_raw
     return true;
 }
 
+// Host side bookkeeping for a SELF between the time its segments are allocated and the time it is linked.
+struct MappedSelf {
+    const uint8_t *self_bytes = nullptr;
+    std::string self_path;
+    const SCE_header *self_header = nullptr;
+    const Elf32_Ehdr *elf = nullptr;
+    const Elf32_Phdr *segments = nullptr;
+    SegmentInfosForReloc segment_reloc_info;
+    std::vector<Elf_Half> load_segments;
+    std::vector<Elf_Half> reloc_segments;
+    bool failed = false;
+};
+
+static ThreadPool &loader_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
 /**
- * \return Negative on failure
+ * \brief Validates the SELF and allocates guest memory for its loadable segments.
+ * Runs serially so segment addresses do not depend on thread scheduling.
+ * \return False on failure
  */
-SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const void *self, const std::string &self_path) {
-    const uint8_t *const self_bytes = static_cast<const uint8_t *>(self);
-    const SCE_header &self_header = *static_cast<const SCE_header *>(self);
+static bool map_self(MappedSelf &mapped, MemState &mem) {
+    const uint8_t *const self_bytes = mapped.self_bytes;
+    const std::string &self_path = mapped.self_path;
+    const SCE_header &self_header = *reinterpret_cast<const SCE_header *>(self_bytes);
 
     // assumes little endian host
     if (self_header.magic != 0x00454353) {
         LOG_CRITICAL("SELF {} is corrupt or encrypted. Decryption is not yet supported.", self_path);
-        return -1;
+        return false;
     }
 
     if (self_header.version != 3) {
         LOG_CRITICAL("SELF {} version {} is not supported.", self_path, self_header.version);
-        return -1;
+        return false;
     }
 
     if (self_header.header_type != 1) {
         LOG_CRITICAL("SELF {} header type {} is not supported.", self_path, self_header.header_type);
-        return -1;
+        return false;
     }
 
     if (self_path == "app0:sce_module/steroid.suprx") {
         LOG_CRITICAL("You're trying to load a vitamin dump. It is not supported.");
-        return -1;
+        return false;
     }
 
     const uint8_t *const elf_bytes = self_bytes + self_header.elf_offset;
@@ -335,12 +358,14 @@ SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &me
 
     const segment_info *const seg_infos = reinterpret_cast<const segment_info *>(self_bytes + self_header.section_info_offset);
 
+    mapped.self_header = &self_header;
+    mapped.elf = &elf;
+    mapped.segments = segments;
+
     LOG_DEBUG_IF(LOG_MODULE_LOADING, "Loading SELF at {}, ELF type: {}, header_type: {}, self_filesize: {}, self_offset: {}, module_info_offset: {}", self_path, log_hex(elf.e_type), log_hex(self_header.header_type), log_hex(self_header.self_filesize), log_hex(self_header.self_offset), log_hex(module_info_offset));
 
-    SegmentInfosForReloc segment_reloc_info;
     for (Elf_Half seg_index = 0; seg_index < elf.e_phnum; ++seg_index) {
         const Elf32_Phdr &seg_header = segments[seg_index];
-        const uint8_t *const seg_bytes = self_bytes + self_header.header_len + seg_header.p_offset;
 
         auto get_seg_header_string = [&seg_header]() {
             return seg_header.p_type == PT_LOAD ? "LOAD" : (seg_header.p_type == PT_LOOS ? "LOOS" : "UNKNOWN");
@@ -357,46 +382,101 @@ SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &me
                 } else {
                     segment_address = alloc(mem, seg_header.p_memsz, alloc_name.c_str());
                 }
-                const Ptr<uint8_t> seg_addr(segment_address);
-                if (!seg_addr) {
+                if (!segment_address) {
                     LOG_ERROR("Failed to allocate memory for segment.");
-                    return -1;
-                }
-
-                if (seg_infos[seg_index].compression == 2) {
-                    unsigned long dest_bytes = seg_header.p_filesz;
-                    const uint8_t *const compressed_segment_bytes = self_bytes + seg_infos[seg_index].offset;
-
-                    int res = mz_uncompress(reinterpret_cast<uint8_t *>(seg_addr.get(mem)), &dest_bytes, compressed_segment_bytes, static_cast<mz_ulong>(seg_infos[seg_index].length));
-                    assert(res == MZ_OK);
-                } else {
-                    memcpy(seg_addr.get(mem), seg_bytes, seg_header.p_filesz);
+                    return false;
                 }
 
-                segment_reloc_info[seg_index] = { segment_address, seg_header.p_vaddr, seg_header.p_memsz };
+                mapped.segment_reloc_info[seg_index] = { segment_address, seg_header.p_vaddr, seg_header.p_memsz };
+                mapped.load_segments.push_back(seg_index);
             }
         } else if (seg_header.p_type == PT_LOOS) {
+            mapped.reloc_segments.push_back(seg_index);
+        } else {
+            LOG_CRITICAL("Unknown segment type {}", log_hex(seg_header.p_type));
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Inflates or copies every loadable segment into guest memory, then applies the relocations.
+ * Segments are unpacked as separate tasks on the pool. Relocations need all of them in place first.
+ * \return False on failure
+ */
+static bool unpack_self(MappedSelf &mapped, MemState &mem, ThreadPool &pool) {
+    const uint8_t *const self_bytes = mapped.self_bytes;
+    const SCE_header &self_header = *mapped.self_header;
+    const segment_info *const seg_infos = reinterpret_cast<const segment_info *>(self_bytes + self_header.section_info_offset);
+
+    std::vector<std::future<bool>> unpacked;
+    for (const Elf_Half seg_index : mapped.load_segments) {
+        unpacked.push_back(pool.submit([&mapped, &mem, self_bytes, &self_header, seg_infos, seg_index]() {
+            const Elf32_Phdr &seg_header = mapped.segments[seg_index];
+            uint8_t *const dest = Ptr<uint8_t>(mapped.segment_reloc_info.at(seg_index).addr).get(mem);
+
             if (seg_infos[seg_index].compression == 2) {
-                unsigned long dest_bytes = seg_header.p_filesz;
+                mz_ulong dest_bytes = seg_header.p_filesz;
                 const uint8_t *const compressed_segment_bytes = self_bytes + seg_infos[seg_index].offset;
-                std::unique_ptr<uint8_t[]> uncompressed(new uint8_t[dest_bytes]);
 
-                int res = mz_uncompress(uncompressed.get(), &dest_bytes, compressed_segment_bytes, static_cast<mz_ulong>(seg_infos[seg_index].length));
-                assert(res == MZ_OK);
-                if (!relocate(uncompressed.get(), seg_header.p_filesz, segment_reloc_info, mem)) {
-                    return -1;
-                }
+                const int res = mz_uncompress(dest, &dest_bytes, compressed_segment_bytes, static_cast<mz_ulong>(seg_infos[seg_index].length));
+                return res == MZ_OK;
+            }
 
-            } else {
-                if (!relocate(seg_bytes, seg_header.p_filesz, segment_reloc_info, mem)) {
-                    return -1;
-                }
+            const uint8_t *const seg_bytes = self_bytes + self_header.header_len + seg_header.p_offset;
+            memcpy(dest, seg_bytes, seg_header.p_filesz);
+            return true;
+        }));
+    }
+
+    bool success = true;
+    for (auto &segment : unpacked) {
+        if (!pool.wait(segment))
+            success = false;
+    }
+    if (!success) {
+        LOG_ERROR("Failed to decompress a segment of {}", mapped.self_path);
+        return false;
+    }
+
+    for (const Elf_Half seg_index : mapped.reloc_segments) {
+        const Elf32_Phdr &seg_header = mapped.segments[seg_index];
+        if (seg_infos[seg_index].compression == 2) {
+            mz_ulong dest_bytes = seg_header.p_filesz;
+            const uint8_t *const compressed_segment_bytes = self_bytes + seg_infos[seg_index].offset;
+            std::unique_ptr<uint8_t[]> uncompressed(new uint8_t[dest_bytes]);
+
+            int res = mz_uncompress(uncompressed.get(), &dest_bytes, compressed_segment_bytes, static_cast<mz_ulong>(seg_infos[seg_index].length));
+            assert(res == MZ_OK);
+            if (!relocate(uncompressed.get(), seg_header.p_filesz, mapped.segment_reloc_info, mem)) {
+                return false;
             }
+
         } else {
-            LOG_CRITICAL("Unknown segment type {}", log_hex(seg_header.p_type));
+            const uint8_t *const seg_bytes = self_bytes + self_header.header_len + seg_header.p_offset;
+            if (!relocate(seg_bytes, seg_header.p_filesz, mapped.segment_reloc_info, mem)) {
+                return false;
+            }
         }
     }
 
+    return true;
+}
+
+/**
+ * \brief Registers the module exports and resolves its imports against the modules linked before it.
+ * \return Negative on failure
+ */
+static SceUID link_self(Ptr<const void> &entry_point, MappedSelf &mapped, KernelState &kernel, MemState &mem) {
+    const uint8_t *const self_bytes = mapped.self_bytes;
+    const std::string &self_path = mapped.self_path;
+    const SCE_header &self_header = *mapped.self_header;
+    const Elf32_Ehdr &elf = *mapped.elf;
+    const uint32_t module_info_offset = elf.e_entry & 0x3fffffff;
+    const Elf32_Phdr *const segments = mapped.segments;
+    SegmentInfosForReloc &segment_reloc_info = mapped.segment_reloc_info;
+
     if (kernel.debugger.dump_elfs) {
         // Dump elf
         std::vector<uint8_t> dump_elf(self_bytes + self_header.header_len, self_bytes + self_header.self_filesize);
@@ -501,3 +581,44 @@ SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &me
 
     return uid;
 }
+
+/**
+ * \return Negative on failure
+ */
+SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const void *self, const std::string &self_path) {
+    std::vector<Ptr<const void>> entry_points;
+    const std::vector<SceUID> uids = load_selfs(entry_points, kernel, mem, { { self, self_path } });
+    entry_point = entry_points.front();
+    return uids.front();
+}
+
+std::vector<SceUID> load_selfs(std::vector<Ptr<const void>> &entry_points, KernelState &kernel, MemState &mem, const std::vector<SelfToLoad> &selfs) {
+    std::vector<MappedSelf> mapped(selfs.size());
+    for (size_t i = 0; i < selfs.size(); i++) {
+        mapped[i].self_bytes = static_cast<const uint8_t *>(selfs[i].self);
+        mapped[i].self_path = selfs[i].path;
+        mapped[i].failed = !map_self(mapped[i], mem);
+    }
+
+    // Modules only touch their own segments while unpacking, so they can all be processed at once
+    ThreadPool &pool = loader_pool();
+    std::vector<std::future<bool>> unpacked;
+    for (auto &module : mapped) {
+        if (module.failed)
+            unpacked.emplace_back();
+        else
+            unpacked.push_back(pool.submit([&module, &mem, &pool]() { return unpack_self(module, mem, pool); }));
+    }
+
+    std::vector<SceUID> uids(selfs.size(), -1);
+    entry_points.assign(selfs.size(), Ptr<const void>(0));
+    for (size_t i = 0; i < mapped.size(); i++) {
+        if (mapped[i].failed || !pool.wait(unpacked[i]))
+            continue;
+
+        // Linking is kept in load order, imports resolve against the exports of earlier modules
+        uids[i] = link_self(entry_points[i], mapped[i], kernel, mem);
+    }
+
+    return uids;
+}
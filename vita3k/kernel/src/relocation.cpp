@@ -20,6 +20,7 @@
 
 #include <self.h>
 
+#include <array>
 #include <cassert>
 #include <cstring>
 #include <string>
@@ -217,59 +218,106 @@ static void write_thumb_mov_abs(void *data, uint16_t symbol) {
     pair->upper.imm4 = symbol >> 12;
 }
 
-static bool relocate_entry(void *data, uint32_t code, uint32_t symval, uint32_t addend, uint32_t addr) {
-    LOG_DEBUG_IF(LOG_RELOCATIONS, "code: {}, *data: {}, data: {}, addr: {}, symval: {}, addend: {}", code, log_hex(*(reinterpret_cast<uint32_t *>(data))), data, log_hex(addr), log_hex(symval), log_hex(addend));
-    switch (code) {
-    case None:
-    case V4BX: // Untested.
-        return true;
+using RelocationWriter = void (*)(void *data, uint32_t symval, uint32_t addend, uint32_t addr);
 
-    case Abs32:
-    case Target1:
+// One specialized writer per relocation code, so applying an entry is a single indirect call
+// instead of a switch over every known code.
+template <Code code>
+static void write_relocation(void *data, uint32_t symval, uint32_t addend, uint32_t addr) {
+    if constexpr (code == Abs32 || code == Target1)
         write(data, symval + addend);
-        return true;
-
-    case Abs8:
+    else if constexpr (code == Abs8)
         write_masked(data, symval + addend, 0xff);
-        return true;
-
-    case Rel32:
-    case Target2:
+    else if constexpr (code == Rel32 || code == Target2)
         write(data, symval + addend - addr);
-        return true;
-
-    case Prel31:
+    else if constexpr (code == Prel31)
         write_masked(data, symval + addend - addr, INT32_MAX);
-        return true;
-
-    case ThumbCall:
+    else if constexpr (code == ThumbCall)
         write_thumb_call(data, symval + addend - addr);
-        return true;
-
-    case Call:
-    case Jump24:
+    else if constexpr (code == Call || code == Jump24)
         write_masked(data, (symval + addend - addr) >> 2, 0xffffff);
-        return true;
-
-    case MovwAbsNc:
+    else if constexpr (code == MovwAbsNc)
         write_mov_abs(data, symval + addend);
-        return true;
-
-    case MovtAbs:
+    else if constexpr (code == MovtAbs)
         write_mov_abs(data, (symval + addend) >> 16);
-        return true;
-
-    case ThumbMovwAbsNc:
+    else if constexpr (code == ThumbMovwAbsNc)
         write_thumb_mov_abs(data, symval + addend);
-        return true;
-
-    case ThumbMovtAbs:
+    else if constexpr (code == ThumbMovtAbs)
         write_thumb_mov_abs(data, (symval + addend) >> 16);
-        return true;
+    // None and V4BX (untested) have nothing to patch
+}
+
+static const std::array<RelocationWriter, 256> relocation_writers = []() {
+    std::array<RelocationWriter, 256> writers{};
+    writers[None] = write_relocation<None>;
+    writers[Abs32] = write_relocation<Abs32>;
+    writers[Rel32] = write_relocation<Rel32>;
+    writers[Abs8] = write_relocation<Abs8>;
+    writers[ThumbCall] = write_relocation<ThumbCall>;
+    writers[Call] = write_relocation<Call>;
+    writers[Jump24] = write_relocation<Jump24>;
+    writers[Target1] = write_relocation<Target1>;
+    writers[V4BX] = write_relocation<V4BX>;
+    writers[Target2] = write_relocation<Target2>;
+    writers[Prel31] = write_relocation<Prel31>;
+    writers[MovwAbsNc] = write_relocation<MovwAbsNc>;
+    writers[MovtAbs] = write_relocation<MovtAbs>;
+    writers[ThumbMovwAbsNc] = write_relocation<ThumbMovwAbsNc>;
+    writers[ThumbMovtAbs] = write_relocation<ThumbMovtAbs>;
+    return writers;
+}();
+
+// Segment table flattened once per patch, so entries never walk the std::map.
+struct RelocationSegments {
+    static constexpr size_t MAX_SEGMENTS = 16;
+
+    std::array<Address, MAX_SEGMENTS> start{};
+    std::array<SegmentInfoForReloc, MAX_SEGMENTS> ranges{};
+    size_t range_count = 0;
+    uint16_t present = 0;
+
+    explicit RelocationSegments(const SegmentInfosForReloc &segments) {
+        for (const auto &[index, seg] : segments) {
+            if (index >= MAX_SEGMENTS)
+                continue;
+            start[index] = seg.addr;
+            present |= 1 << index;
+            ranges[range_count++] = seg;
+        }
+    }
+
+    bool has(uint32_t index) const {
+        return index < MAX_SEGMENTS && (present & (1 << index));
     }
 
-    LOG_WARN("Unhandled relocation code {}.", code);
-    return true; // ignore unhandled relocations
+    // Finds the segment whose original virtual address range contains value, for formats 6 to 9.
+    // The last match wins, like the original map walk did.
+    bool find_by_vaddr(uint32_t value, uint32_t &segbase, Address &saddr) const {
+        bool found = false;
+        for (size_t i = 0; i < range_count; i++) {
+            const auto &seg = ranges[i];
+            if (value >= seg.p_vaddr && value < seg.p_vaddr + seg.size) {
+                segbase = seg.p_vaddr;
+                saddr = seg.addr;
+                found = true;
+            }
+        }
+        return found;
+    }
+};
+
+static bool relocate_entry(uint8_t *memory, uint32_t code, uint32_t symval, uint32_t addend, uint32_t addr) {
+    void *const data = memory + addr;
+    LOG_DEBUG_IF(LOG_RELOCATIONS, "code: {}, *data: {}, data: {}, addr: {}, symval: {}, addend: {}", code, log_hex(*(reinterpret_cast<uint32_t *>(data))), data, log_hex(addr), log_hex(symval), log_hex(addend));
+
+    const RelocationWriter writer = relocation_writers[code & 0xff];
+    if (!writer) {
+        LOG_WARN("Unhandled relocation code {}.", code);
+        return true; // ignore unhandled relocations
+    }
+
+    writer(data, symval, addend, addr);
+    return true;
 }
 
 bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &segments, const MemState &mem, bool is_var_import, uint32_t explicit_symval) {
@@ -284,6 +332,9 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
             LOG_DEBUG("    Segment: {} -> {} (size: {})", seg.first, log_hex(seg.second.addr), seg.second.size);
     }
 
+    const RelocationSegments segs(segments);
+    uint8_t *const memory = &mem.memory[0];
+
     // initialized in format 1 and 2
     Address g_addr = 0,
             g_offset = 0,
@@ -295,6 +346,26 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
             g_type = 0,
             g_type2 = 0;
 
+    // Writes every Abs32 slot of a format 6-9 run. They all live in the current patch segment,
+    // whose base is resolved once for the whole batch.
+    const auto relocate_abs32_run = [&](uint32_t offsets, uint32_t bitsize, uint32_t mask, uint32_t scale) {
+        const Address patch_seg_start = segs.start[g_patchseg & 0xf];
+        g_type2 = 0;
+        g_type = Abs32;
+        do {
+            g_offset += static_cast<Address>((offsets & mask) * scale);
+
+            uint32_t orgval;
+            memcpy(&orgval, memory + patch_seg_start + g_offset, sizeof(orgval));
+
+            uint32_t segbase = 0;
+            segs.find_by_vaddr(orgval, segbase, g_saddr);
+
+            assert((uint32_t)orgval >= (uint32_t)segbase);
+            write(memory + g_addr + g_offset, g_saddr + (orgval - segbase));
+        } while (bitsize && (offsets >>= bitsize));
+    };
+
     const EntryFormatUnknown *generic_entry = nullptr;
     while (entry < end) {
         generic_entry = static_cast<const EntryFormatUnknown *>(entry);
@@ -307,28 +378,28 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
             const EntryFormat0 *const format0_entry = static_cast<const EntryFormat0 *>(entry);
 
             const auto symbol_seg = format0_entry->symbol_segment;
-            const auto symbol_seg_start = segments.find(symbol_seg)->second.addr;
+            const auto symbol_seg_start = segs.start[symbol_seg];
             const auto patch_seg = format0_entry->patch_segment;
-            const auto patch_seg_start = segments.find(patch_seg)->second.addr;
+            const auto patch_seg_start = segs.start[patch_seg];
 
             const Address s = (format0_entry->symbol_segment == 0xf) ? 0 : symbol_seg_start;
             const Address p = patch_seg_start + format0_entry->offset;
             const Address a = format0_entry->addend;
 
-            LOG_DEBUG_IF(LOG_RELOCATIONS, "[FORMAT0]: offset: {}, code: {}, sym_seg: {}, sym_start: {}, patch_seg: {}, patch_start: {}, s: {}, p: {}, a: {}. {}",
-                format0_entry->offset, format0_entry->code, symbol_seg, log_hex(symbol_seg_start), patch_seg, log_hex(patch_seg_start), log_hex(s), log_hex(p), log_hex(a), log_hex((uint64_t)Ptr<uint32_t>(p).get(mem)));
+            LOG_DEBUG_IF(LOG_RELOCATIONS, "[FORMAT0]: offset: {}, code: {}, sym_seg: {}, sym_start: {}, patch_seg: {}, patch_start: {}, s: {}, p: {}, a: {}.",
+                format0_entry->offset, format0_entry->code, symbol_seg, log_hex(symbol_seg_start), patch_seg, log_hex(patch_seg_start), log_hex(s), log_hex(p), log_hex(a));
 
-            if (!relocate_entry(Ptr<uint32_t>(p).get(mem), format0_entry->code, s, a, p)) {
+            if (!relocate_entry(memory, format0_entry->code, s, a, p)) {
                 return false;
             }
 
             const Address addr2 = p + format0_entry->dist2 * 2;
 
             if (format0_entry->code2 != 0) {
-                LOG_DEBUG_IF(LOG_RELOCATIONS, "[FORMAT0/2]: code: {}, sym_seg: {}, sym_start: {}, s: {}, patch_seg: {}, p: {}, a: {}. {}",
-                    format0_entry->code2, format0_entry->symbol_segment, symbol_seg_start, format0_entry->patch_segment, log_hex(patch_seg_start), log_hex(s), log_hex(addr2), log_hex(a), log_hex((uint64_t)Ptr<uint32_t>(addr2).get(mem)));
+                LOG_DEBUG_IF(LOG_RELOCATIONS, "[FORMAT0/2]: code: {}, sym_seg: {}, sym_start: {}, patch_seg: {}, p: {}, a: {}.",
+                    format0_entry->code2, format0_entry->symbol_segment, log_hex(symbol_seg_start), format0_entry->patch_segment, log_hex(addr2), log_hex(a));
 
-                if (!relocate_entry(Ptr<uint32_t>(addr2).get(mem), format0_entry->code2, s, a, addr2)) {
+                if (!relocate_entry(memory, format0_entry->code2, s, a, addr2)) {
                     return false;
                 }
             }
@@ -348,9 +419,9 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
                 const EntryFormat1 *const format1_entry = static_cast<const EntryFormat1 *>(entry);
 
                 const auto symbol_seg = format1_entry->symbol_segment;
-                const auto symbol_seg_start = segments.find(symbol_seg)->second.addr;
+                const auto symbol_seg_start = segs.start[symbol_seg];
                 const auto patch_seg = format1_entry->patch_segment;
-                const auto patch_seg_start = segments.find(patch_seg)->second.addr;
+                const auto patch_seg_start = segs.start[patch_seg];
                 const Address s = (format1_entry->symbol_segment == 0xf) ? 0 : symbol_seg_start;
 
                 const Address offset = format1_entry->offset_lo | (format1_entry->offset_hi << 12);
@@ -358,9 +429,9 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
                 const Address a = format1_entry->addend;
 
                 LOG_DEBUG_IF(LOG_RELOCATIONS, "[FORMAT1]: code: {}, sym_seg: {}, sym_start: {}, patch_seg: {}, data_start: {}, s: {}, offset: {}, p: {}, a: {}",
-                    format1_entry->code, symbol_seg, log_hex(symbol_seg_start), patch_seg, log_hex(patch_seg_start), log_hex(s), format1_entry->patch_segment, patch_seg_start, log_hex(offset), log_hex(p), log_hex(a));
+                    format1_entry->code, symbol_seg, log_hex(symbol_seg_start), patch_seg, log_hex(patch_seg_start), log_hex(s), log_hex(offset), log_hex(p), log_hex(a));
 
-                if (!relocate_entry(Ptr<uint32_t>(p).get(mem), format1_entry->code, s, a, p)) {
+                if (!relocate_entry(memory, format1_entry->code, s, a, p)) {
                     return false;
                 }
 
@@ -376,35 +447,29 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
                 const EntryFormat1Alt *const format1_entry = static_cast<const EntryFormat1Alt *>(entry);
 
                 const auto symbol_seg = format1_entry->symbol_segment;
-                const auto symbol_seg_start_it = segments.find(symbol_seg);
                 const auto patch_seg = format1_entry->patch_segment;
-                const auto patch_seg_start_it = segments.find(patch_seg);
                 const Address s = explicit_symval;
 
-                Address symbol_seg_start{};
-                if (symbol_seg_start_it != segments.end())
-                    symbol_seg_start = symbol_seg_start_it->second.addr;
-                else {
-                    LOG_WARN("[FORMAT1_VAR_IMPORT] symbol segment {} at {} not found. Skipping relocation.", symbol_seg, log_hex(symbol_seg_start));
+                if (!segs.has(symbol_seg)) {
+                    LOG_WARN("[FORMAT1_VAR_IMPORT] symbol segment {} not found. Skipping relocation.", symbol_seg);
                     goto advance_entry;
                 }
+                const Address symbol_seg_start = segs.start[symbol_seg];
 
-                Address patch_seg_start{};
-                if (patch_seg_start_it != segments.end())
-                    patch_seg_start = patch_seg_start_it->second.addr;
-                else {
+                if (!segs.has(patch_seg)) {
                     LOG_WARN("[FORMAT1_VAR_IMPORT] patch segment {} not found. Skipping relocation. symbol_seg {} at {}, s: {} ", patch_seg, symbol_seg, log_hex(symbol_seg_start), log_hex(s));
                     goto advance_entry;
                 }
+                const Address patch_seg_start = segs.start[patch_seg];
 
                 const Address offset = format1_entry->offset;
                 const Address p = patch_seg_start + offset;
                 const Address a = 0;
 
                 LOG_DEBUG_IF(LOG_RELOCATIONS, "[FORMAT1_VAR_IMPORT]: code: {}, sym_seg: {}, sym_start: {}, patch_seg: {}, data_start: {}, s: {}, offset: {}, p: {}, a: {}",
-                    format1_entry->code, symbol_seg, log_hex(symbol_seg_start), patch_seg, log_hex(patch_seg_start), log_hex(s), format1_entry->patch_segment, patch_seg_start, log_hex(offset), log_hex(p), log_hex(a));
+                    format1_entry->code, symbol_seg, log_hex(symbol_seg_start), patch_seg, log_hex(patch_seg_start), log_hex(s), log_hex(offset), log_hex(p), log_hex(a));
 
-                if (!relocate_entry(Ptr<uint32_t>(p).get(mem), format1_entry->code, s, a, p)) {
+                if (!relocate_entry(memory, format1_entry->code, s, a, p)) {
                     return false;
                 }
 
@@ -423,7 +488,7 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
             const EntryFormat2 *const format2_entry = static_cast<const EntryFormat2 *>(entry);
 
             const auto symbol_seg = format2_entry->symbol_segment;
-            const auto symbol_seg_start = segments.find(symbol_seg)->second.addr;
+            const auto symbol_seg_start = segs.start[symbol_seg];
 
             g_offset += format2_entry->offset;
             g_saddr = (format2_entry->symbol_segment == 0xf) ? 0 : symbol_seg_start;
@@ -437,7 +502,7 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
             LOG_DEBUG_IF(LOG_RELOCATIONS, "[FORMAT2]: code: {}, sym_seg: {}, sym_start: {}, offset: {}, s: {}, p: {}, a: {}",
                 format2_entry->code, symbol_seg, log_hex(symbol_seg_start), log_hex(format2_entry->offset), log_hex(s), log_hex(p), log_hex(a));
 
-            if (!relocate_entry(Ptr<uint32_t>(p).get(mem), g_type, s, a, p)) {
+            if (!relocate_entry(memory, g_type, s, a, p)) {
                 return false;
             }
 
@@ -451,35 +516,28 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
                 log_hex(format3_entry->symbol_segment), format3_entry->mode, format3_entry->mode ? "THUMB" : "ARM", log_hex(format3_entry->offset), log_hex(format3_entry->dist2), log_hex(format3_entry->addend));
 
             const auto symbol_seg = format3_entry->symbol_segment;
-            const auto symbol_seg_start = segments.find(symbol_seg)->second.addr;
+            const auto symbol_seg_start = segs.start[symbol_seg];
             const Address s = (format3_entry->symbol_segment == 0xf) ? 0 : symbol_seg_start;
-            const auto mode = format3_entry->mode;
-            const auto offset = format3_entry->offset;
             const auto dist2 = format3_entry->dist2;
 
-            if (mode == 1)
-                g_type = ThumbMovwAbsNc;
-            else if (mode == 0)
-                g_type = MovwAbsNc;
-
-            if (mode == 1)
-                g_type2 = ThumbMovtAbs;
-            else if (mode == 0)
-                g_type2 = MovtAbs;
-
-            g_offset += offset;
+            g_offset += format3_entry->offset;
             g_saddr = s;
             g_addend = format3_entry->addend;
 
             const auto a = g_addend;
             const auto p = g_addr + g_offset;
 
-            if (!relocate_entry(Ptr<uint32_t>(p).get(mem), g_type, s, a, p)) {
-                return false;
-            }
-
-            if (!relocate_entry(Ptr<uint32_t>(p + dist2).get(mem), g_type2, s, a, p + dist2)) {
-                return false;
+            // The movw/movt pair is fully determined by the mode, no table lookup needed
+            if (format3_entry->mode) {
+                g_type = ThumbMovwAbsNc;
+                g_type2 = ThumbMovtAbs;
+                write_relocation<ThumbMovwAbsNc>(memory + p, s, a, p);
+                write_relocation<ThumbMovtAbs>(memory + p + dist2, s, a, p + dist2);
+            } else {
+                g_type = MovwAbsNc;
+                g_type2 = MovtAbs;
+                write_relocation<MovwAbsNc>(memory + p, s, a, p);
+                write_relocation<MovtAbs>(memory + p + dist2, s, a, p + dist2);
             }
 
             break;
@@ -497,11 +555,11 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
             const auto a = g_addend;
             const auto p = g_addr + g_offset;
 
-            if (!relocate_entry(Ptr<uint32_t>(p).get(mem), g_type, s, a, p)) {
+            if (!relocate_entry(memory, g_type, s, a, p)) {
                 return false;
             }
 
-            if (!relocate_entry(Ptr<uint32_t>(p + dist2).get(mem), g_type2, s, a, p + dist2)) {
+            if (!relocate_entry(memory, g_type2, s, a, p + dist2)) {
                 return false;
             }
 
@@ -516,22 +574,22 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
             const auto a = g_addend;
             const auto p = g_addr + g_offset;
 
-            if (!relocate_entry(Ptr<uint32_t>(p).get(mem), g_type, s, a, p)) {
+            if (!relocate_entry(memory, g_type, s, a, p)) {
                 return false;
             }
 
-            if (!relocate_entry(Ptr<uint32_t>(p + format5_entry->dist2).get(mem), g_type2, s, a, p + format5_entry->dist2)) {
+            if (!relocate_entry(memory, g_type2, s, a, p + format5_entry->dist2)) {
                 return false;
             }
 
             g_offset += format5_entry->dist3;
             const auto p2 = g_addr + g_offset;
 
-            if (!relocate_entry(Ptr<uint32_t>(p2).get(mem), g_type, s, a, p2)) {
+            if (!relocate_entry(memory, g_type, s, a, p2)) {
                 return false;
             }
 
-            if (!relocate_entry(Ptr<uint32_t>(p2 + format5_entry->dist4).get(mem), g_type2, s, a, p2 + format5_entry->dist4)) {
+            if (!relocate_entry(memory, g_type2, s, a, p2 + format5_entry->dist4)) {
                 return false;
             }
 
@@ -540,34 +598,8 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
         case 6: {
             const EntryFormat6 *const format6_entry = static_cast<const EntryFormat6 *>(entry);
 
-            g_offset += format6_entry->offset;
-
-            const auto patch_seg_start = segments.find(g_patchseg)->second.addr;
-
-            const uint32_t orgval = *Ptr<uint32_t>(patch_seg_start + g_offset).get(mem);
-
-            uint32_t segbase = 0;
-            for (const auto &seg_ : segments) {
-                const auto seg = seg_.second;
-                if (orgval >= seg.p_vaddr && orgval < seg.p_vaddr + seg.size) {
-                    segbase = seg.p_vaddr;
-                    g_saddr = seg.addr;
-                }
-            }
-
-            assert((uint32_t)orgval >= (uint32_t)segbase);
-            const auto addend = orgval - segbase;
-
-            g_type2 = 0;
-            g_type = Abs32;
-
-            const auto s = g_saddr;
-            const auto a = addend;
-            const auto p = g_addr + g_offset;
-
-            if (!relocate_entry(Ptr<uint32_t>(p).get(mem), g_type, s, a, p)) {
-                return false;
-            }
+            // A single slot at an absolute offset: a run of one with no bit shifting
+            relocate_abs32_run(format6_entry->offset, 0, 0xFFFFFFF, 1);
 
             break;
         }
@@ -576,52 +608,18 @@ bool relocate(const void *entries, uint32_t size, const SegmentInfosForReloc &se
         case 9: {
             const EntryFormat7_8_9 *const format7_8_9_entry = static_cast<const EntryFormat7_8_9 *>(entry);
             const auto format = format7_8_9_entry->format;
-            uint32_t offsets = format7_8_9_entry->offsets;
+            const uint32_t offsets = format7_8_9_entry->offsets;
 
             LOG_DEBUG_IF(LOG_RELOCATIONS, "[FORMAT{}]: offsets: {}", std::to_string(format), log_hex(offsets));
 
-            uint32_t bitsize = 0;
-            uint32_t mask = 0;
             // clang-format off
             switch (format) {
-            case 7: bitsize = 7; mask = 0x7F; break;
-            case 8: bitsize = 4; mask = 0x0F; break;
-            case 9: bitsize = 2; mask = 0x03; break;
+            case 7: relocate_abs32_run(offsets, 7, 0x7F, sizeof(uint32_t)); break;
+            case 8: relocate_abs32_run(offsets, 4, 0x0F, sizeof(uint32_t)); break;
+            case 9: relocate_abs32_run(offsets, 2, 0x03, sizeof(uint32_t)); break;
             }
             // clang-format on
 
-            do {
-                auto offset = (offsets & mask) * sizeof(uint32_t);
-                g_offset += static_cast<Address>(offset);
-
-                const auto patch_seg_start = segments.find(g_patchseg)->second.addr;
-
-                const uint32_t orgval = *Ptr<uint32_t>(patch_seg_start + g_offset).get(mem);
-
-                uint32_t segbase = 0;
-                for (const auto seg_ : segments) {
-                    const auto seg = seg_.second;
-                    if (orgval >= seg.p_vaddr && orgval < seg.p_vaddr + seg.size) {
-                        segbase = seg.p_vaddr;
-                        g_saddr = seg.addr;
-                    }
-                }
-
-                assert((uint32_t)orgval >= (uint32_t)segbase);
-                const auto addend = orgval - segbase;
-
-                g_type2 = 0;
-                g_type = Abs32;
-
-                const auto s = g_saddr;
-                const auto a = addend;
-                const auto p = g_addr + g_offset;
-
-                if (!relocate_entry(Ptr<uint32_t>(p).get(mem), g_type, s, a, p)) {
-                    return false;
-                }
-            } while (offsets >>= bitsize);
-
             break;
         }
         default: {
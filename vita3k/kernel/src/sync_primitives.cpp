@@ -91,18 +91,44 @@ inline int find_condvar(CondvarPtr &condvar_out, CondvarPtrs **condvars_out, Ker
     return SCE_KERNEL_OK;
 }
 
-// TODO: Write remaining time to timeout ptr when it's successfully signaled
+// Sleeps until the thread is woken up, with the timer wheel ending the wait once the timeout runs out.
+// Returns false on timeout, otherwise the time that was left is written back to the timeout.
+static bool wait_with_timeout(KernelState &kernel, const ThreadStatePtr &thread, std::unique_lock<std::mutex> &thread_lock, SceUInt *const timeout) {
+    const uint32_t serial = ++thread->wait_serial;
+    thread->wait_timed_out = false;
+
+    const std::weak_ptr<ThreadState> weak_thread = thread;
+    const TimerHandle timer = kernel.timer_wheel.schedule(*timeout, [weak_thread, serial] {
+        const ThreadStatePtr thread = weak_thread.lock();
+        if (!thread)
+            return;
+
+        const std::lock_guard<std::mutex> lock(thread->mutex);
+        if (thread->wait_serial != serial || thread->status != ThreadStatus::wait)
+            return;
+
+        thread->wait_timed_out = true;
+        thread->status_cond.notify_all();
+    });
+
+    thread->status_cond.wait(thread_lock, [&] { return thread->status == ThreadStatus::run || thread->wait_timed_out; });
+
+    if (thread->status != ThreadStatus::run) {
+        *timeout = 0; // Time run out, so remaining time is 0
+        return false;
+    }
 
-inline int handle_timeout(const ThreadStatePtr &thread, std::unique_lock<std::mutex> &thread_lock,
+    *timeout = static_cast<SceUInt>(kernel.timer_wheel.remaining_us(timer).value_or(0));
+    kernel.timer_wheel.cancel(timer);
+    return true;
+}
+
+inline int handle_timeout(KernelState &kernel, const ThreadStatePtr &thread, std::unique_lock<std::mutex> &thread_lock,
     std::unique_lock<std::mutex> &primitive_lock, WaitingThreadQueuePtr &queue,
     const WaitingThreadData &data, const char *export_name, SceUInt *const timeout) {
     if (timeout && *timeout > 0) {
-        auto status = thread->status_cond.wait_for(thread_lock, std::chrono::microseconds{ *timeout }, [&] { return thread->status == ThreadStatus::run; });
-
-        if (!status) {
-            *timeout = 0; // Time run out, so remaining time is 0
-
-            thread->status = ThreadStatus::run;
+        if (!wait_with_timeout(kernel, thread, thread_lock, timeout)) {
+            thread->update_status(ThreadStatus::run);
 
             thread_lock.unlock();
             primitive_lock.lock();
@@ -227,7 +253,7 @@ inline int mutex_lock_impl(KernelState &kernel, MemState &mem, const char *expor
         mutex->waiting_threads->push(data);
         mutex_lock.unlock();
 
-        int res = handle_timeout(thread, thread_lock, mutex_lock, mutex->waiting_threads, data, export_name, timeout);
+        int res = handle_timeout(kernel, thread, thread_lock, mutex_lock, mutex->waiting_threads, data, export_name, timeout);
 
         if (weight == SyncWeight::Light) {
             mutex->workarea.get(mem)->lockCount = mutex->lock_count;
@@ -429,7 +455,7 @@ SceInt32 semaphore_wait(KernelState &kernel, const char *export_name, SceUID thr
         semaphore->waiting_threads->push(data);
         semaphore_lock.unlock();
 
-        return handle_timeout(thread, thread_lock, semaphore_lock, semaphore->waiting_threads, data, export_name, pTimeout);
+        return handle_timeout(kernel, thread, thread_lock, semaphore_lock, semaphore->waiting_threads, data, export_name, pTimeout);
     } else {
         semaphore->val -= needCount;
     }
@@ -576,7 +602,7 @@ int condvar_wait(KernelState &kernel, MemState &mem, const char *export_name, Sc
     condvar->waiting_threads->push(data);
     condition_variable_lock.unlock();
 
-    if (auto error = handle_timeout(thread, thread_lock, condition_variable_lock, condvar->waiting_threads, data, export_name, timeout))
+    if (auto error = handle_timeout(kernel, thread, thread_lock, condition_variable_lock, condvar->waiting_threads, data, export_name, timeout))
         return error;
 
     thread_lock.unlock();
@@ -757,7 +783,7 @@ static int eventflag_waitorpoll(KernelState &kernel, const char *export_name, Sc
         event->waiting_threads->push(data);
         event_lock.unlock();
 
-        return handle_timeout(thread, thread_lock, event_lock, event->waiting_threads, data, export_name, timeout);
+        return handle_timeout(kernel, thread, thread_lock, event_lock, event->waiting_threads, data, export_name, timeout);
     }
 
     return SCE_KERNEL_OK;
@@ -942,8 +968,7 @@ int msgpipe_recv(KernelState &kernel, const char *export_name, SceUID thread_id,
             for (auto it = msgpipe->senders->begin(); it != msgpipe->senders->end(); it++) {
                 auto threadInfo = (*it);
                 if (threadInfo.mp.request_size <= msgpipe->data_buffer.Free()) { // Found a thread we can service
-                    threadInfo.thread->status = ThreadStatus::run;
-                    threadInfo.thread->status_cond.notify_one();
+                    threadInfo.thread->update_status(ThreadStatus::run);
 
                     msgpipe->senders->erase(it); // Erase other thread's info - done here to avoid race
                     break; // Should we try to signal other threads, too?
@@ -994,7 +1019,7 @@ int msgpipe_recv(KernelState &kernel, const char *export_name, SceUID thread_id,
 
             return finish();
         } else { // There's a timeout - wait until we can fill buffer or timeout
-            auto status = thread->status_cond.wait_for(thread_lock, std::chrono::microseconds{ *timeout }, [&] { return thread->status == ThreadStatus::run; });
+            const bool status = wait_with_timeout(kernel, thread, thread_lock, timeout);
             if (msgpipe->beingDeleted) {
                 std::atomic_fetch_add(&msgpipe->remainingThreads, -1);
                 return SCE_KERNEL_ERROR_WAIT_DELETE;
@@ -1094,7 +1119,7 @@ int msgpipe_send(KernelState &kernel, const char *export_name, SceUID thread_id,
 
             return finish();
         } else { // There's a timeout - wait until we can fill buffer or timeout
-            auto status = thread->status_cond.wait_for(thread_lock, std::chrono::microseconds{ *timeout }, [&] { return thread->status == ThreadStatus::run; });
+            const bool status = wait_with_timeout(kernel, thread, thread_lock, timeout);
             if (msgpipe->beingDeleted) {
                 std::atomic_fetch_add(&msgpipe->remainingThreads, -1);
                 return SCE_KERNEL_ERROR_WAIT_DELETE;
@@ -1146,3 +1171,125 @@ SceUID msgpipe_delete(KernelState &kernel, const char *export_name, const char *
 
     return SCE_KERNEL_OK;
 }
+
+// ***************
+// * Timer Event *
+// ***************
+
+// Wakes a thread waiting on a timer event with the given result, the timer lock must be held.
+// A thread whose wait just timed out is already running and keeps its timeout.
+static void timer_event_wake(const WaitingThreadData &data, SceInt32 result) {
+    const std::lock_guard<std::mutex> waiting_thread_lock(data.thread->mutex);
+    if (data.thread->status != ThreadStatus::wait)
+        return;
+
+    *data.timer.result = result;
+    data.thread->update_status(ThreadStatus::run, ThreadStatus::wait);
+}
+
+void timer_event_fire(TimerState &timer) {
+    const std::lock_guard<std::mutex> timer_lock(timer.mutex);
+
+    if (timer.waiting_threads->empty()) {
+        // Nobody to tell yet, the event stays signalled for the next wait or poll
+        timer.event_count++;
+        return;
+    }
+
+    do {
+        const WaitingThreadData data = *timer.waiting_threads->begin();
+        timer.waiting_threads->pop();
+        timer_event_wake(data, SCE_KERNEL_OK);
+    } while (timer.notify_behaviour == TimerState::NotifyBehaviour::ALL && !timer.waiting_threads->empty());
+
+    // An automatically reset event is used up by the threads it woke
+    if (timer.reset_behaviour == TimerState::ResetBehaviour::MANUAL)
+        timer.event_count++;
+}
+
+// Consumes a pending event, the timer lock must be held
+static bool timer_event_take(TimerState &timer) {
+    if (!timer.event_count)
+        return false;
+
+    if (timer.reset_behaviour == TimerState::ResetBehaviour::AUTOMATIC)
+        timer.event_count = 0;
+    return true;
+}
+
+SceInt32 timer_event_wait(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID timer_id, SceUInt32 *pResultPattern, SceUInt32 *pTimeout) {
+    const TimerPtr timer = lock_and_find(timer_id, kernel.timers, kernel.mutex);
+    if (!timer) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_TIMER_ID);
+    }
+
+    if (LOG_SYNC_PRIMITIVES) {
+        LOG_DEBUG("{}: uid: {} thread_id: {} name: \"{}\" event_count: {} timeout: {} waiting_threads: {}",
+            export_name, timer_id, thread_id, timer->name, timer->event_count, pTimeout ? *pTimeout : 0,
+            timer->waiting_threads->size());
+    }
+
+    const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
+
+    std::unique_lock<std::mutex> timer_lock(timer->mutex);
+
+    SceInt32 result = SCE_KERNEL_OK;
+    if (!timer_event_take(*timer)) {
+        std::unique_lock<std::mutex> thread_lock(thread->mutex);
+        thread->update_status(ThreadStatus::wait, ThreadStatus::run);
+
+        WaitingThreadData data;
+        data.thread = thread;
+        data.priority = timer->thread_behaviour == TimerState::ThreadBehaviour::PRIORITY ? thread->priority : 0;
+        data.timer.result = &result;
+
+        timer->waiting_threads->push(data);
+        timer_lock.unlock();
+
+        const int wait_result = handle_timeout(kernel, thread, thread_lock, timer_lock, timer->waiting_threads, data, export_name, pTimeout);
+        if (wait_result != SCE_KERNEL_OK)
+            return wait_result;
+        if (result == SCE_KERNEL_ERROR_WAIT_CANCEL)
+            return RET_ERROR(SCE_KERNEL_ERROR_WAIT_CANCEL);
+    }
+
+    if (pResultPattern)
+        *pResultPattern = SCE_KERNEL_EVENT_TIMER;
+    return SCE_KERNEL_OK;
+}
+
+SceInt32 timer_event_poll(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID timer_id, SceUInt32 *pResultPattern) {
+    const TimerPtr timer = lock_and_find(timer_id, kernel.timers, kernel.mutex);
+    if (!timer) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_TIMER_ID);
+    }
+
+    const std::lock_guard<std::mutex> timer_lock(timer->mutex);
+    if (!timer_event_take(*timer)) {
+        return RET_ERROR(SCE_KERNEL_ERROR_EVENT_COND);
+    }
+
+    if (pResultPattern)
+        *pResultPattern = SCE_KERNEL_EVENT_TIMER;
+    return SCE_KERNEL_OK;
+}
+
+SceInt32 timer_event_cancel(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID timer_id, SceUInt32 *pNumWaitThreads) {
+    const TimerPtr timer = lock_and_find(timer_id, kernel.timers, kernel.mutex);
+    if (!timer) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_TIMER_ID);
+    }
+
+    const std::lock_guard<std::mutex> timer_lock(timer->mutex);
+    if (pNumWaitThreads)
+        *pNumWaitThreads = static_cast<SceUInt32>(timer->waiting_threads->size());
+
+    while (!timer->waiting_threads->empty()) {
+        const WaitingThreadData data = *timer->waiting_threads->begin();
+        timer->waiting_threads->pop();
+        timer_event_wake(data, SCE_KERNEL_ERROR_WAIT_CANCEL);
+    }
+    timer->event_count = 0;
+
+    return SCE_KERNEL_OK;
+}
@@ -20,6 +20,7 @@
 
 #include <kernel/state.h>
 #include <mem/ptr.h>
+#include <rtc/rtc.h>
 #include <util/align.h>
 
 #include <cpu/functions.h>
@@ -84,13 +85,15 @@ int ThreadState::init(KernelState &kernel, const char *name, Ptr<const void> ent
 
     std::string alloc_name = fmt::format("Stack for thread {} (#{})", name, id);
     stack = alloc_block(mem, stack_size, alloc_name.c_str());
-    memset(stack.get_ptr<void>().get(mem), 0xcc, stack_size);
+    // Fresh blocks read as zero and only get committed once touched, filling them defeats that,
+    // so it's only worth it when hunting reads of uninitialized stack
+    if (kernel.debugger.fill_stacks)
+        memset(stack.get_ptr<void>().get(mem), 0xcc, stack_size);
 
     alloc_name = fmt::format("TLS for thread {} (#{})", name, id);
     const size_t tls_size = KERNEL_TLS_SIZE + kernel.tls_msize;
     tls = alloc_block(mem, tls_size, alloc_name.c_str());
     const Ptr<uint8_t> base_tls_ptr = tls.get_ptr<uint8_t>();
-    memset(base_tls_ptr.get(mem), 0, tls_size);
 
     if (kernel.tls_address) {
         const Ptr<uint8_t> user_tls_ptr = base_tls_ptr + KERNEL_TLS_SIZE;
@@ -134,9 +137,7 @@ void ThreadState::flush_callback_requests() {
 void ThreadState::raise_waiting_threads() {
     for (auto t : waiting_threads) {
         const std::unique_lock<std::mutex> lock(t->mutex);
-        assert(t->status == ThreadStatus::wait);
-        t->status = ThreadStatus::run;
-        t->status_cond.notify_all();
+        t->update_status(ThreadStatus::run, ThreadStatus::wait);
     }
     waiting_threads.clear();
 }
@@ -179,14 +180,23 @@ int ThreadState::start(KernelState &kernel, SceSize arglen, const Ptr<void> &arg
     return SCE_KERNEL_OK;
 }
 
+static thread_local ThreadState *current_thread = nullptr;
+
+ThreadState *get_current_thread() {
+    return current_thread;
+}
+
 bool ThreadState::run_loop() {
+    // Each guest thread runs its whole life in here, on a host thread of its own
+    current_thread = this;
+
     int res = 0;
     RunQueue::iterator current_job;
     std::unique_lock<std::mutex> lock(mutex);
     while (true) {
         switch (to_do) {
         case ThreadToDo::exit:
-            raise_waiting_threads();
+            update_status(ThreadStatus::dormant);
             return true;
         case ThreadToDo::run:
         case ThreadToDo::step:
@@ -321,6 +331,10 @@ void ThreadState::update_status(ThreadStatus status, std::optional<ThreadStatus>
     if (expected)
         assert(expected.value() == this->status);
 
+    // The unlocked guest clock only skips ahead while no guest thread runs
+    if ((this->status == ThreadStatus::run) != (status == ThreadStatus::run))
+        rtc_add_running_guest_threads((status == ThreadStatus::run) ? 1 : -1);
+
     this->status = status;
     status_cond.notify_all();
 
@@ -0,0 +1,323 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <kernel/timer_wheel.h>
+
+#include <rtc/rtc.h>
+
+#include <algorithm>
+#include <chrono>
+
+// The guest clock can change speed or skip ahead while the wheel thread sleeps, so it never sleeps longer than this
+static constexpr std::chrono::milliseconds MAX_HOST_WAIT(4);
+
+static uint32_t highest_bit(uint64_t value) {
+    uint32_t bit = 0;
+    while (value >>= 1)
+        bit++;
+    return bit;
+}
+
+TimerWheel::TimerWheel(bool threaded)
+    : start(rtc_ticks_since_epoch())
+    , threaded(threaded) {
+    for (Level &level : levels)
+        level.heads.fill(NONE);
+}
+
+TimerWheel::~TimerWheel() {
+    stop();
+}
+
+uint64_t TimerWheel::to_tick(uint64_t time_us) const {
+    if (time_us <= start)
+        return 0;
+    return (time_us - start) / TICK_US;
+}
+
+uint64_t TimerWheel::to_time(uint64_t tick) const {
+    return start + tick * TICK_US;
+}
+
+TimerHandle TimerWheel::schedule(uint64_t delay_us, TimerCallback callback, uint64_t period_us) {
+    return schedule_at(rtc_ticks_since_epoch() + delay_us, std::move(callback), period_us);
+}
+
+TimerHandle TimerWheel::schedule_at(uint64_t when_us, TimerCallback callback, uint64_t period_us) {
+    // Round up, a timer never fires early
+    const uint64_t expiry = to_tick(when_us + TICK_US - 1);
+    const uint64_t period = period_us ? std::max<uint64_t>((period_us + TICK_US - 1) / TICK_US, 1) : 0;
+    return insert(expiry, period, std::move(callback));
+}
+
+TimerHandle TimerWheel::insert(uint64_t expiry, uint64_t period, TimerCallback callback) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (quit)
+        return 0;
+
+    uint32_t index;
+    if (free_timers.empty()) {
+        index = static_cast<uint32_t>(timers.size());
+        timers.emplace_back();
+    } else {
+        index = free_timers.back();
+        free_timers.pop_back();
+    }
+
+    Timer &timer = timers[index];
+    timer.expiry = expiry;
+    timer.period = period;
+    timer.callback = std::move(callback);
+    link(index);
+    count++;
+
+    if (threaded) {
+        if (!thread.joinable())
+            thread = std::thread([this] { run(); });
+        else if (std::max(expiry, current + 1) < wake_tick)
+            wake.notify_one();
+    }
+
+    return (static_cast<uint64_t>(timer.generation) << 32) | (index + 1);
+}
+
+TimerWheel::Timer *TimerWheel::find(TimerHandle handle) {
+    const uint64_t index = (handle & UINT32_MAX) - 1;
+    if (handle == 0 || index >= timers.size())
+        return nullptr;
+
+    Timer &timer = timers[index];
+    if (timer.generation != (handle >> 32) || timer.slot == NONE)
+        return nullptr;
+
+    return &timer;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Timer &timer = timers[index];
+    timer.callback = nullptr;
+    timer.generation++;
+    free_timers.push_back(index);
+    count--;
+}
+
+bool TimerWheel::cancel(TimerHandle handle) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    Timer *timer = find(handle);
+    if (!timer)
+        return false;
+
+    const uint32_t index = static_cast<uint32_t>(timer - timers.data());
+    unlink(index);
+    release(index);
+    return true;
+}
+
+std::optional<uint64_t> TimerWheel::remaining_us(TimerHandle handle) {
+    const uint64_t now = rtc_ticks_since_epoch();
+    const std::lock_guard<std::mutex> lock(mutex);
+    const Timer *timer = find(handle);
+    if (!timer)
+        return std::nullopt;
+
+    const uint64_t expiry = to_time(timer->expiry);
+    if (expiry <= now)
+        return 0;
+
+    return expiry - now;
+}
+
+size_t TimerWheel::pending() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return count;
+}
+
+void TimerWheel::link(uint32_t index) {
+    Timer &timer = timers[index];
+    const uint64_t expiry = std::max(timer.expiry, current + 1);
+
+    // The level is picked by the highest group of bits in which the expiry differs from the current tick
+    uint32_t level = highest_bit(expiry ^ current) / LEVEL_BITS;
+    uint32_t slot;
+    if (level < LEVELS) {
+        slot = (expiry >> (level * LEVEL_BITS)) & (SLOTS - 1);
+    } else {
+        // Too far away, park it in the slot of the top level that comes around last
+        level = LEVELS - 1;
+        slot = ((current >> (level * LEVEL_BITS)) - 1) & (SLOTS - 1);
+    }
+
+    Level &wheel_level = levels[level];
+    timer.slot = level * SLOTS + slot;
+    timer.prev = NONE;
+    timer.next = wheel_level.heads[slot];
+    if (timer.next != NONE)
+        timers[timer.next].prev = index;
+    wheel_level.heads[slot] = index;
+    wheel_level.occupied |= uint64_t(1) << slot;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Timer &timer = timers[index];
+    Level &wheel_level = levels[timer.slot / SLOTS];
+    const uint32_t slot = timer.slot % SLOTS;
+
+    if (timer.prev != NONE)
+        timers[timer.prev].next = timer.next;
+    else
+        wheel_level.heads[slot] = timer.next;
+
+    if (timer.next != NONE)
+        timers[timer.next].prev = timer.prev;
+
+    if (wheel_level.heads[slot] == NONE)
+        wheel_level.occupied &= ~(uint64_t(1) << slot);
+
+    timer.prev = NONE;
+    timer.next = NONE;
+    timer.slot = NONE;
+}
+
+void TimerWheel::advance(uint64_t tick, std::vector<uint32_t> &due) {
+    if (tick <= current)
+        return;
+
+    // Empty every slot the wheel moved past, on every level it moved on
+    std::vector<uint32_t> crossed;
+    for (uint32_t level = 0; level < LEVELS; level++) {
+        const uint32_t shift = level * LEVEL_BITS;
+        const uint64_t from = current >> shift;
+        const uint64_t to = tick >> shift;
+        if (from == to)
+            break;
+
+        Level &wheel_level = levels[level];
+        const uint64_t steps = std::min<uint64_t>(to - from, SLOTS);
+        for (uint64_t step = 1; step <= steps && wheel_level.occupied; step++) {
+            const uint32_t slot = (from + step) & (SLOTS - 1);
+            while (wheel_level.heads[slot] != NONE) {
+                const uint32_t index = wheel_level.heads[slot];
+                unlink(index);
+                crossed.push_back(index);
+            }
+        }
+    }
+
+    current = tick;
+
+    // What is not due yet moves down to a finer level
+    for (const uint32_t index : crossed) {
+        if (timers[index].expiry <= tick)
+            due.push_back(index);
+        else
+            link(index);
+    }
+}
+
+std::optional<uint64_t> TimerWheel::next_tick() const {
+    std::optional<uint64_t> next;
+    for (uint32_t level = 0; level < LEVELS; level++) {
+        const Level &wheel_level = levels[level];
+        if (!wheel_level.occupied)
+            continue;
+
+        const uint32_t shift = level * LEVEL_BITS;
+        const uint64_t position = current >> shift;
+        for (uint64_t step = 1; step <= SLOTS; step++) {
+            if (wheel_level.occupied & (uint64_t(1) << ((position + step) & (SLOTS - 1)))) {
+                const uint64_t tick = (position + step) << shift;
+                if (!next || tick < *next)
+                    next = tick;
+                break;
+            }
+        }
+    }
+
+    return next;
+}
+
+size_t TimerWheel::poll(uint64_t now_us) {
+    std::vector<TimerCallback> callbacks;
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        std::vector<uint32_t> due;
+        advance(to_tick(now_us), due);
+        if (due.empty())
+            return 0;
+
+        std::stable_sort(due.begin(), due.end(), [&](uint32_t lhs, uint32_t rhs) {
+            return timers[lhs].expiry < timers[rhs].expiry;
+        });
+
+        callbacks.reserve(due.size());
+        for (const uint32_t index : due) {
+            Timer &timer = timers[index];
+            if (timer.period) {
+                callbacks.push_back(timer.callback);
+                timer.expiry += timer.period;
+                link(index);
+            } else {
+                callbacks.push_back(std::move(timer.callback));
+                release(index);
+            }
+        }
+    }
+
+    for (const TimerCallback &callback : callbacks)
+        callback();
+
+    return callbacks.size();
+}
+
+void TimerWheel::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!quit) {
+        const std::optional<uint64_t> next = next_tick();
+        if (next) {
+            wake_tick = *next;
+            const uint64_t deadline = to_time(*next);
+            const uint64_t now = rtc_ticks_since_epoch();
+            if (deadline > now) {
+                const std::chrono::nanoseconds host_wait(static_cast<int64_t>((deadline - now) * 1000.0 / rtc_get_clock_speed()));
+                wake.wait_for(lock, std::min<std::chrono::nanoseconds>(host_wait, MAX_HOST_WAIT));
+            }
+        } else {
+            wake_tick = UINT64_MAX;
+            wake.wait(lock);
+        }
+        wake_tick = 0;
+
+        if (quit)
+            break;
+
+        lock.unlock();
+        poll(rtc_ticks_since_epoch());
+        lock.lock();
+    }
+}
+
+void TimerWheel::stop() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+        wake.notify_one();
+    }
+
+    if (thread.joinable())
+        thread.join();
+}
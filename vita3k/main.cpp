@@ -26,6 +26,7 @@
 #include <host/pkg.h>
 #include <host/state.h>
 #include <modules/module_parent.h>
+#include <renderer/capture.h>
 #include <renderer/functions.h>
 #include <renderer/gl/functions.h>
 #include <shader/spirv_recompiler.h>
@@ -307,7 +308,7 @@ int main(int argc, char *argv[]) {
         return err;
 
     // Pre-Compile Shader only for glsl, spriv is broken
-    if (!host.cfg.spirv_shader) {
+    if (!host.cfg.spirv_shader && host.renderer->current_backend == renderer::Backend::OpenGL) {
         auto &glstate = static_cast<renderer::gl::GLState &>(*host.renderer);
         if (renderer::gl::get_shaders_cache_hashs(glstate, host.base_path.c_str(), host.io.title_id.c_str()) && cfg.shader_cache) {
             for (const auto &hash : glstate.shaders_cache_hashs) {
@@ -323,6 +324,11 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    if (host.cfg.gxm_capture_frames > 0) {
+        const fs::path capture_path = fs::path(host.base_path) / "gxmcapture" / (host.io.title_id + ".gxmcap");
+        host.renderer->capture = std::make_unique<renderer::capture::CaptureWriter>(capture_path, host.cfg.gxm_capture_frames);
+    }
+
     if (const auto err = run_app(host, entry_point) != Success)
         return err;
 
@@ -334,6 +340,8 @@ int main(int argc, char *argv[]) {
         {
             const std::lock_guard<std::mutex> guard(host.display.display_info_mutex);
             host.renderer->render_frame(host.viewport_pos, host.viewport_size, host.display, host.mem);
+            if (host.renderer->capture)
+                host.renderer->capture->end_frame(host.display);
         }
 
         gui::draw_begin(gui, host);
@@ -353,6 +361,8 @@ int main(int argc, char *argv[]) {
         {
             const std::lock_guard<std::mutex> guard(host.display.display_info_mutex);
             host.renderer->render_frame(host.viewport_pos, host.viewport_size, host.display, host.mem);
+            if (host.renderer->capture)
+                host.renderer->capture->end_frame(host.display);
         }
 
         // Calculate FPS
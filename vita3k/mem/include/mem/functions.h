@@ -29,6 +29,15 @@ Address alloc(MemState &state, size_t size, const char *name);
 Address alloc(MemState &state, size_t size, const char *name, unsigned int alignment);
 bool add_write_protect(MemState &state, Address addr, const size_t size, WriteProtectCallback callback);
 bool remove_write_protect(MemState &state, Address addr);
+// Protect a range against reads and writes, for contents the owner of the request produces later. A thread
+// faulting on the range raises the request's wanted flag and waits in the fault handler until the owner writes
+// the contents and releases the range with remove_access_protect, raising it again now and then. Faults of the
+// owner itself are counted in declined and open the range as it is, nobody else would serve them.
+bool add_access_protect(MemState &state, Address addr, const size_t size, AccessProtectRequestPtr request);
+bool remove_access_protect(MemState &state, Address addr);
+// Write the contents of an access protected range while it stays protected, so that no other thread sees it
+// half written. Hosts that cannot write protected pages open the range just for the copy.
+bool write_access_protected(MemState &state, Address addr, const void *data, size_t size);
 bool is_valid_addr(const MemState &state, Address addr);
 bool is_valid_addr_range(const MemState &state, Address start, Address end);
 bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcept;
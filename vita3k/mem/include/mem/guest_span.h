@@ -0,0 +1,138 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <mem/functions.h>
+#include <mem/ptr.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+template <typename T>
+constexpr size_t guest_element_size() {
+    if constexpr (std::is_void_v<T>)
+        return 1;
+    else
+        return sizeof(T);
+}
+
+/**
+ * \brief Bounds checked view of a guest buffer.
+ *
+ * The whole range is validated against the allocator once, when the view is made. Code using
+ * it then reads and writes guest memory in place, and only has to test valid() once.
+ * A null pointer with a count of 0 is a valid empty view. void buffers are counted in bytes.
+ */
+template <typename T>
+class GuestSpan {
+public:
+    static constexpr size_t element_size = guest_element_size<T>();
+
+    GuestSpan() = default;
+
+    static GuestSpan make(Ptr<T> ptr, size_t count, const MemState &mem) {
+        GuestSpan span;
+        if (count == 0) {
+            span.ptr = ptr;
+            span.is_valid = true;
+            return span;
+        }
+
+        const uint64_t start = ptr.address();
+        const uint64_t end = start + static_cast<uint64_t>(count) * element_size;
+        // end has to fit in an Address, so ranges running up to the very top of the address space are refused too
+        if (!ptr || end >= (uint64_t(1) << 32) || !is_valid_addr_range(mem, static_cast<Address>(start), static_cast<Address>(end)))
+            return span;
+
+        span.ptr = ptr;
+        span.host = ptr.get(mem);
+        span.count = count;
+        span.is_valid = true;
+        return span;
+    }
+
+    bool valid() const {
+        return is_valid;
+    }
+
+    Ptr<T> guest() const {
+        return ptr;
+    }
+
+    T *data() const {
+        return host;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t size_bytes() const {
+        return count * element_size;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    template <typename U = T>
+    std::enable_if_t<!std::is_void_v<U>, U &> operator[](size_t index) const {
+        return host[index];
+    }
+
+    template <typename U = T>
+    std::enable_if_t<!std::is_void_v<U>, U *> begin() const {
+        return host;
+    }
+
+    template <typename U = T>
+    std::enable_if_t<!std::is_void_v<U>, U *> end() const {
+        return host + count;
+    }
+
+    // Clamped to the view, like everything else about it
+    GuestSpan subspan(size_t offset, size_t sub_count) const {
+        GuestSpan span = *this;
+        offset = std::min(offset, count);
+        span.count = std::min(sub_count, count - offset);
+        span.ptr = Ptr<T>(ptr.address() + static_cast<Address>(offset * element_size));
+        if (host) {
+            using Byte = std::conditional_t<std::is_const_v<T>, const uint8_t, uint8_t>;
+            span.host = reinterpret_cast<T *>(reinterpret_cast<Byte *>(host) + offset * element_size);
+        }
+        return span;
+    }
+
+private:
+    Ptr<T> ptr;
+    T *host = nullptr;
+    size_t count = 0;
+    bool is_valid = false;
+};
+
+template <typename T>
+struct is_guest_span : std::false_type {};
+
+template <typename T>
+struct is_guest_span<GuestSpan<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_guest_span_v = is_guest_span<T>::value;
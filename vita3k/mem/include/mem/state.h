@@ -21,6 +21,7 @@
 #include <mem/util.h>
 
 #include <array>
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <set>
@@ -36,27 +37,41 @@ typedef std::unique_ptr<uint8_t[], std::function<void(uint8_t *)>> Memory;
 typedef std::unique_ptr<MemPage[], std::function<void(MemPage *)>> PageTable;
 typedef std::map<int, std::string> PageNameMap;
 
-struct WriteProtect {
+template <typename Callback>
+struct ProtectedRange {
     Address addr = 0;
     size_t size = 0;
-    std::vector<WriteProtectCallback> callbacks;
+    std::vector<Callback> callbacks;
 
-    WriteProtect() = delete;
-    explicit WriteProtect(Address addr)
+    ProtectedRange() = delete;
+    explicit ProtectedRange(Address addr)
         : addr(addr) {}
-    explicit WriteProtect(Address addr, size_t size, WriteProtectCallback callback)
+    explicit ProtectedRange(Address addr, size_t size, Callback callback)
         : addr(addr)
         , size(size) {
         callbacks.push_back(callback);
         callbacks.reserve(5);
     }
 
-    bool operator<(const WriteProtect &other) const {
+    bool operator<(const ProtectedRange &other) const {
         return this->addr < other.addr;
     }
 };
 
+typedef ProtectedRange<WriteProtectCallback> WriteProtect;
+typedef ProtectedRange<AccessProtectRequestPtr> AccessProtect;
 typedef std::set<WriteProtect> WriteProtectTree;
+typedef std::set<AccessProtect> AccessProtectTree;
+
+constexpr size_t ACCESS_PROTECT_SLOT_COUNT = 1024;
+
+// What the fault handler reads instead of the access protect tree: it can't take protect_mutex, which the
+// faulting thread may be holding itself. Slots are only written under protect_mutex.
+struct AccessProtectSlot {
+    // Page aligned address in the high half and size in the low half, zero when the slot is free
+    std::atomic<uint64_t> range{ 0 };
+    std::atomic<AccessProtectRequest *> request{ nullptr };
+};
 
 struct MemState {
     std::mutex generation_mutex;
@@ -67,6 +82,12 @@ struct MemState {
     PageTable page_table;
     BitmapAllocator allocator;
     WriteProtectTree write_protect_tree;
+    AccessProtectTree access_protect_tree;
+    // Bumped whenever an access protected range is released, threads parked in the fault handler watch it
+    std::atomic<uint32_t> access_release_generation{ 0 };
+    std::array<AccessProtectSlot, ACCESS_PROTECT_SLOT_COUNT> access_protect_slots;
+    // Fault handlers between reading a slot and being done with its request, whose tree entry keeps it alive
+    std::atomic<uint32_t> access_protect_lookups{ 0 };
 
     PageNameMap page_name_map;
 };
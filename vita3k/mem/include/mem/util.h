@@ -17,10 +17,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 struct CPUState;
@@ -29,6 +31,18 @@ struct MemState;
 typedef uint32_t Address;
 typedef std::function<void()> WriteProtectCallback;
 
+// Shared by the thread producing the contents of an access protected range and the fault handler, which only
+// touches the atomics, see add_access_protect
+struct AccessProtectRequest {
+    // Faults of this thread are not waited on, nothing else would produce the contents
+    std::thread::id owner;
+    // Raised when another thread faults on the range, it then waits for the owner to write and release it
+    std::atomic<bool> wanted{ false };
+    // Counts the faults of the owner, the range was opened as it was for them
+    std::atomic<uint32_t> declined{ 0 };
+};
+typedef std::shared_ptr<AccessProtectRequest> AccessProtectRequestPtr;
+
 constexpr size_t KB(size_t kb) {
     return kb * 1024;
 }
@@ -25,13 +25,16 @@
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <thread>
 
 #ifdef WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #else
+#include <fcntl.h>
 #include <signal.h>
 #include <sys/mman.h>
+#include <time.h>
 #include <unistd.h>
 #endif
 
@@ -39,11 +42,19 @@ constexpr size_t STANDARD_PAGE_SIZE = 4096;
 constexpr size_t TOTAL_MEM_SIZE = GB(4);
 constexpr bool LOG_PROTECT = false;
 constexpr bool PAGE_NAME_TRACKING = false;
+// A thread faulting on an access protected range asks for its contents again after this many sleeps
+constexpr int ACCESS_WAIT_SLICES = 2000;
+constexpr long ACCESS_WAIT_SLICE_NS = 50'000;
 
 //TODO: support multiple handlers
 static AccessViolationHandler access_violation_handler;
 static void register_access_violation_handler(AccessViolationHandler handler);
 
+#ifdef __linux__
+// Writes through the process memory file ignore page protections, the way a debugger pokes memory
+static int self_memory_fd = -1;
+#endif
+
 static Address alloc_inner(MemState &state, uint32_t start_page, int page_count, const char *name, const bool force);
 static void delete_memory(uint8_t *memory);
 static void delete_pagetable(MemPage *page_table);
@@ -91,6 +102,11 @@ bool init(MemState &state) {
     };
     register_access_violation_handler(handler);
 
+#ifdef __linux__
+    if (self_memory_fd < 0)
+        self_memory_fd = open("/proc/self/mem", O_RDWR | O_CLOEXEC);
+#endif
+
     const Address null_address = alloc_inner(state, 0, 1, "null", true);
     assert(null_address == 0);
 #ifdef WIN32
@@ -154,7 +170,9 @@ static Address alloc_inner(MemState &state, uint32_t start_page, int page_count,
 #else
     mprotect(memory, size, PROT_READ | PROT_WRITE);
 #endif
+#if !defined(WIN32) && !defined(__linux__)
     std::memset(memory, 0, size);
+#endif
 
     MemPage &page = state.page_table[page_num];
     assert(!page.allocated);
@@ -192,7 +210,8 @@ Address alloc(MemState &state, size_t size, const char *name, unsigned int align
     return align_addr;
 }
 
-static void align_to_page(MemState &state, WriteProtect &protect) {
+template <typename Range>
+static void align_to_page(MemState &state, Range &protect) {
     const Address end = align(protect.addr + protect.size, state.page_size);
     const Address addr = align_down(protect.addr, state.page_size);
     const size_t size = end - addr;
@@ -200,7 +219,8 @@ static void align_to_page(MemState &state, WriteProtect &protect) {
     protect.size = size;
 }
 
-static bool overlap_in_page(MemState &state, const WriteProtect &a, const WriteProtect &b) {
+template <typename Range>
+static bool overlap_in_page(MemState &state, const Range &a, const Range &b) {
     const Address a_start = align_down(a.addr, state.page_size);
     const Address a_end = align(a.addr + a.size, state.page_size);
     const Address b_start = align_down(b.addr, state.page_size);
@@ -231,18 +251,181 @@ static void protect_inner(MemState &state, Address addr, size_t size) {
 #endif
 }
 
-static WriteProtectTree::iterator find_write_protect(WriteProtectTree &tree, Address addr) {
-    if (tree.empty()) {
+static void noaccess_inner(MemState &state, Address addr, size_t size) {
+#ifdef WIN32
+    DWORD old_protect = 0;
+    const BOOL ret = VirtualProtect(&state.memory[addr], size - 1, PAGE_NOACCESS, &old_protect);
+    LOG_CRITICAL_IF(!ret, "VirtualAlloc failed: {}", log_hex(GetLastError()));
+#else
+    mprotect(&state.memory[addr], size, PROT_NONE);
+#endif
+}
+
+template <typename Tree>
+static typename Tree::iterator find_write_protect(Tree &tree, Address addr) {
+    auto it = tree.upper_bound(typename Tree::value_type(addr));
+    if (it == tree.begin()) {
         return tree.end();
     }
-    return --tree.upper_bound(WriteProtect(addr));
+    return --it;
 }
 
-bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcept {
-    // We only use write protect for now
-    if (!write) {
+// Call f on the part of every region of the tree that lies in [addr, addr + size)
+template <typename Tree, typename F>
+static void for_each_overlap(Tree &tree, Address addr, size_t size, F f) {
+    auto it = tree.upper_bound(typename Tree::value_type(addr));
+    if (it != tree.begin())
+        --it;
+    const Address end = addr + size;
+    for (; it != tree.end() && it->addr < end; ++it) {
+        const Address start = std::max(it->addr, addr);
+        const Address stop = std::min<Address>(it->addr + it->size, end);
+        if (start < stop)
+            f(start, stop - start);
+    }
+}
+
+// Changing the protection of a range must not lift the stricter protection of the other tree
+static void restore_access_protect(MemState &state, Address addr, size_t size) {
+    for_each_overlap(state.access_protect_tree, addr, size, [&](Address start, size_t length) {
+        noaccess_inner(state, start, length);
+    });
+}
+
+static void restore_write_protect(MemState &state, Address addr, size_t size) {
+    for_each_overlap(state.write_protect_tree, addr, size, [&](Address start, size_t length) {
+        protect_inner(state, start, length);
+    });
+}
+
+// Memory in the range has been written to: anything watching it for writes is stale now
+static void invalidate_write_protect(MemState &state, Address addr, size_t size) {
+    auto it = state.write_protect_tree.upper_bound(WriteProtect(addr));
+    if (it != state.write_protect_tree.begin())
+        --it;
+    while (it != state.write_protect_tree.end() && it->addr < addr + size) {
+        if (it->addr + it->size <= addr) {
+            ++it;
+            continue;
+        }
+        for (const auto &cb : it->callbacks) {
+            cb();
+        }
+        const Address protect_addr = it->addr;
+        const size_t protect_size = it->size;
+        unprotect_inner(state, protect_addr, protect_size);
+        state.write_protect_tree.erase(it++);
+        restore_access_protect(state, protect_addr, protect_size);
+    }
+}
+
+static uint64_t pack_access_range(Address addr, size_t size) {
+    return (static_cast<uint64_t>(addr) << 32) | static_cast<uint32_t>(size);
+}
+
+static bool add_access_protect_slot(MemState &state, Address addr, size_t size, AccessProtectRequest *request) {
+    for (auto &slot : state.access_protect_slots) {
+        if (slot.range.load() == 0) {
+            slot.request.store(request);
+            slot.range.store(pack_access_range(addr, size));
+            return true;
+        }
+    }
+    return false;
+}
+
+static void clear_access_protect_slots(MemState &state, Address addr, size_t size) {
+    bool cleared = false;
+    for (auto &slot : state.access_protect_slots) {
+        const uint64_t range = slot.range.load();
+        const uint64_t slot_addr = range >> 32;
+        if (range && slot_addr < uint64_t(addr) + size && slot_addr + static_cast<uint32_t>(range) > addr) {
+            slot.range.store(0);
+            slot.request.store(nullptr);
+            cleared = true;
+        }
+    }
+
+    // A fault handler that read the slot before it was cleared may still use its request
+    while (cleared && state.access_protect_lookups.load() != 0)
+        std::this_thread::yield();
+}
+
+static void release_access_protect(MemState &state, AccessProtectTree::iterator it) {
+    const Address protect_addr = it->addr;
+    const size_t protect_size = it->size;
+    clear_access_protect_slots(state, protect_addr, protect_size);
+    unprotect_inner(state, protect_addr, protect_size);
+    state.access_protect_tree.erase(it);
+    restore_write_protect(state, protect_addr, protect_size);
+    state.access_release_generation.fetch_add(1, std::memory_order_release);
+}
+
+static void sleep_in_fault_handler() {
+#ifdef WIN32
+    Sleep(1);
+#else
+    // nanosleep is async signal safe, unlike anything built on a mutex or a condition variable
+    const timespec slice = { 0, ACCESS_WAIT_SLICE_NS };
+    nanosleep(&slice, nullptr);
+#endif
+}
+
+static void open_in_fault_handler(MemState &state, Address addr, size_t size) {
+#ifdef WIN32
+    DWORD old_protect = 0;
+    VirtualProtect(&state.memory[addr], size - 1, PAGE_READWRITE, &old_protect);
+#else
+    mprotect(&state.memory[addr], size, PROT_READ | PROT_WRITE);
+#endif
+}
+
+// Only atomics and system calls in here: the faulting thread may hold protect_mutex, or be halfway through
+// changing the trees. Contents are produced and ranges released by the owners of the requests.
+static bool handle_access_protect(MemState &state, Address vaddr) {
+    const uint32_t generation = state.access_release_generation.load(std::memory_order_acquire);
+    const auto self = std::this_thread::get_id();
+    bool found = false;
+    bool wait = false;
+
+    state.access_protect_lookups.fetch_add(1);
+    for (auto &slot : state.access_protect_slots) {
+        const uint64_t range = slot.range.load();
+        const Address addr = static_cast<Address>(range >> 32);
+        const uint32_t size = static_cast<uint32_t>(range);
+        if (!range || vaddr < addr || vaddr - addr >= size)
+            continue;
+        AccessProtectRequest *const request = slot.request.load();
+        if (!request)
+            continue;
+
+        found = true;
+        if (request->owner == self) {
+            request->declined.fetch_add(1, std::memory_order_relaxed);
+            open_in_fault_handler(state, addr, size);
+        } else {
+            request->wanted.store(true, std::memory_order_release);
+            wait = true;
+        }
+    }
+    state.access_protect_lookups.fetch_sub(1);
+
+    if (!found)
         return false;
+    if (!wait)
+        return true;
+
+    // The range stays protected while its contents are produced. Any release retries the access, which faults
+    // again if it was another range. Past the last slice the access is retried anyway, asking for the contents again.
+    for (int slice = 0; slice < ACCESS_WAIT_SLICES; slice++) {
+        if (state.access_release_generation.load(std::memory_order_acquire) != generation)
+            break;
+        sleep_in_fault_handler();
     }
+    return true;
+}
+
+bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcept {
     const uintptr_t memory_addr = reinterpret_cast<uintptr_t>(state.memory.get());
     const uintptr_t fault_addr = reinterpret_cast<uintptr_t>(addr);
     if (fault_addr < memory_addr || fault_addr >= memory_addr + TOTAL_MEM_SIZE) {
@@ -256,6 +439,14 @@ bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcep
         fmt::print("Access: {}\n", log_hex(vaddr));
     }
 
+    if (handle_access_protect(state, vaddr)) {
+        return true;
+    }
+    // Only writes can hit a write protected region
+    if (!write) {
+        return false;
+    }
+
     const std::lock_guard<std::mutex> lock(state.protect_mutex);
     const auto it = find_write_protect(state.write_protect_tree, vaddr);
     if (it == state.write_protect_tree.end()) {
@@ -276,8 +467,11 @@ bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcep
     for (const auto cb : it->callbacks) {
         cb();
     }
-    unprotect_inner(state, it->addr, it->size);
+    const Address protect_addr = it->addr;
+    const size_t protect_size = it->size;
+    unprotect_inner(state, protect_addr, protect_size);
     state.write_protect_tree.erase(it);
+    restore_access_protect(state, protect_addr, protect_size);
     return true;
 }
 
@@ -297,6 +491,7 @@ bool add_write_protect(MemState &state, Address addr, const size_t size, WritePr
     state.write_protect_tree.emplace(protect);
 
     protect_inner(state, protect.addr, protect.size);
+    restore_access_protect(state, protect.addr, protect.size);
 
     return true;
 }
@@ -305,8 +500,67 @@ bool remove_write_protect(MemState &state, Address addr) {
     const auto it = find_write_protect(state.write_protect_tree, addr);
     if (it == state.write_protect_tree.end())
         return false;
-    unprotect_inner(state, it->addr, it->size);
+    const Address protect_addr = it->addr;
+    const size_t protect_size = it->size;
+    unprotect_inner(state, protect_addr, protect_size);
     state.write_protect_tree.erase(it);
+    restore_access_protect(state, protect_addr, protect_size);
+    return true;
+}
+
+bool add_access_protect(MemState &state, Address addr, const size_t size, AccessProtectRequestPtr request) {
+    const std::lock_guard<std::mutex> lock(state.protect_mutex);
+    AccessProtect protect(addr, size, request);
+    align_to_page(state, protect);
+    if (!add_access_protect_slot(state, protect.addr, protect.size, request.get())) {
+        LOG_ERROR("Too many access protected ranges, {} is left unprotected", log_hex(addr));
+        return false;
+    }
+
+    auto it = find_write_protect(state.access_protect_tree, protect.addr);
+    while (it != state.access_protect_tree.end() && overlap_in_page(state, *it, protect)) {
+        const Address start = std::min(it->addr, protect.addr);
+        protect.size = std::max(it->addr + it->size, protect.addr + protect.size) - start;
+        protect.addr = start;
+        protect.callbacks.insert(protect.callbacks.end(), it->callbacks.begin(), it->callbacks.end());
+        state.access_protect_tree.erase(it++);
+    }
+    state.access_protect_tree.emplace(protect);
+
+    noaccess_inner(state, protect.addr, protect.size);
+
+    return true;
+}
+
+bool remove_access_protect(MemState &state, Address addr) {
+    const std::lock_guard<std::mutex> lock(state.protect_mutex);
+    const auto it = find_write_protect(state.access_protect_tree, addr);
+    if (it == state.access_protect_tree.end() || addr >= it->addr + it->size)
+        return false;
+    release_access_protect(state, it);
+    return true;
+}
+
+bool write_access_protected(MemState &state, Address addr, const void *data, size_t size) {
+    const std::lock_guard<std::mutex> lock(state.protect_mutex);
+    const auto it = find_write_protect(state.access_protect_tree, addr);
+    if (it == state.access_protect_tree.end() || addr + size > it->addr + it->size)
+        return false;
+
+    bool written = false;
+#ifdef __linux__
+    if (self_memory_fd >= 0) {
+        const auto target = reinterpret_cast<uintptr_t>(&state.memory[addr]);
+        written = pwrite(self_memory_fd, data, size, static_cast<off_t>(target)) == static_cast<ssize_t>(size);
+    }
+#endif
+    if (!written) {
+        unprotect_inner(state, it->addr, it->size);
+        std::memcpy(&state.memory[addr], data, size);
+        noaccess_inner(state, it->addr, it->size);
+    }
+
+    invalidate_write_protect(state, addr, size);
     return true;
 }
 
@@ -356,6 +610,11 @@ void free(MemState &state, Address address) {
     assert(ret);
 #else
     mprotect(memory, page.size * state.page_size, PROT_NONE);
+#ifdef __linux__
+    // Gives the pages back to the host, they come back zero-filled the next time they're touched.
+    // Decommitted pages on Windows behave the same, so alloc doesn't need to clear anything there either
+    madvise(memory, page.size * state.page_size, MADV_DONTNEED);
+#endif
 #endif
 }
 
@@ -389,11 +648,19 @@ static LONG WINAPI exception_handler(PEXCEPTION_POINTERS pExp) noexcept {
     return EXCEPTION_CONTINUE_SEARCH;
 }
 
+// Vectored handlers also see the faults the JIT handles itself, only this one knows the process is going down
+static LONG WINAPI unhandled_exception_filter(PEXCEPTION_POINTERS pExp) noexcept {
+    // About to crash, get the log out first
+    logging::flush_on_crash();
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+
 static void register_access_violation_handler(AccessViolationHandler handler) {
     access_violation_handler = handler;
     if (!AddVectoredExceptionHandler(1, (PVECTORED_EXCEPTION_HANDLER)exception_handler)) {
         LOG_CRITICAL("Failed to register an exception handler");
     }
+    SetUnhandledExceptionFilter(unhandled_exception_filter);
 }
 
 #else
@@ -416,6 +683,8 @@ static void signal_handler(int sig, siginfo_t *info, void *uct) noexcept {
         }
     }
 
+    // About to crash, get the log out first
+    logging::flush_on_crash();
     raise(SIGTRAP);
     return;
 }
@@ -0,0 +1,161 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <mem/functions.h>
+#include <mem/state.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+TEST(access_protect, read_waits_for_contents) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(64), "protect");
+    const uint32_t *const data = reinterpret_cast<const uint32_t *>(&mem.memory[addr]);
+
+    const auto request = std::make_shared<AccessProtectRequest>();
+    add_access_protect(mem, addr, KB(16), request);
+
+    // Stands in for the renderer: produces the contents once someone asks for them
+    std::thread producer([&]() {
+        while (!request->wanted)
+            std::this_thread::yield();
+        std::vector<uint32_t> contents(KB(16) / 4);
+        for (size_t i = 0; i < contents.size(); i++)
+            contents[i] = static_cast<uint32_t>(i);
+        EXPECT_TRUE(write_access_protected(mem, addr, contents.data(), KB(16)));
+        EXPECT_TRUE(remove_access_protect(mem, addr));
+    });
+
+    EXPECT_EQ(data[100], 100u);
+    EXPECT_EQ(data[200], 200u);
+    producer.join();
+    EXPECT_TRUE(request->wanted);
+}
+
+TEST(access_protect, contents_stay_hidden_until_released) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(16), "protect");
+    const volatile uint8_t *const data = &mem.memory[addr];
+
+    add_access_protect(mem, addr, KB(4), std::make_shared<AccessProtectRequest>());
+    const std::vector<uint8_t> contents(KB(4), 0x5A);
+    ASSERT_TRUE(write_access_protected(mem, addr, contents.data(), contents.size()));
+
+    std::atomic<bool> read{ false };
+    std::thread reader([&]() {
+        EXPECT_EQ(data[KB(1)], 0x5A);
+        read = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(read);
+
+    EXPECT_TRUE(remove_access_protect(mem, addr));
+    reader.join();
+    EXPECT_TRUE(read);
+}
+
+TEST(access_protect, owner_fault_opens_range_as_is) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(16), "protect");
+
+    const auto request = std::make_shared<AccessProtectRequest>();
+    request->owner = std::this_thread::get_id();
+    add_access_protect(mem, addr, KB(4), request);
+
+    EXPECT_EQ(mem.memory[addr + 8], 0);
+    EXPECT_EQ(request->declined, 1u);
+    EXPECT_FALSE(request->wanted);
+    // Still registered, the owner writes its contents and releases it as usual
+    const std::vector<uint8_t> contents(KB(4), 0x33);
+    EXPECT_TRUE(write_access_protected(mem, addr, contents.data(), contents.size()));
+    EXPECT_TRUE(remove_access_protect(mem, addr));
+    EXPECT_EQ(mem.memory[addr + 8], 0x33);
+}
+
+// The faulting thread may be the one holding protect_mutex, the fault handler must get by without it
+TEST(access_protect, fault_while_holding_protect_mutex) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(16), "protect");
+
+    const auto request = std::make_shared<AccessProtectRequest>();
+    request->owner = std::this_thread::get_id();
+    add_access_protect(mem, addr, KB(4), request);
+    {
+        const std::lock_guard<std::mutex> lock(mem.protect_mutex);
+        EXPECT_EQ(mem.memory[addr], 0);
+    }
+    EXPECT_EQ(request->declined, 1u);
+    EXPECT_TRUE(remove_access_protect(mem, addr));
+}
+
+TEST(access_protect, write_fires_overlapping_write_protect) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(64), "protect");
+    uint8_t *const data = &mem.memory[addr];
+
+    bool invalidated = false;
+    add_write_protect(mem, addr, KB(32), [&]() { invalidated = true; });
+    add_access_protect(mem, addr + KB(8), KB(8), std::make_shared<AccessProtectRequest>());
+
+    // Pages outside of the access protected range stay readable
+    EXPECT_EQ(data[0], 0);
+
+    const std::vector<uint8_t> contents(KB(8), 0xAB);
+    EXPECT_TRUE(write_access_protected(mem, addr + KB(8), contents.data(), contents.size()));
+    EXPECT_TRUE(invalidated);
+    EXPECT_TRUE(remove_access_protect(mem, addr + KB(8)));
+
+    data[KB(8) + 1] = 0x12;
+    EXPECT_EQ(data[KB(8)], 0xAB);
+    EXPECT_EQ(data[KB(8) + 1], 0x12);
+}
+
+TEST(access_protect, removed_region_is_accessible) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(16), "protect");
+
+    const auto request = std::make_shared<AccessProtectRequest>();
+    add_access_protect(mem, addr, KB(4), request);
+    EXPECT_TRUE(remove_access_protect(mem, addr));
+    EXPECT_EQ(mem.memory[addr], 0);
+    EXPECT_FALSE(request->wanted);
+}
+
+TEST(alloc, reused_pages_come_back_zeroed) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(64), "dirty");
+    std::memset(&mem.memory[addr], 0xCC, KB(64));
+    free(mem, addr);
+
+    const Address again = alloc(mem, KB(64), "clean");
+    ASSERT_EQ(again, addr);
+    const uint8_t *const data = &mem.memory[again];
+    for (int i = 0; i < KB(64); i++)
+        ASSERT_EQ(data[i], 0) << "at offset " << i;
+}
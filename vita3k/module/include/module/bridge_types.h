@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <mem/guest_span.h>
 #include <mem/ptr.h>
 
 struct MemState;
@@ -40,3 +41,10 @@ struct BridgeTypes<Pointee *> {
         return t.get(mem);
     }
 };
+
+// Guest buffer, only the address is passed here. read() validates it together with
+// the element count in the argument that follows, see read_arg.h.
+template <typename T>
+struct BridgeTypes<GuestSpan<T>> {
+    typedef Ptr<T> ArmType;
+};
@@ -21,11 +21,20 @@
 
 #include <util/log.h>
 
-int unimplemented_impl(const char *name);
-#define UNIMPLEMENTED() unimplemented_impl(export_name)
-
-int stubbed_impl(const char *name, const char *info);
-#define STUBBED(info) stubbed_impl(export_name, info)
+#include <atomic>
+
+// Every call site has its own flag, so once it has been logged a call costs a relaxed load
+int unimplemented_impl(const char *name, std::atomic<bool> &logged);
+#define UNIMPLEMENTED() ([&] {                                                                 \
+    static std::atomic<bool> logged{ false };                                                  \
+    return logged.load(std::memory_order_relaxed) ? 0 : unimplemented_impl(export_name, logged); \
+}())
+
+int stubbed_impl(const char *name, const char *info, std::atomic<bool> &logged);
+#define STUBBED(info) ([&] {                                                                     \
+    static std::atomic<bool> logged{ false };                                                    \
+    return logged.load(std::memory_order_relaxed) ? 0 : stubbed_impl(export_name, info, logged); \
+}())
 
 #define BRIDGE_DECL(name) extern const ImportFn import_##name;
 #define BRIDGE_IMPL(name) const ImportFn import_##name = bridge(&export_##name, #name);
@@ -22,6 +22,8 @@
 
 #include <cpu/functions.h>
 
+#include <tuple>
+
 namespace module {
 class vargs;
 }
@@ -79,6 +81,14 @@ Arg read(CPUState &cpu, const ArgsLayout<Args...> &args, const LayoutArgsState &
     // fault where MSVC evaluates the rest of the function when the Arg type is vargs
     if constexpr (std::is_same_v<Arg, module::vargs>) {
         return make_vargs<Arg>(state);
+    } else if constexpr (is_guest_span_v<Arg>) {
+        // The element count is the next argument of the export, which still gets it as well
+        static_assert(index + 1 < sizeof...(Args), "GuestSpan must be followed by its element count");
+        using CountType = std::tuple_element_t<index + 1, std::tuple<Args...>>;
+        static_assert(std::is_integral_v<CountType>, "GuestSpan must be followed by its element count");
+        const ArmType bridged = read<ArmType>(cpu, args[index], mem);
+        const CountType count = read<CountType>(cpu, args[index + 1], mem);
+        return Arg::make(bridged, static_cast<size_t>(count), mem);
     } else {
         const ArmType bridged = read<ArmType>(cpu, args[index], mem);
         return BridgeTypes<Arg>::arm_to_host(bridged, mem);
@@ -18,36 +18,16 @@
 #include <module/module.h>
 #include <util/log.h>
 
-#include <mutex>
-#include <set>
-
-typedef std::set<std::string> NameSet;
-
-static std::mutex mutex;
-static NameSet logged;
-
-int unimplemented_impl(const char *name) {
-    bool inserted = false;
-    {
-        const std::lock_guard<std::mutex> lock(mutex);
-        inserted = logged.insert(name).second;
-    }
-
-    if (inserted) {
+int unimplemented_impl(const char *name, std::atomic<bool> &logged) {
+    if (!logged.exchange(true, std::memory_order_relaxed)) {
         LOG_WARN("Unimplemented {} import called.", name);
     }
 
     return 0;
 }
 
-int stubbed_impl(const char *name, const char *info) {
-    bool inserted = false;
-    {
-        const std::lock_guard<std::mutex> lock(mutex);
-        inserted = logged.insert(name).second;
-    }
-
-    if (inserted) {
+int stubbed_impl(const char *name, const char *info, std::atomic<bool> &logged) {
+    if (!logged.exchange(true, std::memory_order_relaxed)) {
         LOG_WARN("Stubbed {} import called. ({})", name, info);
     }
 
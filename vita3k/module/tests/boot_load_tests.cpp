@@ -0,0 +1,83 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/load_self.h>
+#include <kernel/state.h>
+#include <mem/functions.h>
+#include <mem/ptr.h>
+#include <util/fs.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+// Boot time benchmark: loads every PRX of a directory (for example vs0/sys/external of an installed firmware)
+// one by one, then all at once through load_selfs, and compares the results.
+// Set VITA3K_TEST_PRX_DIR to run it, it is skipped otherwise.
+
+using Buffers = std::vector<std::vector<uint8_t>>;
+
+static Buffers read_prx_files(const fs::path &dir, std::vector<std::string> &paths) {
+    Buffers buffers;
+    for (const auto &entry : fs::directory_iterator(dir)) {
+        if (entry.path().extension() != ".suprx")
+            continue;
+        std::ifstream file(entry.path().string(), std::ios::binary);
+        buffers.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        paths.push_back(entry.path().filename().string());
+    }
+    return buffers;
+}
+
+TEST(boot, load_prx_set) {
+    const char *const prx_dir = std::getenv("VITA3K_TEST_PRX_DIR");
+    if (!prx_dir || !fs::is_directory(prx_dir))
+        GTEST_SKIP() << "VITA3K_TEST_PRX_DIR is not set";
+
+    std::vector<std::string> paths;
+    const Buffers buffers = read_prx_files(prx_dir, paths);
+    ASSERT_FALSE(buffers.empty());
+
+    MemState serial_mem;
+    ASSERT_TRUE(init(serial_mem));
+    KernelState serial_kernel;
+    size_t serial_loaded = 0;
+    for (size_t i = 0; i < buffers.size(); i++) {
+        Ptr<const void> entry_point;
+        if (load_self(entry_point, serial_kernel, serial_mem, buffers[i].data(), paths[i]) >= 0)
+            serial_loaded++;
+    }
+
+    MemState batch_mem;
+    ASSERT_TRUE(init(batch_mem));
+    KernelState batch_kernel;
+    std::vector<SelfToLoad> selfs;
+    for (size_t i = 0; i < buffers.size(); i++)
+        selfs.push_back({ buffers[i].data(), paths[i] });
+    std::vector<Ptr<const void>> entry_points;
+    const std::vector<SceUID> uids = load_selfs(entry_points, batch_kernel, batch_mem, selfs);
+    const size_t batch_loaded = std::count_if(uids.begin(), uids.end(), [](SceUID uid) { return uid >= 0; });
+
+    EXPECT_EQ(serial_loaded, batch_loaded);
+
+    // Linking stays in load order, so both kernels must resolve the same set of exports
+    EXPECT_EQ(serial_kernel.export_nids.size(), batch_kernel.export_nids.size());
+    for (const auto &[nid, address] : serial_kernel.export_nids)
+        EXPECT_EQ(batch_kernel.export_nids.count(nid), 1u) << "missing NID " << std::hex << nid;
+}
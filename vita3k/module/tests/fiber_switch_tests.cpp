@@ -0,0 +1,101 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <SceFiber/SceFiber.h>
+
+#include <cpu/functions.h>
+#include <host/state.h>
+#include <kernel/thread/thread_state.h>
+#include <mem/functions.h>
+#include <mem/ptr.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+// Fiber ping-pong: two fibers of one thread switched back and forth through the real sceFiberRun,
+// sceFiberSwitch and sceFiberReturnToThread exports. Each side tags a register while it runs, and
+// the tag has to come back with every switch.
+
+namespace {
+
+constexpr int SWITCHES = 200000;
+constexpr SceSize FIBER_CONTEXT_SIZE = 0x1000;
+constexpr int TAG_REGISTER = 5;
+constexpr uint32_t THREAD_TAG = 0x7000;
+constexpr uint32_t FIBER_TAG = 0xF0;
+constexpr SceUInt32 FIBER_ARG = 0x10;
+
+SceFiber *make_fiber(HostState &host, SceUID thread_id, const char *name, Ptr<SceFiberEntry> entry, SceUInt32 arg) {
+    const Ptr<SceFiber> fiber(alloc(host.mem, sizeof(SceFiber), name));
+    const Ptr<void> context(alloc(host.mem, FIBER_CONTEXT_SIZE, name));
+    EXPECT_EQ(export__sceFiberInitializeImpl(host, thread_id, "_sceFiberInitializeImpl", fiber.get(host.mem), name, entry, arg, context, FIBER_CONTEXT_SIZE, nullptr), SCE_FIBER_OK);
+    return fiber.get(host.mem);
+}
+
+void wait_for_host_thread_exit(KernelState &kernel, SceUID thid) {
+    while (kernel.get_thread(thid))
+        std::this_thread::yield();
+}
+
+} // namespace
+
+TEST(fiber, ping_pong_switch) {
+    HostState host;
+    ASSERT_TRUE(init(host.mem));
+    const CallImportFunc call_import = [](CPUState &, uint32_t, SceUID) {};
+    ASSERT_TRUE(host.kernel.init(host.mem, call_import, CPUBackend::Dynarmic, true));
+
+    const ThreadStatePtr thread = host.kernel.create_thread(host.mem, "fiber");
+    ASSERT_TRUE(thread);
+    const SceUID thid = thread->id;
+    CPUState &cpu = *thread->cpu;
+
+    // The fibers never run guest code, the exports only move register files around
+    const Ptr<SceFiberEntry> entry(alloc(host.mem, 4, "fiber entry") | 1);
+    SceFiber *const fibers[2] = { make_fiber(host, thid, "ping", entry, FIBER_ARG), make_fiber(host, thid, "pong", entry, FIBER_ARG + 1) };
+
+    // No argOnReturn for sceFiberReturnToThread to write to
+    write_reg(cpu, 2, 0);
+    write_reg(cpu, TAG_REGISTER, THREAD_TAG);
+    EXPECT_EQ(export_sceFiberRun(host, thid, "sceFiberRun", fibers[0], 0, Ptr<SceUInt32>()), FIBER_ARG);
+    write_reg(cpu, TAG_REGISTER, FIBER_TAG);
+    EXPECT_EQ(export_sceFiberSwitch(host, thid, "sceFiberSwitch", fibers[1], 0, Ptr<SceUInt32>()), FIBER_ARG + 1);
+    write_reg(cpu, TAG_REGISTER, FIBER_TAG + 1);
+
+    int current = 1;
+    for (int i = 0; i < SWITCHES; i++) {
+        current ^= 1;
+        EXPECT_EQ(export_sceFiberSwitch(host, thid, "sceFiberSwitch", fibers[current], 0, Ptr<SceUInt32>()), SCE_FIBER_OK);
+        if (read_reg(cpu, TAG_REGISTER) != FIBER_TAG + current) {
+            ADD_FAILURE() << "Fiber " << current << " lost its registers on switch " << i;
+            break;
+        }
+    }
+    EXPECT_EQ(Ptr<SceFiber>(thread->fiber).get(host.mem), fibers[current]);
+
+    EXPECT_EQ(export_sceFiberReturnToThread(host, thid, "sceFiberReturnToThread", 0, Ptr<uint32_t>()), SCE_FIBER_OK);
+    EXPECT_EQ(read_reg(cpu, TAG_REGISTER), THREAD_TAG);
+    EXPECT_EQ(thread->fiber, 0);
+
+    for (SceFiber *fiber : fibers)
+        EXPECT_EQ(export_sceFiberFinalize(host, thid, "sceFiberFinalize", fiber), SCE_FIBER_OK);
+
+    host.kernel.exit_delete_all_threads();
+    wait_for_host_thread_exit(host.kernel, thid);
+    wait_for_host_thread_exit(host.kernel, host.kernel.guest_func_runner->id);
+}
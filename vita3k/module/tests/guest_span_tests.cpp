@@ -0,0 +1,105 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <module/lay_out_args.h>
+#include <module/read_arg.h>
+
+#include <cpu/functions.h>
+#include <cpu/state.h>
+#include <mem/functions.h>
+#include <mem/guest_span.h>
+#include <mem/state.h>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+namespace {
+
+struct NullProtocol : CPUProtocolBase {
+    explicit NullProtocol(ExclusiveMonitorPtr monitor)
+        : monitor(monitor) {}
+
+    void call_svc(CPUState &cpu, uint32_t svc, Address pc, SceUID thread_id) override {}
+    Address get_watch_memory_addr(Address addr) override {
+        return addr;
+    }
+    ExclusiveMonitorPtr get_exlusive_monitor() override {
+        return monitor;
+    }
+
+    ExclusiveMonitorPtr monitor;
+};
+
+} // namespace
+
+TEST(guest_span, validates_the_whole_range) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(8), "span");
+    const Ptr<uint32_t> ptr(addr);
+
+    const auto whole = GuestSpan<uint32_t>::make(ptr, KB(8) / 4, mem);
+    EXPECT_TRUE(whole.valid());
+    EXPECT_EQ(whole.size(), KB(8) / 4);
+    EXPECT_EQ(whole.size_bytes(), KB(8));
+    EXPECT_EQ(whole.data(), ptr.get(mem));
+
+    // One element past the allocation, and a count that wraps around the address space
+    EXPECT_FALSE((GuestSpan<uint32_t>::make(ptr, KB(8) / 4 + 1, mem).valid()));
+    EXPECT_FALSE((GuestSpan<uint32_t>::make(ptr, 0x40000000, mem).valid()));
+    EXPECT_FALSE((GuestSpan<const void>::make(Ptr<const void>(0), 16, mem).valid()));
+
+    // Nothing to access, so nothing to check
+    const auto empty = GuestSpan<const void>::make(Ptr<const void>(0), 0, mem);
+    EXPECT_TRUE(empty.valid());
+    EXPECT_TRUE(empty.empty());
+
+    std::iota(whole.begin(), whole.end(), 0u);
+    const auto sub = whole.subspan(10, 4);
+    EXPECT_EQ(sub.guest().address(), addr + 40);
+    EXPECT_EQ(sub[0], 10u);
+    EXPECT_EQ(whole.subspan(KB(8) / 4 - 2, 100).size(), 2u);
+}
+
+TEST(guest_span, bridge_reads_the_count_from_the_next_argument) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    const Address addr = alloc(mem, KB(4), "span");
+
+    const ExclusiveMonitorPtr monitor = new_exclusive_monitor(1);
+    NullProtocol protocol(monitor);
+    {
+        CPUStatePtr cpu = init_cpu(CPUBackend::Dynarmic, false, 1, 0, mem, &protocol);
+        ASSERT_TRUE(cpu);
+
+        using Span = GuestSpan<const uint16_t>;
+        constexpr auto layout = lay_out<Ptr<const uint16_t>, uint32_t>();
+        write_reg(*cpu, 0, addr);
+
+        write_reg(*cpu, 1, KB(2));
+        const Span fits = read<Span, 0, Span, uint32_t>(*cpu, std::get<0>(layout), std::get<1>(layout), mem);
+        EXPECT_TRUE(fits.valid());
+        EXPECT_EQ(fits.size(), KB(2));
+
+        write_reg(*cpu, 1, KB(2) + 1);
+        const Span overflows = read<Span, 0, Span, uint32_t>(*cpu, std::get<0>(layout), std::get<1>(layout), mem);
+        EXPECT_FALSE(overflows.valid());
+    }
+    free_exclusive_monitor(monitor);
+}
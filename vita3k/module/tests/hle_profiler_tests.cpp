@@ -0,0 +1,60 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/hle_profiler.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+TEST(hle_profiler, merges_per_thread_counters) {
+    constexpr int THREAD_COUNT = 4;
+    constexpr uint64_t CALLS = 10000;
+
+    HleProfiler profiler;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&profiler, t]() {
+            for (uint64_t i = 0; i < CALLS; i++) {
+                profiler.record(0x1000, 0, 100);
+                profiler.record(0x2000 + t, 0, 1000);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    const HleProfile profile = profiler.snapshot();
+    ASSERT_EQ(profile.size(), 1u + THREAD_COUNT);
+
+    // Sorted by total time: the shared NID adds up across threads but stays cheaper than any per-thread one
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        EXPECT_EQ(profile[i].second.count, CALLS);
+        EXPECT_EQ(profile[i].second.total_ticks, CALLS * 1000);
+    }
+    const auto &[shared_nid, shared_stats] = profile.back();
+    EXPECT_EQ(shared_nid, 0x1000u);
+    EXPECT_EQ(shared_stats.count, CALLS * THREAD_COUNT);
+    EXPECT_EQ(shared_stats.min_ticks, 100u);
+    EXPECT_EQ(shared_stats.max_ticks, 100u);
+    // 100 ticks lands in the [64, 128) bucket
+    EXPECT_EQ(shared_stats.histogram[6], CALLS * THREAD_COUNT);
+
+    profiler.reset();
+    EXPECT_TRUE(profiler.snapshot().empty());
+}
@@ -0,0 +1,131 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <kernel/host_scheduling.h>
+#include <kernel/types.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+TEST(host_scheduling, guest_priority_bands) {
+    EXPECT_EQ(host_priority_for(SCE_KERNEL_HIGHEST_PRIORITY_USER), HostThreadPriority::High);
+    EXPECT_EQ(host_priority_for(127), HostThreadPriority::High);
+    EXPECT_EQ(host_priority_for(128), HostThreadPriority::Normal);
+    EXPECT_EQ(host_priority_for(SCE_KERNEL_GAME_DEFAULT_PRIORITY_ACTUAL), HostThreadPriority::Normal);
+    EXPECT_EQ(host_priority_for(176), HostThreadPriority::Low);
+    EXPECT_EQ(host_priority_for(SCE_KERNEL_LOWEST_PRIORITY_USER), HostThreadPriority::Lowest);
+
+    // Relative to the default priority
+    EXPECT_EQ(host_priority_for(SCE_KERNEL_DEFAULT_PRIORITY), HostThreadPriority::Normal);
+    EXPECT_EQ(host_priority_for(SCE_KERNEL_DEFAULT_PRIORITY + 16), HostThreadPriority::Low);
+    EXPECT_EQ(host_priority_for(SCE_KERNEL_LOWEST_DEFAULT_PRIORITY), HostThreadPriority::Lowest);
+}
+
+TEST(host_scheduling, title_rules_pick_host_cpus) {
+    const std::vector<std::string> rules = { "*=0;1;2-3", "PCSA00001=4-5;6;7", "PCSB00002=8,10;;" };
+
+    HostSchedulingConfig config;
+    configure_host_scheduling(config, true, rules, "PCSA00001");
+    EXPECT_TRUE(config.priorities);
+    EXPECT_EQ(config.core_affinity[0], 0x30u);
+    EXPECT_EQ(config.core_affinity[1], 0x40u);
+    EXPECT_EQ(config.core_affinity[2], 0x80u);
+    EXPECT_EQ(host_affinity_for(config, SCE_KERNEL_CPU_MASK_USER_0 | SCE_KERNEL_CPU_MASK_USER_2), 0xB0u);
+    // No guest core in the mask means any of them
+    EXPECT_EQ(host_affinity_for(config, 0), 0xF0u);
+
+    configure_host_scheduling(config, false, rules, "PCSE00003");
+    EXPECT_FALSE(config.priorities);
+    EXPECT_EQ(config.core_affinity[2], 0xCu);
+
+    // Guest cores without host CPUs run anywhere, and so does a thread that may use one of them
+    configure_host_scheduling(config, true, rules, "PCSB00002");
+    EXPECT_EQ(config.core_affinity[0], 0x500u);
+    EXPECT_EQ(host_affinity_for(config, SCE_KERNEL_CPU_MASK_USER_0), 0x500u);
+    EXPECT_EQ(host_affinity_for(config, SCE_KERNEL_CPU_MASK_USER_ALL), 0u);
+}
+
+TEST(host_scheduling, invalid_rules_are_ignored) {
+    HostSchedulingConfig config;
+    configure_host_scheduling(config, true, { "PCSA00001=a-b", "*=0;1;2;3", "no title" }, "PCSA00001");
+    EXPECT_FALSE(host_affinity_enabled(config));
+
+    std::uint64_t mask = 0;
+    EXPECT_FALSE(parse_host_cpus("3-1", mask));
+    EXPECT_FALSE(parse_host_cpus("64", mask));
+    EXPECT_TRUE(parse_host_cpus("0,2-4,63", mask));
+    EXPECT_EQ(mask, 0x800000000000001Dull);
+}
+
+TEST(host_scheduling, policy_report) {
+    HostThreadPolicy policy;
+    policy.priority = HostThreadPriority::Low;
+    policy.affinity = 0x3D;
+    policy.priority_applied = true;
+    EXPECT_EQ(to_string(policy), "low priority, CPUs 0,2-5 (not applied)");
+
+    policy.affinity = 0;
+    policy.priority_applied = false;
+    EXPECT_EQ(to_string(policy), "low priority (not applied), CPUs any");
+}
+
+#ifdef __linux__
+TEST(host_scheduling, applies_to_host_thread) {
+    HostSchedulingConfig config;
+    config.priorities = true;
+    config.core_affinity[0] = 1;
+
+    // On a thread of its own, so that the test process keeps its priority and affinity
+    std::thread([&config]() {
+        const id_t tid = static_cast<id_t>(syscall(SYS_gettid));
+        const int base = getpriority(PRIO_PROCESS, tid);
+        HostThreadHandle thread = current_host_thread();
+        HostThreadPolicy policy = map_guest_thread(config, SCE_KERNEL_LOWEST_PRIORITY_USER, SCE_KERNEL_CPU_MASK_USER_0);
+        apply_host_policy(config, policy, thread);
+
+        // Without the right to lower a nice value, priorities are left alone rather than only ever going down
+        if (policy.priority_applied) {
+            EXPECT_EQ(getpriority(PRIO_PROCESS, tid), std::min(base + 10, 19));
+
+            policy = map_guest_thread(config, SCE_KERNEL_HIGHEST_PRIORITY_USER, SCE_KERNEL_CPU_MASK_USER_0);
+            apply_host_policy(config, policy, thread);
+            EXPECT_TRUE(policy.priority_applied);
+            EXPECT_EQ(getpriority(PRIO_PROCESS, tid), base);
+        } else {
+            EXPECT_EQ(getpriority(PRIO_PROCESS, tid), base);
+        }
+
+        EXPECT_TRUE(policy.affinity_applied);
+        cpu_set_t set;
+        ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+        EXPECT_EQ(CPU_COUNT(&set), 1);
+        EXPECT_TRUE(CPU_ISSET(0, &set));
+
+        release_host_thread(thread);
+    }).join();
+}
+#endif
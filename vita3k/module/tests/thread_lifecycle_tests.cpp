@@ -0,0 +1,115 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <kernel/state.h>
+#include <kernel/thread/thread_state.h>
+#include <mem/functions.h>
+#include <mem/ptr.h>
+
+#include <cpu/functions.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Thread lifecycle benchmark: creates, starts and joins short lived guest threads that return
+// right away, the way games spawn worker threads, with and without the debug stack fill.
+// Average times are recorded as test properties, see --gtest_output=xml.
+
+namespace {
+
+constexpr int THREAD_COUNT = 200;
+constexpr int STACK_SIZE = 0x40000;
+
+using Clock = std::chrono::steady_clock;
+
+struct LifecycleTimes {
+    Clock::duration create{};
+    Clock::duration run{};
+    Clock::duration exit{};
+};
+
+void wait_for_host_thread_exit(KernelState &kernel, SceUID thid) {
+    while (kernel.get_thread(thid))
+        std::this_thread::yield();
+}
+
+void run_threads(KernelState &kernel, MemState &mem, Ptr<const void> entry_point, Ptr<void> arg, SceSize arglen, LifecycleTimes &times) {
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        auto start = Clock::now();
+        const ThreadStatePtr thread = kernel.create_thread(mem, "lifecycle", entry_point, SCE_KERNEL_DEFAULT_PRIORITY, STACK_SIZE, nullptr);
+        times.create += Clock::now() - start;
+        ASSERT_TRUE(thread);
+
+        start = Clock::now();
+        EXPECT_EQ(thread->start(kernel, arglen, arg), SCE_KERNEL_OK);
+        {
+            std::unique_lock<std::mutex> lock(thread->mutex);
+            thread->status_cond.wait(lock, [&] { return thread->run_queue.empty() && thread->status == ThreadStatus::dormant; });
+        }
+        times.run += Clock::now() - start;
+        // The entry point returns straight away, leaving arglen in r0
+        EXPECT_EQ(read_reg(*thread->cpu, 0), arglen);
+
+        start = Clock::now();
+        kernel.exit_delete_thread(thread);
+        wait_for_host_thread_exit(kernel, thread->id);
+        times.exit += Clock::now() - start;
+    }
+}
+
+void record_times(const std::string &label, const LifecycleTimes &times) {
+    const auto average_us = [](Clock::duration total) {
+        return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(total).count() / THREAD_COUNT);
+    };
+    ::testing::Test::RecordProperty(label + "_create_us", average_us(times.create));
+    ::testing::Test::RecordProperty(label + "_start_to_join_us", average_us(times.run));
+    ::testing::Test::RecordProperty(label + "_exit_us", average_us(times.exit));
+}
+
+} // namespace
+
+TEST(thread, create_start_join) {
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    KernelState kernel;
+    const CallImportFunc call_import = [](CPUState &, uint32_t, SceUID) {};
+    ASSERT_TRUE(kernel.init(mem, call_import, CPUBackend::Dynarmic, true));
+
+    // bx lr, back to the halt instruction of the thread
+    const Address code = alloc(mem, 4, "lifecycle code");
+    *Ptr<uint16_t>(code).get(mem) = 0x4770;
+    const Ptr<const void> entry_point(code | 1);
+
+    const SceSize arglen = 8;
+    const Ptr<void> arg(alloc(mem, arglen, "lifecycle arg"));
+
+    LifecycleTimes lazy;
+    run_threads(kernel, mem, entry_point, arg, arglen, lazy);
+    kernel.debugger.fill_stacks = true;
+    LifecycleTimes filled;
+    run_threads(kernel, mem, entry_point, arg, arglen, filled);
+
+    record_times("lazy_stacks", lazy);
+    record_times("filled_stacks", filled);
+
+    kernel.exit_delete_all_threads();
+    wait_for_host_thread_exit(kernel, kernel.guest_func_runner->id);
+}
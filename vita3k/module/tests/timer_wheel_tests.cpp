@@ -0,0 +1,184 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <kernel/timer_wheel.h>
+
+#include <kernel/state.h>
+#include <kernel/sync_primitives.h>
+#include <kernel/thread/thread_state.h>
+#include <rtc/rtc.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+// Guest microseconds of a duration, the unit the wheel schedules in
+static constexpr uint64_t us(std::chrono::microseconds duration) {
+    return duration.count();
+}
+
+TEST(timer_wheel, fires_in_expiry_order) {
+    TimerWheel wheel(false);
+    const uint64_t start = rtc_ticks_since_epoch();
+
+    std::vector<int> fired;
+    wheel.schedule_at(start + us(5ms), [&] { fired.push_back(2); });
+    wheel.schedule_at(start + us(1ms), [&] { fired.push_back(1); });
+    wheel.schedule_at(start + us(80ms), [&] { fired.push_back(3); });
+    EXPECT_EQ(wheel.pending(), 3u);
+
+    EXPECT_EQ(wheel.poll(start + us(900us)), 0u);
+    EXPECT_EQ(wheel.poll(start + us(10ms)), 2u);
+    EXPECT_EQ(wheel.poll(start + us(80ms + 200us)), 1u);
+    EXPECT_EQ(fired, std::vector<int>({ 1, 2, 3 }));
+    EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST(timer_wheel, cancelled_timers_do_not_fire) {
+    TimerWheel wheel(false);
+    const uint64_t start = rtc_ticks_since_epoch();
+
+    int fired = 0;
+    const TimerHandle first = wheel.schedule_at(start + us(2ms), [&] { fired++; });
+    const TimerHandle second = wheel.schedule_at(start + us(2ms), [&] { fired += 10; });
+    EXPECT_TRUE(wheel.cancel(first));
+    EXPECT_FALSE(wheel.cancel(first));
+
+    wheel.poll(start + us(3ms));
+    EXPECT_EQ(fired, 10);
+    // Fired timers can not be cancelled anymore, and their slot is reused under another handle
+    EXPECT_FALSE(wheel.cancel(second));
+    const TimerHandle third = wheel.schedule_at(start + us(4ms), [] {});
+    EXPECT_NE(third, first);
+    EXPECT_NE(third, second);
+    EXPECT_FALSE(wheel.remaining_us(first));
+    EXPECT_TRUE(wheel.remaining_us(third));
+}
+
+TEST(timer_wheel, far_timers_cascade_down_the_levels) {
+    TimerWheel wheel(false);
+    const uint64_t start = rtc_ticks_since_epoch();
+
+    // One per level, and one past the range of the wheel
+    const std::vector<std::chrono::microseconds> delays = { 300us, 20ms, 1s, 90s, 2h, 40h };
+    std::vector<size_t> fired;
+    for (size_t i = 0; i < delays.size(); i++)
+        wheel.schedule_at(start + us(delays[i]), [&fired, i] { fired.push_back(i); });
+
+    for (size_t i = 0; i < delays.size(); i++) {
+        EXPECT_EQ(wheel.poll(start + us(delays[i] - 100us)), 0u) << i;
+        EXPECT_EQ(wheel.poll(start + us(delays[i] + 100us)), 1u) << i;
+    }
+    EXPECT_EQ(fired, std::vector<size_t>({ 0, 1, 2, 3, 4, 5 }));
+}
+
+TEST(timer_wheel, periodic_timers_repeat_until_cancelled) {
+    TimerWheel wheel(false);
+    const uint64_t start = rtc_ticks_since_epoch();
+
+    int fired = 0;
+    const TimerHandle handle = wheel.schedule_at(start + us(1ms), [&] { fired++; }, 1000);
+    for (int i = 1; i <= 5; i++)
+        wheel.poll(start + us(std::chrono::milliseconds(i) + 100us));
+
+    EXPECT_EQ(fired, 5);
+    EXPECT_TRUE(wheel.cancel(handle));
+    wheel.poll(start + us(10ms));
+    EXPECT_EQ(fired, 5);
+}
+
+TEST(timer_wheel, thread_wakes_for_earlier_timer) {
+    TimerWheel wheel;
+
+    std::promise<void> late_fired;
+    std::promise<void> early_fired;
+    const TimerHandle late = wheel.schedule(10'000'000, [&] { late_fired.set_value(); });
+    wheel.schedule(2000, [&] { early_fired.set_value(); });
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(early_fired.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+
+    EXPECT_TRUE(wheel.cancel(late));
+    EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST(timer_wheel, follows_guest_clock_speed) {
+    TimerWheel wheel;
+
+    // Two guest seconds pass in a tenth of a second
+    rtc_set_clock_speed(20.0);
+    std::promise<void> fired;
+    wheel.schedule(2'000'000, [&] { fired.set_value(); });
+    const std::future_status status = fired.get_future().wait_for(1500ms);
+    rtc_set_clock_speed(1.0);
+
+    EXPECT_EQ(status, std::future_status::ready);
+}
+
+TEST(timer_wheel, timer_events_wake_waiting_threads) {
+    MemState mem;
+    KernelState kernel;
+
+    const SceUID thread_id = kernel.get_next_uid();
+    const ThreadStatePtr thread = std::make_shared<ThreadState>(thread_id, mem);
+    thread->status = ThreadStatus::run;
+    kernel.threads.emplace(thread_id, thread);
+
+    const SceUID timer_id = kernel.get_next_uid();
+    const TimerPtr timer = std::make_shared<TimerState>();
+    timer->reset_behaviour = TimerState::ResetBehaviour::AUTOMATIC;
+    kernel.timers.emplace(timer_id, timer);
+
+    SceUInt32 pattern = 0;
+    EXPECT_EQ(timer_event_poll(kernel, "test", thread_id, timer_id, &pattern), SCE_KERNEL_ERROR_EVENT_COND);
+
+    // Nothing fires, the wait runs out on the guest clock
+    SceUInt32 timeout = 2000;
+    EXPECT_EQ(timer_event_wait(kernel, "test", thread_id, timer_id, &pattern, &timeout), SCE_KERNEL_ERROR_WAIT_TIMEOUT);
+    EXPECT_EQ(timeout, 0u);
+    EXPECT_EQ(thread->status, ThreadStatus::run);
+
+    kernel.timer_wheel.schedule(1000, [timer] { timer_event_fire(*timer); });
+    timeout = 5'000'000;
+    EXPECT_EQ(timer_event_wait(kernel, "test", thread_id, timer_id, &pattern, &timeout), SCE_KERNEL_OK);
+    EXPECT_EQ(pattern, SCE_KERNEL_EVENT_TIMER);
+    EXPECT_GT(timeout, 0u);
+    EXPECT_EQ(thread->status, ThreadStatus::run);
+    // The wait used the automatically reset event up
+    EXPECT_EQ(timer_event_poll(kernel, "test", thread_id, timer_id, &pattern), SCE_KERNEL_ERROR_EVENT_COND);
+
+    // Cancelling releases the thread still waiting
+    SceInt32 result = SCE_KERNEL_OK;
+    std::thread waiter([&] { result = timer_event_wait(kernel, "test", thread_id, timer_id, nullptr, nullptr); });
+    while (true) {
+        const std::lock_guard<std::mutex> lock(timer->mutex);
+        if (!timer->waiting_threads->empty())
+            break;
+    }
+
+    SceUInt32 waiting = 0;
+    EXPECT_EQ(timer_event_cancel(kernel, "test", thread_id, timer_id, &waiting), SCE_KERNEL_OK);
+    waiter.join();
+    EXPECT_EQ(waiting, 1u);
+    EXPECT_EQ(result, SCE_KERNEL_ERROR_WAIT_CANCEL);
+}
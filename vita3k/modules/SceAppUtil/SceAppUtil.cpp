@@ -25,6 +25,7 @@
 #include <util/safe_time.h>
 
 #include <cstring>
+#include <vector>
 
 EXPORT(int, sceAppUtilAddCookieWebBrowser) {
     return UNIMPLEMENTED();
@@ -183,48 +184,54 @@ std::string construct_slotparam_path(const unsigned int data) {
     return construct_savedata0_path("SlotParam_" + std::to_string(data), "bin");
 }
 
-EXPORT(int, sceAppUtilSaveDataDataRemove, SceAppUtilSaveDataFileSlot *slot, SceAppUtilSaveDataRemoveItem *files, unsigned int fileNum, SceAppUtilMountPoint *mountPoint) {
-    for (unsigned int i = 0; i < fileNum; i++) {
-        const auto file = fs::path(construct_savedata0_path(files[i].dataPath.get(host.mem)));
+EXPORT(int, sceAppUtilSaveDataDataRemove, SceAppUtilSaveDataFileSlot *slot, GuestSpan<SceAppUtilSaveDataRemoveItem> files, unsigned int fileNum, SceAppUtilMountPoint *mountPoint) {
+    if (!files.valid())
+        return RET_ERROR(SCE_APPUTIL_ERROR_PARAMETER);
+
+    for (const auto &item : files) {
+        const auto file = fs::path(construct_savedata0_path(item.dataPath.get(host.mem)));
         if (fs::is_regular_file(file)) {
             remove_file(host.io, file.string().c_str(), host.pref_path, export_name);
         } else
             remove_dir(host.io, file.string().c_str(), host.pref_path, export_name);
     }
 
-    if (slot && files[0].mode == SCE_APPUTIL_SAVEDATA_DATA_REMOVE_MODE_DEFAULT) {
+    if (slot && !files.empty() && files[0].mode == SCE_APPUTIL_SAVEDATA_DATA_REMOVE_MODE_DEFAULT) {
         remove_file(host.io, construct_slotparam_path(slot->id).c_str(), host.pref_path, export_name);
     }
 
     return 0;
 }
 
-EXPORT(int, sceAppUtilSaveDataDataSave, SceAppUtilSaveDataFileSlot *slot, SceAppUtilSaveDataDataSaveItem *files, unsigned int fileNum, SceAppUtilMountPoint *mountPoint, SceSize *requiredSizeKB) {
-    SceUID fd;
+EXPORT(int, sceAppUtilSaveDataDataSave, SceAppUtilSaveDataFileSlot *slot, GuestSpan<SceAppUtilSaveDataDataSaveItem> files, unsigned int fileNum, SceAppUtilMountPoint *mountPoint, SceSize *requiredSizeKB) {
+    if (!files.valid())
+        return RET_ERROR(SCE_APPUTIL_ERROR_PARAMETER);
+
+    // Every buffer is checked before anything gets written, a bad item must not leave a half saved slot behind
+    std::vector<GuestSpan<const void>> bufs;
+    bufs.reserve(files.size());
+    for (const auto &file : files) {
+        // Truncating items may come without a buffer, bufSize is then only the new file size
+        bufs.push_back(GuestSpan<const void>::make(file.buf, file.buf ? file.bufSize : 0, host.mem));
+        if (!bufs.back().valid())
+            return RET_ERROR(SCE_APPUTIL_ERROR_PARAMETER);
+    }
 
-    for (unsigned int i = 0; i < fileNum; i++) {
+    // Files are staged and committed in the background, reads through sceIo still see them right away
+    for (size_t i = 0; i < files.size(); i++) {
         const auto file_path = construct_savedata0_path(files[i].dataPath.get(host.mem));
         switch (files[i].mode) {
         case SCE_APPUTIL_SAVEDATA_DATA_SAVE_MODE_DIRECTORY:
             create_dir(host.io, file_path.c_str(), 0777, host.pref_path, export_name);
             break;
         case SCE_APPUTIL_SAVEDATA_DATA_SAVE_MODE_FILE_TRUNCATE:
-            if (files[i].buf) {
-                fd = open_file(host.io, file_path.c_str(), SCE_O_WRONLY | SCE_O_CREAT, host.pref_path, export_name);
-                seek_file(fd, static_cast<int>(files[i].offset), SCE_SEEK_SET, host.io, export_name);
-                write_file(fd, files[i].buf.get(host.mem), files[i].bufSize, host.io, export_name);
-                close_file(host.io, fd, export_name);
-            }
-            fd = open_file(host.io, file_path.c_str(), SCE_O_WRONLY | SCE_O_APPEND | SCE_O_TRUNC, host.pref_path, export_name);
-            truncate_file(fd, files[i].bufSize + files[i].offset, host.io, export_name);
-            close_file(host.io, fd, export_name);
+            if (files[i].buf)
+                stage_write_file(host.io, file_path.c_str(), files[i].offset, bufs[i].data(), bufs[i].size_bytes(), host.pref_path, export_name);
+            stage_truncate_file(host.io, file_path.c_str(), files[i].bufSize + files[i].offset, host.pref_path, export_name);
             break;
         case SCE_APPUTIL_SAVEDATA_DATA_SAVE_MODE_FILE:
         default:
-            fd = open_file(host.io, file_path.c_str(), SCE_O_WRONLY | SCE_O_CREAT, host.pref_path, export_name);
-            seek_file(fd, static_cast<int>(files[i].offset), SCE_SEEK_SET, host.io, export_name);
-            write_file(fd, files[i].buf.get(host.mem), files[i].bufSize, host.io, export_name);
-            close_file(host.io, fd, export_name);
+            stage_write_file(host.io, file_path.c_str(), files[i].offset, bufs[i].data(), bufs[i].size_bytes(), host.pref_path, export_name);
             break;
         }
     }
@@ -242,9 +249,7 @@ EXPORT(int, sceAppUtilSaveDataDataSave, SceAppUtilSaveDataFileSlot *slot, SceApp
         modified_time.minute = local.tm_min;
         modified_time.second = local.tm_sec;
         slot->slotParam.get(host.mem)->modifiedTime = modified_time;
-        fd = open_file(host.io, construct_slotparam_path(slot->id).c_str(), SCE_O_WRONLY | SCE_O_CREAT, host.pref_path, export_name);
-        write_file(fd, slot->slotParam.get(host.mem), sizeof(SceAppUtilSaveDataSlotParam), host.io, export_name);
-        close_file(host.io, fd, export_name);
+        stage_write_file(host.io, construct_slotparam_path(slot->id).c_str(), 0, slot->slotParam.get(host.mem), sizeof(SceAppUtilSaveDataSlotParam), host.pref_path, export_name);
     }
 
     return 0;
@@ -124,7 +124,7 @@ EXPORT(int, sceAudioOutOutput, int port, const void *buf) {
         std::unique_lock<std::mutex> mlock(thread->mutex);
         if (thread->status != ThreadStatus::run)
             return 0;
-        thread->status = ThreadStatus::wait;
+        thread->update_status(ThreadStatus::wait);
         thread->status_cond.wait(mlock, [&]() { return thread->status == ThreadStatus::run; });
     }
 
@@ -19,11 +19,11 @@
 
 #include <codec/state.h>
 #include <io/functions.h>
+#include <rtc/rtc.h>
 
 #include <util/lock_and_find.h>
 #include <util/log.h>
 
-#include <SDL.h>
 #include <algorithm>
 
 // Defines stop/pause behaviour. If true, GetVideo/AudioData will return false when stopped.
@@ -206,9 +206,7 @@ enum SceAvPlayerState {
 };
 
 static inline uint64_t current_time() {
-    return std::chrono::duration_cast<std::chrono::microseconds>(
-        std::chrono::high_resolution_clock::now().time_since_epoch())
-        .count();
+    return rtc_ticks_since_epoch();
 }
 
 static Ptr<uint8_t> get_buffer(const PlayerPtr &player, MediaType media_type,
@@ -235,39 +233,14 @@ static Ptr<uint8_t> get_buffer(const PlayerPtr &player, MediaType media_type,
     return buffer;
 }
 
-struct ThreadParamsEx {
-    MemState *mem = nullptr;
-    KernelState *kernel = nullptr;
-    ThreadState *thread = nullptr;
-    SceUID thid = 0;
-    Address callback_address = 0;
-    uint wait_time = 0;
-    std::vector<uint32_t> args;
-};
-
-static int SDLCALL thread_callback(void *data) {
-    ThreadParamsEx *params = static_cast<ThreadParamsEx *>(data);
+// The ready event is delivered after a short delay rather than right away
+static void run_callback_delayed(HostState &host, const ThreadStatePtr &thread, Address callback_address, const std::vector<uint32_t> &args) {
+    constexpr uint64_t READY_DELAY_US = 40 * 1000;
 
-    SDL_Delay(params->wait_time);
-    LOG_DEBUG("Play Video");
-    params->thread->request_callback(params->callback_address, params->args);
-    delete params;
-
-    return 0;
-}
-
-static int run_callback_threaded(HostState &host, ThreadState &thread, const SceUID &thid, Address callback_address, const std::vector<uint32_t> &args) {
-    ThreadParamsEx *params = new ThreadParamsEx;
-    params->mem = &host.mem;
-    params->kernel = &host.kernel;
-    params->thread = &thread;
-    params->thid = thid;
-    params->callback_address = callback_address;
-    params->args = args;
-    params->wait_time = 40;
-
-    SDL_CreateThread(&thread_callback, "AvPlayer callback thread", params);
-    return 0;
+    host.kernel.timer_wheel.schedule(READY_DELAY_US, [thread, callback_address, args] {
+        LOG_DEBUG("Play Video");
+        thread->request_callback(callback_address, args);
+    });
 }
 
 void run_event_callback(HostState &host, SceUID thread_id, const PlayerPtr player_info, uint32_t event_id, uint32_t source_id, Ptr<void> event_data) {
@@ -275,7 +248,7 @@ void run_event_callback(HostState &host, SceUID thread_id, const PlayerPtr playe
         auto thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
         const std::unique_lock<std::mutex> lock(host.kernel.mutex);
         if (event_id == SCE_AVPLAYER_STATE_READY)
-            run_callback_threaded(host, *thread, thread_id, player_info->event_manager.event_callback.address(), { player_info->event_manager.user_data, event_id, source_id, event_data.address() });
+            run_callback_delayed(host, thread, player_info->event_manager.event_callback.address(), { player_info->event_manager.user_data, event_id, source_id, event_data.address() });
         else
             thread->request_callback(player_info->event_manager.event_callback.address(), { player_info->event_manager.user_data, event_id, source_id, event_data.address() });
     }
@@ -499,8 +472,10 @@ EXPORT(bool, sceAvPlayerGetVideoData, SceUID player_handle, SceAvPlayerFrameInfo
         } else {
             buffer = get_buffer(player_info, MediaType::VIDEO, host.mem, H264DecoderState::buffer_size(size), true);
 
-            std::vector<uint8_t> data = player_info->player.receive_video();
-            std::memcpy(buffer.get(host.mem), data.data(), data.size());
+            // Frames are decoded in place, right into the ring buffer the game reads them from
+            const auto frame = GuestSpan<uint8_t>::make(buffer, player_info->video_buffer_size, host.mem);
+            if (frame.valid())
+                player_info->player.receive_video(frame.data(), frame.size());
         }
     } else {
         buffer = get_buffer(player_info, MediaType::VIDEO, host.mem, H264DecoderState::buffer_size(size), false);
@@ -25,11 +25,10 @@
 #include <io/vfs.h>
 #include <renderer/functions.h>
 #include <renderer/types.h>
+#include <rtc/rtc.h>
 #include <util/log.h>
 #include <util/string_utils.h>
 
-#include <SDL_timer.h>
-
 EXPORT(int, sceCameraImportDialogAbort) {
     return UNIMPLEMENTED();
 }
@@ -588,7 +587,7 @@ EXPORT(int, sceNpTrophySetupDialogInit, const Ptr<SceNpTrophySetupDialogParam> p
 
     host.common_dialog.status = SCE_COMMON_DIALOG_STATUS_RUNNING;
     host.common_dialog.type = TROPHY_SETUP_DIALOG;
-    host.common_dialog.trophy.tick = SDL_GetTicks() + ((param.get(host.mem)->options & 0x01) ? 3000 : 0);
+    host.common_dialog.trophy.tick = rtc_ticks_since_epoch() + ((param.get(host.mem)->options & 0x01) ? 3 * VITA_CLOCKS_PER_SEC : 0);
     return 0;
 }
 
@@ -20,63 +20,47 @@
 #include "cpu/functions.h"
 
 #include <sstream>
-#include <util/lock_and_find.h>
 #include <util/log.h>
 
 const static int DEFAULT_FIBER_STACK_SIZE = 4096;
 
-struct FiberState {
-    std::mutex mutex;
-    std::map<SceUID, SceFiber *> thread_fibers;
-    std::map<SceUID, CPUContext> thread_contexts;
-};
-
-LIBRARY_INIT_IMPL(SceFiber) {
-    host.kernel.obj_store.create<FiberState>();
-}
-LIBRARY_INIT_REGISTER(SceFiber)
-
 constexpr bool LOG_FIBER = false;
 
-void set_thread_fiber(FiberState &state, const SceUID &tid, SceFiber *fiber) {
-    state.thread_fibers[tid] = fiber;
-}
-
-SceFiber *get_thread_fiber(FiberState &state, const SceUID &tid) {
-    if (state.thread_fibers.find(tid) == state.thread_fibers.end()) {
-        return nullptr;
-    }
-    return state.thread_fibers[tid];
+// Fiber functions only ever act on the calling thread, which can be reached without the kernel lock
+static ThreadState *current_thread(HostState &host, SceUID thread_id) {
+    ThreadState *const thread = get_current_thread();
+    if (thread && thread->id == thread_id)
+        return thread;
+    return host.kernel.get_thread(thread_id).get();
 }
 
-void set_thread_context(FiberState &state, const SceUID &tid, const CPUContext &ctx) {
-    state.thread_contexts[tid] = ctx;
+static void set_thread_fiber(HostState &host, ThreadState &thread, SceFiber *fiber) {
+    thread.fiber = fiber ? Ptr<SceFiber>(fiber, host.mem).address() : 0;
 }
 
-CPUContext get_thread_context(FiberState &state, const SceUID &tid) {
-    return state.thread_contexts[tid];
+static SceFiber *get_thread_fiber(HostState &host, const ThreadState &thread) {
+    return thread.fiber ? Ptr<SceFiber>(thread.fiber).get(host.mem) : nullptr;
 }
 
-std::string describe_fiber(FiberState &state, ThreadStatePtr thread, SceFiber *fiber) {
+std::string describe_fiber(ThreadState &thread, SceFiber *fiber) {
     std::stringstream ss;
     ss << fmt::format("Fiber (name: {})\n", fiber->name);
     ss << fmt::format("entry: {}\n", log_hex(fiber->cpu->get_pc()), log_hex(fiber->entry.address()));
     ss << "CPU Context:\n";
     ss << fiber->cpu->description();
-    ss << "Referenced from " << thread->id << "\n";
+    ss << "Referenced from " << thread.id << "\n";
     ss << "CPU Context:\n";
-    auto ctx = get_thread_context(state, thread->id);
-    ss << ctx.description();
+    ss << thread.fiber_thread_context.description();
     return ss.str();
 }
 
-void log_fiber(FiberState &state, ThreadStatePtr thread, SceFiber *fiber, const std::string &function_name) {
+void log_fiber(ThreadState &thread, SceFiber *fiber, const std::string &function_name) {
     std::string log_msg = function_name + "\n";
-    log_msg += describe_fiber(state, thread, fiber);
+    log_msg += describe_fiber(thread, fiber);
     LOG_INFO("{}", log_msg);
 }
 
-void setup_fiber_to_run(HostState &host, const ThreadStatePtr thread, SceFiber *fiber, uint32_t thread_sp, const uint32_t &argOnRunTo) {
+void setup_fiber_to_run(HostState &host, SceFiber *fiber, uint32_t thread_sp, const uint32_t &argOnRunTo) {
     assert(fiber->status != FiberStatus::RUN);
     if (!fiber->addrContext) {
         fiber->cpu->set_sp(thread_sp);
@@ -95,8 +79,7 @@ void setup_fiber_to_run(HostState &host, const ThreadStatePtr thread, SceFiber *
     fiber->status = FiberStatus::RUN;
 }
 
-void initialize_fiber(HostState &host, const ThreadStatePtr thread, SceFiber *fiber, const char *name, Ptr<SceFiberEntry> entry, SceUInt32 argOnInitialize, Ptr<void> addrContext, SceSize sizeContext, SceFiberOptParam *params) {
-    const auto state = host.kernel.obj_store.get<FiberState>();
+void initialize_fiber(HostState &host, ThreadState &thread, SceFiber *fiber, const char *name, Ptr<SceFiberEntry> entry, SceUInt32 argOnInitialize, Ptr<void> addrContext, SceSize sizeContext, SceFiberOptParam *params) {
     fiber->entry = entry;
     strncpy(fiber->name, name, 32);
     fiber->argOnInitialize = argOnInitialize;
@@ -105,7 +88,7 @@ void initialize_fiber(HostState &host, const ThreadStatePtr thread, SceFiber *fi
     fiber->sizeContext = sizeContext;
     fiber->cpu = new CPUContext;
     fiber->status = FiberStatus::INIT;
-    *fiber->cpu = save_context(*thread->cpu);
+    save_context(*thread.cpu, *fiber->cpu);
 
     if (addrContext && sizeContext > 0) {
         memset(addrContext.get(host.mem), 0xCC, sizeContext);
@@ -117,14 +100,12 @@ void initialize_fiber(HostState &host, const ThreadStatePtr thread, SceFiber *fi
 EXPORT(int, _sceFiberAttachContextAndRun, SceFiber *fiber, Address addrContext, SceSize sizeContext, SceUInt32 argOnRunTo, Ptr<SceUInt32> argOnRun) {
     // Maybe Need more check on real hw
     STUBBED("Todo: not sure for now");
-    const auto state = host.kernel.obj_store.get<FiberState>();
-    const std::lock_guard<std::mutex> lock(state->mutex);
-    const auto thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
-    SceFiber *thread_fiber = get_thread_fiber(*state, thread->id);
+    ThreadState *const thread = current_thread(host, thread_id);
+    SceFiber *thread_fiber = get_thread_fiber(host, *thread);
     assert(!thread_fiber);
     assert(!fiber->addrContext);
     if (LOG_FIBER) {
-        log_fiber(*state, thread, fiber, "Attach context and run");
+        log_fiber(*thread, fiber, "Attach context and run");
     }
 
     fiber->addrContext = addrContext;
@@ -133,9 +114,9 @@ EXPORT(int, _sceFiberAttachContextAndRun, SceFiber *fiber, Address addrContext,
         fiber->cpu->set_sp(addrContext + sizeContext);
     }
 
-    setup_fiber_to_run(host, thread, fiber, read_sp(*thread->cpu), argOnRunTo);
-    set_thread_context(*state, thread->id, save_context(*thread->cpu));
-    set_thread_fiber(*state, thread->id, fiber);
+    setup_fiber_to_run(host, fiber, read_sp(*thread->cpu), argOnRunTo);
+    save_context(*thread->cpu, thread->fiber_thread_context);
+    set_thread_fiber(host, *thread, fiber);
 
     load_context(*thread->cpu, *fiber->cpu);
     return fiber->cpu->cpu_registers[0];
@@ -144,13 +125,10 @@ EXPORT(int, _sceFiberAttachContextAndRun, SceFiber *fiber, Address addrContext,
 EXPORT(int, _sceFiberAttachContextAndSwitch, SceFiber *fiber, Address addrContext, SceSize sizeContext, SceUInt32 argOnRunTo, Ptr<SceUInt32> argOnRun) {
     // Maybe Need more check on real hw
     STUBBED("Todo: not sure for now");
-    const auto state = host.kernel.obj_store.get<FiberState>();
-    const std::lock_guard<std::mutex> lock(state->mutex);
-    const auto thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
-    auto ctx = get_thread_context(*state, thread->id);
-    SceFiber *thread_fiber = get_thread_fiber(*state, thread->id);
+    ThreadState *const thread = current_thread(host, thread_id);
+    SceFiber *thread_fiber = get_thread_fiber(host, *thread);
     if (LOG_FIBER) {
-        log_fiber(*state, thread, fiber, "Attach context and switch");
+        log_fiber(*thread, fiber, "Attach context and switch");
     }
 
     assert(thread_fiber);
@@ -161,12 +139,12 @@ EXPORT(int, _sceFiberAttachContextAndSwitch, SceFiber *fiber, Address addrContex
         fiber->cpu->set_sp(addrContext + sizeContext);
     }
 
-    *thread_fiber->cpu = save_context(*thread->cpu);
-    setup_fiber_to_run(host, thread, fiber, ctx.get_sp(), argOnRunTo);
+    save_context(*thread->cpu, *thread_fiber->cpu);
+    setup_fiber_to_run(host, fiber, thread->fiber_thread_context.get_sp(), argOnRunTo);
     thread_fiber->status = FiberStatus::SUSPEND;
     thread_fiber->argOnRun = argOnRun;
     thread_fiber->cpu->cpu_registers[0] = SCE_FIBER_OK;
-    set_thread_fiber(*state, thread->id, fiber);
+    set_thread_fiber(host, *thread, fiber);
     load_context(*thread->cpu, *fiber->cpu);
 
     return fiber->cpu->cpu_registers[0];
@@ -185,12 +163,12 @@ EXPORT(SceInt32, _sceFiberInitializeImpl, SceFiber *fiber, const char *name, Ptr
         return RET_ERROR(SCE_FIBER_ERROR_INVALID);
     }
 
-    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    ThreadState *const thread = current_thread(host, thread_id);
     if (!thread) {
         return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_THREAD_ID);
     }
 
-    initialize_fiber(host, thread, fiber, name, entry, argOnInitialize, addrContext, sizeContext, params);
+    initialize_fiber(host, *thread, fiber, name, entry, argOnInitialize, addrContext, sizeContext, params);
 
     return SCE_FIBER_OK;
 }
@@ -208,12 +186,12 @@ EXPORT(int, _sceFiberInitializeWithInternalOptionImpl, SceFiber *fiber, const ch
         return RET_ERROR(SCE_FIBER_ERROR_INVALID);
     }
 
-    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    ThreadState *const thread = current_thread(host, thread_id);
     if (!thread) {
         return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_THREAD_ID);
     }
 
-    initialize_fiber(host, thread, fiber, name, entry, argOnInitialize, addrContext, sizeContext, nullptr);
+    initialize_fiber(host, *thread, fiber, name, entry, argOnInitialize, addrContext, sizeContext, nullptr);
 
     return SCE_FIBER_OK;
 }
@@ -232,17 +210,12 @@ EXPORT(int, sceFiberGetInfo) {
 }
 
 EXPORT(SceUInt32, sceFiberGetSelf, Ptr<SceFiber> *fiber) {
-    const auto state = host.kernel.obj_store.get<FiberState>();
     if (!fiber) {
         return RET_ERROR(SCE_FIBER_ERROR_NULL);
     }
 
-    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
-    SceFiber *thread_fiber = get_thread_fiber(*state, thread->id);
-    if (thread_fiber)
-        *fiber = Ptr<SceFiber>(thread_fiber, host.mem);
-    else
-        *fiber = Ptr<SceFiber>(0);
+    const ThreadState *const thread = current_thread(host, thread_id);
+    *fiber = Ptr<SceFiber>(thread->fiber);
 
     return SCE_FIBER_OK;
 }
@@ -264,24 +237,21 @@ EXPORT(int, sceFiberRenameSelf) {
 }
 
 EXPORT(SceInt32, sceFiberReturnToThread, uint32_t argOnReturnTo, Ptr<uint32_t> argOnRun) {
-    const auto state = host.kernel.obj_store.get<FiberState>();
-    const std::lock_guard<std::mutex> lock(state->mutex);
-    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
-    SceFiber *fiber = get_thread_fiber(*state, thread->id);
-    CPUContext thread_context = get_thread_context(*state, thread->id);
+    ThreadState *const thread = current_thread(host, thread_id);
+    SceFiber *fiber = get_thread_fiber(host, *thread);
     assert(fiber->status == FiberStatus::RUN);
     if (LOG_FIBER) {
-        log_fiber(*state, thread, fiber, "Return to thread");
+        log_fiber(*thread, fiber, "Return to thread");
     }
 
-    *fiber->cpu = save_context(*thread->cpu);
+    save_context(*thread->cpu, *fiber->cpu);
     fiber->cpu->cpu_registers[0] = SCE_FIBER_OK;
     fiber->status = FiberStatus::SUSPEND;
     fiber->argOnRun = argOnRun;
-    set_thread_fiber(*state, thread->id, nullptr);
+    set_thread_fiber(host, *thread, nullptr);
 
-    load_context(*thread->cpu, thread_context);
-    Address argOnReturn = thread_context.cpu_registers[2];
+    load_context(*thread->cpu, thread->fiber_thread_context);
+    const Address argOnReturn = thread->fiber_thread_context.cpu_registers[2];
     if (argOnReturn) {
         *(Ptr<uint32_t>(argOnReturn).get(host.mem)) = argOnReturnTo;
     }
@@ -290,22 +260,20 @@ EXPORT(SceInt32, sceFiberReturnToThread, uint32_t argOnReturnTo, Ptr<uint32_t> a
 }
 
 EXPORT(SceUInt32, sceFiberRun, SceFiber *fiber, SceUInt32 argOnRunTo, Ptr<SceUInt32> argOnReturn) {
-    const auto state = host.kernel.obj_store.get<FiberState>();
-    const std::lock_guard<std::mutex> lock(state->mutex);
-    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
     if (!fiber) {
         return RET_ERROR(SCE_FIBER_ERROR_NULL);
     }
 
-    SceFiber *thread_fiber = get_thread_fiber(*state, thread->id);
+    ThreadState *const thread = current_thread(host, thread_id);
+    SceFiber *thread_fiber = get_thread_fiber(host, *thread);
     assert(!thread_fiber);
     if (LOG_FIBER) {
-        log_fiber(*state, thread, fiber, "Run");
+        log_fiber(*thread, fiber, "Run");
     }
 
-    setup_fiber_to_run(host, thread, fiber, read_sp(*thread->cpu), argOnRunTo);
-    set_thread_context(*state, thread->id, save_context(*thread->cpu));
-    set_thread_fiber(*state, thread->id, fiber);
+    setup_fiber_to_run(host, fiber, read_sp(*thread->cpu), argOnRunTo);
+    save_context(*thread->cpu, thread->fiber_thread_context);
+    set_thread_fiber(host, *thread, fiber);
 
     load_context(*thread->cpu, *fiber->cpu);
     return fiber->cpu->cpu_registers[0];
@@ -320,26 +288,24 @@ EXPORT(int, sceFiberStopContextSizeCheck) {
 }
 
 EXPORT(SceUInt32, sceFiberSwitch, SceFiber *fiber, SceUInt32 argOnRunTo, Ptr<SceUInt32> argOnRun) {
-    const auto state = host.kernel.obj_store.get<FiberState>();
-    const std::lock_guard<std::mutex> lock(state->mutex);
-    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
-    auto ctx = get_thread_context(*state, thread->id);
     if (!fiber) {
         return RET_ERROR(SCE_FIBER_ERROR_NULL);
     }
 
-    SceFiber *thread_fiber = get_thread_fiber(*state, thread->id);
+    ThreadState *const thread = current_thread(host, thread_id);
+    SceFiber *thread_fiber = get_thread_fiber(host, *thread);
     assert(thread_fiber);
     if (LOG_FIBER) {
-        log_fiber(*state, thread, fiber, "Switch");
+        log_fiber(*thread, fiber, "Switch");
     }
 
-    *thread_fiber->cpu = save_context(*thread->cpu);
+    // Both register files are copied in place, nothing is allocated or looked up on the way
+    save_context(*thread->cpu, *thread_fiber->cpu);
     thread_fiber->status = FiberStatus::SUSPEND;
     thread_fiber->argOnRun = argOnRun;
     thread_fiber->cpu->cpu_registers[0] = SCE_FIBER_OK;
-    set_thread_fiber(*state, thread->id, fiber);
-    setup_fiber_to_run(host, thread, fiber, ctx.get_sp(), argOnRunTo);
+    set_thread_fiber(host, *thread, fiber);
+    setup_fiber_to_run(host, fiber, thread->fiber_thread_context.get_sp(), argOnRunTo);
     load_context(*thread->cpu, *fiber->cpu);
 
     return fiber->cpu->cpu_registers[0];
@@ -27,6 +27,7 @@
 
 #include <mem/allocator.h>
 #include <mem/mempool.h>
+#include <renderer/command_payloads.h>
 #include <renderer/functions.h>
 #include <renderer/types.h>
 #include <util/bytes.h>
@@ -49,6 +50,9 @@ static Ptr<void> gxmRunDeferredMemoryCallback(KernelState &kernel, const MemStat
     return result;
 }
 
+// How often sceGxmNotificationWait looks at a notification that nothing signalled
+static constexpr auto NOTIFICATION_RECHECK_INTERVAL = std::chrono::milliseconds(1);
+
 #pragma pack(push, 1)
 struct SceGxmCommandDataCopyInfo {
     std::uint8_t **dest_pointer;
@@ -1426,18 +1430,18 @@ EXPORT(int, sceGxmEndScene, SceGxmContext *context, Ptr<SceGxmNotification> vert
 
     // Add NOP for SceGxmFinish
     renderer::add_command(context->renderer.get(), renderer::CommandOpcode::Nop, &context->renderer->render_finish_status,
-        ++host.renderer->last_scene_id);
+        renderer::payload::Nop{ ++host.renderer->last_scene_id });
 
     if (vertexNotification) {
         renderer::add_command(context->renderer.get(), renderer::CommandOpcode::SignalNotification,
-            nullptr, vertexNotification, true);
+            nullptr, renderer::payload::SignalNotification{ vertexNotification, true });
         // volatile uint32_t *val = vertexNotification.get(host.mem)->address.get(host.mem);
         // *val = vertexNotification.get(host.mem)->value;
     }
 
     if (fragmentNotification) {
         renderer::add_command(context->renderer.get(), renderer::CommandOpcode::SignalNotification,
-            nullptr, fragmentNotification, false);
+            nullptr, renderer::payload::SignalNotification{ fragmentNotification, false });
         // volatile uint32_t *val = fragmentNotification.get(host.mem)->address.get(host.mem);
         // *val = fragmentNotification.get(host.mem)->value;
     }
@@ -1446,7 +1450,7 @@ EXPORT(int, sceGxmEndScene, SceGxmContext *context, Ptr<SceGxmNotification> vert
         // Add NOP for our sync object
         SceGxmSyncObject *sync = context->state.fragment_sync_object.get(mem);
         renderer::add_command(context->renderer.get(), renderer::CommandOpcode::SignalSyncObject,
-            nullptr, context->state.fragment_sync_object);
+            nullptr, renderer::payload::SignalSyncObject{ context->state.fragment_sync_object });
 
         renderer::subject_in_progress(sync, renderer::SyncObjectSubject::Fragment);
     }
@@ -1731,6 +1735,12 @@ EXPORT(int, sceGxmMapVertexUsseMemory, Ptr<void> base, uint32_t size, uint32_t *
     return 0;
 }
 
+static void signal_notification(HostState &host, const Ptr<SceGxmNotification> notification) {
+    volatile uint32_t *val = notification.get(host.mem)->address.get(host.mem);
+    *val = notification.get(host.mem)->value;
+    host.renderer->notification_waiters.notify(val);
+}
+
 EXPORT(int, sceGxmMidSceneFlush, SceGxmContext *immediateContext, uint32_t flags, SceGxmSyncObject *vertexSyncObject, const Ptr<SceGxmNotification> vertexNotification) {
     STUBBED("STUB");
 
@@ -1746,10 +1756,8 @@ EXPORT(int, sceGxmMidSceneFlush, SceGxmContext *immediateContext, uint32_t flags
         return RET_ERROR(SCE_GXM_ERROR_INVALID_POINTER);
     }
 
-    if (vertexNotification) {
-        volatile uint32_t *val = vertexNotification.get(host.mem)->address.get(host.mem);
-        *val = vertexNotification.get(host.mem)->value;
-    }
+    if (vertexNotification)
+        signal_notification(host, vertexNotification);
 
     return 0;
 }
@@ -1763,11 +1771,25 @@ EXPORT(int, sceGxmNotificationWait, const Ptr<SceGxmNotification> notification)
         return RET_ERROR(SCE_GXM_ERROR_INVALID_POINTER);
     }
 
-    // TODO: This is so horrible
     volatile std::uint32_t *value = notification.get(host.mem)->address.get(host.mem);
-    //LOG_DEBUG("value: {}, notif value: {}", *value, notification.get(host.mem)->value);
-    while (*value != notification.get(host.mem)->value) {
-       //LOG_INFO("Waiting..., value: {}, notif value: {}", *value, notification.get(host.mem)->value);
+    const std::uint32_t expected = notification.get(host.mem)->value;
+    if (*value == expected)
+        return 0;
+
+    // Sleep as a waiting guest thread until the renderer (or a transfer) writes the notification. Guest CPU
+    // stores to the notification never call notify(), so the value is also checked again periodically.
+    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    {
+        const std::lock_guard<std::mutex> thread_lock(thread->mutex);
+        thread->update_status(ThreadStatus::wait, ThreadStatus::run);
+    }
+    while (!host.renderer->notification_waiters.wait_for(value, NOTIFICATION_RECHECK_INTERVAL, [&]() { return *value == expected; })) {
+        if (host.renderer->notification_waiters.is_aborted())
+            break;
+    }
+    {
+        const std::lock_guard<std::mutex> thread_lock(thread->mutex);
+        thread->update_status(ThreadStatus::run, ThreadStatus::wait);
     }
 
     return 0;
@@ -3954,8 +3976,7 @@ EXPORT(int, sceGxmTransferCopy, uint32_t width, uint32_t height, uint32_t colorK
 
     if (notification) {
         LOG_DEBUG("notification");
-        volatile uint32_t *val = notification.get(host.mem)->address.get(host.mem);
-        *val = notification.get(host.mem)->value;
+        signal_notification(host, notification);
     }
 
     return 0;
@@ -4000,8 +4021,7 @@ EXPORT(int, sceGxmTransferDownscale, SceGxmTransferFormat srcFormat, const void
 
     if (notification) {
         LOG_DEBUG("notification");
-        volatile uint32_t *val = notification.get(host.mem)->address.get(host.mem);
-        *val = notification.get(host.mem)->value;
+        signal_notification(host, notification);
     }
 
     return 0;
@@ -4038,10 +4058,8 @@ EXPORT(int, sceGxmTransferFill, uint32_t fillColor, SceGxmTransferFormat destFor
         renderer::wishlist(sync, (renderer::SyncObjectSubject)(renderer::SyncObjectSubject::DisplayQueue | renderer::SyncObjectSubject::Fragment));
     }
 
-    if (notification) {
-        volatile uint32_t *val = notification.get(host.mem)->address.get(host.mem);
-        *val = notification.get(host.mem)->value;
-    }
+    if (notification)
+        signal_notification(host, notification);
 
     return 0;
 }
@@ -103,13 +103,15 @@ EXPORT(int, _sceIoOpenAsync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _sceIoPread, const SceUID fd, void *data, const SceSize size, const SceOff offset) {
+EXPORT(int, _sceIoPread, const SceUID fd, GuestSpan<void> data, const SceSize size, const SceOff offset) {
+    if (!data.valid())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
     auto pos = tell_file(host.io, fd, export_name);
     if (pos < 0)
         return static_cast<int>(pos);
 
     seek_file(fd, offset, SCE_SEEK_SET, host.io, export_name);
-    const int res = read_file(data, host.io, fd, size, export_name);
+    const int res = read_file(data.data(), host.io, fd, size, export_name);
     seek_file(fd, pos, SCE_SEEK_SET, host.io, export_name);
     return res;
 }
@@ -226,8 +228,10 @@ EXPORT(int, sceIoLseek32, const SceUID fd, const int32_t offset, const SceIoSeek
     return static_cast<int>(seek_file(fd, offset, whence, host.io, export_name));
 }
 
-EXPORT(int, sceIoRead, const SceUID fd, void *data, const SceSize size) {
-    return read_file(data, host.io, fd, size, export_name);
+EXPORT(int, sceIoRead, const SceUID fd, GuestSpan<void> data, const SceSize size) {
+    if (!data.valid())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
+    return read_file(data.data(), host.io, fd, size, export_name);
 }
 
 EXPORT(int, sceIoReadAsync) {
@@ -262,8 +266,10 @@ EXPORT(int, sceIoSyncByFdAsync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceIoWrite, const SceUID fd, const void *data, const SceSize size) {
-    return write_file(fd, data, size, host.io, export_name);
+EXPORT(int, sceIoWrite, const SceUID fd, GuestSpan<const void> data, const SceSize size) {
+    if (!data.valid())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
+    return write_file(fd, data.data(), size, host.io, export_name);
 }
 
 EXPORT(int, sceIoWriteAsync) {
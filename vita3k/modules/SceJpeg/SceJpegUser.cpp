@@ -19,11 +19,11 @@
 
 #include <codec/state.h>
 
-typedef std::shared_ptr<DecoderState> DecoderPtr;
-
 struct MJpegState {
     bool initialized = false;
-    DecoderPtr decoder;
+    std::shared_ptr<MjpegDecoderState> decoder;
+    // YUV of the last decoded frame, kept around so videos don't allocate a frame each time
+    std::vector<uint8_t> yuv;
 };
 
 struct SceJpegMJpegInitInfo {
@@ -55,33 +55,46 @@ EXPORT(int, sceJpegCsc) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceJpegDecodeMJpeg, const unsigned char *pJpeg, SceSize isize, uint8_t *pRGBA, SceSize osize,
+EXPORT(int, sceJpegDecodeMJpeg, GuestSpan<const uint8_t> jpeg, SceSize isize, GuestSpan<uint8_t> rgba, SceSize osize,
     int decodeMode, uint8_t *pTempBuffer, SceSize tempBufferSize, void *pCoefBuffer, SceSize coefBufferSize) {
+    if (!jpeg.valid() || !rgba.valid())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
+
     const auto state = host.kernel.obj_store.get<MJpegState>();
 
     DecoderSize size = {};
 
-    // hold yuv for now, really inefficient but i'm hoping it works
-    std::vector<uint8_t> temporary(osize);
-    // ^^ allocates i think an extra frame but i want to be careful here
-    state->decoder->send(pJpeg, isize);
-    state->decoder->receive(temporary.data(), &size);
-
-    convert_yuv_to_rgb(temporary.data(), pRGBA, size.width, size.height);
+    // Only frames whose RGBA fits in the output get decoded, and their YUV444 is 3/4 of that
+    const size_t yuv_capacity = rgba.size() / 4 * 3;
+    if (state->yuv.size() < yuv_capacity)
+        state->yuv.resize(yuv_capacity);
+    state->decoder->send(jpeg.data(), isize);
+    state->decoder->receive(state->yuv.data(), &size, yuv_capacity);
+
+    // The decoder still reports the size of a frame it had no room for
+    if (static_cast<uint64_t>(size.width) * size.height * 4 > rgba.size())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
+    convert_yuv_to_rgb(state->yuv.data(), rgba.data(), size.width, size.height);
     LOG_DEBUG("size, x:{}, y: {}", size.width, size.height);
 
     // Top 16 bits = width, bottom 16 bits = height.
     return (size.width << 16u) | size.height;
 }
 
-EXPORT(int, sceJpegDecodeMJpegYCbCr, const uint8_t *jpeg_data, uint32_t jpeg_size,
-    uint8_t *output, uint32_t output_size, int mode, void *buffer, uint32_t buffer_size) {
+EXPORT(int, sceJpegDecodeMJpegYCbCr, GuestSpan<const uint8_t> jpeg_data, uint32_t jpeg_size,
+    GuestSpan<uint8_t> output, uint32_t output_size, int mode, void *buffer, uint32_t buffer_size) {
+    if (!jpeg_data.valid() || !output.valid())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
+
     const auto state = host.kernel.obj_store.get<MJpegState>();
 
     DecoderSize size = {};
 
-    state->decoder->send(jpeg_data, jpeg_size);
-    state->decoder->receive(output, &size);
+    state->decoder->send(jpeg_data.data(), jpeg_size);
+    state->decoder->receive(output.data(), &size, output.size());
+
+    if (static_cast<uint64_t>(size.width) * size.height * 3 > output.size())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
 
     // Top 16 bits = width, bottom 16 bits = height.
     return (size.width << 16u) | size.height;
@@ -97,13 +110,16 @@ EXPORT(int, sceJpegFinishMJpeg) {
     return 0;
 }
 
-EXPORT(int, sceJpegGetOutputInfo, const uint8_t *jpeg_data, uint32_t jpeg_size,
+EXPORT(int, sceJpegGetOutputInfo, GuestSpan<const uint8_t> jpeg_data, uint32_t jpeg_size,
     int32_t format, int32_t mode, SceJpegOutputInfo *output) {
+    if (!jpeg_data.valid())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
+
     const auto state = host.kernel.obj_store.get<MJpegState>();
 
     DecoderSize size = {};
 
-    state->decoder->send(jpeg_data, jpeg_size);
+    state->decoder->send(jpeg_data.data(), jpeg_size);
     state->decoder->receive(nullptr, &size);
 
     output->width = size.width;
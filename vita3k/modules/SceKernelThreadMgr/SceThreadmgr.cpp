@@ -21,6 +21,7 @@
 #include <host/functions.h>
 #include <kernel/callback.h>
 #include <kernel/sync_primitives.h>
+#include <rtc/rtc.h>
 
 #include <util/lock_and_find.h>
 
@@ -29,10 +30,29 @@
 #include <chrono>
 #include <thread>
 
-inline uint64_t get_current_time() {
-    return std::chrono::duration_cast<std::chrono::microseconds>(
-        std::chrono::high_resolution_clock::now().time_since_epoch())
-        .count();
+// Timer events count from the moment they are armed, and only while their timer is started
+static void arm_timer_event(KernelState &kernel, const TimerPtr &timer_info) {
+    if (!timer_info->is_started || !timer_info->event_interval)
+        return;
+
+    const std::weak_ptr<TimerState> weak_timer = timer_info;
+    timer_info->event = kernel.timer_wheel.schedule(
+        timer_info->event_interval, [weak_timer] {
+            if (const TimerPtr timer = weak_timer.lock())
+                timer_event_fire(*timer);
+        },
+        timer_info->repeats ? timer_info->event_interval : 0);
+}
+
+static bool is_timer(KernelState &kernel, SceUID uid) {
+    return lock_and_find(uid, kernel.timers, kernel.mutex) != nullptr;
+}
+
+static void disarm_timer_event(KernelState &kernel, TimerState &timer_info) {
+    if (timer_info.event) {
+        kernel.timer_wheel.cancel(timer_info.event);
+        timer_info.event = 0;
+    }
 }
 
 EXPORT(int, __sceKernelCreateLwMutex, Ptr<SceKernelLwMutexWork> workarea, const char *name, unsigned int attr, Ptr<SceKernelCreateLwMutex_opt> opt) {
@@ -71,8 +91,15 @@ EXPORT(int, _sceKernelCancelSema) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _sceKernelCancelTimer) {
-    return UNIMPLEMENTED();
+EXPORT(int, _sceKernelCancelTimer, SceUID timer_handle, SceUInt32 *num_wait_threads) {
+    const TimerPtr timer_info = lock_and_find(timer_handle, host.kernel.timers, host.kernel.mutex);
+    if (!timer_info)
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_TIMER_ID);
+
+    disarm_timer_event(host.kernel, *timer_info);
+    timer_info->event_interval = 0;
+
+    return timer_event_cancel(host.kernel, export_name, thread_id, timer_handle, num_wait_threads);
 }
 
 EXPORT(SceUID, _sceKernelCreateCond, const char *pName, SceUInt32 attr, SceUID mutexId, const SceKernelCondOptParam *pOptParam) {
@@ -397,8 +424,18 @@ EXPORT(int, _sceKernelGetTimerBase) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _sceKernelGetTimerEventRemainingTime) {
-    return UNIMPLEMENTED();
+EXPORT(int, _sceKernelGetTimerEventRemainingTime, SceUID timer_handle, SceKernelSysClock *time) {
+    const TimerPtr timer_info = lock_and_find(timer_handle, host.kernel.timers, host.kernel.mutex);
+    if (!timer_info)
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_TIMER_ID);
+
+    const auto remaining = host.kernel.timer_wheel.remaining_us(timer_info->event);
+    if (!remaining)
+        return RET_ERROR(SCE_KERNEL_ERROR_EVENT_NOT_SET);
+
+    *time = *remaining;
+
+    return SCE_KERNEL_OK;
 }
 
 EXPORT(int, _sceKernelGetTimerInfo) {
@@ -447,8 +484,13 @@ EXPORT(int, _sceKernelPMonThreadGetCounter) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _sceKernelPollEvent) {
-    return UNIMPLEMENTED();
+EXPORT(int, _sceKernelPollEvent, SceUID eventId, SceUInt32 bitPattern, SceUInt32 *pResultPattern, SceUInt64 *pUserData) {
+    if (!is_timer(host.kernel, eventId))
+        return UNIMPLEMENTED();
+
+    if (pUserData)
+        *pUserData = 0;
+    return timer_event_poll(host.kernel, export_name, thread_id, eventId, pResultPattern);
 }
 
 EXPORT(int, _sceKernelPollEventFlag, SceUID event_id, unsigned int flags, unsigned int wait, unsigned int *outBits) {
@@ -508,8 +550,19 @@ EXPORT(int, _sceKernelSetThreadContextForVM, SceUID threadId, Ptr<SceKernelThrea
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _sceKernelSetTimerEvent) {
-    return UNIMPLEMENTED();
+EXPORT(int, _sceKernelSetTimerEvent, SceUID timer_handle, SceInt32 type, SceKernelSysClock *interval, SceInt32 repeats) {
+    STUBBED("Type not implemented.");
+
+    const TimerPtr timer_info = lock_and_find(timer_handle, host.kernel.timers, host.kernel.mutex);
+    if (!timer_info)
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_TIMER_ID);
+
+    disarm_timer_event(host.kernel, *timer_info);
+    timer_info->repeats = repeats;
+    timer_info->event_interval = interval ? *interval : 0;
+    arm_timer_event(host.kernel, timer_info);
+
+    return SCE_KERNEL_OK;
 }
 
 EXPORT(int, _sceKernelSetTimerTime) {
@@ -574,12 +627,25 @@ EXPORT(SceInt32, _sceKernelWaitCondCB, SceUID condId, SceUInt32 *pTimeout) {
 }
 
 EXPORT(SceInt32, _sceKernelWaitEvent, SceUID eventId, SceUInt32 waitPattern, SceUInt32 *pResultPattern, SceUInt64 *pUserData, SceUInt32 *pTimeout) {
+    if (is_timer(host.kernel, eventId)) {
+        if (pUserData)
+            *pUserData = 0;
+        return timer_event_wait(host.kernel, export_name, thread_id, eventId, pResultPattern, pTimeout);
+    }
+
     // Need create event_wait function for pUserData and pResultPattern
     //return eventflag_wait(host.kernel, export_name, thread_id, eventId, waitPattern, pResultPattern, pTimeout);
     return UNIMPLEMENTED();
 }
 
 EXPORT(SceInt32, _sceKernelWaitEventCB, SceUID eventId, SceUInt32 waitPattern, SceUInt32 *pResultPattern, SceUInt64 *pUserData, SceUInt32 *pTimeout) {
+    if (is_timer(host.kernel, eventId)) {
+        process_callbacks(host.kernel, thread_id);
+        if (pUserData)
+            *pUserData = 0;
+        return timer_event_wait(host.kernel, export_name, thread_id, eventId, pResultPattern, pTimeout);
+    }
+
     //STUBBED("no CB");
     // Need create event_wait function for pUserData and pResultPattern
     //return eventflag_wait(host.kernel, export_name, thread_id, eventId, waitPattern, pResultPattern, pResultPattern, pTimeout);
@@ -668,7 +734,7 @@ int wait_thread_end(ThreadStatePtr &waiter, ThreadStatePtr &target, int *stat) {
         target->waiting_threads.push_back(waiter);
     }
 
-    waiter->status = ThreadStatus::wait;
+    waiter->update_status(ThreadStatus::wait);
     waiter->status_cond.wait(waiter_lock, [&]() { return waiter->status == ThreadStatus::run; });
     return 0;
 }
@@ -705,16 +771,29 @@ EXPORT(int, sceKernelChangeActiveCpuMask) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceKernelChangeThreadCpuAffinityMask) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceKernelChangeThreadCpuAffinityMask, SceUID thid, int cpu_affinity_mask) {
+    if (cpu_affinity_mask & ~SCE_KERNEL_CPU_MASK_USER_ALL)
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_CPU_AFFINITY_MASK);
+
+    const ThreadStatePtr thread = lock_and_find(thid ? thid : thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread)
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_THREAD_ID);
+
+    const std::lock_guard<std::mutex> lock(thread->mutex);
+    thread->affinity_mask = cpu_affinity_mask;
+    host.kernel.update_host_scheduling(*thread);
+
+    return SCE_KERNEL_OK;
 }
 
 EXPORT(int, sceKernelChangeThreadPriority, SceUID thid, int priority) {
-    STUBBED("STUB");
-
     const ThreadStatePtr thread = lock_and_find(thid ? thid : thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread)
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_THREAD_ID);
+
     const std::lock_guard<std::mutex> lock(thread->mutex);
-    thread.get()->priority = priority;
+    thread->priority = priority;
+    host.kernel.update_host_scheduling(*thread);
 
     return SCE_KERNEL_OK;
 }
@@ -795,11 +874,11 @@ EXPORT(SceUID, sceKernelCreateCallback, char *name, SceUInt32 attr, Ptr<SceKerne
 }
 
 EXPORT(int, sceKernelCreateThreadForUser, const char *name, SceKernelThreadEntry entry, int init_priority, SceKernelCreateThread_opt *options) {
-    if (options->cpu_affinity_mask > 0x70000) {
+    if (options->cpu_affinity_mask > SCE_KERNEL_CPU_MASK_USER_ALL) {
         return RET_ERROR(SCE_KERNEL_ERROR_INVALID_CPU_AFFINITY);
     }
 
-    const ThreadStatePtr thread = host.kernel.create_thread(host.mem, name, entry.cast<void>(), init_priority, options->stack_size, options->option.get(host.mem));
+    const ThreadStatePtr thread = host.kernel.create_thread(host.mem, name, entry.cast<void>(), init_priority, options->stack_size, options->option.get(host.mem), options->cpu_affinity_mask);
     if (!thread)
         return RET_ERROR(SCE_KERNEL_ERROR_ERROR);
     return thread->id;
@@ -809,19 +888,21 @@ int delay_thread(SceUInt delay_us) {
     if (delay_us == 0)
         return SCE_KERNEL_ERROR_INVALID_ARGUMENT;
 
-    std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+    // A delayed thread is not running, it must not hold the unlocked clock back from reaching its own deadline
+    rtc_add_running_guest_threads(-1);
+    rtc_sleep_for(delay_us);
+    rtc_add_running_guest_threads(1);
 
     return SCE_KERNEL_OK;
 }
 
 int delay_thread_cb(HostState &host, SceUID thread_id, SceUInt delay_us) {
-    auto start = std::chrono::high_resolution_clock::now(); //Meseaure the time taken to process callbacks
+    const uint64_t start = rtc_ticks_since_epoch(); //Meseaure the time taken to process callbacks
     process_callbacks(host.kernel, thread_id);
-    auto end = std::chrono::high_resolution_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    const uint64_t elapsed = rtc_ticks_since_epoch() - start;
 
-    if (delay_us > elapsed.count()) //If we spent less time than requested processing callbacks, sleep the remaining time
-        return delay_thread(delay_us - elapsed.count());
+    if (delay_us > elapsed) //If we spent less time than requested processing callbacks, sleep the remaining time
+        return delay_thread(static_cast<SceUInt>(delay_us - elapsed));
     else //Else return directly
         return SCE_KERNEL_OK;
 }
@@ -889,6 +970,10 @@ EXPORT(int, sceKernelDeleteThread, SceUID thid) {
 }
 
 EXPORT(int, sceKernelDeleteTimer, SceUID timer_handle) {
+    const TimerPtr timer_info = lock_and_find(timer_handle, host.kernel.timers, host.kernel.mutex);
+    if (timer_info)
+        disarm_timer_event(host.kernel, *timer_info);
+
     host.kernel.timers.erase(timer_handle);
 
     return 0;
@@ -920,11 +1005,15 @@ EXPORT(int, sceKernelGetProcessId) {
 }
 
 EXPORT(uint64_t, sceKernelGetSystemTimeWide) {
-    return get_current_time();
+    return rtc_ticks_since_epoch();
 }
 
-EXPORT(int, sceKernelGetThreadCpuAffinityMask) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceKernelGetThreadCpuAffinityMask, SceUID thid) {
+    const ThreadStatePtr thread = lock_and_find(thid ? thid : thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread)
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_THREAD_ID);
+
+    return thread->affinity_mask;
 }
 
 EXPORT(int, sceKernelGetThreadStackFreeSize) {
@@ -954,7 +1043,7 @@ EXPORT(uint64_t, sceKernelGetTimerTimeWide, SceUID timer_handle) {
     if (!timer_info)
         return -1;
 
-    return get_current_time() - timer_info->time;
+    return rtc_ticks_since_epoch() - timer_info->time;
 }
 
 EXPORT(SceInt32, sceKernelNotifyCallback, SceUID callbackId, SceInt32 notifyArg) {
@@ -1103,7 +1192,8 @@ EXPORT(int, sceKernelStartTimer, SceUID timer_handle) {
         return false;
 
     timer_info->is_started = true;
-    timer_info->time = get_current_time();
+    timer_info->time = rtc_ticks_since_epoch();
+    arm_timer_event(host.kernel, timer_info);
 
     return true;
 }
@@ -1115,7 +1205,8 @@ EXPORT(int, sceKernelStopTimer, SceUID timer_handle) {
         return false;
 
     timer_info->is_started = false;
-    timer_info->time = get_current_time();
+    timer_info->time = rtc_ticks_since_epoch();
+    disarm_timer_event(host.kernel, *timer_info);
 
     return true;
 }
@@ -50,6 +50,9 @@ EXPORT(int, _sceKernelSetThreadContextForVM, SceUID threadId, Ptr<SceKernelThrea
 EXPORT(int, _sceKernelGetThreadContextForVM, SceUID threadId, Ptr<SceKernelThreadCpuRegisterInfo> pCpuRegisterInfo, Ptr<SceKernelThreadVfpRegisterInfo> pVfpRegisterInfo);
 EXPORT(int, sceKernelResumeThreadForVM, SceUID threadId);
 EXPORT(int, sceKernelSuspendThreadForVM, SceUID threadId);
+EXPORT(int, _sceKernelCancelTimer, SceUID timer_handle, SceUInt32 *num_wait_threads);
+EXPORT(int, _sceKernelGetTimerEventRemainingTime, SceUID timer_handle, SceKernelSysClock *time);
+EXPORT(int, _sceKernelSetTimerEvent, SceUID timer_handle, SceInt32 type, SceKernelSysClock *interval, SceInt32 repeats);
 
 BRIDGE_DECL(__sceKernelCreateLwMutex)
 BRIDGE_DECL(_sceKernelCancelEvent)
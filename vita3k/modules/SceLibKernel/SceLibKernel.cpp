@@ -49,12 +49,6 @@ enum class TimerFlags : uint32_t {
     OPENABLE = 0x00000080,
 };
 
-inline uint64_t get_current_time() {
-    return std::chrono::duration_cast<std::chrono::microseconds>(
-        std::chrono::high_resolution_clock::now().time_since_epoch())
-        .count();
-}
-
 EXPORT(int, __sce_aeabi_idiv0) {
     return UNIMPLEMENTED();
 }
@@ -472,13 +466,15 @@ EXPORT(int, sceIoOpenAsync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(SceSSize, sceIoPread, const SceUID fd, void *data, const SceSize size, const SceOff offset) {
+EXPORT(SceSSize, sceIoPread, const SceUID fd, GuestSpan<void> data, const SceSize size, const SceOff offset) {
+    if (!data.valid())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
     auto pos = tell_file(host.io, fd, export_name);
     if (pos < 0) {
         return pos;
     }
     seek_file(fd, offset, SCE_SEEK_SET, host.io, export_name);
-    const auto res = read_file(data, host.io, fd, size, export_name);
+    const auto res = read_file(data.data(), host.io, fd, size, export_name);
     seek_file(fd, pos, SCE_SEEK_SET, host.io, export_name);
     return res;
 }
@@ -487,13 +483,15 @@ EXPORT(int, sceIoPreadAsync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(SceSSize, sceIoPwrite, const SceUID fd, const void *data, const SceSize size, const SceOff offset) {
+EXPORT(SceSSize, sceIoPwrite, const SceUID fd, GuestSpan<const void> data, const SceSize size, const SceOff offset) {
+    if (!data.valid())
+        return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_ADDR);
     auto pos = tell_file(host.io, fd, export_name);
     if (pos < 0) {
         return pos;
     }
     seek_file(fd, offset, SCE_SEEK_SET, host.io, export_name);
-    const auto res = write_file(fd, data, size, host.io, export_name);
+    const auto res = write_file(fd, data.data(), size, host.io, export_name);
     seek_file(fd, pos, SCE_SEEK_SET, host.io, export_name);
     return res;
 }
@@ -880,8 +878,8 @@ EXPORT(int, sceKernelCancelSema) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceKernelCancelTimer) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceKernelCancelTimer, SceUID timer_handle, SceUInt32 *num_wait_threads) {
+    return CALL_EXPORT(_sceKernelCancelTimer, timer_handle, num_wait_threads);
 }
 
 EXPORT(int, sceKernelChangeCurrentThreadAttr) {
@@ -989,10 +987,12 @@ EXPORT(SceUID, sceKernelCreateTimer, const char *name, uint32_t flags, const voi
 
     timer_info->name = name;
 
-    if (flags & static_cast<uint32_t>(TimerFlags::PRIORITY_THREAD))
+    if (flags & static_cast<uint32_t>(TimerFlags::PRIORITY_THREAD)) {
         timer_info->thread_behaviour = TimerState::ThreadBehaviour::PRIORITY;
-    else
+        timer_info->waiting_threads = std::make_unique<PriorityThreadDataQueue<WaitingThreadData>>();
+    } else {
         timer_info->thread_behaviour = TimerState::ThreadBehaviour::FIFO;
+    }
 
     if (flags & static_cast<uint32_t>(TimerFlags::AUTOMATIC_RESET))
         timer_info->reset_behaviour = TimerState::ResetBehaviour::AUTOMATIC;
@@ -1186,8 +1186,8 @@ EXPORT(int, sceKernelGetTimerBase, SceUID timer_handle, SceKernelSysClock *time)
     return 0;
 }
 
-EXPORT(int, sceKernelGetTimerEventRemainingTime) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceKernelGetTimerEventRemainingTime, SceUID timer_handle, SceKernelSysClock *time) {
+    return CALL_EXPORT(_sceKernelGetTimerEventRemainingTime, timer_handle, time);
 }
 
 EXPORT(int, sceKernelGetTimerInfo) {
@@ -1200,7 +1200,7 @@ EXPORT(int, sceKernelGetTimerTime, SceUID timer_handle, SceKernelSysClock *time)
     if (!timer_info)
         return SCE_KERNEL_ERROR_UNKNOWN_TIMER_ID;
 
-    *time = get_current_time() - timer_info->time;
+    *time = rtc_ticks_since_epoch() - timer_info->time;
 
     return 0;
 }
@@ -1348,18 +1348,7 @@ EXPORT(int, sceKernelSetThreadContextForVM, SceUID threadId, Ptr<SceKernelThread
 }
 
 EXPORT(int, sceKernelSetTimerEvent, SceUID timer_handle, int32_t type, SceKernelSysClock *clock, int32_t repeats) {
-    STUBBED("Type not implemented.");
-
-    const TimerPtr timer_info = lock_and_find(timer_handle, host.kernel.timers, host.kernel.mutex);
-
-    if (!timer_info)
-        return SCE_KERNEL_ERROR_UNKNOWN_TIMER_ID;
-
-    // TODO: Timer values for type.
-
-    timer_info->repeats = repeats;
-
-    return SCE_KERNEL_OK;
+    return CALL_EXPORT(_sceKernelSetTimerEvent, timer_handle, type, clock, repeats);
 }
 
 EXPORT(int, sceKernelSetTimerTime) {
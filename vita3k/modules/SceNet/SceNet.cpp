@@ -21,9 +21,6 @@
 #include <net/types.h>
 #include <util/lock_and_find.h>
 
-#include <chrono>
-#include <thread>
-
 EXPORT(int, sceNetAccept, int sid, SceNetSockaddr *addr, unsigned int *addrlen) {
     auto sock = lock_and_find(sid, host.net.socks, host.kernel.mutex);
     if (!sock) {
@@ -82,32 +79,81 @@ EXPORT(int, sceNetEmulationSet) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceNetEpollAbort) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollAbort, int eid, int flags) {
+    const auto epoll = lock_and_find(eid, host.net.epolls, host.kernel.mutex);
+    if (!epoll) {
+        return RET_ERROR(SCE_NET_ERROR_EBADF);
+    }
+    epoll->abort(flags);
+    return 0;
 }
 
-EXPORT(int, sceNetEpollControl) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceNetEpollControl, int eid, int op, int id, const SceNetEpollEvent *event) {
+    const auto epoll = lock_and_find(eid, host.net.epolls, host.kernel.mutex);
+    if (!epoll) {
+        return RET_ERROR(SCE_NET_ERROR_EBADF);
+    }
 
-EXPORT(int, sceNetEpollCreate, const char *name) {
-    return UNIMPLEMENTED();
+    switch (op) {
+    case SCE_NET_EPOLL_CTL_ADD: {
+        const auto sock = lock_and_find(id, host.net.socks, host.kernel.mutex);
+        if (!sock) {
+            return RET_ERROR(SCE_NET_ERROR_EBADF);
+        }
+        if (!event) {
+            return RET_ERROR(SCE_NET_ERROR_EINVAL);
+        }
+        return epoll->add(id, sock, *event);
+    }
+    case SCE_NET_EPOLL_CTL_MOD:
+        if (!event) {
+            return RET_ERROR(SCE_NET_ERROR_EINVAL);
+        }
+        return epoll->modify(id, *event);
+    case SCE_NET_EPOLL_CTL_DEL:
+        return epoll->remove(id);
+    default:
+        return RET_ERROR(SCE_NET_ERROR_EINVAL);
+    }
 }
 
-EXPORT(int, sceNetEpollDestroy) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollCreate, const char *name, int flags) {
+    const auto epoll = std::make_shared<NetEpoll>();
+    if (!epoll->valid()) {
+        return RET_ERROR(SCE_NET_ERROR_EMFILE);
+    }
+    const std::lock_guard<std::mutex> lock(host.kernel.mutex);
+    const auto id = ++host.net.next_id;
+    host.net.epolls.emplace(id, epoll);
+    return id;
 }
 
-struct SceNetEpollEvent {}; // TODO fill this
+EXPORT(int, sceNetEpollDestroy, int eid) {
+    NetEpollPtr epoll;
+    {
+        const std::lock_guard<std::mutex> lock(host.kernel.mutex);
+        const auto it = host.net.epolls.find(eid);
+        if (it == host.net.epolls.end()) {
+            return RET_ERROR(SCE_NET_ERROR_EBADF);
+        }
+        epoll = it->second;
+        host.net.epolls.erase(it);
+    }
+    // Threads still waiting on it hold their own reference, it goes away once they're woken up
+    epoll->abort(SCE_NET_EPOLL_ABORT_FLAG_PRESERVATION);
+    return 0;
+}
 
-EXPORT(int, sceNetEpollWait, int sid, SceNetEpollEvent *events, int maxevents, int timeout) {
-    auto x = std::chrono::microseconds(timeout);
-    std::this_thread::sleep_for(x);
-    return STUBBED("only timeout");
+EXPORT(int, sceNetEpollWait, int eid, SceNetEpollEvent *events, int maxevents, int timeout) {
+    const auto epoll = lock_and_find(eid, host.net.epolls, host.kernel.mutex);
+    if (!epoll) {
+        return RET_ERROR(SCE_NET_ERROR_EBADF);
+    }
+    return epoll->wait(events, maxevents, timeout);
 }
 
-EXPORT(int, sceNetEpollWaitCB) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollWaitCB, int eid, SceNetEpollEvent *events, int maxevents, int timeout) {
+    return CALL_EXPORT(sceNetEpollWait, eid, events, maxevents, timeout);
 }
 
 EXPORT(int, sceNetErrnoLoc) {
@@ -361,6 +407,12 @@ EXPORT(int, sceNetSocketClose, int sid) {
     if (!sock) {
         return -1;
     }
+    {
+        // Closed sockets leave the epolls watching them, before the host gets a chance to reuse their descriptor
+        const std::lock_guard<std::mutex> lock(host.kernel.mutex);
+        for (const auto &[_, epoll] : host.net.epolls)
+            epoll->remove(sid);
+    }
     return sock->close();
 }
 
@@ -135,7 +135,13 @@ void call_import(HostState &host, CPUState &cpu, uint32_t nid, SceUID thread_id)
         }
         const ImportFn fn = resolve_import(nid);
         if (fn) {
-            fn(host, cpu, thread_id);
+            if (host.kernel.hle_profiler.enabled) {
+                const uint64_t start = HleProfiler::timestamp();
+                fn(host, cpu, thread_id);
+                host.kernel.hle_profiler.record(nid, start, HleProfiler::timestamp());
+            } else {
+                fn(host, cpu, thread_id);
+            }
         } else if (host.missing_nids.count(nid) == 0 || LOG_UNK_NIDS_ALWAYS) {
             const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
             LOG_ERROR("Import function for NID {} not found (thread name: {}, thread ID: {})", log_hex(nid), thread->name, thread_id);
@@ -174,35 +180,43 @@ bool load_module(HostState &host, SceSysmoduleModuleId module_id) {
 
     const auto module_paths = sysmodule_paths[module_id];
 
+    std::vector<vfs::FileBuffer> module_buffers;
+    std::vector<SelfToLoad> selfs;
+    module_buffers.reserve(module_paths.size());
     for (std::string module_path : module_paths) {
         module_path = "sys/external/" + module_path + ".suprx";
 
         vfs::FileBuffer module_buffer;
-        Ptr<const void> lib_entry_point;
-
         if (vfs::read_file(VitaIoDevice::vs0, module_buffer, host.pref_path, module_path)) {
-            SceUID loaded_module_uid = load_self(lib_entry_point, host.kernel, host.mem, module_buffer.data(), module_path);
-            const auto module = host.kernel.loaded_modules[loaded_module_uid];
-            const auto module_name = module->module_name;
+            module_buffers.push_back(std::move(module_buffer));
+            selfs.push_back({ module_buffers.back().data(), module_path });
+        } else {
+            LOG_ERROR("Module at \"{}\" not present", module_path);
+            // ignore and assume it was loaded
+        }
+    }
 
-            if (loaded_module_uid >= 0) {
-                LOG_INFO("Module {} (at \"{}\") loaded", module_name, module_path);
-            } else {
-                LOG_ERROR("Error when loading module at \"{}\"", module_path);
-                return false;
-            }
+    // The modules are independent, load them all at once and only then run their start routines in order
+    std::vector<Ptr<const void>> lib_entry_points;
+    const std::vector<SceUID> loaded_module_uids = load_selfs(lib_entry_points, host.kernel, host.mem, selfs);
 
-            if (lib_entry_point) {
-                LOG_DEBUG("Running module_start of module: {}", module_name);
+    for (size_t i = 0; i < selfs.size(); i++) {
+        const auto &module_path = selfs[i].path;
+        if (loaded_module_uids[i] < 0) {
+            LOG_ERROR("Error when loading module at \"{}\"", module_path);
+            return false;
+        }
 
-                Ptr<void> argp = Ptr<void>();
-                const auto ret = host.kernel.run_guest_function(lib_entry_point.address(), { 0, argp.address() });
-                LOG_INFO("Module {} (at \"{}\") module_start returned {}", module_name, module->path, log_hex(ret));
-            }
+        const auto module = host.kernel.loaded_modules[loaded_module_uids[i]];
+        const auto module_name = module->module_name;
+        LOG_INFO("Module {} (at \"{}\") loaded", module_name, module_path);
 
-        } else {
-            LOG_ERROR("Module at \"{}\" not present", module_path);
-            // ignore and assume it was loaded
+        if (lib_entry_points[i]) {
+            LOG_DEBUG("Running module_start of module: {}", module_name);
+
+            Ptr<void> argp = Ptr<void>();
+            const auto ret = host.kernel.run_guest_function(lib_entry_points[i].address(), { 0, argp.address() });
+            LOG_INFO("Module {} (at \"{}\") module_start returned {}", module_name, module->path, log_hex(ret));
         }
     }
 
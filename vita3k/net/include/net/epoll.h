@@ -0,0 +1,87 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <net/socket.h>
+#include <net/types.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+// SceNet epoll instance, backed by a host epoll on Linux and by poll elsewhere.
+// Only sockets with a host descriptor behind them (PosixSocket) can be watched.
+struct NetEpoll {
+    NetEpoll();
+    ~NetEpoll();
+
+    NetEpoll(const NetEpoll &) = delete;
+    NetEpoll &operator=(const NetEpoll &) = delete;
+
+    bool valid() const;
+
+    int add(int sid, const SocketPtr &sock, const SceNetEpollEvent &event);
+    int modify(int sid, const SceNetEpollEvent &event);
+    int remove(int sid);
+
+    /**
+     * \brief Waits for sockets to be ready and fills events with them.
+     *
+     * \param timeout  Timeout in microseconds, negative waits until something happens.
+     * \return         Number of events written, or a SceNet error.
+     */
+    int wait(SceNetEpollEvent *events, int maxevents, int timeout);
+
+    /**
+     * \brief Makes the threads blocked in wait return SCE_NET_ERROR_EINTR.
+     *
+     * \param flags  With SCE_NET_EPOLL_ABORT_FLAG_PRESERVATION, every later wait fails right away as well.
+     */
+    void abort(int flags);
+
+private:
+    struct Entry {
+        SocketPtr sock;
+        abs_socket host;
+        unsigned int events;
+        SceNetEpollData data;
+    };
+
+    // Returns false when a preserved abort makes every wait fail
+    bool begin_wait(uint32_t &generation);
+    // Both need the lock
+    bool aborted_since(uint32_t generation) const;
+    void end_wait(uint32_t generation);
+
+    std::mutex mutex;
+    std::map<int, Entry> entries;
+
+    uint32_t abort_generation = 0; // Bumped by every abort, waits that started before it return
+    int waiters = 0;
+    int aborted_waiters = 0; // Waits released by an abort that did not return yet
+    bool preserved_abort = false;
+
+#ifdef __linux__
+    int epoll_fd = -1;
+    int wake_fd = -1; // Kept readable until every aborted wait returned
+    bool wake_pending = false;
+#endif
+};
+
+typedef std::shared_ptr<NetEpoll> NetEpollPtr;
@@ -294,6 +294,42 @@ enum SceNetErrorCode {
     SCE_NET_ERROR_RESOLVER_EALIGNMENT = 0x804101EA
 };
 
+enum SceNetEpollEventType {
+    SCE_NET_EPOLLIN = 0x00000001,
+    SCE_NET_EPOLLOUT = 0x00000002,
+    SCE_NET_EPOLLERR = 0x00000008,
+    SCE_NET_EPOLLHUP = 0x00000010,
+    SCE_NET_EPOLLDESCID = 0x00010000
+};
+
+enum SceNetEpollControlFlag {
+    SCE_NET_EPOLL_CTL_ADD = 1,
+    SCE_NET_EPOLL_CTL_MOD = 2,
+    SCE_NET_EPOLL_CTL_DEL = 3
+};
+
+enum SceNetEpollAbortFlag {
+    SCE_NET_EPOLL_ABORT_FLAG_PRESERVATION = 0x00000001
+};
+
+union SceNetEpollData {
+    Address ptr;
+    int fd;
+    unsigned int u32;
+    unsigned long long int u64;
+};
+
+struct SceNetEpollSystemData {
+    unsigned int system[4];
+};
+
+struct SceNetEpollEvent {
+    unsigned int events;
+    unsigned int reserved;
+    SceNetEpollSystemData system;
+    SceNetEpollData data;
+};
+
 struct SceNetEtherAddr {
     unsigned char data[6];
 };
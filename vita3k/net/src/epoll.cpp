@@ -0,0 +1,361 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <net/epoll.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#elif !defined(WIN32)
+#include <poll.h>
+#endif
+
+#ifdef WIN32
+#define poll WSAPoll
+#endif
+
+static int ms_from_us(int timeout) {
+    // Round up, waking up early would look like a spurious timeout to the game
+    return timeout < 0 ? -1 : (timeout + 999) / 1000;
+}
+
+#ifdef __linux__
+// Marks the wake up descriptor in the host epoll, socket ids are never negative
+constexpr uint64_t WAKE_UP_ID = ~0ull;
+
+static uint32_t host_events(unsigned int events) {
+    // Peers closing their end are reported as a hang up
+    uint32_t host = EPOLLRDHUP;
+    if (events & SCE_NET_EPOLLIN)
+        host |= EPOLLIN;
+    if (events & SCE_NET_EPOLLOUT)
+        host |= EPOLLOUT;
+    return host;
+}
+
+static unsigned int sce_events(uint32_t host) {
+    unsigned int events = 0;
+    if (host & EPOLLIN)
+        events |= SCE_NET_EPOLLIN;
+    if (host & EPOLLOUT)
+        events |= SCE_NET_EPOLLOUT;
+    if (host & EPOLLERR)
+        events |= SCE_NET_EPOLLERR;
+    if (host & (EPOLLHUP | EPOLLRDHUP))
+        events |= SCE_NET_EPOLLHUP;
+    return events;
+}
+
+NetEpoll::NetEpoll() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (epoll_fd < 0 || wake_fd < 0)
+        return;
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_UP_ID;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+}
+
+NetEpoll::~NetEpoll() {
+    if (wake_fd >= 0)
+        close(wake_fd);
+    if (epoll_fd >= 0)
+        close(epoll_fd);
+}
+
+bool NetEpoll::valid() const {
+    return epoll_fd >= 0 && wake_fd >= 0;
+}
+#else
+// poll has no way to be interrupted, so aborts are picked up between slices of this length
+constexpr int POLL_SLICE_MS = 10;
+
+static short host_events(unsigned int events) {
+    short host = 0;
+    if (events & SCE_NET_EPOLLIN)
+        host |= POLLIN;
+    if (events & SCE_NET_EPOLLOUT)
+        host |= POLLOUT;
+    return host;
+}
+
+static unsigned int sce_events(short host) {
+    unsigned int events = 0;
+    if (host & POLLIN)
+        events |= SCE_NET_EPOLLIN;
+    if (host & POLLOUT)
+        events |= SCE_NET_EPOLLOUT;
+    if (host & (POLLERR | POLLNVAL))
+        events |= SCE_NET_EPOLLERR;
+    if (host & POLLHUP)
+        events |= SCE_NET_EPOLLHUP;
+    return events;
+}
+
+NetEpoll::NetEpoll() = default;
+NetEpoll::~NetEpoll() = default;
+
+bool NetEpoll::valid() const {
+    return true;
+}
+#endif
+
+int NetEpoll::add(int sid, const SocketPtr &sock, const SceNetEpollEvent &event) {
+    const auto posix = std::dynamic_pointer_cast<PosixSocket>(sock);
+    if (!posix)
+        return SCE_NET_ERROR_ENOTSUP;
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (entries.count(sid))
+        return SCE_NET_ERROR_EEXIST;
+
+#ifdef __linux__
+    epoll_event host_event = {};
+    host_event.events = host_events(event.events);
+    host_event.data.u64 = static_cast<uint64_t>(sid);
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, posix->sock, &host_event) < 0)
+        return SCE_NET_ERROR_EBADF;
+#endif
+
+    entries.emplace(sid, Entry{ sock, posix->sock, event.events, event.data });
+    return 0;
+}
+
+int NetEpoll::modify(int sid, const SceNetEpollEvent &event) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    const auto entry = entries.find(sid);
+    if (entry == entries.end())
+        return SCE_NET_ERROR_ENOENT;
+
+#ifdef __linux__
+    epoll_event host_event = {};
+    host_event.events = host_events(event.events);
+    host_event.data.u64 = static_cast<uint64_t>(sid);
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, entry->second.host, &host_event) < 0)
+        return SCE_NET_ERROR_EBADF;
+#endif
+
+    entry->second.events = event.events;
+    entry->second.data = event.data;
+    return 0;
+}
+
+int NetEpoll::remove(int sid) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    const auto entry = entries.find(sid);
+    if (entry == entries.end())
+        return SCE_NET_ERROR_ENOENT;
+
+#ifdef __linux__
+    // Fails when the socket got closed already, the host dropped it from the set by itself then
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, entry->second.host, nullptr);
+#endif
+
+    entries.erase(entry);
+    return 0;
+}
+
+bool NetEpoll::begin_wait(uint32_t &generation) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (preserved_abort)
+        return false;
+
+    generation = abort_generation;
+    waiters++;
+    return true;
+}
+
+bool NetEpoll::aborted_since(uint32_t generation) const {
+    return generation != abort_generation;
+}
+
+void NetEpoll::end_wait(uint32_t generation) {
+    waiters--;
+    if (!aborted_since(generation) || --aborted_waiters > 0)
+        return;
+
+#ifdef __linux__
+    // The last aborted wait is out, later waits must block again
+    if (wake_pending) {
+        uint64_t value;
+        [[maybe_unused]] const auto read_size = read(wake_fd, &value, sizeof(value));
+        wake_pending = false;
+    }
+#endif
+}
+
+void NetEpoll::abort(int flags) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    abort_generation++;
+    aborted_waiters = waiters;
+    if (flags & SCE_NET_EPOLL_ABORT_FLAG_PRESERVATION)
+        preserved_abort = true;
+
+#ifdef __linux__
+    if (aborted_waiters > 0 && !wake_pending) {
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = write(wake_fd, &one, sizeof(one));
+        wake_pending = true;
+    }
+#endif
+}
+
+#ifdef __linux__
+int NetEpoll::wait(SceNetEpollEvent *events, int maxevents, int timeout) {
+    if (!events || maxevents <= 0)
+        return SCE_NET_ERROR_EINVAL;
+
+    uint32_t generation;
+    if (!begin_wait(generation))
+        return SCE_NET_ERROR_EINTR;
+
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::microseconds(std::max(timeout, 0));
+    constexpr int MAX_HOST_EVENTS = 64;
+    epoll_event host[MAX_HOST_EVENTS];
+    while (true) {
+        int wait_ms = ms_from_us(timeout);
+        if (timeout >= 0) {
+            const auto left = std::chrono::duration_cast<std::chrono::microseconds>(deadline - Clock::now()).count();
+            wait_ms = ms_from_us(static_cast<int>(std::max<int64_t>(left, 0)));
+        }
+        // One more than asked for, the wake up descriptor may take a slot
+        const int host_count = epoll_wait(epoll_fd, host, std::min(maxevents + 1, MAX_HOST_EVENTS), wait_ms);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (aborted_since(generation)) {
+            end_wait(generation);
+            return SCE_NET_ERROR_EINTR;
+        }
+        if (host_count < 0 && errno != EINTR) {
+            end_wait(generation);
+            return SCE_NET_ERROR_EINTERNAL;
+        }
+
+        int count = 0;
+        bool woken_for_others = false;
+        for (int i = 0; i < host_count && count < maxevents; i++) {
+            if (host[i].data.u64 == WAKE_UP_ID) {
+                woken_for_others = true;
+                continue;
+            }
+            // Removed by another thread while this one was waking up
+            const auto entry = entries.find(static_cast<int>(host[i].data.u64));
+            if (entry == entries.end())
+                continue;
+
+            SceNetEpollEvent &event = events[count++];
+            event = {};
+            event.events = sce_events(host[i].events);
+            event.data = entry->second.data;
+        }
+
+        if (count > 0 || (timeout >= 0 && Clock::now() >= deadline)) {
+            end_wait(generation);
+            return count;
+        }
+        lock.unlock();
+
+        // An abort from before this wait started is still releasing its waiters, let them drain the wake up descriptor
+        if (woken_for_others)
+            std::this_thread::yield();
+    }
+}
+#else
+int NetEpoll::wait(SceNetEpollEvent *events, int maxevents, int timeout) {
+    if (!events || maxevents <= 0)
+        return SCE_NET_ERROR_EINVAL;
+
+    uint32_t generation;
+    if (!begin_wait(generation))
+        return SCE_NET_ERROR_EINTR;
+
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::microseconds(std::max(timeout, 0));
+    std::vector<pollfd> fds;
+    std::vector<int> sids;
+    while (true) {
+        // Rebuilt each slice so sockets added or removed meanwhile are taken into account
+        fds.clear();
+        sids.clear();
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (aborted_since(generation)) {
+                end_wait(generation);
+                return SCE_NET_ERROR_EINTR;
+            }
+
+            for (const auto &[sid, entry] : entries) {
+                pollfd fd = {};
+                fd.fd = entry.host;
+                fd.events = host_events(entry.events);
+                fds.push_back(fd);
+                sids.push_back(sid);
+            }
+        }
+
+        int slice = POLL_SLICE_MS;
+        if (timeout >= 0) {
+            const auto left = std::chrono::duration_cast<std::chrono::microseconds>(deadline - Clock::now()).count();
+            slice = std::min(slice, ms_from_us(static_cast<int>(std::max<int64_t>(left, 0))));
+        }
+        const int ready = fds.empty() ? 0 : poll(fds.data(), static_cast<unsigned int>(fds.size()), slice);
+        if (fds.empty() && slice > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(slice));
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (ready < 0) {
+            end_wait(generation);
+            return SCE_NET_ERROR_EINTERNAL;
+        }
+
+        if (ready > 0) {
+            int count = 0;
+            for (size_t i = 0; i < fds.size() && count < maxevents; i++) {
+                const auto entry = entries.find(sids[i]);
+                if (!fds[i].revents || entry == entries.end())
+                    continue;
+
+                SceNetEpollEvent &event = events[count++];
+                event = {};
+                event.events = sce_events(fds[i].revents);
+                event.data = entry->second.data;
+            }
+            if (count > 0) {
+                end_wait(generation);
+                return count;
+            }
+        }
+
+        if (timeout >= 0 && Clock::now() >= deadline) {
+            end_wait(generation);
+            return 0;
+        }
+    }
+}
+#endif
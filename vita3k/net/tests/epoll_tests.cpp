@@ -0,0 +1,217 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <net/epoll.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Connected loopback TCP pair, both ends wrapped the same way sceNetSocket wraps host sockets
+struct SocketPair {
+    SocketPtr server;
+    SocketPtr client;
+
+    SocketPair() {
+#ifdef WIN32
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+        const abs_socket listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrlen = sizeof(addr);
+        ::bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        ::listen(listener, 1);
+        getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &addrlen);
+
+        const abs_socket connecting = socket(AF_INET, SOCK_STREAM, 0);
+        ::connect(connecting, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        const abs_socket accepted = ::accept(listener, nullptr, nullptr);
+        std::make_shared<PosixSocket>(listener)->close();
+
+        server = std::make_shared<PosixSocket>(accepted);
+        client = std::make_shared<PosixSocket>(connecting);
+    }
+
+    ~SocketPair() {
+        server->close();
+        client->close();
+    }
+
+    void send_byte() {
+        const char byte = 1;
+        client->send_packet(&byte, 1, 0, nullptr, 0);
+    }
+};
+
+SceNetEpollEvent make_event(unsigned int events, int fd) {
+    SceNetEpollEvent event = {};
+    event.events = events;
+    event.data.fd = fd;
+    return event;
+}
+
+} // namespace
+
+TEST(epoll, reports_readable_socket) {
+    NetEpoll epoll;
+    ASSERT_TRUE(epoll.valid());
+    SocketPair pair;
+    ASSERT_EQ(epoll.add(1, pair.server, make_event(SCE_NET_EPOLLIN, 1)), 0);
+
+    SceNetEpollEvent events[4] = {};
+    EXPECT_EQ(epoll.wait(events, 4, 0), 0);
+
+    pair.send_byte();
+    ASSERT_EQ(epoll.wait(events, 4, 1000000), 1);
+    EXPECT_EQ(events[0].events, SCE_NET_EPOLLIN);
+    EXPECT_EQ(events[0].data.fd, 1);
+}
+
+TEST(epoll, control_errors) {
+    NetEpoll epoll;
+    SocketPair pair;
+    const auto event = make_event(SCE_NET_EPOLLIN, 1);
+    ASSERT_EQ(epoll.add(1, pair.server, event), 0);
+    EXPECT_EQ(epoll.add(1, pair.server, event), SCE_NET_ERROR_EEXIST);
+    EXPECT_EQ(epoll.modify(2, event), SCE_NET_ERROR_ENOENT);
+    EXPECT_EQ(epoll.remove(2), SCE_NET_ERROR_ENOENT);
+
+    SceNetEpollEvent events[1];
+    EXPECT_EQ(epoll.wait(nullptr, 1, 0), SCE_NET_ERROR_EINVAL);
+    EXPECT_EQ(epoll.wait(events, 0, 0), SCE_NET_ERROR_EINVAL);
+}
+
+TEST(epoll, modify_and_remove) {
+    NetEpoll epoll;
+    SocketPair pair;
+    ASSERT_EQ(epoll.add(1, pair.server, make_event(SCE_NET_EPOLLIN, 1)), 0);
+
+    // A fresh connection has room to send right away
+    SceNetEpollEvent events[4] = {};
+    ASSERT_EQ(epoll.modify(1, make_event(SCE_NET_EPOLLOUT, 7)), 0);
+    ASSERT_EQ(epoll.wait(events, 4, 0), 1);
+    EXPECT_EQ(events[0].events, SCE_NET_EPOLLOUT);
+    EXPECT_EQ(events[0].data.fd, 7);
+
+    ASSERT_EQ(epoll.remove(1), 0);
+    EXPECT_EQ(epoll.wait(events, 4, 0), 0);
+}
+
+TEST(epoll, maxevents_caps_the_result) {
+    NetEpoll epoll;
+    SocketPair first, second, third;
+    ASSERT_EQ(epoll.add(1, first.server, make_event(SCE_NET_EPOLLOUT, 1)), 0);
+    ASSERT_EQ(epoll.add(2, second.server, make_event(SCE_NET_EPOLLOUT, 2)), 0);
+    ASSERT_EQ(epoll.add(3, third.server, make_event(SCE_NET_EPOLLOUT, 3)), 0);
+
+    SceNetEpollEvent events[2] = {};
+    EXPECT_EQ(epoll.wait(events, 2, 0), 2);
+}
+
+TEST(epoll, peer_close_is_a_hang_up) {
+    NetEpoll epoll;
+    SocketPair pair;
+    ASSERT_EQ(epoll.add(1, pair.server, make_event(SCE_NET_EPOLLIN, 1)), 0);
+    pair.client->close();
+    pair.client = std::make_shared<PosixSocket>(static_cast<abs_socket>(-1));
+
+    SceNetEpollEvent events[1] = {};
+    ASSERT_EQ(epoll.wait(events, 1, 1000000), 1);
+    EXPECT_TRUE(events[0].events & SCE_NET_EPOLLIN);
+    EXPECT_TRUE(events[0].events & SCE_NET_EPOLLHUP);
+}
+
+TEST(epoll, abort_wakes_up_waiters) {
+    NetEpoll epoll;
+    SocketPair pair;
+    ASSERT_EQ(epoll.add(1, pair.server, make_event(SCE_NET_EPOLLIN, 1)), 0);
+
+    int result = 0;
+    std::atomic<bool> returned = false;
+    std::thread waiter([&]() {
+        SceNetEpollEvent events[1];
+        result = epoll.wait(events, 1, -1);
+        returned = true;
+    });
+    // An abort only reaches threads that are blocked already, so keep aborting until the waiter got one
+    while (!returned) {
+        epoll.abort(0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    waiter.join();
+    EXPECT_EQ(result, SCE_NET_ERROR_EINTR);
+
+    // Only the waits that were blocked are aborted, later ones block and see events again
+    SceNetEpollEvent events[1];
+    EXPECT_EQ(epoll.wait(events, 1, 20000), 0);
+    pair.send_byte();
+    EXPECT_EQ(epoll.wait(events, 1, 1000000), 1);
+}
+
+TEST(epoll, preserved_abort_fails_later_waits) {
+    NetEpoll epoll;
+    SocketPair pair;
+    ASSERT_EQ(epoll.add(1, pair.server, make_event(SCE_NET_EPOLLOUT, 1)), 0);
+
+    epoll.abort(SCE_NET_EPOLL_ABORT_FLAG_PRESERVATION);
+    SceNetEpollEvent events[1];
+    EXPECT_EQ(epoll.wait(events, 1, 0), SCE_NET_ERROR_EINTR);
+    EXPECT_EQ(epoll.wait(events, 1, -1), SCE_NET_ERROR_EINTR);
+}
+
+// Time between data arriving and a blocked waiter returning, the old implementation slept out the whole timeout
+TEST(epoll, wake_up_latency) {
+    NetEpoll epoll;
+    SocketPair pair;
+    ASSERT_EQ(epoll.add(1, pair.server, make_event(SCE_NET_EPOLLIN, 1)), 0);
+
+    constexpr int ROUNDS = 100;
+    Clock::duration worst{};
+    char byte;
+    for (int i = 0; i < ROUNDS; i++) {
+        Clock::time_point sent;
+        std::thread sender([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            sent = Clock::now();
+            pair.send_byte();
+        });
+
+        SceNetEpollEvent events[1];
+        const int count = epoll.wait(events, 1, 1000000);
+        const auto received = Clock::now();
+        // The sender wrote sent before it sent the byte, joining makes that write visible here
+        sender.join();
+        ASSERT_EQ(count, 1);
+        pair.server->recv_packet(&byte, 1, 0, nullptr, nullptr);
+
+        worst = std::max(worst, received - sent);
+    }
+
+    const auto us = [](Clock::duration d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+    // Far below the 1 second timeout, without depending on how loaded the machine is
+    EXPECT_LT(us(worst), 500000);
+}
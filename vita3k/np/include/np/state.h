@@ -49,6 +49,7 @@ struct NpTrophyState {
     std::mutex access_mutex;
 
     std::vector<np::trophy::Context> contexts;
+    np::trophy::ProgressWriter progress_writer;
     NpTrophyUnlockCallback trophy_unlock_callback;
 };
 
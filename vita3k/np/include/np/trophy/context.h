@@ -18,11 +18,14 @@
 #pragma once
 
 #include <np/common.h>
+#include <np/trophy/progress_writer.h>
 #include <np/trophy/trp_parser.h>
+#include <util/fs.h>
 #include <util/types.h>
 
 #include <array>
 #include <cstdint>
+#include <string>
 
 struct IOState;
 
@@ -46,6 +49,11 @@ enum class SceNpTrophyGrade : SceInt32 {
     SCE_NP_TROPHY_GRADE_BRONZE = 4
 };
 
+struct TrophyDetail {
+    std::string name;
+    std::string detail;
+};
+
 struct Context {
     bool valid{ true };
     TRPFile trophy_file;
@@ -67,7 +75,12 @@ struct Context {
     std::int32_t platinum_trophy_id{ -1 };
 
     std::string trophy_progress_output_file_path;
-    std::string trophy_detail_xml;
+    fs::path trophy_progress_output_host_path;
+    ProgressWriter *progress_writer = nullptr;
+
+    // Parsed once from TROP_XX.SFM when the context is created, indexed by trophy id
+    std::array<TrophyDetail, MAX_TROPHIES> trophy_details;
+    TrophyDetail trophy_set;
 
     std::uint32_t lang{ 1 };
 
@@ -80,6 +93,7 @@ struct Context {
     int copy_file_data_from_trophy_file(const char *filename, void *buffer, SceSize *size);
     int install_trophy_conf(IOState *io, const std::wstring &pref_path, const std::string np_com_id);
     bool init_info_from_trp();
+    bool load_trophy_details();
     bool unlock_trophy(std::int32_t id, np::NpTrophyError *err, const bool force_unlock = false);
 
     const bool is_trophy_hidden(const uint32_t &trophy_index);
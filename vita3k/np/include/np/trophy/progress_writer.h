@@ -0,0 +1,58 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <util/fs.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace np::trophy {
+
+// Writes trophy progress files on a background thread, so unlocking a trophy never waits on the disk.
+// Saves queued while a write is in flight are coalesced: only the latest contents of a file are written.
+class ProgressWriter {
+public:
+    ProgressWriter() = default;
+    ~ProgressWriter();
+
+    ProgressWriter(const ProgressWriter &) = delete;
+    ProgressWriter &operator=(const ProgressWriter &) = delete;
+
+    void queue(const fs::path &path, std::vector<std::uint8_t> data);
+
+    // Block until everything queued so far is on disk
+    void flush();
+
+private:
+    void worker_loop();
+
+    std::mutex mutex;
+    std::condition_variable work_cond;
+    std::condition_variable idle_cond;
+    std::map<fs::path, std::vector<std::uint8_t>> pending;
+    bool writing = false;
+    bool stopping = false;
+    std::thread worker;
+};
+
+} // namespace np::trophy
@@ -41,6 +41,7 @@ bool init(NpTrophyState &state) {
 }
 
 bool deinit(NpTrophyState &state) {
+    state.progress_writer.flush();
     state.inited = false;
     return true;
 }
@@ -163,11 +163,10 @@ bool Context::init_info_from_trp() {
 static constexpr std::uint32_t TROPHY_USR_MAGIC = 0x12D5819A;
 
 void Context::save_trophy_progress_file() {
-    // Open the file
-    const SceUID output = open_file(*io, trophy_progress_output_file_path.c_str(), SCE_O_WRONLY | SCE_O_CREAT, pref_path, "save_trophy_progress");
-
-    auto write_stuff = [&](const void *data, std::uint32_t amount) -> int {
-        return write_file(output, data, amount, *io, "save_trophy_progress_file");
+    std::vector<std::uint8_t> data;
+    auto write_stuff = [&](const void *source, std::uint32_t amount) {
+        const auto bytes = static_cast<const std::uint8_t *>(source);
+        data.insert(data.end(), bytes, bytes + amount);
     };
 
     write_stuff(&TROPHY_USR_MAGIC, 4);
@@ -181,6 +180,13 @@ void Context::save_trophy_progress_file() {
     write_stuff(unlock_timestamps.data(), (std::uint32_t)unlock_timestamps.size() * 8);
     write_stuff(trophy_kinds.data(), (std::uint32_t)trophy_kinds.size() * 4);
 
+    if (progress_writer) {
+        progress_writer->queue(trophy_progress_output_host_path, std::move(data));
+        return;
+    }
+
+    const SceUID output = open_file(*io, trophy_progress_output_file_path.c_str(), SCE_O_WRONLY | SCE_O_CREAT, pref_path, "save_trophy_progress");
+    write_file(output, data.data(), static_cast<SceSize>(data.size()), *io, "save_trophy_progress_file");
     close_file(*io, output, "save_trophy_progress_file");
 }
 
@@ -294,64 +300,55 @@ const int Context::total_trophy_unlocked() {
     return total;
 }
 
-bool Context::get_trophy_details(const int32_t id, std::string &name, std::string &detail) {
-    if (id < 0 || id >= MAX_TROPHIES) {
-        return false;
-    }
-
-    if (trophy_detail_xml.empty()) {
-        const std::string fname = fmt::format("TROP_{:0>2d}.SFM", lang);
+bool Context::load_trophy_details() {
+    std::string detail_xml;
+    const std::string fname = fmt::format("TROP_{:0>2d}.SFM", lang);
 
-        if (!read_trophy_entry_to_buffer(trophy_file, fname.c_str(), trophy_detail_xml)) {
-            if (!read_trophy_entry_to_buffer(trophy_file, "TROP.SFM", trophy_detail_xml)) {
-                return false;
-            }
+    if (!read_trophy_entry_to_buffer(trophy_file, fname.c_str(), detail_xml)) {
+        if (!read_trophy_entry_to_buffer(trophy_file, "TROP.SFM", detail_xml)) {
+            return false;
         }
     }
 
-    // Parse it
     pugi::xml_document doc;
-    const auto result = doc.load_string(trophy_detail_xml.c_str());
+    const auto result = doc.load_string(detail_xml.c_str());
 
     if (!result) {
         return false;
     }
 
-    // Try to find the description for the id
-    for (const auto &trop : doc.child("trophyconf")) {
-        if ((trop.name() == std::string("trophy")) && (trop.attribute("id").as_uint() == id)) {
-            name = trop.child("name").text().as_string();
-            detail = trop.child("detail").text().as_string();
+    std::fill(trophy_details.begin(), trophy_details.end(), TrophyDetail{});
 
-            break;
-        }
-    }
-
-    return !name.empty() && !detail.empty();
-}
+    const auto trophy_conf = doc.child("trophyconf");
+    trophy_set.name = trophy_conf.child("title-name").text().as_string();
+    trophy_set.detail = trophy_conf.child("title-detail").text().as_string();
 
-bool Context::get_trophy_set(std::string &name, std::string &detail) {
-    if (trophy_detail_xml.empty()) {
-        const std::string fname = fmt::format("TROP_{:0>2d}.SFM", lang);
+    for (const auto &trop : trophy_conf.children("trophy")) {
+        const std::uint32_t id = trop.attribute("id").as_uint();
+        if (id >= MAX_TROPHIES)
+            continue;
 
-        if (!read_trophy_entry_to_buffer(trophy_file, fname.c_str(), trophy_detail_xml)) {
-            if (!read_trophy_entry_to_buffer(trophy_file, "TROP.SFM", trophy_detail_xml)) {
-                return false;
-            }
-        }
+        trophy_details[id].name = trop.child("name").text().as_string();
+        trophy_details[id].detail = trop.child("detail").text().as_string();
     }
 
-    // Parse it
-    pugi::xml_document doc;
-    const auto result = doc.load_string(trophy_detail_xml.c_str());
+    return true;
+}
 
-    if (!result) {
+bool Context::get_trophy_details(const int32_t id, std::string &name, std::string &detail) {
+    if (id < 0 || id >= MAX_TROPHIES) {
         return false;
     }
 
-    const auto trophy_conf = doc.child("trophyconf");
-    name = trophy_conf.child("title-name").text().as_string();
-    detail = trophy_conf.child("title-detail").text().as_string();
+    name = trophy_details[id].name;
+    detail = trophy_details[id].detail;
+
+    return !name.empty() && !detail.empty();
+}
+
+bool Context::get_trophy_set(std::string &name, std::string &detail) {
+    name = trophy_set.name;
+    detail = trophy_set.detail;
 
     return !name.empty() && !detail.empty();
 }
@@ -419,6 +416,8 @@ np::trophy::ContextHandle create_trophy_context(NpState &np, IOState *io, const
 
     create_dir(*io, trophy_progress_save_file.c_str(), 0, pref_path, "create_trophy_context", true);
     trophy_progress_save_file += "TROPUSR.DAT";
+    const fs::path trophy_progress_host_path = device::construct_emulated_path(VitaIoDevice::ux0,
+        "user/" + io->user_id + "/trophy/data/" + unique_trophy_folder + "TROPUSR.DAT", pref_path);
     const SceUID trophy_progress_file_inp = open_file(*io, trophy_progress_save_file.c_str(), SCE_O_RDONLY, pref_path, "create_trophy_context");
 
     np::trophy::Context *new_context = nullptr;
@@ -430,9 +429,11 @@ np::trophy::ContextHandle create_trophy_context(NpState &np, IOState *io, const
             context.comm_id = *custom_comm;
             context.trophy_file_stream = trophy_file;
             context.trophy_progress_output_file_path = trophy_progress_save_file;
+            context.pref_path = pref_path;
             context.valid = true;
 
             new_context = &context;
+            break;
         }
     }
 
@@ -446,7 +447,10 @@ np::trophy::ContextHandle create_trophy_context(NpState &np, IOState *io, const
     }
 
     new_context->lang = lang;
+    new_context->trophy_progress_output_host_path = trophy_progress_host_path;
+    new_context->progress_writer = &np.trophy_state.progress_writer;
     new_context->trophy_file.header_parse();
+    new_context->load_trophy_details();
 
     new_context->install_trophy_conf(io, pref_path, unique_trophy_folder);
 
@@ -479,6 +483,7 @@ bool destroy_trophy_context(NpTrophyState &state, const np::trophy::ContextHandl
         return false;
     }
 
+    state.progress_writer.flush();
     close_file(*state.contexts[handle - 1].io, state.contexts[handle - 1].trophy_file_stream, "destroy_trophy_context");
     state.contexts[handle - 1].valid = false;
 
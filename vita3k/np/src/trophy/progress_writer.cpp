@@ -0,0 +1,88 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <np/trophy/progress_writer.h>
+
+#include <util/log.h>
+
+#include <fstream>
+
+namespace np::trophy {
+
+ProgressWriter::~ProgressWriter() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_cond.notify_one();
+    if (worker.joinable())
+        worker.join();
+}
+
+void ProgressWriter::queue(const fs::path &path, std::vector<std::uint8_t> data) {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        pending[path] = std::move(data);
+        if (!worker.joinable())
+            worker = std::thread([this]() { worker_loop(); });
+    }
+    work_cond.notify_one();
+}
+
+void ProgressWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle_cond.wait(lock, [&]() { return pending.empty() && !writing; });
+}
+
+static void write_progress_file(const fs::path &path, const std::vector<std::uint8_t> &data) {
+    // Write next to the file and rename over it, so a crash mid-write keeps the previous progress
+    const fs::path temp_path = fs::path(path).concat(".tmp");
+    {
+        std::ofstream file(temp_path.string(), std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), data.size());
+        if (!file) {
+            LOG_ERROR("Failed to write trophy progress file {}", temp_path.string());
+            return;
+        }
+    }
+
+    boost::system::error_code error;
+    fs::rename(temp_path, path, error);
+    if (error)
+        LOG_ERROR("Failed to replace trophy progress file {}: {}", path.string(), error.message());
+}
+
+void ProgressWriter::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_cond.wait(lock, [&]() { return stopping || !pending.empty(); });
+        if (pending.empty())
+            return;
+
+        auto node = pending.extract(pending.begin());
+        writing = true;
+        lock.unlock();
+        write_progress_file(node.key(), node.mapped());
+        lock.lock();
+        writing = false;
+
+        if (pending.empty())
+            idle_cond.notify_all();
+    }
+}
+
+} // namespace np::trophy
@@ -0,0 +1,134 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <gxm/types.h>
+#include <mem/ptr.h>
+#include <renderer/commands.h>
+#include <util/fs.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+struct Config;
+struct DisplayState;
+struct MemState;
+
+namespace renderer {
+struct FragmentProgram;
+struct RenderTarget;
+struct State;
+
+namespace capture {
+
+constexpr std::uint32_t CAPTURE_MAGIC = 0x50414347; // GCAP
+constexpr std::uint32_t CAPTURE_VERSION = 1;
+
+enum class RecordType : std::uint8_t {
+    Memory = 0, ///< Guest memory contents: address, size, bytes
+    Reserve = 1, ///< Guest memory that has to exist but whose contents do not matter: address, size
+    RenderTarget = 2, ///< Render target id, SceGxmRenderTargetParams
+    VertexProgram = 3, ///< SceGxmVertexProgram address, program address, streams, attributes
+    FragmentProgram = 4, ///< SceGxmFragmentProgram address, program address, mask update flag, blend info
+    CommandList = 5, ///< Context id, command count, commands
+    EndFrame = 6 ///< Display base, pitch, width, height
+};
+
+/**
+ * \brief Records the command lists consumed by the renderer, with the guest memory and objects they reference.
+ *
+ * Everything is written from the renderer thread before the commands run, except blend infos which are given
+ * when a fragment program is created on a guest thread. Host pointers are stored as ids, guest memory is only
+ * written again when its contents changed since the last time it was captured.
+ */
+class CaptureWriter {
+public:
+    CaptureWriter(const fs::path &path, std::uint32_t frame_count);
+
+    bool recording() const;
+
+    void record_command_list(State &state, const MemState &mem, const CommandList &command_list);
+    void record_render_target(const RenderTarget *render_target, const SceGxmRenderTargetParams &params);
+    void record_blend(const FragmentProgram *program, const SceGxmBlendInfo *blend);
+    void end_frame(const DisplayState &display);
+
+private:
+    void record_dependencies(State &state, const MemState &mem, Command &cmd);
+    void record_memory(State &state, const MemState &mem, Address address, std::uint32_t size);
+    void record_reserve(Address address, std::uint32_t size);
+    void record_program(State &state, const MemState &mem, Ptr<const void> program, bool is_fragment);
+    std::uint64_t program_hash(State &state, const MemState &mem, Address gxp_address);
+    void record_texture(State &state, const MemState &mem, const SceGxmTexture &texture);
+    void write_command(const MemState &mem, Command &cmd);
+    void finish();
+
+    template <typename T>
+    void write(const T &value) {
+        file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void write_bytes(const void *data, std::size_t size) {
+        file.write(reinterpret_cast<const char *>(data), size);
+    }
+
+    std::ofstream file;
+    fs::path path;
+    std::atomic<bool> active{ false };
+    std::uint32_t frames_left = 0;
+    std::uint32_t frames_written = 0;
+    bool frame_has_lists = false;
+
+    std::map<std::pair<Address, std::uint32_t>, std::uint64_t> memory_hashes;
+    std::set<std::pair<Address, std::uint32_t>> reserved;
+    std::map<Address, std::uint64_t> programs;
+
+    std::mutex blend_mutex;
+    std::map<const FragmentProgram *, SceGxmBlendInfo> blends;
+};
+
+struct ReplayStats {
+    std::uint32_t command_lists = 0;
+    std::uint64_t commands = 0;
+    std::vector<std::chrono::nanoseconds> frame_times;
+};
+
+/**
+ * \brief Capture loaded in memory, that can be fed through process_batch any number of times.
+ */
+class Capture {
+public:
+    bool load(const fs::path &path);
+
+    // Replays every frame once, as fast as the backend allows. The guest memory referenced by the capture is
+    // allocated in mem when missing.
+    bool replay(State &state, MemState &mem, Config &config, ReplayStats &stats) const;
+
+private:
+    std::vector<std::uint8_t> data;
+};
+
+} // namespace capture
+} // namespace renderer
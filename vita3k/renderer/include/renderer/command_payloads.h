@@ -0,0 +1,210 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <gxm/types.h>
+#include <mem/ptr.h>
+#include <renderer/commands.h>
+#include <renderer/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace renderer {
+struct Context;
+struct RenderTarget;
+
+/**
+ * \brief Payload layouts of the commands, stored at the start of Command::data.
+ *
+ * Producers fill one struct and handlers pop the same struct, so both sides agree on the layout by construction.
+ * Structs are packed: the data buffer only has room for them without padding, and some producers hand out a pointer
+ * to a field that is filled after the command was added (see set_vertex_stream).
+ */
+namespace payload {
+#pragma pack(push, 1)
+
+struct CreateContext {
+    std::unique_ptr<Context> *context;
+};
+
+struct CreateRenderTarget {
+    std::unique_ptr<RenderTarget> *render_target;
+    const SceGxmRenderTargetParams *params;
+};
+
+struct DestroyRenderTarget {
+    std::unique_ptr<RenderTarget> *render_target;
+};
+
+struct Draw {
+    SceGxmPrimitiveType type;
+    SceGxmIndexFormat format;
+    void *indices; ///< Owned by the command, freed by the backend
+    std::uint32_t count;
+    std::uint32_t instance_count;
+};
+
+struct Nop {
+    int code_to_finish;
+};
+
+struct SetContext {
+    const RenderTarget *render_target;
+    SceGxmColorSurface *color_surface; ///< Owned by the command
+    SceGxmDepthStencilSurface *depth_stencil_surface; ///< Owned by the command
+};
+
+struct SignalSyncObject {
+    Ptr<SceGxmSyncObject> sync;
+};
+
+struct SignalNotification {
+    Ptr<SceGxmNotification> notification;
+    bool is_vertex;
+};
+
+// SetState commands start with the GXMState, followed by one of these
+struct SetState {
+    GXMState state;
+};
+
+struct RegionClip {
+    SceGxmRegionClipMode mode;
+    std::uint32_t x_min;
+    std::uint32_t x_max;
+    std::uint32_t y_min;
+    std::uint32_t y_max;
+};
+
+struct Program {
+    Ptr<const void> program;
+    bool is_fragment;
+};
+
+struct Viewport {
+    bool flat;
+    // Only set when the viewport is not flat
+    float x_offset;
+    float y_offset;
+    float z_offset;
+    float x_scale;
+    float y_scale;
+    float z_scale;
+};
+
+struct DepthBias {
+    bool is_front;
+    int factor;
+    int units;
+};
+
+struct DepthFunc {
+    bool is_front;
+    SceGxmDepthFunc func;
+};
+
+struct DepthWriteEnable {
+    bool is_front;
+    SceGxmDepthWriteMode mode;
+};
+
+struct PolygonMode {
+    bool is_front;
+    SceGxmPolygonMode mode;
+};
+
+struct PointLineWidth {
+    bool is_front;
+    std::uint32_t width;
+};
+
+struct StencilFunc {
+    bool is_front;
+    SceGxmStencilFunc func;
+    SceGxmStencilOp stencil_fail;
+    SceGxmStencilOp depth_fail;
+    SceGxmStencilOp depth_pass;
+    std::uint8_t compare_mask;
+    std::uint8_t write_mask;
+};
+
+struct Texture {
+    std::uint32_t index;
+    SceGxmTexture texture;
+};
+
+struct StencilRef {
+    bool is_front;
+    std::uint8_t ref;
+};
+
+struct VertexStream {
+    std::uint8_t *data; ///< Filled by the client after the command is added, owned by the command
+    std::size_t index;
+    std::size_t size;
+};
+
+struct TwoSided {
+    SceGxmTwoSidedMode mode;
+};
+
+struct CullMode {
+    SceGxmCullMode mode;
+};
+
+struct Uniform {
+    bool is_vertex;
+    const SceGxmProgramParameter *parameter;
+    const void *data;
+};
+
+struct UniformBuffer {
+    std::uint8_t *data; ///< Filled by the client after the command is added, owned by the command
+    bool is_vertex;
+    int block_num;
+    std::uint32_t size;
+};
+
+struct FragmentProgramEnable {
+    bool is_front;
+    SceGxmFragmentProgramMode mode;
+};
+
+#pragma pack(pop)
+
+// Set state payloads come after the state
+template <typename T>
+constexpr bool fits_set_state = sizeof(SetState) + sizeof(T) <= MAX_COMMAND_DATA_SIZE;
+
+static_assert(sizeof(Draw) <= MAX_COMMAND_DATA_SIZE);
+static_assert(sizeof(SetContext) <= MAX_COMMAND_DATA_SIZE);
+static_assert(sizeof(CreateRenderTarget) <= MAX_COMMAND_DATA_SIZE);
+static_assert(sizeof(SignalNotification) <= MAX_COMMAND_DATA_SIZE);
+static_assert(fits_set_state<Viewport>);
+static_assert(fits_set_state<StencilFunc>);
+static_assert(fits_set_state<Texture>);
+static_assert(fits_set_state<VertexStream>);
+static_assert(fits_set_state<Uniform>);
+static_assert(fits_set_state<UniformBuffer>);
+static_assert(std::is_trivially_copyable_v<Texture>);
+
+} // namespace payload
+} // namespace renderer
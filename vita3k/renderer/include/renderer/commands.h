@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <functional>
@@ -66,7 +67,9 @@ enum class CommandOpcode : std::uint8_t {
 
     SignalNotification = 10,
 
-    DestroyRenderTarget = 11
+    DestroyRenderTarget = 11,
+
+    TotalOpcode
 };
 
 enum CommandErrorCode {
@@ -77,6 +80,9 @@ enum CommandErrorCode {
 
 constexpr std::size_t MAX_COMMAND_DATA_SIZE = 0x20;
 
+// Submitting more command lists than this blocks the guest until the renderer catches up
+constexpr std::size_t MAX_PENDING_COMMAND_LISTS = 32;
+
 struct Command {
     enum {
         FLAG_FROM_HOST = 1 << 0,
@@ -87,7 +93,7 @@ struct Command {
     std::uint8_t flags = 0;
 
     std::uint8_t data[MAX_COMMAND_DATA_SIZE];
-    int *status;
+    std::atomic<int> *status;
 
     Command *next = nullptr;
 };
@@ -113,6 +119,8 @@ struct CommandHelper {
 
     template <typename T>
     bool push(T &val) {
+        static_assert(sizeof(T) <= MAX_COMMAND_DATA_SIZE, "Command payload too large.");
+
         if (point + sizeof(T) > MAX_COMMAND_DATA_SIZE) {
             return false;
         }
@@ -125,6 +133,8 @@ struct CommandHelper {
 
     template <typename T>
     T pop() {
+        static_assert(sizeof(T) <= MAX_COMMAND_DATA_SIZE, "Command payload too large.");
+
         if (point + sizeof(T) > MAX_COMMAND_DATA_SIZE) {
             // Shouldn't happen
             assert(false);
@@ -137,7 +147,7 @@ struct CommandHelper {
     }
 
     void complete(const int code) {
-        *cmd->status = code;
+        cmd->status->store(code, std::memory_order_release);
     }
 };
 
@@ -155,7 +165,7 @@ bool do_command_push_data(CommandHelper &helper, Head arg1, Args... args2) {
 }
 
 template <typename... Args>
-Command *make_command(CommandAllocFunc alloc_func, CommandFreeFunc free_func, const CommandOpcode opcode, int *status, Args... arguments) {
+Command *make_command(CommandAllocFunc alloc_func, CommandFreeFunc free_func, const CommandOpcode opcode, std::atomic<int> *status, Args... arguments) {
     Command *new_command = alloc_func();
 
     new_command->opcode = opcode;
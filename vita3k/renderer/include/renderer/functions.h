@@ -54,10 +54,10 @@ void subject_done(SceGxmSyncObject *sync_object, const SyncObjectSubject subject
  */
 void subject_in_progress(SceGxmSyncObject *sync_object, const SyncObjectSubject subjects);
 
-int wait_for_status(State &state, int *status, int signal, bool wake_on_equal);
+int wait_for_status(State &state, std::atomic<int> *status, int signal, bool wake_on_equal);
 void reset_command_list(CommandList &command_list);
 void submit_command_list(State &state, renderer::Context *context, CommandList &command_list);
-void process_batch(State &state, MemState &mem, Config &config, CommandList &command_list, const char *base_path, const char *title_id);
+void process_batch(State &state, const FeatureState &features, MemState &mem, Config &config, CommandList &command_list, const char *base_path, const char *title_id);
 void process_batches(State &state, const FeatureState &features, MemState &mem, Config &config, const char *base_path, const char *title_id);
 bool init(SDL_Window *window, std::unique_ptr<State> &state, Backend backend, const Config &config, const char *base_path);
 
@@ -91,7 +91,7 @@ Command *generic_command_allocate();
 void generic_command_free(Command *cmd);
 
 template <typename... Args>
-bool add_command(Context *ctx, const CommandOpcode opcode, int *status, Args... arguments) {
+bool add_command(Context *ctx, const CommandOpcode opcode, std::atomic<int> *status, Args... arguments) {
     auto cmd_maked = make_command(ctx ? ctx->alloc_func : generic_command_allocate, ctx ? ctx->free_func : generic_command_free,
         opcode, status, arguments...);
 
@@ -118,7 +118,7 @@ bool add_state_set_command(Context *ctx, const GXMState state, Args... arguments
 template <typename... Args>
 int send_single_command(State &state, Context *ctx, const CommandOpcode opcode, Args... arguments) {
     // Make a temporary command list
-    int status = CommandErrorCodePending; // Pending.
+    std::atomic<int> status = CommandErrorCodePending; // Pending.
     auto cmd = make_command(ctx ? ctx->alloc_func : generic_command_allocate, ctx ? ctx->free_func : generic_command_free,
         opcode, &status, arguments...);
 
@@ -166,10 +166,13 @@ void swizzled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint1
 void tiled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel);
 
 void cache_and_bind_texture(TextureCacheState &cache, const SceGxmTexture &gxm_texture, MemState &mem);
+void upload_finished_decodes(TextureCacheState &cache);
 size_t bits_per_pixel(SceGxmTextureBaseFormat base_format);
 bool is_compressed_format(SceGxmTextureBaseFormat base_format, std::uint32_t width, std::uint32_t height, size_t &source_size);
 TextureCacheHash hash_texture_data(const SceGxmTexture &texture, const MemState &mem);
 size_t texture_size(const SceGxmTexture &texture);
+// Upper bound of the memory used by every face and mip level, texture_size only covers the base level
+size_t texture_memory_size(const SceGxmTexture &texture);
 
 } // namespace texture
 
@@ -56,6 +56,12 @@ bool create(std::unique_ptr<VertexProgram> &vp, GLState &state, const SceGxmProg
 void sync_rendertarget(const GLRenderTarget &rt);
 void set_context(GLState &state, GLContext &ctx, const MemState &mem, const GLRenderTarget *rt, const FeatureState &features);
 void get_surface_data(GLState &renderer, GLContext &context, size_t width, size_t height, size_t stride_in_pixels, uint32_t *pixels, SceGxmColorFormat format);
+
+// Color surface readback.
+void get_color_read_format(SceGxmColorFormat format, GLenum &read_format, GLenum &read_type);
+size_t get_color_read_bytes_per_pixel(SceGxmColorFormat format);
+void pack_se5m9m9m9(const uint16_t *src, uint32_t *dst, size_t pixel_count);
+void tile_surface(uint8_t *pixels, size_t width, size_t height, size_t stride_in_pixels, SceGxmColorFormat format);
 void draw(GLState &renderer, GLContext &context, const FeatureState &features, SceGxmPrimitiveType type, SceGxmIndexFormat format,
     void *indices, size_t count, uint32_t instance_count, MemState &mem, const char *base_path, const char *title_id, const Config &config);
 
@@ -96,6 +102,8 @@ namespace texture {
 void bind_texture(GLTextureCacheState &cache, const SceGxmTexture &gxm_texture, const MemState &mem);
 void configure_bound_texture(const SceGxmTexture &gxm_texture);
 void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem);
+void decode_texture(const SceGxmTexture &gxm_texture, const MemState &mem, renderer::texture::DecodedTexture &decoded);
+void upload_decoded_texture(const renderer::texture::DecodedTexture &decoded);
 
 // Texture formats.
 const GLint *translate_swizzle(SceGxmTextureFormat fmt);
@@ -109,6 +117,8 @@ size_t bits_per_pixel(SceGxmTextureBaseFormat base_format);
 
 // Texture cache.
 bool init(GLTextureCacheState &cache, const bool hashless_texture_cache);
+void enable_async_decode(GLState &state, const bool wait_for_decode);
+void upload_finished_decodes(GLTextureCacheState &cache);
 void dump(const SceGxmTexture &gxm_texture, const MemState &mem, const std::string &name, const std::string &base_path, const std::string &title_id, Sha256Hash hash);
 
 } // namespace texture
@@ -19,6 +19,7 @@
 
 #include <renderer/gl/screen_render.h>
 #include <renderer/gl/surface_cache.h>
+#include <renderer/gl/surface_readback.h>
 #include <renderer/state.h>
 #include <renderer/texture_cache_state.h>
 #include <renderer/types.h>
@@ -42,6 +43,7 @@ struct GLState : public renderer::State {
 
     GLTextureCacheState texture_cache;
     GLSurfaceCache surface_cache;
+    SurfaceReadback surface_readback;
 
     std::vector<ShadersHash> shaders_cache_hashs;
     std::string shader_version = "v1";
@@ -51,6 +53,7 @@ struct GLState : public renderer::State {
     bool init(const char *base_path, const bool hashless_texture_cache) override;
     void render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &viewport_size, const DisplayState &display,
         const MemState &mem) override;
+    void resolve_memory(Address address, size_t size) override;
 };
 
 } // namespace renderer::gl
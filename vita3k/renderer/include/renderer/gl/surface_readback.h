@@ -0,0 +1,99 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <glutil/object_array.h>
+#include <gxm/types.h>
+#include <mem/util.h>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct MemState;
+
+namespace renderer::gl {
+
+// Copies color surfaces back to guest memory without stalling the renderer.
+// At the end of a scene the surface is read into a pixel buffer object, which the GPU fills on its own time,
+// and the guest memory behind it is access protected. A guest thread touching that memory only raises the
+// request's flag from the fault handler and waits there, with the memory still protected. The renderer thread then maps the
+// buffer, converts it and writes it to guest memory before lifting the protection, so surfaces nobody reads
+// cost a GPU copy and nothing else, and nobody sees one half written.
+class SurfaceReadback {
+public:
+    static constexpr size_t RING_SIZE = 8;
+
+    ~SurfaceReadback();
+
+    // Must be called from the renderer thread, with the GL context current
+    bool init();
+
+    // Queue a readback of the bound read framebuffer into the color surface at address
+    void request(MemState &mem, Address address, size_t width, size_t height, size_t stride_in_pixels, SceGxmColorFormat format, bool tiled);
+
+    // Write back the surfaces guest threads are waiting on. Called regularly by the renderer thread.
+    void poll();
+
+    // Write back the surfaces in a range before the renderer thread reads it, or hands it to GL or to a decode
+    // worker: nothing would serve a fault of the renderer thread itself
+    void resolve(Address address, size_t size);
+
+private:
+    struct Readback {
+        Address address = 0;
+        size_t size = 0;
+        size_t width = 0;
+        size_t height = 0;
+        size_t stride_in_pixels = 0;
+        SceGxmColorFormat format = SCE_GXM_COLOR_FORMAT_U8U8U8U8_ABGR;
+        bool tiled = false;
+
+        size_t slot = 0;
+        size_t read_size = 0;
+        GLsync fence = nullptr;
+
+        // Filled by stage(), after which the pixel buffer can be reused
+        std::vector<uint8_t> data;
+        bool staged = false;
+        // Raised from the fault handler when a guest thread waits on the surface. Readbacks replacing each other
+        // under the same protection share it.
+        AccessProtectRequestPtr request;
+        // Written back, or replaced by a newer readback of the same surface
+        bool done = false;
+    };
+    using ReadbackPtr = std::shared_ptr<Readback>;
+
+    void stage(Readback &readback);
+    void write_back(std::vector<ReadbackPtr> readbacks);
+
+    GLObjectArray<RING_SIZE> buffers;
+    std::array<size_t, RING_SIZE> buffer_sizes{};
+    std::array<ReadbackPtr, RING_SIZE> slots;
+    size_t next_slot = 0;
+
+    // Only touched by the renderer thread, the fault handler only goes through the requests
+    std::map<Address, ReadbackPtr> pending;
+    MemState *mem = nullptr;
+    std::thread::id renderer_thread;
+};
+
+} // namespace renderer::gl
@@ -0,0 +1,47 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <gxm/types.h>
+
+#include <renderer/null/state.h>
+#include <renderer/null/types.h>
+
+#include <chrono>
+#include <memory>
+
+struct MemState;
+struct FeatureState;
+
+namespace renderer::null {
+
+bool create(std::unique_ptr<renderer::State> &state, const char *base_path, const bool hashless_texture_cache);
+bool create(std::unique_ptr<Context> &context);
+bool create(std::unique_ptr<RenderTarget> &rt, const SceGxmRenderTargetParams &params);
+bool create(std::unique_ptr<FragmentProgram> &fp, NullState &state, const SceGxmProgram &program, GXPPtrMap &gxp_ptr_map);
+bool create(std::unique_ptr<VertexProgram> &vp, NullState &state, const SceGxmProgram &program, GXPPtrMap &gxp_ptr_map);
+
+void sync_texture(NullState &state, MemState &mem, const SceGxmTexture &texture);
+void draw(NullState &state, NullContext &context, const FeatureState &features, SceGxmPrimitiveType type, SceGxmIndexFormat format,
+    void *indices, size_t count, uint32_t instance_count, const MemState &mem);
+
+// Called by process_batch once a command list has been consumed
+void account_batch(NullState &state, std::uint32_t command_count, std::chrono::nanoseconds cpu_time);
+
+} // namespace renderer::null
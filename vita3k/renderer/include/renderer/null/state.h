@@ -0,0 +1,53 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <renderer/state.h>
+#include <renderer/texture_cache_state.h>
+#include <renderer/types.h>
+
+#include <renderer/null/types.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace renderer::null {
+/**
+ * \brief Renderer backend that never touches a graphics API.
+ *
+ * Command lists are consumed and validated, textures go through the texture cache and are decoded on the CPU, and
+ * shaders are translated to GLSL, so that everything the other backends do on the CPU is accounted for. Nothing is
+ * presented: render_frame only closes the frame statistics.
+ */
+struct NullState : public renderer::State {
+    TextureCacheState texture_cache;
+    std::vector<std::uint8_t> texture_scratch;
+    std::set<std::string> translated_shaders;
+
+    NullFrameStats current_frame;
+    NullFrameStats last_frame;
+    NullFrameStats total;
+    std::uint64_t frame_count = 0;
+
+    bool init(const char *base_path, const bool hashless_texture_cache) override;
+    void render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &viewport_size, const DisplayState &display,
+        const MemState &mem) override;
+};
+} // namespace renderer::null
@@ -0,0 +1,56 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <renderer/types.h>
+
+#include <chrono>
+#include <cstdint>
+
+namespace renderer::null {
+
+struct NullContext : public renderer::Context {
+};
+
+struct NullRenderTarget : public renderer::RenderTarget {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+};
+
+struct NullFragmentProgram : public renderer::FragmentProgram {
+};
+
+struct NullVertexProgram : public renderer::VertexProgram {
+};
+
+// CPU side work done by the null backend, accumulated between two render_frame calls
+struct NullFrameStats {
+    std::uint64_t batches = 0;
+    std::uint64_t commands = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t invalid_draws = 0;
+    std::uint64_t texture_uploads = 0;
+    std::uint64_t texture_bytes = 0;
+    std::uint64_t shaders_translated = 0;
+    std::chrono::nanoseconds cpu_time{};
+
+    NullFrameStats &operator+=(const NullFrameStats &rhs);
+};
+
+} // namespace renderer::null
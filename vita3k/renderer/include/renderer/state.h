@@ -18,11 +18,14 @@
 #pragma once
 
 #include <features/state.h>
+#include <renderer/capture.h>
 #include <renderer/commands.h>
 #include <renderer/types.h>
-#include <threads/queue.h>
+#include <threads/ring_queue.h>
+#include <threads/wait_table.h>
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 
 struct SDL_Cursor;
@@ -34,9 +37,12 @@ struct State {
     FeatureState features;
 
     GXPPtrMap gxp_ptr_map;
-    Queue<CommandList> command_buffer_queue;
-    std::condition_variable command_finish_one;
-    std::mutex command_finish_one_mutex;
+    RingQueue<CommandList> command_buffer_queue{ MAX_PENDING_COMMAND_LISTS };
+    WaitTable status_waiters;
+    WaitTable notification_waiters;
+
+    // Set while GXM commands are being captured to a file
+    std::unique_ptr<capture::CaptureWriter> capture;
 
     int last_scene_id = 0;
 
@@ -50,6 +56,8 @@ struct State {
     virtual void render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &viewport_size, const DisplayState &display,
         const MemState &mem)
         = 0;
+    // Writes back what the backend still holds of this guest memory, before the renderer thread reads it
+    virtual void resolve_memory(Address address, size_t size) {}
 
     virtual ~State() = default;
 };
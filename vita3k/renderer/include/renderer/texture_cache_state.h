@@ -20,10 +20,12 @@
 #include <glutil/object_array.h>
 
 #include <gxm/types.h>
+#include <renderer/texture_decoder.h>
 
 #include <array>
 #include <cstdint>
 #include <functional>
+#include <memory>
 
 struct MemState;
 
@@ -49,6 +51,8 @@ typedef std::array<TextureCacheInfo, TextureCacheSize> TextureCacheInfoes;
 typedef std::function<void(std::size_t, const void *)> TextureCacheStateSelectCallback;
 typedef std::function<void(std::size_t, const void *)> TextureCacheStateConfigureTextureCallback;
 typedef std::function<void(std::size_t, const void *, const MemState &)> TextureCacheStateUploadTextureCallback;
+typedef std::function<void(std::size_t, const texture::DecodedTexture &)> TextureCacheStateUploadDecodedCallback;
+typedef std::function<void(Address, size_t)> TextureCacheStateResolveCallback;
 
 struct TextureCacheState {
     bool use_protect = false;
@@ -58,5 +62,13 @@ struct TextureCacheState {
     TextureCacheStateSelectCallback select_callback;
     TextureCacheStateConfigureTextureCallback configure_texture_callback;
     TextureCacheStateUploadTextureCallback upload_texture_callback;
+    // Makes guest memory the backend still has to write back readable, before the cache reads a texture from it
+    TextureCacheStateResolveCallback resolve_callback;
+
+    // Set when textures are decoded on worker threads, the upload callback is then replaced by the decoded one
+    std::unique_ptr<texture::TextureDecoder> decoder;
+    TextureCacheStateUploadDecodedCallback upload_decoded_callback;
+    // Draws wait for a pending decode, instead of sampling what the texture held before
+    bool wait_for_decode = false;
 };
 } // namespace renderer
@@ -0,0 +1,149 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <gxm/types.h>
+#include <threads/thread_pool.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct MemState;
+
+namespace renderer::texture {
+/**
+ * \brief One face and mip level of a decoded texture, ready to be handed to the graphics API.
+ */
+struct TextureUploadLevel {
+    std::uint32_t face = 0;
+    std::uint32_t mip = 0;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t row_length = 0; // In pixels
+    bool compressed = false;
+    std::size_t size = 0; // Size of the compressed data, unused for everything else
+    std::size_t offset = 0; // Offset of the pixels in the staging buffer
+};
+
+/**
+ * \brief CPU side result of a texture decode: palette expansion, YUV conversion, decompression and un-swizzle are done,
+ * only the upload is left.
+ *
+ * Instances come from a StagingPool and keep their buffers' capacity between uses.
+ */
+struct DecodedTexture {
+    SceGxmTexture texture;
+    std::vector<TextureUploadLevel> levels;
+    std::vector<std::uint8_t> staging;
+    // Intermediate results, when a level goes through more than one conversion
+    std::array<std::vector<std::uint8_t>, 2> scratch;
+
+    const std::uint8_t *pixels(const TextureUploadLevel &level) const {
+        return staging.data() + level.offset;
+    }
+
+    void clear() {
+        levels.clear();
+        staging.clear();
+        scratch[0].clear();
+        scratch[1].clear();
+    }
+};
+
+typedef std::unique_ptr<DecodedTexture> DecodedTexturePtr;
+typedef std::function<void(const SceGxmTexture &, const MemState &, DecodedTexture &)> TextureDecodeFunc;
+typedef std::function<void(std::size_t, const DecodedTexture &)> TextureDecodedFunc;
+typedef std::function<void()> TextureDecodeWaitFunc;
+
+/**
+ * \brief Recycles decoded textures so that steady state decoding does not allocate.
+ */
+class StagingPool {
+public:
+    DecodedTexturePtr acquire();
+    void release(DecodedTexturePtr decoded);
+
+    std::size_t pooled() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<DecodedTexturePtr> free_list;
+};
+
+/**
+ * \brief Decodes textures on worker threads for the texture cache.
+ *
+ * Only the render thread calls into this. Jobs are keyed by texture cache slot and a new request for a slot replaces the
+ * pending one, so a slot only ever gets its latest contents. The source memory of a request must be readable by the
+ * workers without help from the render thread: a fault there is only served while the render thread runs the wait
+ * callback.
+ */
+class TextureDecoder {
+public:
+    explicit TextureDecoder(TextureDecodeFunc decode, std::size_t thread_count = 2);
+
+    void request(std::size_t index, const SceGxmTexture &texture, const MemState &mem);
+
+    /**
+     * \brief Get the decoded texture of a slot.
+     *
+     * \param index Texture cache slot.
+     * \param wait  Block until the pending decode of the slot is done instead of returning null while it runs. The wait
+     *              callback is called regularly in the meantime.
+     *
+     * \return The decoded texture, to be given back with recycle() once uploaded. Null if nothing is ready.
+     */
+    DecodedTexturePtr take(std::size_t index, bool wait);
+
+    // Hand every finished decode to upload and recycle it, for slots that may not be bound again soon
+    void take_finished(const TextureDecodedFunc &upload);
+
+    // Drop the pending decode of a slot, used when the slot is given to another texture
+    void cancel(std::size_t index);
+    void recycle(DecodedTexturePtr decoded);
+
+    bool pending(std::size_t index) const;
+    StagingPool &staging() {
+        return pool;
+    }
+
+    // Called by the render thread while it waits on a decode, to serve whatever the workers may be waiting on
+    void set_wait_callback(TextureDecodeWaitFunc callback) {
+        wait_callback = std::move(callback);
+    }
+
+private:
+    void reap_orphans();
+
+    TextureDecodeFunc decode;
+    TextureDecodeWaitFunc wait_callback;
+    StagingPool pool;
+    std::unordered_map<std::size_t, std::future<DecodedTexturePtr>> jobs;
+    std::vector<std::future<DecodedTexturePtr>> orphans;
+
+    // Last member, so that the workers are joined before the jobs they fill are destroyed
+    ThreadPool workers;
+};
+} // namespace renderer::texture
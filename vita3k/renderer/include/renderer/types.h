@@ -24,6 +24,7 @@
 #include <renderer/commands.h>
 
 #include <array>
+#include <atomic>
 #include <map>
 #include <string>
 #include <tuple>
@@ -51,11 +52,13 @@ typedef std::map<Sha256Hash, const SceGxmProgram *> GXPPtrMap;
 
 struct CommandBuffer;
 
+// Values are stable, the settings dialog uses them as indices
 enum class Backend {
-    OpenGL,
+    OpenGL = 0,
 #ifdef USE_VULKAN
-    Vulkan,
+    Vulkan = 1,
 #endif
+    Null = 2,
 };
 
 enum class GXMState : std::uint16_t {
@@ -134,8 +137,8 @@ struct Context {
     CommandAllocFunc alloc_func;
     CommandFreeFunc free_func;
 
-    int render_finish_status = 0;
-    int notification_finish_status = 0;
+    std::atomic<int> render_finish_status = 0;
+    std::atomic<int> notification_finish_status = 0;
 
     std::string last_draw_fragment_program_hash;
     std::string last_draw_vertex_program_hash;
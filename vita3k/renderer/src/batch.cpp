@@ -15,14 +15,18 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <renderer/capture.h>
 #include <renderer/commands.h>
 #include <renderer/functions.h>
 #include <renderer/state.h>
 #include <renderer/types.h>
 
+#include <renderer/null/functions.h>
+
 #include "driver_functions.h"
 
-#include <functional>
+#include <array>
+#include <chrono>
 #include <util/log.h>
 #include <util/string_utils.h>
 
@@ -38,30 +42,39 @@ void generic_command_free(Command *cmd) {
 }
 
 void complete_command(State &state, CommandHelper &helper, const int code) {
-    auto lock = std::unique_lock(state.command_finish_one_mutex);
     helper.complete(code);
-    state.command_finish_one.notify_all();
+    // Only wakes threads waiting on this status, and costs nothing more than the store when nobody waits
+    state.status_waiters.notify(helper.cmd->status);
 }
 
 void process_batch(renderer::State &state, const FeatureState &features, MemState &mem, Config &config, CommandList &command_list, const char *base_path,
     const char *title_id) {
-    using CommandHandlerFunc = std::function<void(renderer::State &, MemState &, Config &,
-        CommandHelper &, const FeatureState &, Context *, const char *, const char *)>;
-
-    static std::map<CommandOpcode, CommandHandlerFunc> handlers = {
-        { CommandOpcode::SetContext, cmd_handle_set_context },
-        { CommandOpcode::SyncSurfaceData, cmd_handle_sync_surface_data },
-        { CommandOpcode::CreateContext, cmd_handle_create_context },
-        { CommandOpcode::CreateRenderTarget, cmd_handle_create_render_target },
-        { CommandOpcode::Draw, cmd_handle_draw },
-        { CommandOpcode::Nop, cmd_handle_nop },
-        { CommandOpcode::SetState, cmd_handle_set_state },
-        { CommandOpcode::SignalSyncObject, cmd_handle_signal_sync_object },
-        { CommandOpcode::SignalNotification, cmd_handle_notification },
-        { CommandOpcode::DestroyRenderTarget, cmd_handle_destroy_render_target }
-    };
+    using CommandHandlerFunc = void (*)(renderer::State &, MemState &, Config &, CommandHelper &, const FeatureState &, Context *,
+        const char *, const char *);
+
+    // Indexed by opcode, unused opcodes stay null
+    static constexpr auto handlers = [] {
+        std::array<CommandHandlerFunc, static_cast<std::size_t>(CommandOpcode::TotalOpcode)> table{};
+        table[static_cast<std::size_t>(CommandOpcode::SetContext)] = cmd_handle_set_context;
+        table[static_cast<std::size_t>(CommandOpcode::SyncSurfaceData)] = cmd_handle_sync_surface_data;
+        table[static_cast<std::size_t>(CommandOpcode::CreateContext)] = cmd_handle_create_context;
+        table[static_cast<std::size_t>(CommandOpcode::CreateRenderTarget)] = cmd_handle_create_render_target;
+        table[static_cast<std::size_t>(CommandOpcode::Draw)] = cmd_handle_draw;
+        table[static_cast<std::size_t>(CommandOpcode::Nop)] = cmd_handle_nop;
+        table[static_cast<std::size_t>(CommandOpcode::SetState)] = cmd_handle_set_state;
+        table[static_cast<std::size_t>(CommandOpcode::SignalSyncObject)] = cmd_handle_signal_sync_object;
+        table[static_cast<std::size_t>(CommandOpcode::SignalNotification)] = cmd_handle_notification;
+        table[static_cast<std::size_t>(CommandOpcode::DestroyRenderTarget)] = cmd_handle_destroy_render_target;
+        return table;
+    }();
+
+    if (state.capture && state.capture->recording()) {
+        state.capture->record_command_list(state, mem, command_list);
+    }
 
     Command *cmd = command_list.first;
+    const auto start = std::chrono::steady_clock::now();
+    std::uint32_t command_count = 0;
 
     // Take a batch, and execute it. Hope it's not too large
     do {
@@ -69,16 +82,17 @@ void process_batch(renderer::State &state, const FeatureState &features, MemStat
             break;
         }
 
-        auto handler = handlers.find(cmd->opcode);
-        if (handler == handlers.end()) {
-            LOG_ERROR("Unimplemented command opcode {}", static_cast<int>(cmd->opcode));
+        const auto opcode = static_cast<std::size_t>(cmd->opcode);
+        if (opcode >= handlers.size() || !handlers[opcode]) {
+            LOG_ERROR("Unimplemented command opcode {}", opcode);
         } else {
             CommandHelper helper(cmd);
-            handler->second(state, mem, config, helper, features, command_list.context, base_path, title_id);
+            handlers[opcode](state, mem, config, helper, features, command_list.context, base_path, title_id);
         }
 
         Command *last_cmd = cmd;
         cmd = cmd->next;
+        command_count++;
 
         if (command_list.context) {
             command_list.context->free_func(last_cmd);
@@ -86,6 +100,10 @@ void process_batch(renderer::State &state, const FeatureState &features, MemStat
             generic_command_free(last_cmd);
         }
     } while (true);
+
+    if (state.current_backend == Backend::Null) {
+        null::account_batch(static_cast<null::NullState &>(state), command_count, std::chrono::steady_clock::now() - start);
+    }
 }
 
 void process_batches(renderer::State &state, const FeatureState &features, MemState &mem, Config &config, const char *base_path,
@@ -94,14 +112,14 @@ void process_batches(renderer::State &state, const FeatureState &features, MemSt
     const uint32_t queue_size = is_avg_scene_per_frame ? state.average_scene_per_frame.load() : state.command_buffer_queue.size();
 
     for (uint32_t pc = 0; pc < queue_size; pc++) {
-        auto cmd_list = state.command_buffer_queue.pop(3);
+        CommandList cmd_list;
 
-        if (!cmd_list) {
-            // Try to wait for a batch (about 2 or 3ms, game should be fast for this)
+        // Waits for a batch only when none is queued, a submission wakes us up right away
+        if (!state.command_buffer_queue.pop(cmd_list, std::chrono::milliseconds(3))) {
             return;
         }
 
-        process_batch(state, features, mem, config, *cmd_list, base_path, title_id);
+        process_batch(state, features, mem, config, cmd_list, base_path, title_id);
     }
 }
 
@@ -0,0 +1,725 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <renderer/capture.h>
+#include <renderer/command_payloads.h>
+#include <renderer/functions.h>
+#include <renderer/state.h>
+#include <renderer/types.h>
+
+#include <display/state.h>
+#include <gxm/functions.h>
+#include <mem/functions.h>
+#include <mem/ptr.h>
+#include <mem/state.h>
+#include <util/log.h>
+
+#include <cstring>
+#include <new>
+#include <xxh3.h>
+
+namespace renderer::capture {
+
+struct CaptureHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t pointer_size;
+};
+
+static bool is_recorded(const Command &cmd) {
+    switch (cmd.opcode) {
+    // Creation commands carry pointers to client side objects, render targets are recorded by their handler instead
+    case CommandOpcode::CreateContext:
+    case CommandOpcode::CreateRenderTarget:
+    case CommandOpcode::DestroyRenderTarget:
+    // These only wake up guest threads
+    case CommandOpcode::SignalSyncObject:
+    case CommandOpcode::SignalNotification:
+        return false;
+
+    default:
+        return true;
+    }
+}
+
+CaptureWriter::CaptureWriter(const fs::path &path, std::uint32_t frame_count)
+    : path(path)
+    , frames_left(frame_count) {
+    fs::create_directories(path.parent_path());
+    file.open(path.string(), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        LOG_ERROR("Failed to open GXM capture file {}", path.string());
+        return;
+    }
+
+    const CaptureHeader header = { CAPTURE_MAGIC, CAPTURE_VERSION, sizeof(void *) };
+    write(header);
+    active = frames_left > 0;
+
+    LOG_INFO("Capturing {} frames of GXM commands to {}", frames_left, path.string());
+}
+
+bool CaptureWriter::recording() const {
+    return active.load(std::memory_order_relaxed);
+}
+
+void CaptureWriter::record_memory(State &state, const MemState &mem, Address address, std::uint32_t size) {
+    if (address == 0 || size == 0) {
+        return;
+    }
+
+    // Trim to what is actually mapped, sizes of mipmapped textures are estimates
+    while (size > 0 && !is_valid_addr_range(mem, address, address + size)) {
+        size = (size > mem.page_size) ? size - static_cast<std::uint32_t>(mem.page_size) : 0;
+    }
+
+    if (size == 0) {
+        return;
+    }
+
+    // A surface the GPU wrote there may still be waiting to be read back, the fault that would otherwise
+    // bring it in is dropped on the renderer thread
+    state.resolve_memory(address, size);
+
+    const void *data = Ptr<const void>(address).get(mem);
+    const std::uint64_t hash = XXH_INLINE_XXH3_64bits(data, size);
+    auto &known_hash = memory_hashes[{ address, size }];
+    if (known_hash == hash) {
+        return;
+    }
+
+    known_hash = hash;
+    write(RecordType::Memory);
+    write(address);
+    write(size);
+    write_bytes(data, size);
+}
+
+void CaptureWriter::record_reserve(Address address, std::uint32_t size) {
+    if (address == 0 || size == 0 || !reserved.emplace(address, size).second) {
+        return;
+    }
+
+    write(RecordType::Reserve);
+    write(address);
+    write(size);
+}
+
+std::uint64_t CaptureWriter::program_hash(State &state, const MemState &mem, Address gxp_address) {
+    const SceGxmProgram *gxp = Ptr<const SceGxmProgram>(gxp_address).get(mem);
+    record_memory(state, mem, gxp_address, gxp->size);
+
+    // Seeded with the binary, so that a program object pointing to a binary that changed is recorded again
+    const auto found = memory_hashes.find({ gxp_address, gxp->size });
+    const std::uint64_t gxp_hash = (found != memory_hashes.end()) ? found->second : 0;
+    return XXH_INLINE_XXH3_64bits_withSeed(&gxp_address, sizeof(gxp_address), gxp_hash);
+}
+
+void CaptureWriter::record_program(State &state, const MemState &mem, Ptr<const void> program, bool is_fragment) {
+    if (!program) {
+        return;
+    }
+
+    // Programs are destroyed and created again at the same address, the record is only skipped when nothing changed
+    const auto is_known = [&](std::uint64_t hash) {
+        auto &known_hash = programs[program.address()];
+        if (known_hash == hash) {
+            return true;
+        }
+
+        known_hash = hash;
+        return false;
+    };
+
+    if (is_fragment) {
+        const SceGxmFragmentProgram *fragment_program = program.cast<const SceGxmFragmentProgram>().get(mem);
+
+        SceGxmBlendInfo blend{};
+        std::uint8_t has_blend = 0;
+        {
+            const std::lock_guard<std::mutex> lock(blend_mutex);
+            const auto found = blends.find(fragment_program->renderer_data.get());
+            if (found != blends.end()) {
+                blend = found->second;
+                has_blend = 1;
+            }
+        }
+
+        const std::uint8_t is_maskupdate = fragment_program->is_maskupdate;
+        std::uint64_t hash = program_hash(state, mem, fragment_program->program.address());
+        hash = XXH_INLINE_XXH3_64bits_withSeed(&is_maskupdate, sizeof(is_maskupdate), hash);
+        hash = XXH_INLINE_XXH3_64bits_withSeed(&has_blend, sizeof(has_blend), hash);
+        hash = XXH_INLINE_XXH3_64bits_withSeed(&blend, sizeof(blend), hash);
+        if (is_known(hash)) {
+            return;
+        }
+
+        write(RecordType::FragmentProgram);
+        write(program.address());
+        write(fragment_program->program.address());
+        write(is_maskupdate);
+        write(has_blend);
+        write(blend);
+    } else {
+        const SceGxmVertexProgram *vertex_program = program.cast<const SceGxmVertexProgram>().get(mem);
+        const std::size_t streams_size = vertex_program->streams.size() * sizeof(SceGxmVertexStream);
+        const std::size_t attributes_size = vertex_program->attributes.size() * sizeof(SceGxmVertexAttribute);
+
+        std::uint64_t hash = program_hash(state, mem, vertex_program->program.address());
+        hash = XXH_INLINE_XXH3_64bits_withSeed(vertex_program->streams.data(), streams_size, hash);
+        hash = XXH_INLINE_XXH3_64bits_withSeed(vertex_program->attributes.data(), attributes_size, hash);
+        if (is_known(hash)) {
+            return;
+        }
+
+        write(RecordType::VertexProgram);
+        write(program.address());
+        write(vertex_program->program.address());
+        write(static_cast<std::uint32_t>(vertex_program->streams.size()));
+        write_bytes(vertex_program->streams.data(), streams_size);
+        write(static_cast<std::uint32_t>(vertex_program->attributes.size()));
+        write_bytes(vertex_program->attributes.data(), attributes_size);
+    }
+}
+
+void CaptureWriter::record_texture(State &state, const MemState &mem, const SceGxmTexture &texture) {
+    std::size_t size = texture::texture_size(texture);
+    if (texture.true_mip_count() > 1) {
+        // Every level is at most a quarter of the previous one
+        size += size / 3;
+    }
+
+    const auto texture_type = texture.texture_type();
+    if ((texture_type == SCE_GXM_TEXTURE_CUBE) || (texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY)) {
+        size *= 6;
+    }
+
+    record_memory(state, mem, texture.data_addr << 2, static_cast<std::uint32_t>(size));
+
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(&texture));
+    if (gxm::is_paletted_format(base_format)) {
+        const std::uint32_t palette_size = (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P8) ? 256 * 4 : 16 * 4;
+        record_memory(state, mem, texture.palette_addr << 6, palette_size);
+    }
+}
+
+void CaptureWriter::record_dependencies(State &state, const MemState &mem, Command &cmd) {
+    CommandHelper helper(&cmd);
+
+    switch (cmd.opcode) {
+    case CommandOpcode::SetState: {
+        const GXMState gxm_state = helper.pop<payload::SetState>().state;
+        if (gxm_state == GXMState::Program) {
+            const auto args = helper.pop<payload::Program>();
+            record_program(state, mem, args.program, args.is_fragment);
+        } else if (gxm_state == GXMState::Texture) {
+            record_texture(state, mem, helper.pop<payload::Texture>().texture);
+        }
+        break;
+    }
+
+    case CommandOpcode::SetContext: {
+        const auto args = helper.pop<payload::SetContext>();
+        const SceGxmColorSurface *color_surface = args.color_surface;
+        const SceGxmDepthStencilSurface *depth_stencil_surface = args.depth_stencil_surface;
+
+        if (color_surface) {
+            const std::size_t bpp = color::bits_per_pixel(gxm::get_base_format(color_surface->colorFormat));
+            record_reserve(color_surface->data.address(), static_cast<std::uint32_t>(color_surface->strideInPixels * color_surface->height * bpp / 8));
+        }
+
+        if (depth_stencil_surface) {
+            record_memory(state, mem, depth_stencil_surface->control.address(), sizeof(SceGxmDepthStencilControl));
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void CaptureWriter::write_command(const MemState &mem, Command &cmd) {
+    write(cmd.opcode);
+    write_bytes(cmd.data, MAX_COMMAND_DATA_SIZE);
+
+    // Attachments, the host pointers left in the raw data are replaced when replaying
+    CommandHelper helper(&cmd);
+    switch (cmd.opcode) {
+    case CommandOpcode::Draw: {
+        const auto args = helper.pop<payload::Draw>();
+        const std::uint32_t size = static_cast<std::uint32_t>(args.count * gxm::index_element_size(args.format));
+        write(size);
+        write_bytes(args.indices, size);
+        break;
+    }
+
+    case CommandOpcode::SetContext: {
+        const auto args = helper.pop<payload::SetContext>();
+        const SceGxmColorSurface *color_surface = args.color_surface;
+        const SceGxmDepthStencilSurface *depth_stencil_surface = args.depth_stencil_surface;
+
+        write(reinterpret_cast<std::uint64_t>(args.render_target));
+        write(static_cast<std::uint8_t>(color_surface != nullptr));
+        write(color_surface ? *color_surface : SceGxmColorSurface{});
+        write(static_cast<std::uint8_t>(depth_stencil_surface != nullptr));
+        write(depth_stencil_surface ? *depth_stencil_surface : SceGxmDepthStencilSurface{});
+        break;
+    }
+
+    case CommandOpcode::SetState: {
+        const GXMState state = helper.pop<payload::SetState>().state;
+        if (state == GXMState::VertexStream) {
+            const auto args = helper.pop<payload::VertexStream>();
+            const auto size = static_cast<std::uint32_t>(args.data ? args.size : 0);
+            write(size);
+            write_bytes(args.data, size);
+        } else if (state == GXMState::UniformBuffer) {
+            const auto args = helper.pop<payload::UniformBuffer>();
+            const std::uint32_t size = args.data ? args.size : 0;
+            write(size);
+            write_bytes(args.data, size);
+        } else if (state == GXMState::Uniform) {
+            const auto args = helper.pop<payload::Uniform>();
+            write(Ptr<const void>(args.parameter, mem).address());
+            write(Ptr<const void>(args.data, mem).address());
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void CaptureWriter::record_command_list(State &state, const MemState &mem, const CommandList &command_list) {
+    if (!recording()) {
+        return;
+    }
+
+    // Whatever the commands reference goes first, so the replay can simply walk the file
+    std::uint32_t count = 0;
+    for (Command *cmd = command_list.first; cmd; cmd = cmd->next) {
+        if (is_recorded(*cmd)) {
+            record_dependencies(state, mem, *cmd);
+            count++;
+        }
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    write(RecordType::CommandList);
+    write(reinterpret_cast<std::uint64_t>(command_list.context));
+    write(count);
+    for (Command *cmd = command_list.first; cmd; cmd = cmd->next) {
+        if (is_recorded(*cmd)) {
+            write_command(mem, *cmd);
+        }
+    }
+
+    frame_has_lists = true;
+}
+
+void CaptureWriter::record_render_target(const RenderTarget *render_target, const SceGxmRenderTargetParams &params) {
+    if (!recording()) {
+        return;
+    }
+
+    write(RecordType::RenderTarget);
+    write(reinterpret_cast<std::uint64_t>(render_target));
+    write(params);
+}
+
+void CaptureWriter::record_blend(const FragmentProgram *program, const SceGxmBlendInfo *blend) {
+    if (!recording() || !blend) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(blend_mutex);
+    blends[program] = *blend;
+}
+
+void CaptureWriter::end_frame(const DisplayState &display) {
+    if (!recording() || !frame_has_lists) {
+        return;
+    }
+
+    write(RecordType::EndFrame);
+    write(display.base.address());
+    write(display.pitch);
+    write(display.image_size);
+
+    frame_has_lists = false;
+    frames_written++;
+    if (--frames_left == 0) {
+        finish();
+    }
+}
+
+void CaptureWriter::finish() {
+    active = false;
+    file.close();
+    LOG_INFO("GXM capture of {} frames written to {}", frames_written, path.string());
+}
+
+namespace {
+class RecordReader {
+public:
+    RecordReader(const std::uint8_t *begin, const std::uint8_t *end)
+        : current(begin)
+        , end(end) {
+    }
+
+    template <typename T>
+    T read() {
+        T value{};
+        if (static_cast<std::size_t>(end - current) < sizeof(T)) {
+            failed = true;
+            current = end;
+            return value;
+        }
+
+        std::memcpy(&value, current, sizeof(T));
+        current += sizeof(T);
+        return value;
+    }
+
+    const std::uint8_t *read_bytes(std::size_t size) {
+        if (static_cast<std::size_t>(end - current) < size) {
+            failed = true;
+            current = end;
+            return nullptr;
+        }
+
+        const std::uint8_t *bytes = current;
+        current += size;
+        return bytes;
+    }
+
+    bool at_end() const {
+        return current >= end;
+    }
+
+    bool failed = false;
+
+private:
+    const std::uint8_t *current;
+    const std::uint8_t *end;
+};
+
+// Objects rebuilt by a replay, released once it is done
+struct ReplayObjects {
+    std::map<std::uint64_t, std::unique_ptr<Context>> contexts;
+    std::map<std::uint64_t, std::unique_ptr<RenderTarget>> render_targets;
+    std::map<Address, SceGxmVertexProgram *> vertex_programs;
+    std::map<Address, SceGxmFragmentProgram *> fragment_programs;
+
+    ~ReplayObjects() {
+        for (auto &[address, program] : vertex_programs)
+            program->~SceGxmVertexProgram();
+        for (auto &[address, program] : fragment_programs)
+            program->~SceGxmFragmentProgram();
+    }
+};
+} // namespace
+
+static void ensure_mapped(MemState &mem, Address address, std::uint32_t size) {
+    const Address first_page = address - (address % mem.page_size);
+    for (Address page = first_page; page < address + size; page += static_cast<Address>(mem.page_size)) {
+        if (page != 0 && !is_valid_addr(mem, page)) {
+            alloc_at(mem, page, mem.page_size, "gxm_replay");
+        }
+    }
+}
+
+template <typename... Args>
+static void run_single_command(State &state, MemState &mem, Config &config, const CommandOpcode opcode, Args... arguments) {
+    // Runs on this thread right away, nothing goes through the command queue
+    std::atomic<int> status = CommandErrorCodePending;
+    CommandList list;
+    list.first = list.last = make_command(generic_command_allocate, generic_command_free, opcode, &status, arguments...);
+    list.context = nullptr;
+    process_batch(state, state.features, mem, config, list, "", "");
+}
+
+template <typename T>
+static T *new_copy(const T &value) {
+    return new T(value);
+}
+
+static std::uint8_t *new_copy(const std::uint8_t *data, std::size_t size) {
+    if (!data) {
+        return nullptr;
+    }
+
+    std::uint8_t *copy = new std::uint8_t[size];
+    std::memcpy(copy, data, size);
+    return copy;
+}
+
+template <typename T>
+static void rewrite_payload(Command &cmd, std::size_t offset, const T &args) {
+    std::memcpy(cmd.data + offset, &args, sizeof(T));
+}
+
+static Command *read_command(RecordReader &reader, MemState &mem, ReplayObjects &objects, std::atomic<int> &status) {
+    Command *cmd = generic_command_allocate();
+    cmd->opcode = reader.read<CommandOpcode>();
+    cmd->status = &status;
+    cmd->next = nullptr;
+
+    const std::uint8_t *raw = reader.read_bytes(MAX_COMMAND_DATA_SIZE);
+    if (!raw) {
+        generic_command_free(cmd);
+        return nullptr;
+    }
+    std::memcpy(cmd->data, raw, MAX_COMMAND_DATA_SIZE);
+
+    // Put back pointers valid in this process, at the same place in the payload
+    CommandHelper helper(cmd);
+    switch (cmd->opcode) {
+    case CommandOpcode::Draw: {
+        auto args = helper.pop<payload::Draw>();
+        const std::uint32_t size = reader.read<std::uint32_t>();
+        args.indices = new_copy(reader.read_bytes(size), size);
+        rewrite_payload(*cmd, 0, args);
+        break;
+    }
+
+    case CommandOpcode::SetContext: {
+        const auto render_target = objects.render_targets.find(reader.read<std::uint64_t>());
+        RenderTarget *rt = (render_target != objects.render_targets.end()) ? render_target->second.get() : nullptr;
+        const bool has_color = reader.read<std::uint8_t>() != 0;
+        const auto color_surface = reader.read<SceGxmColorSurface>();
+        const bool has_depth = reader.read<std::uint8_t>() != 0;
+        const auto depth_stencil_surface = reader.read<SceGxmDepthStencilSurface>();
+
+        const payload::SetContext args = {
+            rt,
+            has_color ? new_copy(color_surface) : nullptr,
+            has_depth ? new_copy(depth_stencil_surface) : nullptr
+        };
+        rewrite_payload(*cmd, 0, args);
+        break;
+    }
+
+    case CommandOpcode::SetState: {
+        const GXMState state = helper.pop<payload::SetState>().state;
+        if (state == GXMState::VertexStream) {
+            auto args = helper.pop<payload::VertexStream>();
+            const std::uint32_t size = reader.read<std::uint32_t>();
+            args.data = size ? new_copy(reader.read_bytes(size), size) : nullptr;
+            rewrite_payload(*cmd, sizeof(payload::SetState), args);
+        } else if (state == GXMState::UniformBuffer) {
+            auto args = helper.pop<payload::UniformBuffer>();
+            const std::uint32_t size = reader.read<std::uint32_t>();
+            args.data = size ? new_copy(reader.read_bytes(size), size) : nullptr;
+            rewrite_payload(*cmd, sizeof(payload::SetState), args);
+        } else if (state == GXMState::Uniform) {
+            auto args = helper.pop<payload::Uniform>();
+            args.parameter = Ptr<const SceGxmProgramParameter>(reader.read<Address>()).get(mem);
+            args.data = Ptr<const void>(reader.read<Address>()).get(mem);
+            rewrite_payload(*cmd, sizeof(payload::SetState), args);
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    if (reader.failed) {
+        generic_command_free(cmd);
+        return nullptr;
+    }
+
+    return cmd;
+}
+
+bool Capture::load(const fs::path &path) {
+    std::ifstream file(path.string(), std::ios::binary);
+    if (!file) {
+        LOG_ERROR("Failed to open GXM capture {}", path.string());
+        return false;
+    }
+
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    RecordReader reader(data.data(), data.data() + data.size());
+    const auto header = reader.read<CaptureHeader>();
+    if (reader.failed || header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION || header.pointer_size != sizeof(void *)) {
+        LOG_ERROR("{} is not a GXM capture this build can replay", path.string());
+        data.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool Capture::replay(State &state, MemState &mem, Config &config, ReplayStats &stats) const {
+    if (data.empty()) {
+        return false;
+    }
+
+    RecordReader reader(data.data() + sizeof(CaptureHeader), data.data() + data.size());
+    ReplayObjects objects;
+    DisplayState display;
+    std::atomic<int> status = CommandErrorCodePending;
+
+    auto frame_start = std::chrono::steady_clock::now();
+
+    while (!reader.at_end() && !reader.failed) {
+        switch (reader.read<RecordType>()) {
+        case RecordType::Memory: {
+            const Address address = reader.read<Address>();
+            const std::uint32_t size = reader.read<std::uint32_t>();
+            const std::uint8_t *bytes = reader.read_bytes(size);
+            if (!bytes)
+                break;
+            ensure_mapped(mem, address, size);
+            std::memcpy(Ptr<std::uint8_t>(address).get(mem), bytes, size);
+            break;
+        }
+
+        case RecordType::Reserve: {
+            const Address address = reader.read<Address>();
+            ensure_mapped(mem, address, reader.read<std::uint32_t>());
+            break;
+        }
+
+        case RecordType::RenderTarget: {
+            const std::uint64_t id = reader.read<std::uint64_t>();
+            const auto params = reader.read<SceGxmRenderTargetParams>();
+            run_single_command(state, mem, config, CommandOpcode::CreateRenderTarget, payload::CreateRenderTarget{ &objects.render_targets[id], &params });
+            break;
+        }
+
+        case RecordType::VertexProgram: {
+            const Address address = reader.read<Address>();
+            const Address program = reader.read<Address>();
+            const std::uint32_t stream_count = reader.read<std::uint32_t>();
+            const auto *streams = reinterpret_cast<const SceGxmVertexStream *>(reader.read_bytes(stream_count * sizeof(SceGxmVertexStream)));
+            const std::uint32_t attribute_count = reader.read<std::uint32_t>();
+            const auto *attributes = reinterpret_cast<const SceGxmVertexAttribute *>(reader.read_bytes(attribute_count * sizeof(SceGxmVertexAttribute)));
+            if (reader.failed)
+                break;
+
+            // Recorded again when a program replaced the previous one at this address
+            auto &vertex_program = objects.vertex_programs[address];
+            if (vertex_program) {
+                vertex_program->~SceGxmVertexProgram();
+            } else {
+                ensure_mapped(mem, address, sizeof(SceGxmVertexProgram));
+            }
+            vertex_program = new (Ptr<SceGxmVertexProgram>(address).get(mem)) SceGxmVertexProgram;
+            vertex_program->program = Ptr<const SceGxmProgram>(program);
+            vertex_program->streams.assign(streams, streams + stream_count);
+            vertex_program->attributes.assign(attributes, attributes + attribute_count);
+            create(vertex_program->renderer_data, state, *vertex_program->program.get(mem), state.gxp_ptr_map, "", "");
+            break;
+        }
+
+        case RecordType::FragmentProgram: {
+            const Address address = reader.read<Address>();
+            const Address program = reader.read<Address>();
+            const bool is_maskupdate = reader.read<std::uint8_t>() != 0;
+            const bool has_blend = reader.read<std::uint8_t>() != 0;
+            const auto blend = reader.read<SceGxmBlendInfo>();
+            if (reader.failed)
+                break;
+
+            auto &fragment_program = objects.fragment_programs[address];
+            if (fragment_program) {
+                fragment_program->~SceGxmFragmentProgram();
+            } else {
+                ensure_mapped(mem, address, sizeof(SceGxmFragmentProgram));
+            }
+            fragment_program = new (Ptr<SceGxmFragmentProgram>(address).get(mem)) SceGxmFragmentProgram;
+            fragment_program->program = Ptr<const SceGxmProgram>(program);
+            fragment_program->is_maskupdate = is_maskupdate;
+            create(fragment_program->renderer_data, state, *fragment_program->program.get(mem), has_blend ? &blend : nullptr, state.gxp_ptr_map, "", "");
+            break;
+        }
+
+        case RecordType::CommandList: {
+            const std::uint64_t context_id = reader.read<std::uint64_t>();
+            const std::uint32_t count = reader.read<std::uint32_t>();
+
+            auto &context = objects.contexts[context_id];
+            if (!context) {
+                run_single_command(state, mem, config, CommandOpcode::CreateContext, payload::CreateContext{ &context });
+                if (!context) {
+                    LOG_ERROR("Failed to create a renderer context for the replay");
+                    return false;
+                }
+                context->alloc_func = generic_command_allocate;
+                context->free_func = generic_command_free;
+            }
+
+            CommandList list;
+            list.context = context.get();
+            for (std::uint32_t i = 0; i < count; i++) {
+                Command *cmd = read_command(reader, mem, objects, status);
+                if (!cmd)
+                    break;
+                if (!list.first)
+                    list.first = cmd;
+                else
+                    list.last->next = cmd;
+                list.last = cmd;
+            }
+
+            process_batch(state, state.features, mem, config, list, "", "");
+            stats.command_lists++;
+            stats.commands += count;
+            break;
+        }
+
+        case RecordType::EndFrame: {
+            display.base = Ptr<const void>(reader.read<Address>());
+            display.pitch = reader.read<std::uint32_t>();
+            display.image_size = reader.read<SceIVector2>();
+            ensure_mapped(mem, display.base.address(), display.pitch * display.image_size.y * 4);
+
+            const SceFVector2 viewport_pos = { 0.0f, 0.0f };
+            const SceFVector2 viewport_size = { static_cast<float>(DEFAULT_RES_WIDTH), static_cast<float>(DEFAULT_RES_HEIGHT) };
+            state.render_frame(viewport_pos, viewport_size, display, mem);
+
+            const auto now = std::chrono::steady_clock::now();
+            stats.frame_times.push_back(now - frame_start);
+            frame_start = now;
+            break;
+        }
+
+        default:
+            LOG_ERROR("Unknown record in GXM capture");
+            return false;
+        }
+    }
+
+    if (reader.failed) {
+        LOG_ERROR("GXM capture is truncated");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace renderer::capture
@@ -22,12 +22,14 @@
 #include <renderer/types.h>
 
 #include <renderer/gl/functions.h>
+#include <renderer/null/functions.h>
 #ifdef USE_VULKAN
 #include <renderer/vulkan/functions.h>
 #endif
 #include <renderer/texture_cache_state.h>
 
 #include "driver_functions.h"
+#include <renderer/command_payloads.h>
 
 #include <gxm/types.h>
 #include <renderer/functions.h>
@@ -36,7 +38,7 @@
 
 namespace renderer {
 COMMAND(handle_create_context) {
-    std::unique_ptr<Context> *ctx = helper.pop<std::unique_ptr<Context> *>();
+    std::unique_ptr<Context> *ctx = helper.pop<payload::CreateContext>().context;
     bool result = false;
 
     switch (renderer.current_backend) {
@@ -45,6 +47,11 @@ COMMAND(handle_create_context) {
         break;
     }
 
+    case Backend::Null: {
+        result = null::create(*ctx);
+        break;
+    }
+
     default: {
         REPORT_MISSING(renderer.current_backend);
         break;
@@ -55,8 +62,9 @@ COMMAND(handle_create_context) {
 }
 
 COMMAND(handle_create_render_target) {
-    std::unique_ptr<RenderTarget> *render_target = helper.pop<std::unique_ptr<RenderTarget> *>();
-    SceGxmRenderTargetParams *params = helper.pop<SceGxmRenderTargetParams *>();
+    const auto args = helper.pop<payload::CreateRenderTarget>();
+    std::unique_ptr<RenderTarget> *render_target = args.render_target;
+    const SceGxmRenderTargetParams *params = args.params;
 
     bool result = false;
 
@@ -66,18 +74,26 @@ COMMAND(handle_create_render_target) {
         break;
     }
 
+    case Backend::Null: {
+        result = null::create(*render_target, *params);
+        break;
+    }
+
     default: {
         REPORT_MISSING(renderer.current_backend);
         break;
     }
     }
 
+    if (result && renderer.capture) {
+        renderer.capture->record_render_target(render_target->get(), *params);
+    }
+
     complete_command(renderer, helper, result);
 }
 
 COMMAND(handle_destroy_render_target) {
-    std::unique_ptr<RenderTarget> *render_target = helper.pop<std::unique_ptr<RenderTarget> *>();
-    render_target->reset();
+    helper.pop<payload::DestroyRenderTarget>().render_target->reset();
 
     complete_command(renderer, helper, 0);
 }
@@ -87,9 +103,17 @@ COMMAND(handle_prepare_overall_buffer_storage) {
 
 // Client
 bool create(std::unique_ptr<FragmentProgram> &fp, State &state, const SceGxmProgram &program, const SceGxmBlendInfo *blend, GXPPtrMap &gxp_ptr_map, const char *base_path, const char *title_id) {
+    bool result = false;
+
     switch (state.current_backend) {
     case Backend::OpenGL: {
-        return gl::create(fp, static_cast<gl::GLState &>(state), program, blend, gxp_ptr_map, base_path, title_id);
+        result = gl::create(fp, static_cast<gl::GLState &>(state), program, blend, gxp_ptr_map, base_path, title_id);
+        break;
+    }
+
+    case Backend::Null: {
+        result = null::create(fp, static_cast<null::NullState &>(state), program, gxp_ptr_map);
+        break;
     }
 
     default: {
@@ -98,7 +122,12 @@ bool create(std::unique_ptr<FragmentProgram> &fp, State &state, const SceGxmProg
     }
     }
 
-    return false;
+    // Blending is baked in the program, a replay has to create it again with the same info
+    if (result && state.capture) {
+        state.capture->record_blend(fp.get(), blend);
+    }
+
+    return result;
 }
 
 bool create(std::unique_ptr<VertexProgram> &vp, State &state, const SceGxmProgram &program, GXPPtrMap &gxp_ptr_map, const char *base_path, const char *title_id) {
@@ -107,6 +136,10 @@ bool create(std::unique_ptr<VertexProgram> &vp, State &state, const SceGxmProgra
         return gl::create(vp, static_cast<gl::GLState &>(state), program, gxp_ptr_map, base_path, title_id);
     }
 
+    case Backend::Null: {
+        return null::create(vp, static_cast<null::NullState &>(state), program, gxp_ptr_map);
+    }
+
     default: {
         REPORT_MISSING(state.current_backend);
         break;
@@ -122,6 +155,13 @@ bool init(SDL_Window *window, std::unique_ptr<State> &state, Backend backend, co
         state = std::make_unique<gl::GLState>();
         if (!gl::create(window, state, base_path, config.hashless_taexture_cache))
             return false;
+        if (config.async_texture_decode)
+            gl::texture::enable_async_decode(static_cast<gl::GLState &>(*state), config.async_texture_decode_wait);
+        break;
+    case Backend::Null:
+        state = std::make_unique<null::NullState>();
+        if (!null::create(state, base_path, config.hashless_taexture_cache))
+            return false;
         break;
 #ifdef USE_VULKAN
     case Backend::Vulkan:
@@ -137,9 +177,6 @@ bool init(SDL_Window *window, std::unique_ptr<State> &state, Backend backend, co
 
     state->current_backend = backend;
 
-    // Can change this
-    state->command_buffer_queue.maxPendingCount_ = 30;
-
     return true;
 }
 } // namespace renderer
@@ -36,6 +36,7 @@
 #include <SDL.h>
 #include <SDL_video.h>
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
@@ -73,6 +74,36 @@ bool init(GLTextureCacheState &cache, const bool hashless_texture_cache) {
 
     return cache.textures.init(reinterpret_cast<renderer::Generator *>(glGenTextures), reinterpret_cast<renderer::Deleter *>(glDeleteTextures));
 }
+
+void enable_async_decode(GLState &state, const bool wait_for_decode) {
+    GLTextureCacheState &cache = state.texture_cache;
+    cache.decoder = std::make_unique<renderer::texture::TextureDecoder>(decode_texture);
+    cache.decoder->set_wait_callback([&state]() {
+        // A worker reading a surface that is still being read back waits for it in its fault handler
+        state.surface_readback.poll();
+    });
+    cache.upload_decoded_callback = [](const std::size_t index, const renderer::texture::DecodedTexture &decoded) {
+        upload_decoded_texture(decoded);
+    };
+    cache.wait_for_decode = wait_for_decode;
+}
+
+void upload_finished_decodes(GLTextureCacheState &cache) {
+    if (!cache.decoder) {
+        return;
+    }
+
+    // Uploading binds the slots on the active unit, draws expect to find what they bound there
+    GLint texture_2d = 0;
+    GLint texture_cube = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture_2d);
+    glGetIntegerv(GL_TEXTURE_BINDING_CUBE_MAP, &texture_cube);
+
+    renderer::texture::upload_finished_decodes(cache);
+
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture_2d));
+    glBindTexture(GL_TEXTURE_CUBE_MAP, static_cast<GLuint>(texture_cube));
+}
 } // namespace texture
 
 static GLenum translate_blend_func(SceGxmBlendFunc src) {
@@ -299,6 +330,14 @@ bool GLState::init(const char *base_path, const bool hashless_texture_cache) {
         return false;
     }
 
+    if (!surface_readback.init()) {
+        LOG_ERROR("Failed to initialize surface readback");
+        return false;
+    }
+    texture_cache.resolve_callback = [this](Address address, size_t size) {
+        surface_readback.resolve(address, size);
+    };
+
     return true;
 }
 
@@ -490,136 +529,203 @@ void set_context(GLState &state, GLContext &context, const MemState &mem, const
     }
 }
 
-void get_surface_data(GLState &renderer, GLContext &context, size_t width, size_t height, size_t stride_in_pixels, uint32_t *pixels, SceGxmColorFormat format) {
-    R_PROFILE(__func__);
-
-    if (!pixels)
-        return;
-
-    glPixelStorei(GL_PACK_ROW_LENGTH, static_cast<GLint>(stride_in_pixels));
+static bool is_se5m9m9m9(SceGxmColorFormat format) {
+    return format == SCE_GXM_COLOR_FORMAT_SE5M9M9M9_RGB || format == SCE_GXM_COLOR_FORMAT_SE5M9M9M9_BGR;
+}
 
+void get_color_read_format(SceGxmColorFormat format, GLenum &read_format, GLenum &read_type) {
     // TODO Need more check into this
     switch (format) {
     case SCE_GXM_COLOR_FORMAT_U8U8U8U8_ABGR:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, pixels);
+        read_format = GL_RGBA;
+        read_type = GL_UNSIGNED_INT_8_8_8_8_REV;
         break;
     case SCE_GXM_COLOR_FORMAT_U8U8U8U8_ARGB:
     case SCE_GXM_COLOR_FORMAT_U8U8U8U8_BGRA:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, pixels);
+        read_format = GL_BGRA;
+        read_type = GL_UNSIGNED_INT_8_8_8_8_REV;
         break;
     case SCE_GXM_COLOR_FORMAT_U8U8U8U8_RGBA:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, pixels);
+        read_format = GL_RGBA;
+        read_type = GL_UNSIGNED_INT_8_8_8_8;
         break;
     case SCE_GXM_COLOR_FORMAT_U1U5U5U5_ABGR:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, pixels);
+        read_format = GL_RGBA;
+        read_type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
         break;
     case SCE_GXM_COLOR_FORMAT_U4U4U4U4_ARGB:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_BGRA, GL_UNSIGNED_SHORT_4_4_4_4_REV, pixels);
+        read_format = GL_BGRA;
+        read_type = GL_UNSIGNED_SHORT_4_4_4_4_REV;
         break;
     case SCE_GXM_COLOR_FORMAT_U8U8U8_BGR:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_BGR, GL_UNSIGNED_BYTE, pixels);
+        read_format = GL_BGR;
+        read_type = GL_UNSIGNED_BYTE;
         break;
     case SCE_GXM_COLOR_FORMAT_U5U6U5_RGB:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGB, GL_UNSIGNED_SHORT_5_6_5, pixels);
+        read_format = GL_RGB;
+        read_type = GL_UNSIGNED_SHORT_5_6_5;
         break;
     case SCE_GXM_COLOR_FORMAT_U16_R:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RED, GL_UNSIGNED_SHORT, pixels);
+        read_format = GL_RED;
+        read_type = GL_UNSIGNED_SHORT;
         break;
     case SCE_GXM_COLOR_FORMAT_U8U8_AR:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RG, GL_UNSIGNED_BYTE, pixels);
+        read_format = GL_RG;
+        read_type = GL_UNSIGNED_BYTE;
         break;
     case SCE_GXM_COLOR_FORMAT_U8U8_GR:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RG, GL_UNSIGNED_BYTE, pixels);
+        read_format = GL_RG;
+        read_type = GL_UNSIGNED_BYTE;
         break;
     case SCE_GXM_COLOR_FORMAT_U8_A:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_ALPHA, GL_UNSIGNED_BYTE, pixels);
+        read_format = GL_ALPHA;
+        read_type = GL_UNSIGNED_BYTE;
         break;
     case SCE_GXM_COLOR_FORMAT_U8_R:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RED, GL_UNSIGNED_BYTE, pixels);
+        read_format = GL_RED;
+        read_type = GL_UNSIGNED_BYTE;
         break;
     case SCE_GXM_COLOR_FORMAT_U2F10F10F10_ABGR:
     case SCE_GXM_COLOR_FORMAT_F10F10F10U2_RGBA:
     case SCE_GXM_COLOR_FORMAT_U2U10U10U10_ABGR:
     case SCE_GXM_COLOR_FORMAT_U10U10U10U2_RGBA:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, pixels);
+        read_format = GL_RGBA;
+        read_type = GL_UNSIGNED_INT_2_10_10_10_REV;
         break;
     case SCE_GXM_COLOR_FORMAT_F11F11F10_RGB: // F1 2011
         //LOG_DEBUG("Todo: SCE_GXM_COLOR_FORMAT_F11F11F10_RGB");
     case SCE_GXM_COLOR_FORMAT_F10F11F11_BGR:
         //LOG_DEBUG("Todo: SCE_GXM_COLOR_FORMAT_F10F11F11_BGR");
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV, pixels);
+        read_format = GL_RGB;
+        read_type = GL_UNSIGNED_INT_10F_11F_11F_REV;
         break;
     case SCE_GXM_COLOR_FORMAT_F16_R:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RED, GL_HALF_FLOAT, pixels);
+        read_format = GL_RED;
+        read_type = GL_HALF_FLOAT;
         break;
     case SCE_GXM_COLOR_FORMAT_F16F16_GR:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RG, GL_HALF_FLOAT, pixels);
+        read_format = GL_RG;
+        read_type = GL_HALF_FLOAT;
         break;
     case SCE_GXM_COLOR_FORMAT_F16F16F16F16_ABGR:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_HALF_FLOAT, pixels);
+        read_format = GL_RGBA;
+        read_type = GL_HALF_FLOAT;
         break;
     case SCE_GXM_COLOR_FORMAT_F16F16F16F16_ARGB:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_BGRA, GL_HALF_FLOAT, pixels);
+        read_format = GL_BGRA;
+        read_type = GL_HALF_FLOAT;
         break;
     case SCE_GXM_COLOR_FORMAT_F16F16F16F16_RGBA:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_HALF_FLOAT, pixels);
+        read_format = GL_RGBA;
+        read_type = GL_HALF_FLOAT;
         break;
     case SCE_GXM_COLOR_FORMAT_F32_R:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RED, GL_FLOAT, pixels);
+        read_format = GL_RED;
+        read_type = GL_FLOAT;
         break;
     case SCE_GXM_COLOR_FORMAT_F32F32_GR:
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RG, GL_FLOAT, pixels);
+        read_format = GL_RG;
+        read_type = GL_FLOAT;
         break;
     case SCE_GXM_COLOR_FORMAT_SE5M9M9M9_RGB:
-    case SCE_GXM_COLOR_FORMAT_SE5M9M9M9_BGR: {
-        std::vector<uint16_t> temp_bytes(width * height * 3);
-        GLenum rfmt = (format == SCE_GXM_COLOR_FORMAT_SE5M9M9M9_BGR) ? GL_BGR : GL_RGB;
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), rfmt, GL_HALF_FLOAT, temp_bytes.data());
-        for (int i = 0, iptr = 0; i < width * height; ++i) {
-            uint32_t pixel = 0;
-            pixel |= (uint32_t(temp_bytes[iptr++] << 17) & (0x3FFFF << 18)); // Exp + 9 bits
-            pixel |= (uint32_t(temp_bytes[iptr++] << 8) & (0x1FF << 9));
-            pixel |= (uint32_t(temp_bytes[iptr++] >> 1) & (0x1FF << 0));
-            pixels[i] = pixel;
-        }
+        // Read as half floats, packed later by pack_se5m9m9m9
+        read_format = GL_RGB;
+        read_type = GL_HALF_FLOAT;
+        break;
+    case SCE_GXM_COLOR_FORMAT_SE5M9M9M9_BGR:
+        read_format = GL_BGR;
+        read_type = GL_HALF_FLOAT;
         break;
-    }
     case SCE_GXM_COLOR_FORMAT_U8U3U3U2_ARGB:
         LOG_DEBUG("Todo: SCE_GXM_COLOR_FORMAT_U8U3U3U2_ARGB");
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_BGRA, GL_UNSIGNED_SHORT_4_4_4_4_REV, pixels);
+        read_format = GL_BGRA;
+        read_type = GL_UNSIGNED_SHORT_4_4_4_4_REV;
         break;
     default:
         LOG_ERROR("Color format not implemented: {}, report this to developer", format);
-        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        read_format = GL_RGBA;
+        read_type = GL_UNSIGNED_BYTE;
         break;
     }
 
-    if (context.record.color_surface.surfaceType == SCE_GXM_COLOR_SURFACE_TILED) {
-        const SceGxmColorBaseFormat base_format = gxm::get_base_format(format);
-        const size_t bpp = renderer::color::bits_per_pixel(base_format);
-        const size_t bytes_per_pixel = (bpp + 7) >> 3;
-        std::vector<uint8_t> buffer;
-
-        buffer.resize(((width + 31) / 32) * ((height + 31) / 32) * 1024 * bytes_per_pixel);
-        for (int j = 0; j < height; j++) {
-            for (int hori_tile = 0; hori_tile < (width >> 5); hori_tile++) {
-                const size_t tile_position = hori_tile + (j >> 5) * ((width + 31) >> 5);
-                const size_t first_pixel_offset_in_tile = (tile_position << 10) + (j & 31) * 32;
-                const size_t first_pixel_offset_in_linear = (j * stride_in_pixels) + hori_tile * 32;
-
-                memcpy(buffer.data() + first_pixel_offset_in_tile * bytes_per_pixel,
-                    (const char *)(pixels) + first_pixel_offset_in_linear * bytes_per_pixel, 32 * bytes_per_pixel);
-            }
+}
+
+size_t get_color_read_bytes_per_pixel(SceGxmColorFormat format) {
+    if (is_se5m9m9m9(format))
+        return 3 * sizeof(uint16_t);
+
+    const size_t bpp = renderer::color::bits_per_pixel(gxm::get_base_format(format));
+    return std::max<size_t>((bpp + 7) >> 3, 4);
+}
+
+void pack_se5m9m9m9(const uint16_t *src, uint32_t *dst, size_t pixel_count) {
+    // Every source pixel is read before its (smaller) destination is written, so this also works in place
+    for (size_t i = 0, iptr = 0; i < pixel_count; ++i) {
+        uint32_t pixel = 0;
+        pixel |= (uint32_t(src[iptr++] << 17) & (0x3FFFF << 18)); // Exp + 9 bits
+        pixel |= (uint32_t(src[iptr++] << 8) & (0x1FF << 9));
+        pixel |= (uint32_t(src[iptr++] >> 1) & (0x1FF << 0));
+        dst[i] = pixel;
+    }
+}
+
+void tile_surface(uint8_t *pixels, size_t width, size_t height, size_t stride_in_pixels, SceGxmColorFormat format) {
+    const SceGxmColorBaseFormat base_format = gxm::get_base_format(format);
+    const size_t bpp = renderer::color::bits_per_pixel(base_format);
+    const size_t bytes_per_pixel = (bpp + 7) >> 3;
+    std::vector<uint8_t> buffer;
+
+    buffer.resize(((width + 31) / 32) * ((height + 31) / 32) * 1024 * bytes_per_pixel);
+    for (int j = 0; j < height; j++) {
+        for (int hori_tile = 0; hori_tile < (width >> 5); hori_tile++) {
+            const size_t tile_position = hori_tile + (j >> 5) * ((width + 31) >> 5);
+            const size_t first_pixel_offset_in_tile = (tile_position << 10) + (j & 31) * 32;
+            const size_t first_pixel_offset_in_linear = (j * stride_in_pixels) + hori_tile * 32;
+
+            memcpy(buffer.data() + first_pixel_offset_in_tile * bytes_per_pixel,
+                pixels + first_pixel_offset_in_linear * bytes_per_pixel, 32 * bytes_per_pixel);
         }
-        memcpy(pixels, buffer.data(), buffer.size());
     }
+    memcpy(pixels, buffer.data(), buffer.size());
+}
+
+void get_surface_data(GLState &renderer, GLContext &context, size_t width, size_t height, size_t stride_in_pixels, uint32_t *pixels, SceGxmColorFormat format) {
+    R_PROFILE(__func__);
+
+    if (!pixels)
+        return;
+
+    GLenum read_format;
+    GLenum read_type;
+    get_color_read_format(format, read_format, read_type);
+
+    glPixelStorei(GL_PACK_ROW_LENGTH, static_cast<GLint>(stride_in_pixels));
+
+    if (is_se5m9m9m9(format)) {
+        std::vector<uint16_t> temp_bytes(stride_in_pixels * height * 3);
+        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), read_format, read_type, temp_bytes.data());
+        pack_se5m9m9m9(temp_bytes.data(), pixels, stride_in_pixels * height);
+    } else {
+        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), read_format, read_type, pixels);
+    }
+
+    if (context.record.color_surface.surfaceType == SCE_GXM_COLOR_SURFACE_TILED)
+        tile_surface(reinterpret_cast<uint8_t *>(pixels), width, height, stride_in_pixels, format);
 
     glPixelStorei(GL_PACK_ROW_LENGTH, 0);
     ++renderer.texture_cache.timestamp;
 }
 
+void GLState::resolve_memory(Address address, size_t size) {
+    surface_readback.resolve(address, size);
+}
+
 void GLState::render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &viewport_size, const DisplayState &display,
     const MemState &mem) {
+    surface_readback.poll();
+    // Textures used by a single draw would otherwise keep their decode until they are bound again
+    texture::upload_finished_decodes(texture_cache);
+
     // Check if the surface exists
     float uvs[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
     bool need_uv = true;
@@ -630,6 +736,7 @@ void GLState::render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &v
         need_uv = false;
 
         glBindTexture(GL_TEXTURE_2D, screen_renderer.get_resident_texture());
+        surface_readback.resolve(display.base.address(), display.pitch * display.image_size.y * 4);
         const auto pixels = display.base.cast<void>().get(mem);
 
         glPixelStorei(GL_UNPACK_ROW_LENGTH, display.pitch);
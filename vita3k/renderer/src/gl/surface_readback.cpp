@@ -0,0 +1,220 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/gl/surface_readback.h>
+
+#include <renderer/functions.h>
+#include <renderer/gl/functions.h>
+#include <renderer/profile.h>
+
+#include <gxm/functions.h>
+#include <mem/functions.h>
+#include <mem/ptr.h>
+#include <mem/state.h>
+#include <util/align.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace renderer::gl {
+
+constexpr GLuint64 FENCE_TIMEOUT_NS = 1'000'000'000;
+
+SurfaceReadback::~SurfaceReadback() {
+    for (const auto &readback : slots) {
+        if (readback && readback->fence)
+            glDeleteSync(readback->fence);
+    }
+}
+
+bool SurfaceReadback::init() {
+    renderer_thread = std::this_thread::get_id();
+    return buffers.init(reinterpret_cast<renderer::Generator *>(glGenBuffers), reinterpret_cast<renderer::Deleter *>(glDeleteBuffers));
+}
+
+void SurfaceReadback::request(MemState &mem, Address address, size_t width, size_t height, size_t stride_in_pixels, SceGxmColorFormat format, bool tiled) {
+    R_PROFILE(__func__);
+
+    if (!address || !width || !height)
+        return;
+
+    this->mem = &mem;
+
+    const size_t bytes_per_pixel = (color::bits_per_pixel(gxm::get_base_format(format)) + 7) >> 3;
+    size_t size = stride_in_pixels * height * bytes_per_pixel;
+    if (tiled)
+        size = std::max(size, ((width + 31) / 32) * ((height + 31) / 32) * 1024 * bytes_per_pixel);
+
+    const auto readback = std::make_shared<Readback>();
+    readback->address = address;
+    readback->size = size;
+    readback->width = width;
+    readback->height = height;
+    readback->stride_in_pixels = stride_in_pixels;
+    readback->format = format;
+    readback->tiled = tiled;
+    readback->read_size = stride_in_pixels * height * get_color_read_bytes_per_pixel(format);
+
+    // Reuse the oldest pixel buffer, keeping its contents around if nobody has read them yet
+    readback->slot = next_slot;
+    next_slot = (next_slot + 1) % RING_SIZE;
+    ReadbackPtr &slot = slots[readback->slot];
+    if (slot) {
+        if (!slot->staged && !slot->done)
+            stage(*slot);
+        if (slot->fence) {
+            glDeleteSync(slot->fence);
+            slot->fence = nullptr;
+        }
+    }
+    slot = readback;
+
+    GLenum read_format;
+    GLenum read_type;
+    get_color_read_format(format, read_format, read_type);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[readback->slot]);
+    if (buffer_sizes[readback->slot] < readback->read_size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, readback->read_size, nullptr, GL_STREAM_READ);
+        buffer_sizes[readback->slot] = readback->read_size;
+    }
+    glPixelStorei(GL_PACK_ROW_LENGTH, static_cast<GLint>(stride_in_pixels));
+    glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), read_format, read_type, nullptr);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    bool need_protect = true;
+    ReadbackPtr &entry = pending[address];
+    if (entry) {
+        // The previous contents were never looked at: drop them, the protection is still in place
+        need_protect = entry->size < size;
+        entry->done = true;
+        if (!need_protect)
+            readback->request = entry->request;
+    }
+    if (!readback->request) {
+        readback->request = std::make_shared<AccessProtectRequest>();
+        readback->request->owner = renderer_thread;
+    }
+    entry = readback;
+
+    if (need_protect)
+        add_access_protect(mem, address, size, readback->request);
+}
+
+void SurfaceReadback::stage(Readback &readback) {
+    R_PROFILE(__func__);
+
+    if (readback.fence) {
+        if (glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS) == GL_TIMEOUT_EXPIRED)
+            LOG_WARN("Timed out waiting for the readback of color surface {}", log_hex(readback.address));
+        glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[readback.slot]);
+    const auto mapped = static_cast<const uint8_t *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback.read_size, GL_MAP_READ_BIT));
+    if (mapped) {
+        readback.data.assign(mapped, mapped + readback.read_size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        LOG_ERROR("Failed to map the readback buffer of color surface {}", log_hex(readback.address));
+        readback.data.assign(readback.read_size, 0);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.staged = true;
+}
+
+void SurfaceReadback::write_back(std::vector<ReadbackPtr> readbacks) {
+    R_PROFILE(__func__);
+
+    // Surfaces sharing a page share one protected range, and releasing it exposes all of them: every surface
+    // on pages touching the range is written before any protection is lifted
+    const auto page_start = [&](Address address) -> size_t { return align_down(address, mem->page_size); };
+    const auto page_end = [&](Address address, size_t size) -> size_t { return align(address + size, mem->page_size); };
+    size_t start = page_start(readbacks.front()->address);
+    size_t end = page_end(readbacks.front()->address, readbacks.front()->size);
+    for (bool grown = true; grown;) {
+        grown = false;
+        for (const auto &[address, readback] : pending) {
+            if (page_start(address) > end || page_end(address, readback->size) < start)
+                continue;
+            if (std::find(readbacks.begin(), readbacks.end(), readback) == readbacks.end()) {
+                readbacks.push_back(readback);
+                grown = true;
+            }
+            start = std::min(start, page_start(address));
+            end = std::max(end, page_end(address, readback->size));
+        }
+    }
+
+    for (const auto &readback : readbacks) {
+        pending.erase(readback->address);
+        readback->done = true;
+        if (!readback->staged)
+            stage(*readback);
+
+        std::vector<uint8_t> &data = readback->data;
+        if (readback->format == SCE_GXM_COLOR_FORMAT_SE5M9M9M9_RGB || readback->format == SCE_GXM_COLOR_FORMAT_SE5M9M9M9_BGR)
+            pack_se5m9m9m9(reinterpret_cast<const uint16_t *>(data.data()), reinterpret_cast<uint32_t *>(data.data()), readback->stride_in_pixels * readback->height);
+        if (data.size() < readback->size)
+            data.resize(readback->size);
+        if (readback->tiled)
+            tile_surface(data.data(), readback->width, readback->height, readback->stride_in_pixels, readback->format);
+
+        // Fails when the surface could not be protected, guest threads may have read it already
+        if (!write_access_protected(*mem, readback->address, data.data(), readback->size))
+            LOG_WARN("Color surface {} was read before its readback was written back", log_hex(readback->address));
+        data = std::vector<uint8_t>();
+    }
+
+    for (const auto &readback : readbacks)
+        remove_access_protect(*mem, readback->address);
+}
+
+void SurfaceReadback::poll() {
+    std::vector<ReadbackPtr> wanted;
+    for (const auto &[address, readback] : pending) {
+        // The renderer thread faulting on a surface read whatever was there, the contents are still written back
+        if (readback->request->declined.exchange(0, std::memory_order_relaxed)) {
+            LOG_WARN("The renderer thread touched color surface {} before resolving its readback", log_hex(address));
+            wanted.push_back(readback);
+        } else if (readback->request->wanted.load(std::memory_order_acquire))
+            wanted.push_back(readback);
+    }
+    if (!wanted.empty())
+        write_back(std::move(wanted));
+}
+
+void SurfaceReadback::resolve(Address address, size_t size) {
+    if (pending.empty())
+        return;
+
+    std::vector<ReadbackPtr> overlapping;
+    for (const auto &[readback_address, readback] : pending) {
+        if (readback_address < address + size && readback_address + readback->size > address)
+            overlapping.push_back(readback);
+    }
+
+    if (!overlapping.empty())
+        write_back(std::move(overlapping));
+}
+
+} // namespace renderer::gl
@@ -18,6 +18,7 @@
 #include <renderer/functions.h>
 #include <renderer/profile.h>
 #include <renderer/pvrt-dec.h>
+#include <renderer/texture_decoder.h>
 
 #include <renderer/gl/functions.h>
 #include <renderer/gl/types.h>
@@ -29,6 +30,8 @@
 
 #include <stb_image_write.h>
 
+#include <cstring>
+
 static constexpr bool log_parameter = false;
 
 namespace renderer::gl {
@@ -249,7 +252,7 @@ static void convert_f32m_to_f32(void *dest, const void *data, const uint32_t wid
     }
 }
 
-void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem) {
+void decode_texture(const SceGxmTexture &gxm_texture, const MemState &mem, renderer::texture::DecodedTexture &decoded) {
     R_PROFILE(__func__);
 
     const SceGxmTextureFormat fmt = gxm::get_format(&gxm_texture);
@@ -257,13 +260,14 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
     auto width = static_cast<uint32_t>(gxm::get_width(&gxm_texture));
     auto height = static_cast<uint32_t>(gxm::get_height(&gxm_texture));
     const Ptr<uint8_t> data(gxm_texture.data_addr << 2);
-    uint8_t *texture_data = data.get(mem);
-    std::vector<uint8_t> texture_data_decompressed;
-    std::vector<uint8_t> texture_pixels_lineared; // TODO Move to context to avoid frequent allocation?
-    std::vector<uint32_t> palette_texture_pixels;
-    std::vector<uint8_t> yuv_texture_pixels;
+    const uint8_t *texture_data = data.get(mem);
+
+    decoded.clear();
+    decoded.texture = gxm_texture;
 
     const void *pixels = nullptr;
+    size_t pixels_size = 0;
+    bool pixels_staged = false;
 
     size_t pixels_per_stride = 0;
     size_t bpp = renderer::texture::bits_per_pixel(base_format);
@@ -271,7 +275,9 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
 
     const auto texture_type = gxm_texture.texture_type();
     const bool is_swizzled = (texture_type == SCE_GXM_TEXTURE_SWIZZLED) || (texture_type == SCE_GXM_TEXTURE_CUBE) || (texture_type == SCE_GXM_TEXTURE_SWIZZLED_ARBITRARY) || (texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY);
+    const bool is_linearized = is_swizzled || (texture_type == SCE_GXM_TEXTURE_TILED);
     const bool need_decompress_and_unswizzle_on_cpu = is_swizzled && !can_texture_be_unswizzled_without_decode(base_format);
+    const bool is_yuv = gxm::is_yuv_format(base_format);
 
     uint32_t mip_index = 0;
     uint32_t total_mip = gxm_texture.true_mip_count();
@@ -293,13 +299,9 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
         total_mip = 1;
     }
 
-    // GXM's cube map index is same as OpenGL: right, left, top, bottom, front, back
-    GLenum upload_type = GL_TEXTURE_2D;
-
     face_total_count = 1;
 
     if ((texture_type == SCE_GXM_TEXTURE_CUBE) || (texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY)) {
-        upload_type = GL_TEXTURE_CUBE_MAP_POSITIVE_X;
         face_total_count = 6;
 
         const bool twok_align_cond1 = ((width >= 32) && (height >= 32) && ((bytes_per_pixel == 1) || (is_block_compressed_format(base_format))));
@@ -311,19 +313,38 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
         }
     }
 
+    // Each conversion reads the result of the previous one. Intermediate results go to the scratch buffers and the
+    // last conversion of a level writes straight to the staging buffer.
+    renderer::texture::TextureUploadLevel level;
+    const auto output = [&](const size_t size, const bool last) -> uint8_t * {
+        pixels_size = size;
+        if (last) {
+            level.offset = decoded.staging.size();
+            decoded.staging.resize(level.offset + size);
+            pixels_staged = true;
+            return decoded.staging.data() + level.offset;
+        }
+
+        auto &scratch = decoded.scratch[(pixels == decoded.scratch[0].data()) ? 1 : 0];
+        scratch.resize(size);
+        return scratch.data();
+    };
+
     while ((face_uploaded_count < face_total_count) && width && height) {
         pixels = texture_data;
+        pixels_staged = false;
+        level = {};
 
         if (gxm::is_paletted_format(base_format)) {
-            palette_texture_pixels.resize(width * height * 4);
+            uint8_t *const palette_texture_pixels = output(width * height * 4, !is_linearized);
             if (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P8) {
-                renderer::texture::palette_texture_to_rgba_8(palette_texture_pixels.data(),
+                renderer::texture::palette_texture_to_rgba_8(reinterpret_cast<uint32_t *>(palette_texture_pixels),
                     reinterpret_cast<const uint8_t *>(pixels), width, height, renderer::texture::get_texture_palette(gxm_texture, mem));
             } else {
-                renderer::texture::palette_texture_to_rgba_4(reinterpret_cast<uint32_t *>(palette_texture_pixels.data()),
+                renderer::texture::palette_texture_to_rgba_4(reinterpret_cast<uint32_t *>(palette_texture_pixels),
                     reinterpret_cast<const uint8_t *>(pixels), width, height, renderer::texture::get_texture_palette(gxm_texture, mem));
             }
-            pixels = palette_texture_pixels.data();
+            pixels = palette_texture_pixels;
             bytes_per_pixel = 4;
             bpp = 32;
         }
@@ -342,13 +363,15 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
                 height = nearest_power_of_two(height);
             }
 
+            const bool is_pvrt = (base_format >= SCE_GXM_TEXTURE_BASE_FORMAT_PVRT2BPP) && (base_format <= SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII4BPP);
+
             if (need_decompress_and_unswizzle_on_cpu) {
                 // Must decompress them
-                texture_data_decompressed.resize(width * height * 4);
-                source_size = decompress_compressed_swizz_texture(base_format, texture_data_decompressed.data(), pixels, width, height);
+                uint8_t *const texture_data_decompressed = output(width * height * 4, is_pvrt);
+                source_size = decompress_compressed_swizz_texture(base_format, texture_data_decompressed, pixels, width, height);
                 bytes_per_pixel = 4;
                 bpp = 32;
-                pixels = texture_data_decompressed.data();
+                pixels = texture_data_decompressed;
             }
 
             pixels_per_stride = width;
@@ -359,41 +382,42 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
             case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII2BPP:
             case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII4BPP:
                 break;
-            case SCE_GXM_TEXTURE_BASE_FORMAT_SE5M9M9M9:
-                texture_data_decompressed.resize(width * height * 6);
-                decompress_packed_float_e5m9m9m9(base_format, texture_data_decompressed.data(), pixels, width, height);
-                pixels = texture_data_decompressed.data();
+            case SCE_GXM_TEXTURE_BASE_FORMAT_SE5M9M9M9: {
+                uint8_t *const texture_data_decompressed = output(width * height * 6, true);
+                decompress_packed_float_e5m9m9m9(base_format, texture_data_decompressed, pixels, width, height);
+                pixels = texture_data_decompressed;
                 break;
-            case SCE_GXM_TEXTURE_BASE_FORMAT_X8U24:
+            }
+            case SCE_GXM_TEXTURE_BASE_FORMAT_X8U24: {
                 // X8 = [24-31], D24 = [0-23], technically this is GL_UNSIGNED_INT_24_8_REV which does not exist
                 // TODO: Requires shader to convert the normalized value read by GL to unsigned int. Just multiply by 2^24-1 when reading and you're done.
-                texture_data_decompressed.resize(width * height * 4);
-                convert_x8u24_to_u24x8(texture_data_decompressed.data(), pixels, width, height, pixels_per_stride);
-                pixels = texture_data_decompressed.data();
+                uint8_t *const texture_data_decompressed = output(width * height * 4, true);
+                convert_x8u24_to_u24x8(texture_data_decompressed, pixels, width, height, pixels_per_stride);
+                pixels = texture_data_decompressed;
                 break;
-            case SCE_GXM_TEXTURE_BASE_FORMAT_F32M:
+            }
+            case SCE_GXM_TEXTURE_BASE_FORMAT_F32M: {
                 // Convert F32M to F32
-                texture_data_decompressed.resize(width * height * 4);
-                convert_f32m_to_f32(texture_data_decompressed.data(), pixels, width, height, pixels_per_stride);
-                pixels = texture_data_decompressed.data();
+                uint8_t *const texture_data_decompressed = output(width * height * 4, true);
+                convert_f32m_to_f32(texture_data_decompressed, pixels, width, height, pixels_per_stride);
+                pixels = texture_data_decompressed;
                 break;
-            default:
+            }
+            default: {
                 // Convert data
-                texture_pixels_lineared.resize(width * height * bytes_per_pixel);
+                uint8_t *const texture_pixels_lineared = output(width * height * bytes_per_pixel, !is_yuv);
 
                 if (is_swizzled)
-                    renderer::texture::swizzled_texture_to_linear_texture(texture_pixels_lineared.data(), reinterpret_cast<const uint8_t *>(pixels), width, height,
+                    renderer::texture::swizzled_texture_to_linear_texture(texture_pixels_lineared, reinterpret_cast<const uint8_t *>(pixels), width, height,
                         static_cast<std::uint8_t>(bpp));
                 else
-                    renderer::texture::tiled_texture_to_linear_texture(texture_pixels_lineared.data(), reinterpret_cast<const uint8_t *>(pixels), width, height,
+                    renderer::texture::tiled_texture_to_linear_texture(texture_pixels_lineared, reinterpret_cast<const uint8_t *>(pixels), width, height,
                         static_cast<std::uint8_t>(bpp));
 
-                pixels = texture_pixels_lineared.data();
-
-                if (need_decompress_and_unswizzle_on_cpu)
-                    texture_data_decompressed.clear();
+                pixels = texture_pixels_lineared;
                 break;
             }
+            }
 
             if ((texture_type == SCE_GXM_TEXTURE_SWIZZLED_ARBITRARY) || (texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY)) {
                 width = org_width;
@@ -421,7 +445,7 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
             pixels_per_stride = width;
         }
 
-        if (gxm::is_yuv_format(base_format)) {
+        if (is_yuv) {
             switch (fmt) {
             case SCE_GXM_TEXTURE_FORMAT_YUV420P2_CSC0:
             case SCE_GXM_TEXTURE_FORMAT_YVU420P2_CSC0:
@@ -431,10 +455,10 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
             case SCE_GXM_TEXTURE_FORMAT_YVU420P3_CSC0:
             case SCE_GXM_TEXTURE_FORMAT_YUV420P3_CSC1:
             case SCE_GXM_TEXTURE_FORMAT_YVU420P3_CSC1: {
-                yuv_texture_pixels.resize(width * height * 3);
-                renderer::texture::yuv420_texture_to_rgb(yuv_texture_pixels.data(),
+                uint8_t *const yuv_texture_pixels = output(width * height * 3, true);
+                renderer::texture::yuv420_texture_to_rgb(yuv_texture_pixels,
                     reinterpret_cast<const uint8_t *>(pixels), width, height);
-                pixels = yuv_texture_pixels.data();
+                pixels = yuv_texture_pixels;
                 pixels_per_stride = width;
                 break;
             }
@@ -454,25 +478,34 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
             }
         }
 
-        const GLenum format = translate_format(base_format);
-        const GLenum type = translate_type(base_format);
-
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(pixels_per_stride));
-
-        if (need_decompress_and_unswizzle_on_cpu)
-            glTexSubImage2D(upload_type, mip_index, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-        else {
+        if (!need_decompress_and_unswizzle_on_cpu) {
             size_t compressed_size = 0;
             if (renderer::texture::is_compressed_format(base_format, width, height, compressed_size)) {
                 source_size = compressed_size;
-                glCompressedTexSubImage2D(upload_type, mip_index, 0, 0, width, height, format, static_cast<GLsizei>(compressed_size), pixels);
+                level.compressed = true;
+                level.size = compressed_size;
             } else {
                 source_size = (width * height * ((bpp + 7) >> 3));
-                glTexSubImage2D(upload_type, mip_index, 0, 0, width, height, format, type, pixels);
             }
         }
 
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        if (pixels == texture_data) {
+            // Guest memory may have changed or be protected again by the time this is uploaded, so it's copied now
+            const size_t used_pixels = pixels_per_stride * (height - 1) + width;
+            const size_t level_size = level.compressed ? level.size : (used_pixels * bpp + 7) / 8;
+            std::memcpy(output(level_size, true), texture_data, level_size);
+        } else if (!pixels_staged) {
+            // Ended on an intermediate result, the staging buffer still needs a copy of it
+            const void *const intermediate = pixels;
+            std::memcpy(output(pixels_size, true), intermediate, pixels_size);
+        }
+
+        level.face = face_uploaded_count;
+        level.mip = mip_index;
+        level.width = width;
+        level.height = height;
+        level.row_length = static_cast<std::uint32_t>(pixels_per_stride);
+        decoded.levels.push_back(level);
 
         mip_index++;
         width /= 2;
@@ -488,8 +521,6 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
             width = org_width_const;
             height = org_height_const;
 
-            upload_type++;
-
             size_t source_unaligned_size = total_source_so_far;
             total_source_so_far = align(total_source_so_far, face_align_bytes);
 
@@ -498,6 +529,45 @@ void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem)
     }
 }
 
+void upload_decoded_texture(const renderer::texture::DecodedTexture &decoded) {
+    R_PROFILE(__func__);
+
+    const SceGxmTexture &gxm_texture = decoded.texture;
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(&gxm_texture));
+    const auto texture_type = gxm_texture.texture_type();
+    const bool is_swizzled = (texture_type == SCE_GXM_TEXTURE_SWIZZLED) || (texture_type == SCE_GXM_TEXTURE_CUBE) || (texture_type == SCE_GXM_TEXTURE_SWIZZLED_ARBITRARY) || (texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY);
+    const bool need_decompress_and_unswizzle_on_cpu = is_swizzled && !can_texture_be_unswizzled_without_decode(base_format);
+
+    // GXM's cube map index is same as OpenGL: right, left, top, bottom, front, back
+    const GLenum first_upload_type = ((texture_type == SCE_GXM_TEXTURE_CUBE) || (texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY)) ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : GL_TEXTURE_2D;
+    const GLenum format = translate_format(base_format);
+    const GLenum type = translate_type(base_format);
+
+    for (const auto &level : decoded.levels) {
+        const GLenum upload_type = first_upload_type + level.face;
+        const void *pixels = decoded.pixels(level);
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(level.row_length));
+
+        if (need_decompress_and_unswizzle_on_cpu)
+            glTexSubImage2D(upload_type, level.mip, 0, 0, level.width, level.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        else if (level.compressed)
+            glCompressedTexSubImage2D(upload_type, level.mip, 0, 0, level.width, level.height, format, static_cast<GLsizei>(level.size), pixels);
+        else
+            glTexSubImage2D(upload_type, level.mip, 0, 0, level.width, level.height, format, type, pixels);
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+}
+
+void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem) {
+    // Only used from the render thread, the buffers are kept from one upload to the next
+    static renderer::texture::DecodedTexture decoded;
+
+    decode_texture(gxm_texture, mem, decoded);
+    upload_decoded_texture(decoded);
+}
+
 // Dumps bound texture to a file
 void dump(const SceGxmTexture &gxm_texture, const MemState &mem, const std::string &parameter_name, const std::string &base_path, const std::string &title_id, Sha256Hash program_hash) {
     static uint32_t g_tex_index = 0;
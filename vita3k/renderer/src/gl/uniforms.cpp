@@ -70,8 +70,9 @@ bool set_uniform_buffer(GLContext &context, MemState &mem, const bool vertex_sha
     }
 
     if (log_active_shader) {
-        std::vector<uint8_t> my_data((uint8_t *)data, (uint8_t *)data + size);
-        context.ubo_data[base_binding_ubo_relative + block_num] = my_data;
+        // Reuses the storage of the previous upload to that block
+        const uint8_t *const bytes = static_cast<const uint8_t *>(data);
+        context.ubo_data[base_binding_ubo_relative + block_num].assign(bytes, bytes + size);
     }
 
     return true;
@@ -0,0 +1,280 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <renderer/functions.h>
+#include <renderer/profile.h>
+#include <renderer/state.h>
+#include <renderer/types.h>
+
+#include <renderer/null/functions.h>
+#include <renderer/null/state.h>
+#include <renderer/null/types.h>
+
+#include <crypto/hash.h>
+#include <features/state.h>
+#include <gxm/functions.h>
+#include <gxm/types.h>
+#include <mem/ptr.h>
+#include <shader/spirv_recompiler.h>
+#include <shader/usse_program_analyzer.h>
+#include <util/align.h>
+#include <util/log.h>
+
+namespace renderer::null {
+
+// Number of frames between two statistics reports in the log
+static constexpr std::uint64_t STATS_REPORT_INTERVAL = 600;
+
+NullFrameStats &NullFrameStats::operator+=(const NullFrameStats &rhs) {
+    batches += rhs.batches;
+    commands += rhs.commands;
+    draws += rhs.draws;
+    invalid_draws += rhs.invalid_draws;
+    texture_uploads += rhs.texture_uploads;
+    texture_bytes += rhs.texture_bytes;
+    shaders_translated += rhs.shaders_translated;
+    cpu_time += rhs.cpu_time;
+    return *this;
+}
+
+bool create(std::unique_ptr<renderer::State> &state, const char *base_path, const bool hashless_texture_cache) {
+    return state->init(base_path, hashless_texture_cache);
+}
+
+bool create(std::unique_ptr<Context> &context) {
+    context = std::make_unique<NullContext>();
+    return true;
+}
+
+bool create(std::unique_ptr<RenderTarget> &rt, const SceGxmRenderTargetParams &params) {
+    auto null_rt = std::make_unique<NullRenderTarget>();
+    null_rt->width = params.width;
+    null_rt->height = params.height;
+    rt = std::move(null_rt);
+    return true;
+}
+
+static void layout_uniform_buffers(ShaderProgram &program) {
+    std::uint32_t last_offset = 0;
+
+    for (std::size_t i = 0; i < program.uniform_buffer_sizes.size(); i++) {
+        if (program.uniform_buffer_sizes[i] != 0) {
+            program.uniform_buffer_data_offsets[i] = last_offset;
+            last_offset += ((program.uniform_buffer_sizes[i] + 3) / 4 * 4);
+        } else {
+            program.uniform_buffer_data_offsets[i] = static_cast<std::uint32_t>(-1);
+        }
+    }
+
+    program.max_total_uniform_buffer_storage = static_cast<std::size_t>(last_offset);
+}
+
+template <typename T>
+static bool create_program(std::unique_ptr<T> &program_data, std::unique_ptr<T> created, const SceGxmProgram &program, GXPPtrMap &gxp_ptr_map) {
+    const Sha256Hash hash_bytes = sha256(&program, program.size);
+    created->hash.assign(hash_bytes.begin(), hash_bytes.end());
+    gxp_ptr_map.emplace(hash_bytes, &program);
+
+    shader::usse::get_uniform_buffer_sizes(program, created->uniform_buffer_sizes);
+    layout_uniform_buffers(*created);
+
+    program_data = std::move(created);
+    return true;
+}
+
+bool create(std::unique_ptr<FragmentProgram> &fp, NullState &state, const SceGxmProgram &program, GXPPtrMap &gxp_ptr_map) {
+    return create_program<FragmentProgram>(fp, std::make_unique<NullFragmentProgram>(), program, gxp_ptr_map);
+}
+
+bool create(std::unique_ptr<VertexProgram> &vp, NullState &state, const SceGxmProgram &program, GXPPtrMap &gxp_ptr_map) {
+    return create_program<VertexProgram>(vp, std::make_unique<NullVertexProgram>(), program, gxp_ptr_map);
+}
+
+// Same CPU work the OpenGL backend does before handing the base level to the driver, the result is thrown away
+static size_t decode_texture(std::vector<std::uint8_t> &scratch, const SceGxmTexture &gxm_texture, const MemState &mem) {
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(&gxm_texture));
+    std::uint32_t width = static_cast<std::uint32_t>(gxm::get_width(&gxm_texture));
+    std::uint32_t height = static_cast<std::uint32_t>(gxm::get_height(&gxm_texture));
+    const std::uint8_t *data = Ptr<const std::uint8_t>(gxm_texture.data_addr << 2).get(mem);
+
+    if (!data || !width || !height) {
+        return 0;
+    }
+
+    const auto texture_type = gxm_texture.texture_type();
+    const bool is_arbitrary = (texture_type == SCE_GXM_TEXTURE_SWIZZLED_ARBITRARY) || (texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY);
+    const bool is_swizzled = (texture_type == SCE_GXM_TEXTURE_SWIZZLED) || (texture_type == SCE_GXM_TEXTURE_CUBE) || is_arbitrary;
+    const bool is_tiled = texture_type == SCE_GXM_TEXTURE_TILED;
+
+    if (is_arbitrary) {
+        width = nearest_power_of_two(width);
+        height = nearest_power_of_two(height);
+    }
+
+    if (gxm::is_paletted_format(base_format)) {
+        scratch.resize(width * height * 4);
+        const uint32_t *palette = texture::get_texture_palette(gxm_texture, mem);
+        if (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P8) {
+            texture::palette_texture_to_rgba_8(reinterpret_cast<std::uint32_t *>(scratch.data()), data, width, height, palette);
+        } else {
+            texture::palette_texture_to_rgba_4(reinterpret_cast<std::uint32_t *>(scratch.data()), data, width, height, palette);
+        }
+        return scratch.size();
+    }
+
+    switch (base_format) {
+    case SCE_GXM_TEXTURE_BASE_FORMAT_UBC1:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_UBC2:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_UBC3: {
+        if (!is_swizzled) {
+            // Uploaded compressed as is
+            return texture::texture_size(gxm_texture);
+        }
+
+        const std::uint8_t bc_type = (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_UBC1) ? 1 : ((base_format == SCE_GXM_TEXTURE_BASE_FORMAT_UBC2) ? 2 : 3);
+        scratch.resize(align(width, 4) * align(height, 4) * 4);
+        texture::decompress_bc_swizz_image(width, height, data, reinterpret_cast<std::uint32_t *>(scratch.data()), bc_type);
+        return scratch.size();
+    }
+
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRT2BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRT4BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII2BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII4BPP:
+        return texture::texture_size(gxm_texture);
+
+    default:
+        break;
+    }
+
+    if (!is_swizzled && !is_tiled) {
+        return texture::texture_size(gxm_texture);
+    }
+
+    const std::size_t bpp = texture::bits_per_pixel(base_format);
+    scratch.resize(width * height * ((bpp + 7) >> 3));
+    if (is_swizzled) {
+        texture::swizzled_texture_to_linear_texture(scratch.data(), data, width, height, static_cast<std::uint8_t>(bpp));
+    } else {
+        texture::tiled_texture_to_linear_texture(scratch.data(), data, width, height, static_cast<std::uint8_t>(bpp));
+    }
+
+    return scratch.size();
+}
+
+bool NullState::init(const char *base_path, const bool hashless_texture_cache) {
+    texture_cache.use_protect = hashless_texture_cache;
+    texture_cache.select_callback = [](std::size_t, const void *) {};
+    texture_cache.configure_texture_callback = [](std::size_t, const void *) {};
+    texture_cache.upload_texture_callback = [this](std::size_t, const void *texture, const MemState &mem) {
+        current_frame.texture_uploads++;
+        current_frame.texture_bytes += decode_texture(texture_scratch, *reinterpret_cast<const SceGxmTexture *>(texture), mem);
+    };
+
+    LOG_INFO("Using the null renderer, nothing will be displayed");
+    return true;
+}
+
+void NullState::render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &viewport_size, const DisplayState &display,
+    const MemState &mem) {
+    last_frame = current_frame;
+    total += current_frame;
+    current_frame = {};
+    frame_count++;
+
+    if (frame_count % STATS_REPORT_INTERVAL == 0) {
+        const auto average_us = std::chrono::duration_cast<std::chrono::microseconds>(total.cpu_time).count() / static_cast<std::int64_t>(frame_count);
+        LOG_INFO("Null renderer, {} frames: {} us CPU per frame, {} batches, {} commands, {} draws ({} invalid), {} texture uploads ({} bytes), {} shaders translated",
+            frame_count, average_us, total.batches, total.commands, total.draws, total.invalid_draws, total.texture_uploads, total.texture_bytes,
+            total.shaders_translated);
+    }
+}
+
+void sync_texture(NullState &state, MemState &mem, const SceGxmTexture &texture) {
+    R_PROFILE(__func__);
+
+    if (texture.data_addr == 0) {
+        return;
+    }
+
+    texture::cache_and_bind_texture(state.texture_cache, texture, mem);
+}
+
+static void translate_shader(NullState &state, const FeatureState &features, const SceGxmProgram &program, const std::string &hash,
+    const std::vector<SceGxmVertexAttribute> *hint_attributes, bool maskupdate) {
+    if (!state.translated_shaders.insert(hash).second) {
+        return;
+    }
+
+    shader::convert_gxp_to_glsl(program, hash, features, hint_attributes, maskupdate);
+    state.current_frame.shaders_translated++;
+}
+
+static bool validate_draw(const NullContext &context, const SceGxmVertexProgram *vertex_program, const SceGxmFragmentProgram *fragment_program,
+    const void *indices, size_t count) {
+    if (!context.current_render_target) {
+        LOG_ERROR("Draw without a render target");
+        return false;
+    }
+
+    if (!vertex_program || !fragment_program || !vertex_program->renderer_data || !fragment_program->renderer_data) {
+        LOG_ERROR("Draw without a vertex or fragment program");
+        return false;
+    }
+
+    if (!indices || count == 0) {
+        LOG_ERROR("Draw without indices");
+        return false;
+    }
+
+    for (size_t stream = 0; stream < vertex_program->streams.size() && stream < SCE_GXM_MAX_VERTEX_STREAMS; stream++) {
+        if (!context.record.vertex_streams[stream].data) {
+            LOG_ERROR("Draw with vertex stream {} unset", stream);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void draw(NullState &state, NullContext &context, const FeatureState &features, SceGxmPrimitiveType type, SceGxmIndexFormat format,
+    void *indices, size_t count, uint32_t instance_count, const MemState &mem) {
+    R_PROFILE(__func__);
+
+    const SceGxmVertexProgram *vertex_program = context.record.vertex_program.get(mem);
+    const SceGxmFragmentProgram *fragment_program = context.record.fragment_program.get(mem);
+
+    state.current_frame.draws++;
+
+    if (!validate_draw(context, vertex_program, fragment_program, indices, count)) {
+        state.current_frame.invalid_draws++;
+    } else {
+        translate_shader(state, features, *fragment_program->program.get(mem), fragment_program->renderer_data->hash, nullptr, context.record.is_maskupdate);
+        translate_shader(state, features, *vertex_program->program.get(mem), vertex_program->renderer_data->hash, &vertex_program->attributes, false);
+    }
+
+    delete[] reinterpret_cast<std::uint8_t *>(indices);
+}
+
+void account_batch(NullState &state, std::uint32_t command_count, std::chrono::nanoseconds cpu_time) {
+    state.current_frame.batches++;
+    state.current_frame.commands += command_count;
+    state.current_frame.cpu_time += cpu_time;
+}
+
+} // namespace renderer::null
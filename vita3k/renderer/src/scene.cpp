@@ -21,8 +21,10 @@
 #include <renderer/types.h>
 
 #include "driver_functions.h"
+#include <renderer/command_payloads.h>
 #include <renderer/gl/functions.h>
 #include <renderer/gl/types.h>
+#include <renderer/null/functions.h>
 
 #include <config/state.h>
 #include <renderer/functions.h>
@@ -37,9 +39,10 @@
 
 namespace renderer {
 COMMAND(handle_set_context) {
-    const RenderTarget *rt = helper.pop<const RenderTarget *>();
-    const SceGxmColorSurface *color_surface = helper.pop<SceGxmColorSurface *>();
-    const SceGxmDepthStencilSurface *depth_stencil_surface = helper.pop<SceGxmDepthStencilSurface *>();
+    const auto args = helper.pop<payload::SetContext>();
+    const RenderTarget *rt = args.render_target;
+    const SceGxmColorSurface *color_surface = args.color_surface;
+    const SceGxmDepthStencilSurface *depth_stencil_surface = args.depth_stencil_surface;
 
     if (rt) {
         render_context->current_render_target = rt;
@@ -84,9 +87,9 @@ COMMAND(handle_sync_surface_data) {
 
     switch (renderer.current_backend) {
     case Backend::OpenGL: {
-        //gl::get_surface_data(static_cast<gl::GLState &>(renderer), *reinterpret_cast<gl::GLContext *>(render_context), width, height,
-        //    stride_in_pixels, pixels, render_context->record.color_surface.colorFormat);
-
+        // Only queued here, the pixels reach guest memory the first time something touches it
+        static_cast<gl::GLState &>(renderer).surface_readback.request(mem, data, width, height, stride_in_pixels,
+            render_context->record.color_surface.colorFormat, render_context->record.color_surface.surfaceType == SCE_GXM_COLOR_SURFACE_TILED);
         break;
     }
 
@@ -110,16 +113,19 @@ COMMAND(handle_sync_surface_data) {
 }
 
 COMMAND(handle_draw) {
-    SceGxmPrimitiveType type = helper.pop<SceGxmPrimitiveType>();
-    SceGxmIndexFormat format = helper.pop<SceGxmIndexFormat>();
-    void *indicies = helper.pop<void *>();
-    const std::uint32_t count = helper.pop<const std::uint32_t>();
-    const std::uint32_t instance_count = helper.pop<const std::uint32_t>();
+    const auto args = helper.pop<payload::Draw>();
 
     switch (renderer.current_backend) {
     case Backend::OpenGL: {
         gl::draw(static_cast<gl::GLState &>(renderer), *reinterpret_cast<gl::GLContext *>(render_context),
-            features, type, format, indicies, count, instance_count, mem, base_path, title_id, config);
+            features, args.type, args.format, args.indices, args.count, args.instance_count, mem, base_path, title_id, config);
+
+        break;
+    }
+
+    case Backend::Null: {
+        null::draw(static_cast<null::NullState &>(renderer), *reinterpret_cast<null::NullContext *>(render_context),
+            features, args.type, args.format, args.indices, args.count, args.instance_count, mem);
 
         break;
     }
@@ -23,26 +23,27 @@
 #include <renderer/gl/functions.h>
 #include <renderer/gl/state.h>
 #include <renderer/gl/types.h>
+#include <renderer/null/functions.h>
 
 #include "driver_functions.h"
+#include <renderer/command_payloads.h>
 
 #include <util/align.h>
 #include <util/log.h>
 
 #include <config/state.h>
 
+#include <array>
+
 namespace renderer {
 COMMAND_SET_STATE(region_clip) {
-    render_context->record.region_clip_mode = helper.pop<SceGxmRegionClipMode>();
-    const std::uint32_t xMin = helper.pop<std::uint32_t>();
-    const std::uint32_t xMax = helper.pop<std::uint32_t>();
-    const std::uint32_t yMin = helper.pop<std::uint32_t>();
-    const std::uint32_t yMax = helper.pop<std::uint32_t>();
+    const auto args = helper.pop<payload::RegionClip>();
 
-    render_context->record.region_clip_min.x = static_cast<SceInt>(align_down(xMin, SCE_GXM_TILE_SIZEX));
-    render_context->record.region_clip_min.y = static_cast<SceInt>(align_down(yMin, SCE_GXM_TILE_SIZEY));
-    render_context->record.region_clip_max.x = static_cast<SceInt>(align(xMax, SCE_GXM_TILE_SIZEX));
-    render_context->record.region_clip_max.y = static_cast<SceInt>(align(yMax, SCE_GXM_TILE_SIZEY));
+    render_context->record.region_clip_mode = args.mode;
+    render_context->record.region_clip_min.x = static_cast<SceInt>(align_down(args.x_min, SCE_GXM_TILE_SIZEX));
+    render_context->record.region_clip_min.y = static_cast<SceInt>(align_down(args.y_min, SCE_GXM_TILE_SIZEY));
+    render_context->record.region_clip_max.x = static_cast<SceInt>(align(args.x_max, SCE_GXM_TILE_SIZEX));
+    render_context->record.region_clip_max.y = static_cast<SceInt>(align(args.y_max, SCE_GXM_TILE_SIZEY));
 
     switch (renderer.current_backend) {
     case Backend::OpenGL: {
@@ -57,10 +58,10 @@ COMMAND_SET_STATE(region_clip) {
 }
 
 COMMAND_SET_STATE(program) {
-    const Ptr<const void> program = helper.pop<Ptr<const void>>();
-    const bool is_fragment = helper.pop<bool>();
+    const auto args = helper.pop<payload::Program>();
+    const Ptr<const void> program = args.program;
 
-    if (is_fragment) {
+    if (args.is_fragment) {
         render_context->record.fragment_program = program.cast<const SceGxmFragmentProgram>();
         const bool is_maskupdate = render_context->record.fragment_program.get(mem)->is_maskupdate;
         render_context->record.is_maskupdate = is_maskupdate;
@@ -81,16 +82,14 @@ COMMAND_SET_STATE(program) {
 }
 
 COMMAND_SET_STATE(uniform) {
-    const bool is_vertex = helper.pop<bool>();
-    const SceGxmProgramParameter *parameter = helper.pop<SceGxmProgramParameter *>();
-    const void *data = helper.pop<const void *>();
+    const auto args = helper.pop<payload::Uniform>();
 
     switch (renderer.current_backend) {
     case Backend::OpenGL: {
-        gl::UniformSetRequest request{ parameter, data };
+        gl::UniformSetRequest request{ args.parameter, args.data };
         gl::GLContext *gl_context = reinterpret_cast<gl::GLContext *>(render_context);
 
-        if (is_vertex) {
+        if (args.is_vertex) {
             gl_context->vertex_set_requests.push_back(std::move(request));
         } else {
             gl_context->fragment_set_requests.push_back(std::move(request));
@@ -106,14 +105,11 @@ COMMAND_SET_STATE(uniform) {
 }
 
 COMMAND_SET_STATE(uniform_buffer) {
-    std::uint8_t *data = helper.pop<std::uint8_t *>();
-    const bool is_vertex = helper.pop<bool>();
-    const int block_num = helper.pop<int>();
-    const std::uint32_t size = helper.pop<std::uint32_t>();
+    const auto args = helper.pop<payload::UniformBuffer>();
 
     switch (renderer.current_backend) {
     case Backend::OpenGL: {
-        gl::set_uniform_buffer(*reinterpret_cast<gl::GLContext *>(render_context), mem, is_vertex, block_num, size, data, config.log_active_shaders);
+        gl::set_uniform_buffer(*reinterpret_cast<gl::GLContext *>(render_context), mem, args.is_vertex, args.block_num, args.size, args.data, config.log_active_shaders);
         break;
     }
 
@@ -122,23 +118,17 @@ COMMAND_SET_STATE(uniform_buffer) {
         break;
     }
 
-    delete[] data;
+    delete[] args.data;
 }
 
 COMMAND_SET_STATE(viewport) {
-    const bool flat = helper.pop<bool>();
-
-    if (!flat) {
-        const float xOffset = helper.pop<float>();
-        const float yOffset = helper.pop<float>();
-        const float zOffset = helper.pop<float>();
-        const float xScale = helper.pop<float>();
-        const float yScale = helper.pop<float>();
-        const float zScale = helper.pop<float>();
+    const auto args = helper.pop<payload::Viewport>();
 
+    if (!args.flat) {
         switch (renderer.current_backend) {
         case Backend::OpenGL:
-            gl::sync_viewport_real(*reinterpret_cast<gl::GLContext *>(render_context), xOffset, yOffset, zOffset, xScale, yScale, zScale);
+            gl::sync_viewport_real(*reinterpret_cast<gl::GLContext *>(render_context), args.x_offset, args.y_offset, args.z_offset,
+                args.x_scale, args.y_scale, args.z_scale);
             break;
 
         default:
@@ -159,14 +149,12 @@ COMMAND_SET_STATE(viewport) {
 }
 
 COMMAND_SET_STATE(depth_bias) {
-    const bool is_front = helper.pop<bool>();
-    const int factor = helper.pop<int>();
-    const int unit = helper.pop<int>();
+    const auto args = helper.pop<payload::DepthBias>();
 
     switch (renderer.current_backend) {
     case Backend::OpenGL: {
-        if (is_front) {
-            gl::sync_depth_bias(factor, unit, is_front);
+        if (args.is_front) {
+            gl::sync_depth_bias(args.factor, args.units, args.is_front);
         } else {
             // LOG_INFO("AAAA");
         }
@@ -181,8 +169,9 @@ COMMAND_SET_STATE(depth_bias) {
 }
 
 COMMAND_SET_STATE(depth_func) {
-    const bool is_front = helper.pop<bool>();
-    const SceGxmDepthFunc depth_func = helper.pop<SceGxmDepthFunc>();
+    const auto args = helper.pop<payload::DepthFunc>();
+    const bool is_front = args.is_front;
+    const SceGxmDepthFunc depth_func = args.func;
 
     if (is_front) {
         render_context->record.front_depth_func = depth_func;
@@ -203,8 +192,9 @@ COMMAND_SET_STATE(depth_func) {
 }
 
 COMMAND_SET_STATE(depth_write_enable) {
-    const bool is_front = helper.pop<bool>();
-    const SceGxmDepthWriteMode mode = helper.pop<SceGxmDepthWriteMode>();
+    const auto args = helper.pop<payload::DepthWriteEnable>();
+    const bool is_front = args.is_front;
+    const SceGxmDepthWriteMode mode = args.mode;
 
     if (is_front)
         render_context->record.front_depth_write_mode = mode;
@@ -224,12 +214,11 @@ COMMAND_SET_STATE(depth_write_enable) {
 }
 
 COMMAND_SET_STATE(polygon_mode) {
-    const bool is_front = helper.pop<bool>();
-    const SceGxmPolygonMode mode = helper.pop<SceGxmPolygonMode>();
+    const auto args = helper.pop<payload::PolygonMode>();
 
     switch (renderer.current_backend) {
     case Backend::OpenGL:
-        gl::sync_polygon_mode(mode, is_front);
+        gl::sync_polygon_mode(args.mode, args.is_front);
         break;
 
     default:
@@ -239,12 +228,11 @@ COMMAND_SET_STATE(polygon_mode) {
 }
 
 COMMAND_SET_STATE(point_line_width) {
-    const bool is_front = helper.pop<bool>();
-    const std::uint32_t width = helper.pop<std::uint32_t>();
+    const auto args = helper.pop<payload::PointLineWidth>();
 
     switch (renderer.current_backend) {
     case Backend::OpenGL: {
-        gl::sync_point_line_width(width, is_front);
+        gl::sync_point_line_width(args.width, args.is_front);
         break;
     }
 
@@ -256,15 +244,16 @@ COMMAND_SET_STATE(point_line_width) {
 
 COMMAND_SET_STATE(stencil_func) {
     // Is this the pain that driver guys have to suffer?
-    const bool is_front = helper.pop<bool>();
+    const auto args = helper.pop<payload::StencilFunc>();
+    const bool is_front = args.is_front;
     GxmStencilState stencil_state;
 
-    stencil_state.func = helper.pop<SceGxmStencilFunc>();
-    stencil_state.stencil_fail = helper.pop<SceGxmStencilOp>();
-    stencil_state.depth_fail = helper.pop<SceGxmStencilOp>();
-    stencil_state.depth_pass = helper.pop<SceGxmStencilOp>();
-    stencil_state.compare_mask = helper.pop<std::uint8_t>();
-    stencil_state.write_mask = helper.pop<std::uint8_t>();
+    stencil_state.func = args.func;
+    stencil_state.stencil_fail = args.stencil_fail;
+    stencil_state.depth_fail = args.depth_fail;
+    stencil_state.depth_pass = args.depth_pass;
+    stencil_state.compare_mask = args.compare_mask;
+    stencil_state.write_mask = args.write_mask;
 
     if (render_context->record.is_maskupdate) {
         if (stencil_state.func == SCE_GXM_STENCIL_FUNC_NEVER) {
@@ -298,19 +287,19 @@ COMMAND_SET_STATE(stencil_func) {
 COMMAND_SET_STATE(stencil_ref) {
     REPORT_STUBBED();
 
-    const bool is_front = helper.pop<bool>();
-    const unsigned char sref = helper.pop<const unsigned char>();
+    const auto args = helper.pop<payload::StencilRef>();
 
-    if (is_front) {
-        render_context->record.front_stencil_state.ref = sref;
+    if (args.is_front) {
+        render_context->record.front_stencil_state.ref = args.ref;
     } else {
-        render_context->record.back_stencil_state.ref = sref;
+        render_context->record.back_stencil_state.ref = args.ref;
     }
 }
 
 COMMAND_SET_STATE(texture) {
-    const std::uint32_t texture_index = helper.pop<std::uint32_t>();
-    SceGxmTexture texture = helper.pop<SceGxmTexture>();
+    const auto args = helper.pop<payload::Texture>();
+    const std::uint32_t texture_index = args.index;
+    const SceGxmTexture texture = args.texture;
 
     switch (renderer.current_backend) {
     case Backend::OpenGL:
@@ -318,6 +307,10 @@ COMMAND_SET_STATE(texture) {
             config, base_path, title_id);
         break;
 
+    case Backend::Null:
+        null::sync_texture(static_cast<null::NullState &>(renderer), mem, texture);
+        break;
+
     default:
         REPORT_MISSING(renderer.current_backend);
         break;
@@ -325,12 +318,11 @@ COMMAND_SET_STATE(texture) {
 }
 
 COMMAND_SET_STATE(two_sided) {
-    const SceGxmTwoSidedMode two_sided = helper.pop<SceGxmTwoSidedMode>();
-    render_context->record.two_sided = two_sided;
+    render_context->record.two_sided = helper.pop<payload::TwoSided>().mode;
 }
 
 COMMAND_SET_STATE(cull_mode) {
-    render_context->record.cull_mode = helper.pop<SceGxmCullMode>();
+    render_context->record.cull_mode = helper.pop<payload::CullMode>().mode;
 
     switch (renderer.current_backend) {
     case Backend::OpenGL: {
@@ -345,18 +337,17 @@ COMMAND_SET_STATE(cull_mode) {
 }
 
 COMMAND_SET_STATE(vertex_stream) {
-    std::uint8_t *stream_data = helper.pop<std::uint8_t *>();
-    const std::size_t stream_index = helper.pop<std::size_t>();
-    const std::size_t stream_data_length = helper.pop<std::size_t>();
+    const auto args = helper.pop<payload::VertexStream>();
 
     switch (renderer.current_backend) {
-    case Backend::OpenGL: {
-        renderer::GXMStreamInfo &info = render_context->record.vertex_streams[stream_index];
+    case Backend::OpenGL:
+    case Backend::Null: {
+        renderer::GXMStreamInfo &info = render_context->record.vertex_streams[args.index];
         if (info.data) {
             delete info.data;
         }
-        info.data = stream_data;
-        info.size = stream_data_length;
+        info.data = args.data;
+        info.size = args.size;
 
         break;
     }
@@ -368,45 +359,43 @@ COMMAND_SET_STATE(vertex_stream) {
 }
 
 COMMAND_SET_STATE(fragment_program_enable) {
-    const bool is_front = helper.pop<bool>();
-    const SceGxmFragmentProgramMode mode = helper.pop<SceGxmFragmentProgramMode>();
+    const auto args = helper.pop<payload::FragmentProgramEnable>();
 
-    if (is_front)
-        render_context->record.front_side_fragment_program_mode = mode;
+    if (args.is_front)
+        render_context->record.front_side_fragment_program_mode = args.mode;
     else
-        render_context->record.back_side_fragment_program_mode = mode;
+        render_context->record.back_side_fragment_program_mode = args.mode;
 }
 
 COMMAND(handle_set_state) {
-    renderer::GXMState gxm_state_to_set = helper.pop<renderer::GXMState>();
-    using StateChangeHandlerFunc = std::function<void(renderer::State &, MemState &, Config &, CommandHelper &,
-        Context *, const char *base_path, const char *title_id)>;
-
-    static const std::map<renderer::GXMState, StateChangeHandlerFunc> handlers = {
-        { renderer::GXMState::RegionClip, cmd_set_state_region_clip },
-        { renderer::GXMState::Program, cmd_set_state_program },
-        { renderer::GXMState::Viewport, cmd_set_state_viewport },
-        { renderer::GXMState::DepthBias, cmd_set_state_depth_bias },
-        { renderer::GXMState::DepthFunc, cmd_set_state_depth_func },
-        { renderer::GXMState::DepthWriteEnable, cmd_set_state_depth_write_enable },
-        { renderer::GXMState::PolygonMode, cmd_set_state_polygon_mode },
-        { renderer::GXMState::PointLineWidth, cmd_set_state_point_line_width },
-        { renderer::GXMState::StencilFunc, cmd_set_state_stencil_func },
-        { renderer::GXMState::Texture, cmd_set_state_texture },
-        { renderer::GXMState::StencilRef, cmd_set_state_stencil_ref },
-        { renderer::GXMState::TwoSided, cmd_set_state_two_sided },
-        { renderer::GXMState::CullMode, cmd_set_state_cull_mode },
-        { renderer::GXMState::VertexStream, cmd_set_state_vertex_stream },
-        { renderer::GXMState::Uniform, cmd_set_state_uniform },
-        { renderer::GXMState::UniformBuffer, cmd_set_state_uniform_buffer },
-        { renderer::GXMState::FragmentProgramEnable, cmd_set_state_fragment_program_enable }
-    };
-
-    auto result = handlers.find(gxm_state_to_set);
-
-    if (result != handlers.end()) {
-        // LOG_TRACE("State set: {}", (int)gxm_state_to_set);
-        result->second(renderer, mem, config, helper, render_context, base_path, title_id);
+    using StateChangeHandlerFunc = void (*)(renderer::State &, MemState &, Config &, CommandHelper &,
+        Context *, const char *base_path, const char *title_id);
+
+    static constexpr auto handlers = [] {
+        std::array<StateChangeHandlerFunc, static_cast<std::size_t>(GXMState::TotalState)> table{};
+        table[static_cast<std::size_t>(GXMState::RegionClip)] = cmd_set_state_region_clip;
+        table[static_cast<std::size_t>(GXMState::Program)] = cmd_set_state_program;
+        table[static_cast<std::size_t>(GXMState::Viewport)] = cmd_set_state_viewport;
+        table[static_cast<std::size_t>(GXMState::DepthBias)] = cmd_set_state_depth_bias;
+        table[static_cast<std::size_t>(GXMState::DepthFunc)] = cmd_set_state_depth_func;
+        table[static_cast<std::size_t>(GXMState::DepthWriteEnable)] = cmd_set_state_depth_write_enable;
+        table[static_cast<std::size_t>(GXMState::PolygonMode)] = cmd_set_state_polygon_mode;
+        table[static_cast<std::size_t>(GXMState::PointLineWidth)] = cmd_set_state_point_line_width;
+        table[static_cast<std::size_t>(GXMState::StencilFunc)] = cmd_set_state_stencil_func;
+        table[static_cast<std::size_t>(GXMState::Texture)] = cmd_set_state_texture;
+        table[static_cast<std::size_t>(GXMState::StencilRef)] = cmd_set_state_stencil_ref;
+        table[static_cast<std::size_t>(GXMState::TwoSided)] = cmd_set_state_two_sided;
+        table[static_cast<std::size_t>(GXMState::CullMode)] = cmd_set_state_cull_mode;
+        table[static_cast<std::size_t>(GXMState::VertexStream)] = cmd_set_state_vertex_stream;
+        table[static_cast<std::size_t>(GXMState::Uniform)] = cmd_set_state_uniform;
+        table[static_cast<std::size_t>(GXMState::UniformBuffer)] = cmd_set_state_uniform_buffer;
+        table[static_cast<std::size_t>(GXMState::FragmentProgramEnable)] = cmd_set_state_fragment_program_enable;
+        return table;
+    }();
+
+    const auto state = static_cast<std::size_t>(helper.pop<payload::SetState>().state);
+    if (state < handlers.size() && handlers[state]) {
+        handlers[state](renderer, mem, config, helper, render_context, base_path, title_id);
     }
 }
 } // namespace renderer
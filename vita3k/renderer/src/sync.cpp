@@ -22,6 +22,7 @@
 #include <renderer/types.h>
 
 #include "driver_functions.h"
+#include <renderer/command_payloads.h>
 #include <renderer/gl/functions.h>
 
 #include <renderer/functions.h>
@@ -30,22 +31,22 @@
 namespace renderer {
 COMMAND(handle_nop) {
     // Signal back to client
-    int code_to_finish = helper.pop<int>();
-    complete_command(renderer, helper, code_to_finish);
+    complete_command(renderer, helper, helper.pop<payload::Nop>().code_to_finish);
 }
 
 COMMAND(handle_signal_sync_object) {
-    SceGxmSyncObject *sync = helper.pop<Ptr<SceGxmSyncObject>>().get(mem);
+    SceGxmSyncObject *sync = helper.pop<payload::SignalSyncObject>().sync.get(mem);
     renderer::subject_done(sync, renderer::SyncObjectSubject::Fragment);
 }
 
 COMMAND(handle_notification) {
-    SceGxmNotification *nof = helper.pop<Ptr<SceGxmNotification>>().get(mem);
-    [[maybe_unused]] const bool is_vertex = helper.pop<bool>();
+    SceGxmNotification *nof = helper.pop<payload::SignalNotification>().notification.get(mem);
 
     volatile std::uint32_t *val = nof->address.get(mem);
-    if (val) // Ratchet and clank Trilogy request this
+    if (val) { // Ratchet and clank Trilogy request this
         *val = nof->value;
+        renderer.notification_waiters.notify(val);
+    }
 }
 
 // Client side function
@@ -54,17 +55,14 @@ void finish(State &state, Context &context) {
     wait_for_status(state, &context.render_finish_status, state.last_scene_id, true);
 }
 
-int wait_for_status(State &state, int *status, int signal, bool wake_on_equal) {
-    std::unique_lock<std::mutex> lock(state.command_finish_one_mutex);
-    const bool wake_on_unequal = !wake_on_equal;
-    if ((*status == signal) ^ wake_on_unequal) {
-        // Signaled, return
-        return *status;
+int wait_for_status(State &state, std::atomic<int> *status, int signal, bool wake_on_equal) {
+    const auto signaled = [&]() { return (status->load(std::memory_order_acquire) == signal) == wake_on_equal; };
+    if (!signaled()) {
+        // Wait for it to get signaled
+        state.status_waiters.wait(status, signaled);
     }
 
-    // Wait for it to get signaled
-    state.command_finish_one.wait(lock, [&]() { return (*status == signal) ^ wake_on_unequal; });
-    return *status;
+    return status->load(std::memory_order_acquire);
 }
 
 void wishlist(SceGxmSyncObject *sync_object, const SyncObjectSubject subjects) {
@@ -96,6 +94,6 @@ void subject_in_progress(SceGxmSyncObject *sync_object, const SyncObjectSubject
 
 void submit_command_list(State &state, renderer::Context *context, CommandList &command_list) {
     command_list.context = context;
-    state.command_buffer_queue.push(std::move(command_list));
+    state.command_buffer_queue.push(command_list);
 }
 } // namespace renderer
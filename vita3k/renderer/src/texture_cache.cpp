@@ -88,6 +88,14 @@ void cache_and_bind_texture(TextureCacheState &cache, const SceGxmTexture &gxm_t
     bool upload = false;
     const size_t size = texture_size(gxm_texture);
 
+    if (cache.resolve_callback) {
+        // The decode reads the whole mip chain and every face, not only the base level
+        cache.resolve_callback(gxm_texture.data_addr << 2, texture_memory_size(gxm_texture));
+        const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(&gxm_texture));
+        if (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P4 || base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P8)
+            cache.resolve_callback(gxm_texture.palette_addr << 6, (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P4 ? 16 : 256) * sizeof(uint32_t));
+    }
+
     // Try to find GXM texture in cache.
     int cached_gxm_texture_index = -1;
     for (size_t a = 0; a < cache.used; a++) {
@@ -142,10 +150,17 @@ void cache_and_bind_texture(TextureCacheState &cache, const SceGxmTexture &gxm_t
     cache.select_callback(index, &gxm_texture);
 
     if (configure) {
+        if (cache.decoder) {
+            cache.decoder->cancel(index);
+        }
         cache.configure_texture_callback(index, &gxm_texture);
     }
     if (upload) {
-        cache.upload_texture_callback(index, &gxm_texture, mem);
+        if (cache.decoder) {
+            cache.decoder->request(index, gxm_texture, mem);
+        } else {
+            cache.upload_texture_callback(index, &gxm_texture, mem);
+        }
         if (!info->use_hash) {
             info->dirty = false;
             add_write_protect(mem, gxm_texture.data_addr << 2, size, [&cache, info, gxm_texture] {
@@ -156,8 +171,30 @@ void cache_and_bind_texture(TextureCacheState &cache, const SceGxmTexture &gxm_t
         }
     }
 
+    if (cache.decoder) {
+        // Until its decode is done, a slot keeps what it held before (nothing yet for a new one)
+        if (auto decoded = cache.decoder->take(index, cache.wait_for_decode)) {
+            cache.upload_decoded_callback(index, *decoded);
+            cache.decoder->recycle(std::move(decoded));
+        }
+    }
+
     info->timestamp = cache.timestamp++;
 }
 
+void upload_finished_decodes(TextureCacheState &cache) {
+    R_PROFILE(__func__);
+
+    if (!cache.decoder) {
+        return;
+    }
+
+    // A pending job always belongs to the texture its slot holds, configuring the slot again cancels it
+    cache.decoder->take_finished([&cache](std::size_t index, const DecodedTexture &decoded) {
+        cache.select_callback(index, &decoded.texture);
+        cache.upload_decoded_callback(index, decoded);
+    });
+}
+
 } // namespace texture
 } // namespace renderer
@@ -0,0 +1,156 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <renderer/profile.h>
+#include <renderer/texture_decoder.h>
+
+#include <chrono>
+
+namespace renderer::texture {
+// Past that many idle decoded textures, released ones are freed instead of kept
+static constexpr std::size_t MAX_POOLED_TEXTURES = 32;
+// How long the render thread waits on a decode between two calls to the wait callback
+static constexpr auto DECODE_WAIT_SLICE = std::chrono::milliseconds(1);
+
+DecodedTexturePtr StagingPool::acquire() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (!free_list.empty()) {
+            DecodedTexturePtr decoded = std::move(free_list.back());
+            free_list.pop_back();
+            return decoded;
+        }
+    }
+
+    return std::make_unique<DecodedTexture>();
+}
+
+void StagingPool::release(DecodedTexturePtr decoded) {
+    if (!decoded) {
+        return;
+    }
+
+    decoded->clear();
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (free_list.size() < MAX_POOLED_TEXTURES) {
+        free_list.push_back(std::move(decoded));
+    }
+}
+
+std::size_t StagingPool::pooled() const {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return free_list.size();
+}
+
+TextureDecoder::TextureDecoder(TextureDecodeFunc decode, std::size_t thread_count)
+    : decode(std::move(decode))
+    , workers(thread_count) {
+}
+
+void TextureDecoder::request(std::size_t index, const SceGxmTexture &texture, const MemState &mem) {
+    R_PROFILE(__func__);
+
+    reap_orphans();
+    cancel(index);
+
+    jobs.emplace(index, workers.submit([this, texture, &mem]() {
+        DecodedTexturePtr decoded = pool.acquire();
+        decoded->texture = texture;
+        decode(texture, mem, *decoded);
+        return decoded;
+    }));
+}
+
+DecodedTexturePtr TextureDecoder::take(std::size_t index, bool wait) {
+    R_PROFILE(__func__);
+
+    const auto job = jobs.find(index);
+    if (job == jobs.end()) {
+        return nullptr;
+    }
+
+    if (wait) {
+        // Not decoded on this thread even if no worker picked it up yet: a worker blocked on guest memory the render
+        // thread has to write back would never be released
+        while (job->second.wait_for(DECODE_WAIT_SLICE) != std::future_status::ready) {
+            if (wait_callback)
+                wait_callback();
+        }
+        DecodedTexturePtr decoded = job->second.get();
+        jobs.erase(job);
+        return decoded;
+    }
+
+    if (job->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return nullptr;
+    }
+
+    DecodedTexturePtr decoded = job->second.get();
+    jobs.erase(job);
+    return decoded;
+}
+
+void TextureDecoder::take_finished(const TextureDecodedFunc &upload) {
+    R_PROFILE(__func__);
+
+    reap_orphans();
+
+    for (auto job = jobs.begin(); job != jobs.end();) {
+        if (job->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++job;
+            continue;
+        }
+
+        DecodedTexturePtr decoded = job->second.get();
+        upload(job->first, *decoded);
+        pool.release(std::move(decoded));
+        job = jobs.erase(job);
+    }
+}
+
+void TextureDecoder::cancel(std::size_t index) {
+    const auto job = jobs.find(index);
+    if (job == jobs.end()) {
+        return;
+    }
+
+    // The job can't be stopped, keep its future around to get the staging buffer back
+    orphans.push_back(std::move(job->second));
+    jobs.erase(job);
+}
+
+void TextureDecoder::recycle(DecodedTexturePtr decoded) {
+    pool.release(std::move(decoded));
+}
+
+bool TextureDecoder::pending(std::size_t index) const {
+    return jobs.find(index) != jobs.end();
+}
+
+void TextureDecoder::reap_orphans() {
+    for (auto orphan = orphans.begin(); orphan != orphans.end();) {
+        if (orphan->wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            pool.release(orphan->get());
+            orphan = orphans.erase(orphan);
+        } else {
+            ++orphan;
+        }
+    }
+}
+} // namespace renderer::texture
@@ -22,6 +22,7 @@
 
 #include <gxm/functions.h>
 #include <gxm/types.h>
+#include <util/align.h>
 
 namespace renderer::texture {
 
@@ -111,6 +112,37 @@ size_t texture_size(const SceGxmTexture &texture) {
     return size;
 }
 
+size_t texture_memory_size(const SceGxmTexture &texture) {
+    const SceGxmTextureFormat format = gxm::get_format(&texture);
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(format);
+    const size_t bpp = bits_per_pixel(base_format);
+    const auto texture_type = texture.texture_type();
+
+    if (texture_type == SCE_GXM_TEXTURE_LINEAR_STRIDED)
+        return gxm::get_stride_in_bytes(&texture) * gxm::get_height(&texture);
+
+    std::uint32_t width = static_cast<std::uint32_t>(gxm::get_width(&texture));
+    std::uint32_t height = static_cast<std::uint32_t>(gxm::get_height(&texture));
+    if ((texture_type == SCE_GXM_TEXTURE_SWIZZLED_ARBITRARY) || (texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY)) {
+        width = nearest_power_of_two(width);
+        height = nearest_power_of_two(height);
+    }
+
+    // Rounding every level up to whole compressed blocks and linear rows keeps this an upper bound for all layouts
+    size_t face_size = 0;
+    for (std::uint32_t mip = 0; (mip < texture.true_mip_count()) && width && height; mip++) {
+        face_size += (bpp * align(width, 8) * align(height, 4)) / 8;
+        width /= 2;
+        height /= 2;
+    }
+
+    if ((texture_type != SCE_GXM_TEXTURE_CUBE) && (texture_type != SCE_GXM_TEXTURE_CUBE_ARBITRARY))
+        return face_size;
+
+    // Faces are at most 2KB aligned
+    return align(face_size, 2048) * 5 + face_size;
+}
+
 // Based on this: http://xen.firefly.nu/up/rearrange.c.html
 // Thanks daniel from GXTConvert finding this out first
 
@@ -0,0 +1,137 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <config/state.h>
+#include <mem/functions.h>
+#include <mem/state.h>
+#include <renderer/command_payloads.h>
+#include <renderer/functions.h>
+#include <renderer/null/state.h>
+#include <renderer/state.h>
+#include <util/log.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace renderer;
+
+template <typename... Args>
+static void append(CommandList &list, CommandOpcode opcode, std::atomic<int> *status, Args... arguments) {
+    Command *cmd = make_command(generic_command_allocate, generic_command_free, opcode, status, arguments...);
+    if (!list.first)
+        list.first = cmd;
+    else
+        list.last->next = cmd;
+    list.last = cmd;
+}
+
+struct BatchTest : public testing::Test {
+    void SetUp() override {
+        ASSERT_TRUE(init(mem));
+        ASSERT_TRUE(renderer::init(nullptr, state, Backend::Null, config, ""));
+
+        CommandList list;
+        list.context = nullptr;
+        append(list, CommandOpcode::CreateContext, &status, payload::CreateContext{ &context });
+        process_batch(*state, state->features, mem, config, list, "", "");
+        ASSERT_TRUE(context);
+        context->alloc_func = generic_command_allocate;
+        context->free_func = generic_command_free;
+    }
+
+    CommandList make_list() {
+        CommandList list;
+        list.context = context.get();
+        return list;
+    }
+
+    MemState mem;
+    Config config;
+    std::unique_ptr<State> state;
+    std::unique_ptr<Context> context;
+    std::atomic<int> status = CommandErrorCodePending;
+};
+
+TEST_F(BatchTest, payloads_reach_handlers) {
+    CommandList list = make_list();
+    append(list, CommandOpcode::SetState, nullptr, GXMState::CullMode, payload::CullMode{ SCE_GXM_CULL_CW });
+    append(list, CommandOpcode::SetState, nullptr, GXMState::DepthFunc, payload::DepthFunc{ false, SCE_GXM_DEPTH_FUNC_GREATER });
+    append(list, CommandOpcode::SetState, nullptr, GXMState::RegionClip, payload::RegionClip{ SCE_GXM_REGION_CLIP_ALL, 1, 100, 1, 50 });
+    append(list, CommandOpcode::Nop, &status, payload::Nop{ 42 });
+    process_batch(*state, state->features, mem, config, list, "", "");
+
+    EXPECT_EQ(context->record.cull_mode, SCE_GXM_CULL_CW);
+    EXPECT_EQ(context->record.back_depth_func, SCE_GXM_DEPTH_FUNC_GREATER);
+    EXPECT_EQ(context->record.region_clip_mode, SCE_GXM_REGION_CLIP_ALL);
+    EXPECT_EQ(context->record.region_clip_max.x, 128);
+    EXPECT_EQ(status.load(), 42);
+}
+
+TEST_F(BatchTest, unknown_opcodes_are_skipped) {
+    CommandList list = make_list();
+    append(list, static_cast<CommandOpcode>(7), nullptr);
+    append(list, CommandOpcode::TotalOpcode, nullptr);
+    append(list, CommandOpcode::SetState, nullptr, GXMState::TotalState);
+    append(list, CommandOpcode::Nop, &status, payload::Nop{ 1 });
+    process_batch(*state, state->features, mem, config, list, "", "");
+
+    EXPECT_EQ(status.load(), 1);
+}
+
+// Dispatch cost of a frame worth of state changes and draws. The null backend does almost nothing with them, so
+// the time is spent in process_batch itself. It is recorded as a test property, see --gtest_output=xml.
+TEST_F(BatchTest, processes_large_batches) {
+    constexpr int COMMANDS_PER_LIST = 8000;
+    constexpr int ITERATIONS = 100;
+
+    const auto build = [&]() {
+        CommandList list = make_list();
+        for (int i = 0; i < COMMANDS_PER_LIST / 8; i++) {
+            append(list, CommandOpcode::SetState, nullptr, GXMState::CullMode, payload::CullMode{ SCE_GXM_CULL_CCW });
+            append(list, CommandOpcode::SetState, nullptr, GXMState::DepthFunc, payload::DepthFunc{ true, SCE_GXM_DEPTH_FUNC_LESS });
+            append(list, CommandOpcode::SetState, nullptr, GXMState::TwoSided, payload::TwoSided{ SCE_GXM_TWO_SIDED_ENABLED });
+            append(list, CommandOpcode::SetState, nullptr, GXMState::StencilRef, payload::StencilRef{ true, 0x80 });
+            append(list, CommandOpcode::SetState, nullptr, GXMState::FragmentProgramEnable, payload::FragmentProgramEnable{ false, SCE_GXM_FRAGMENT_PROGRAM_ENABLED });
+            append(list, CommandOpcode::SetState, nullptr, GXMState::Texture, payload::Texture{ 0, SceGxmTexture{} });
+            append(list, CommandOpcode::SetState, nullptr, GXMState::VertexStream, payload::VertexStream{ nullptr, 0, 0 });
+            append(list, CommandOpcode::Draw, nullptr, payload::Draw{ SCE_GXM_PRIMITIVE_TRIANGLES, SCE_GXM_INDEX_FORMAT_U16, nullptr, 0, 1 });
+        }
+        return list;
+    };
+
+    // Draws are invalid without programs and each one logs an error, which would be all this measures
+    const auto log_level = spdlog::get_level();
+    spdlog::set_level(spdlog::level::off);
+
+    std::chrono::nanoseconds total{};
+    for (int i = 0; i < ITERATIONS; i++) {
+        CommandList list = build();
+        const auto start = std::chrono::steady_clock::now();
+        process_batch(*state, state->features, mem, config, list, "", "");
+        total += std::chrono::steady_clock::now() - start;
+    }
+
+    spdlog::set_level(log_level);
+
+    const double ns_per_command = static_cast<double>(total.count()) / (static_cast<double>(COMMANDS_PER_LIST) * ITERATIONS);
+    RecordProperty("ps_per_command", static_cast<int>(ns_per_command * 1000));
+    RecordProperty("k_commands_per_s", static_cast<int>(1e6 / ns_per_command));
+
+    EXPECT_EQ(static_cast<null::NullState &>(*state).current_frame.draws, static_cast<std::uint64_t>(COMMANDS_PER_LIST / 8 * ITERATIONS));
+}
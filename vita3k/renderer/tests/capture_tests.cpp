@@ -0,0 +1,261 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <config/state.h>
+#include <display/state.h>
+#include <mem/functions.h>
+#include <mem/state.h>
+#include <renderer/capture.h>
+#include <renderer/command_payloads.h>
+#include <renderer/functions.h>
+#include <renderer/null/state.h>
+#include <renderer/state.h>
+#include <util/fs.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <new>
+
+using namespace renderer;
+
+static constexpr std::uint32_t TEXTURE_SIZE = 16;
+
+template <typename... Args>
+static Command *command(CommandOpcode opcode, std::atomic<int> *status, Args... arguments) {
+    return make_command(generic_command_allocate, generic_command_free, opcode, status, arguments...);
+}
+
+static void run(State &state, MemState &mem, Config &config, Context *context, std::initializer_list<Command *> commands) {
+    CommandList list;
+    list.context = context;
+    for (Command *cmd : commands) {
+        if (!list.first)
+            list.first = cmd;
+        else
+            list.last->next = cmd;
+        list.last = cmd;
+    }
+
+    process_batch(state, state.features, mem, config, list, "", "");
+}
+
+static SceGxmTexture linear_texture(Address data) {
+    const SceGxmTextureFormat format = SCE_GXM_TEXTURE_FORMAT_U8U8U8U8_ABGR;
+
+    SceGxmTexture texture{};
+    texture.format0 = (format & 0x80000000) >> 31;
+    texture.base_format = (format & 0x1F000000) >> 24;
+    texture.swizzle_format = (format & 0x7000) >> 12;
+    texture.type = SCE_GXM_TEXTURE_LINEAR >> 29;
+    texture.width = TEXTURE_SIZE - 1;
+    texture.height = TEXTURE_SIZE - 1;
+    texture.data_addr = data >> 2;
+    texture.normalize_mode = 1;
+    return texture;
+}
+
+static std::uint8_t *bytes(std::uint8_t value, std::size_t size) {
+    std::uint8_t *data = new std::uint8_t[size];
+    std::memset(data, value, size);
+    return data;
+}
+
+// Smallest binary the program creation accepts: no parameters, only a default uniform buffer
+static Address empty_gxp(MemState &mem) {
+    const Address address = alloc(mem, sizeof(SceGxmProgram), "gxp");
+    SceGxmProgram *gxp = Ptr<SceGxmProgram>(address).get(mem);
+    std::memset(gxp, 0, sizeof(SceGxmProgram));
+    std::memcpy(&gxp->magic, "GXP", 4);
+    gxp->size = sizeof(SceGxmProgram);
+    gxp->default_uniform_buffer_count = 4;
+    return address;
+}
+
+static std::uint8_t *indices() {
+    std::uint8_t *data = new std::uint8_t[3 * sizeof(std::uint16_t)];
+    const std::uint16_t values[] = { 0, 1, 2 };
+    std::memcpy(data, values, sizeof(values));
+    return data;
+}
+
+// Records two frames on the null renderer, the texture changes between them, then replays the capture in a fresh
+// guest memory. The replay has to go through the same draws and upload the same texture data.
+TEST(capture, round_trip_on_null_renderer) {
+    const fs::path capture_path = fs::temp_directory_path() / fs::unique_path("gxm-capture-%%%%-%%%%.gxmcap");
+    Config config;
+
+    null::NullFrameStats recorded;
+    {
+        MemState mem;
+        ASSERT_TRUE(init(mem));
+
+        std::unique_ptr<State> state;
+        ASSERT_TRUE(renderer::init(nullptr, state, Backend::Null, config, ""));
+        state->capture = std::make_unique<capture::CaptureWriter>(capture_path, 2);
+        ASSERT_TRUE(state->capture->recording());
+
+        std::atomic<int> status = CommandErrorCodePending;
+        std::unique_ptr<Context> context;
+        std::unique_ptr<RenderTarget> render_target;
+        SceGxmRenderTargetParams params{};
+        params.width = DEFAULT_RES_WIDTH;
+        params.height = DEFAULT_RES_HEIGHT;
+        run(*state, mem, config, nullptr, { command(CommandOpcode::CreateContext, &status, payload::CreateContext{ &context }) });
+        run(*state, mem, config, nullptr, { command(CommandOpcode::CreateRenderTarget, &status, payload::CreateRenderTarget{ &render_target, &params }) });
+        ASSERT_TRUE(context && render_target);
+        context->alloc_func = generic_command_allocate;
+        context->free_func = generic_command_free;
+
+        const Address color_data = alloc(mem, DEFAULT_RES_WIDTH * DEFAULT_RES_HEIGHT * 4, "color");
+        const Address texture_data = alloc(mem, TEXTURE_SIZE * TEXTURE_SIZE * 4, "texture");
+        std::memset(Ptr<std::uint8_t>(texture_data).get(mem), 0x40, TEXTURE_SIZE * TEXTURE_SIZE * 4);
+
+        DisplayState display;
+        const SceGxmTexture texture = linear_texture(texture_data);
+        for (int frame = 0; frame < 2; frame++) {
+            SceGxmColorSurface *color_surface = new SceGxmColorSurface{};
+            color_surface->width = color_surface->strideInPixels = DEFAULT_RES_WIDTH;
+            color_surface->height = DEFAULT_RES_HEIGHT;
+            color_surface->colorFormat = SCE_GXM_COLOR_FORMAT_U8U8U8U8_ABGR;
+            color_surface->data = Ptr<void>(color_data);
+            SceGxmDepthStencilSurface *depth_stencil_surface = nullptr;
+
+            if (frame == 1) {
+                Ptr<std::uint8_t>(texture_data).get(mem)[0] = 0xFF;
+            }
+
+            run(*state, mem, config, context.get(),
+                { command(CommandOpcode::SetContext, nullptr, payload::SetContext{ render_target.get(), color_surface, depth_stencil_surface }),
+                    command(CommandOpcode::SetState, nullptr, GXMState::Texture, payload::Texture{ 0, texture }),
+                    command(CommandOpcode::Draw, nullptr, payload::Draw{ SCE_GXM_PRIMITIVE_TRIANGLES, SCE_GXM_INDEX_FORMAT_U16, indices(), 3, 1 }),
+                    command(CommandOpcode::SignalNotification, nullptr, payload::SignalNotification{}) });
+
+            state->render_frame({ 0.0f, 0.0f }, { DEFAULT_RES_WIDTH, DEFAULT_RES_HEIGHT }, display, mem);
+            state->capture->end_frame(display);
+        }
+
+        EXPECT_FALSE(state->capture->recording());
+        recorded = static_cast<null::NullState &>(*state).total;
+    }
+
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    std::unique_ptr<State> state;
+    ASSERT_TRUE(renderer::init(nullptr, state, Backend::Null, config, ""));
+
+    capture::Capture capture;
+    ASSERT_TRUE(capture.load(capture_path));
+
+    capture::ReplayStats stats;
+    ASSERT_TRUE(capture.replay(*state, mem, config, stats));
+
+    const null::NullFrameStats &replayed = static_cast<null::NullState &>(*state).total;
+    EXPECT_EQ(stats.frame_times.size(), 2u);
+    EXPECT_EQ(stats.command_lists, 2u);
+    // The notification only wakes guest threads and is left out
+    EXPECT_EQ(stats.commands, 6u);
+    EXPECT_EQ(replayed.draws, recorded.draws);
+    EXPECT_EQ(replayed.texture_uploads, 2u);
+    EXPECT_EQ(replayed.texture_uploads, recorded.texture_uploads);
+    EXPECT_EQ(replayed.texture_bytes, recorded.texture_bytes);
+
+    fs::remove(capture_path);
+}
+
+// The vertex and fragment programs are destroyed and created again at the same addresses between the two frames,
+// the way apps swap shaders, with different streams and mask update flag. The replay has to end up with the second
+// versions, and the vertex streams and uniform buffers attached to the commands have to be read back in step.
+TEST(capture, programs_streams_and_uniform_buffers) {
+    const fs::path capture_path = fs::temp_directory_path() / fs::unique_path("gxm-capture-%%%%-%%%%.gxmcap");
+    Config config;
+
+    Address vertex_address = 0;
+    Address fragment_address = 0;
+    {
+        MemState mem;
+        ASSERT_TRUE(init(mem));
+
+        std::unique_ptr<State> state;
+        ASSERT_TRUE(renderer::init(nullptr, state, Backend::Null, config, ""));
+        state->capture = std::make_unique<capture::CaptureWriter>(capture_path, 2);
+
+        std::atomic<int> status = CommandErrorCodePending;
+        std::unique_ptr<Context> context;
+        run(*state, mem, config, nullptr, { command(CommandOpcode::CreateContext, &status, payload::CreateContext{ &context }) });
+        ASSERT_TRUE(context);
+
+        const Address gxp = empty_gxp(mem);
+        vertex_address = alloc(mem, sizeof(SceGxmVertexProgram), "vertex program");
+        fragment_address = alloc(mem, sizeof(SceGxmFragmentProgram), "fragment program");
+
+        DisplayState display;
+        for (int frame = 0; frame < 2; frame++) {
+            const std::uint16_t stream_count = frame + 1;
+            auto *vertex_program = new (Ptr<SceGxmVertexProgram>(vertex_address).get(mem)) SceGxmVertexProgram;
+            vertex_program->program = Ptr<const SceGxmProgram>(gxp);
+            for (std::uint16_t i = 0; i < stream_count; i++)
+                vertex_program->streams.push_back({ static_cast<std::uint16_t>(16 * stream_count), SCE_GXM_INDEX_SOURCE_EACH_VERTEX_16BIT });
+            auto *fragment_program = new (Ptr<SceGxmFragmentProgram>(fragment_address).get(mem)) SceGxmFragmentProgram;
+            fragment_program->program = Ptr<const SceGxmProgram>(gxp);
+            fragment_program->is_maskupdate = (frame == 1);
+
+            // Set twice, an unchanged program is not recorded again
+            for (int i = 0; i < 2; i++) {
+                run(*state, mem, config, context.get(),
+                    { command(CommandOpcode::SetState, nullptr, GXMState::Program, payload::Program{ Ptr<const void>(vertex_address), false }),
+                        command(CommandOpcode::SetState, nullptr, GXMState::Program, payload::Program{ Ptr<const void>(fragment_address), true }),
+                        command(CommandOpcode::SetState, nullptr, GXMState::VertexStream, payload::VertexStream{ bytes(0x10 + frame, 64), 0, 64 }),
+                        command(CommandOpcode::SetState, nullptr, GXMState::UniformBuffer, payload::UniformBuffer{ bytes(0x20 + frame, 16), true, 14, 16 }),
+                        command(CommandOpcode::SetState, nullptr, GXMState::VertexStream, payload::VertexStream{ nullptr, 1, 0 }) });
+            }
+
+            state->render_frame({ 0.0f, 0.0f }, { DEFAULT_RES_WIDTH, DEFAULT_RES_HEIGHT }, display, mem);
+            state->capture->end_frame(display);
+
+            vertex_program->~SceGxmVertexProgram();
+            fragment_program->~SceGxmFragmentProgram();
+        }
+
+        EXPECT_FALSE(state->capture->recording());
+    }
+
+    MemState mem;
+    ASSERT_TRUE(init(mem));
+    std::unique_ptr<State> state;
+    ASSERT_TRUE(renderer::init(nullptr, state, Backend::Null, config, ""));
+
+    capture::Capture capture;
+    ASSERT_TRUE(capture.load(capture_path));
+
+    capture::ReplayStats stats;
+    ASSERT_TRUE(capture.replay(*state, mem, config, stats));
+    EXPECT_EQ(stats.frame_times.size(), 2u);
+    EXPECT_EQ(stats.command_lists, 4u);
+    EXPECT_EQ(stats.commands, 20u);
+
+    const SceGxmVertexProgram *vertex_program = Ptr<const SceGxmVertexProgram>(vertex_address).get(mem);
+    ASSERT_EQ(vertex_program->streams.size(), 2u);
+    EXPECT_EQ(vertex_program->streams[1].stride, 32);
+    EXPECT_TRUE(vertex_program->renderer_data);
+    const SceGxmFragmentProgram *fragment_program = Ptr<const SceGxmFragmentProgram>(fragment_address).get(mem);
+    EXPECT_TRUE(fragment_program->is_maskupdate);
+    EXPECT_TRUE(fragment_program->renderer_data);
+
+    fs::remove(capture_path);
+}
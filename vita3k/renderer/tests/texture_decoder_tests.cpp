@@ -0,0 +1,216 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <mem/functions.h>
+#include <mem/state.h>
+#include <renderer/functions.h>
+#include <renderer/texture_cache_state.h>
+#include <renderer/texture_decoder.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace renderer;
+
+static constexpr std::uint32_t TEXTURE_SIZE = 16;
+static constexpr std::size_t TEXTURE_BYTES = TEXTURE_SIZE * TEXTURE_SIZE * 4;
+
+static SceGxmTexture linear_texture(Address data) {
+    const SceGxmTextureFormat format = SCE_GXM_TEXTURE_FORMAT_U8U8U8U8_ABGR;
+
+    SceGxmTexture texture{};
+    texture.format0 = (format & 0x80000000) >> 31;
+    texture.base_format = (format & 0x1F000000) >> 24;
+    texture.swizzle_format = (format & 0x7000) >> 12;
+    texture.type = SCE_GXM_TEXTURE_LINEAR >> 29;
+    texture.width = TEXTURE_SIZE - 1;
+    texture.height = TEXTURE_SIZE - 1;
+    texture.data_addr = data >> 2;
+    texture.normalize_mode = 1;
+    return texture;
+}
+
+// Copies the texture to the staging buffer once the gate opens
+class GatedDecode {
+public:
+    GatedDecode()
+        : gate(opened.get_future().share()) {
+    }
+
+    texture::TextureDecodeFunc func() {
+        return [this](const SceGxmTexture &gxm_texture, const MemState &mem, texture::DecodedTexture &decoded) {
+            gate.wait();
+            const std::uint8_t *data = Ptr<std::uint8_t>(gxm_texture.data_addr << 2).get(mem);
+            decoded.staging.assign(data, data + TEXTURE_BYTES);
+            texture::TextureUploadLevel level;
+            level.width = TEXTURE_SIZE;
+            level.height = TEXTURE_SIZE;
+            level.row_length = TEXTURE_SIZE;
+            decoded.levels.push_back(level);
+            decodes++;
+        };
+    }
+
+    void open() {
+        opened.set_value();
+    }
+
+    std::atomic<int> decodes = 0;
+
+private:
+    std::promise<void> opened;
+    std::shared_future<void> gate;
+};
+
+class TextureDecoderTest : public testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(init(mem));
+        data = alloc(mem, TEXTURE_BYTES, "texture");
+        std::memset(Ptr<std::uint8_t>(data).get(mem), 0x40, TEXTURE_BYTES);
+    }
+
+    MemState mem;
+    Address data = 0;
+};
+
+TEST_F(TextureDecoderTest, staging_buffers_are_recycled) {
+    GatedDecode decode;
+    decode.open();
+    texture::TextureDecoder decoder(decode.func());
+
+    decoder.request(0, linear_texture(data), mem);
+    texture::DecodedTexturePtr first = decoder.take(0, true);
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first->staging.size(), TEXTURE_BYTES);
+    const texture::DecodedTexture *const first_address = first.get();
+    const std::uint8_t *const first_staging = first->staging.data();
+    decoder.recycle(std::move(first));
+    EXPECT_EQ(decoder.staging().pooled(), 1);
+
+    decoder.request(1, linear_texture(data), mem);
+    texture::DecodedTexturePtr second = decoder.take(1, true);
+    ASSERT_TRUE(second);
+    EXPECT_EQ(second.get(), first_address);
+    EXPECT_EQ(second->staging.data(), first_staging);
+    EXPECT_FALSE(decoder.pending(1));
+}
+
+TEST_F(TextureDecoderTest, newer_request_replaces_pending_one) {
+    GatedDecode decode;
+    texture::TextureDecoder decoder(decode.func());
+
+    const Address other_data = alloc(mem, TEXTURE_BYTES, "other texture");
+    std::memset(Ptr<std::uint8_t>(other_data).get(mem), 0x80, TEXTURE_BYTES);
+
+    decoder.request(0, linear_texture(data), mem);
+    decoder.request(0, linear_texture(other_data), mem);
+    EXPECT_FALSE(decoder.take(0, false));
+    decode.open();
+
+    texture::DecodedTexturePtr decoded = decoder.take(0, true);
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(decoded->texture.data_addr, other_data >> 2);
+    EXPECT_EQ(decoded->staging[0], 0x80);
+    EXPECT_FALSE(decoder.take(0, true));
+}
+
+// A worker held up by the render thread, like one faulting on a surface that is being read back, is released by the
+// wait callback instead of the render thread waiting on it forever
+TEST_F(TextureDecoderTest, waiting_runs_the_wait_callback) {
+    GatedDecode decode;
+    texture::TextureDecoder decoder(decode.func());
+    int waits = 0;
+    decoder.set_wait_callback([&]() {
+        if (waits++ == 0)
+            decode.open();
+    });
+
+    decoder.request(0, linear_texture(data), mem);
+    texture::DecodedTexturePtr decoded = decoder.take(0, true);
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(decoded->staging[0], 0x40);
+    EXPECT_GE(waits, 1);
+}
+
+TEST_F(TextureDecoderTest, finished_decodes_are_taken_without_binding) {
+    GatedDecode decode;
+    texture::TextureDecoder decoder(decode.func());
+
+    decoder.request(0, linear_texture(data), mem);
+    decoder.request(1, linear_texture(data), mem);
+    std::vector<std::size_t> uploaded;
+    decoder.take_finished([&](std::size_t index, const texture::DecodedTexture &) { uploaded.push_back(index); });
+    EXPECT_TRUE(uploaded.empty());
+
+    decode.open();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (uploaded.size() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        decoder.take_finished([&](std::size_t index, const texture::DecodedTexture &) { uploaded.push_back(index); });
+    }
+    std::sort(uploaded.begin(), uploaded.end());
+    EXPECT_EQ(uploaded, (std::vector<std::size_t>{ 0, 1 }));
+    EXPECT_FALSE(decoder.pending(0));
+    EXPECT_FALSE(decoder.pending(1));
+    EXPECT_EQ(decoder.staging().pooled(), 2);
+}
+
+// A changed texture is only uploaded once its decode is done, draws in between keep the previous contents
+TEST_F(TextureDecoderTest, cache_uploads_when_decode_is_done) {
+    GatedDecode decode;
+    TextureCacheState cache;
+    int uploads = 0;
+    cache.select_callback = [](std::size_t, const void *) {};
+    cache.configure_texture_callback = [](std::size_t, const void *) {};
+    cache.upload_texture_callback = [](std::size_t, const void *, const MemState &) { FAIL() << "Texture uploaded on the render thread"; };
+    cache.decoder = std::make_unique<texture::TextureDecoder>(decode.func());
+    cache.upload_decoded_callback = [&](std::size_t, const texture::DecodedTexture &decoded) {
+        EXPECT_EQ(decoded.pixels(decoded.levels[0])[0], 0x40);
+        uploads++;
+    };
+
+    const SceGxmTexture gxm_texture = linear_texture(data);
+    texture::cache_and_bind_texture(cache, gxm_texture, mem);
+    EXPECT_EQ(uploads, 0);
+
+    decode.open();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (uploads == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        texture::cache_and_bind_texture(cache, gxm_texture, mem);
+    }
+    EXPECT_EQ(uploads, 1);
+    EXPECT_EQ(decode.decodes, 1);
+
+    // Same contents, nothing to decode again
+    texture::cache_and_bind_texture(cache, gxm_texture, mem);
+    EXPECT_EQ(uploads, 1);
+
+    cache.wait_for_decode = true;
+    Ptr<std::uint8_t>(data).get(mem)[1] = 0xFF;
+    texture::cache_and_bind_texture(cache, gxm_texture, mem);
+    EXPECT_EQ(uploads, 2);
+    EXPECT_EQ(decode.decodes, 2);
+}
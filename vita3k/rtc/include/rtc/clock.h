@@ -0,0 +1,82 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+
+/**
+ * \brief Guest time source, in microseconds.
+ *
+ * Guest time follows the host steady clock scaled by a speed multiplier. In unlocked mode, once no guest
+ * thread is running, the clock jumps forward to the earliest sleeper's deadline instead of waiting for it
+ * on the host, so time advances as fast as the guest consumes it. While a guest thread runs, sleepers are
+ * paced on the host like in locked mode. Values returned by now() never go backwards, whichever thread
+ * reads them.
+ */
+class VirtualClock {
+public:
+    using HostClock = std::chrono::steady_clock;
+
+    explicit VirtualClock(std::uint64_t start_time = 0);
+
+    std::uint64_t now();
+
+    void set_speed(double multiplier);
+    double get_speed() const;
+
+    void set_unlocked(bool unlocked);
+    bool is_unlocked() const;
+
+    // Guest threads report when they start and stop running, unlocked sleeps only skip ahead while none runs
+    void add_running_threads(int count);
+
+    // Block the calling thread until the guest clock reaches the deadline (or skip ahead to it when unlocked)
+    void sleep_until(std::uint64_t deadline);
+    void sleep_for(std::uint64_t duration);
+
+    // Like sleep_until, but only sleeps until spin_time before the deadline and spins for the rest, trading
+    // a little CPU for wake ups that do not depend on the host scheduler granularity
+    void sleep_until_precise(std::uint64_t deadline, std::uint64_t spin_time);
+
+private:
+    std::uint64_t raw_now(std::uint64_t skip) const;
+    void rebase(double multiplier);
+
+    std::mutex rebase_mutex;
+
+    // Seqlock protected mapping between host and guest time, only rewritten when the speed changes
+    std::atomic<std::uint32_t> generation{ 0 };
+    std::atomic<std::int64_t> host_base{ 0 };
+    std::atomic<std::uint64_t> guest_base{ 0 };
+    std::atomic<double> speed{ 1.0 };
+
+    std::atomic<std::uint64_t> skipped{ 0 };
+    std::atomic<std::uint64_t> last{ 0 };
+    std::atomic<bool> unlocked{ false };
+
+    std::atomic<int> running_threads{ 0 };
+    // Deadlines of the threads sleeping in unlocked mode, only the earliest one may skip the clock ahead
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cond;
+    std::multiset<std::uint64_t> sleepers;
+};
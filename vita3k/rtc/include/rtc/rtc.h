@@ -81,8 +81,21 @@ inline time_t rtc_timegm(struct tm *tm) {
 }
 #endif
 
+std::uint64_t rtc_ticks_since_epoch();
 std::uint64_t rtc_base_ticks();
 std::uint64_t rtc_get_ticks(uint64_t base_tick);
+
+// Guest clock controls. Every guest visible time source (process time, RTC ticks, timers, delays and
+// vblank) reads the same virtual clock, so they stay consistent when it is sped up or unlocked.
+void rtc_set_clock_speed(double multiplier);
+double rtc_get_clock_speed();
+void rtc_set_clock_unlocked(bool unlocked);
+bool rtc_is_clock_unlocked();
+// Called as guest threads start and stop running, an unlocked clock only skips ahead while none runs
+void rtc_add_running_guest_threads(int count);
+void rtc_sleep_for(std::uint64_t us);
+void rtc_sleep_until(std::uint64_t ticks_since_epoch);
+void rtc_sleep_until_precise(std::uint64_t ticks_since_epoch, std::uint64_t spin_us);
 void __RtcPspTimeToTm(tm *val, const SceDateTime *pt);
 void __RtcTicksToPspTime(SceDateTime *t, std::uint64_t ticks);
 std::uint64_t __RtcPspTimeToTicks(const SceDateTime *pt);
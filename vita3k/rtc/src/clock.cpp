@@ -0,0 +1,153 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <rtc/clock.h>
+
+#include <algorithm>
+#include <thread>
+
+// How often sleepers paced on the host in unlocked mode check whether the guest went idle
+static constexpr auto UNLOCKED_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+static std::int64_t host_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(VirtualClock::HostClock::now().time_since_epoch()).count();
+}
+
+VirtualClock::VirtualClock(std::uint64_t start_time) {
+    host_base = host_now_ns();
+    guest_base = start_time;
+    last = start_time;
+}
+
+std::uint64_t VirtualClock::raw_now(std::uint64_t skip) const {
+    std::uint32_t gen;
+    std::int64_t host;
+    std::uint64_t guest;
+    double multiplier;
+    do {
+        gen = generation.load(std::memory_order_acquire);
+        host = host_base.load(std::memory_order_relaxed);
+        guest = guest_base.load(std::memory_order_relaxed);
+        multiplier = speed.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((gen & 1) || gen != generation.load(std::memory_order_relaxed));
+
+    const std::int64_t elapsed_ns = host_now_ns() - host;
+    const auto elapsed_us = static_cast<std::uint64_t>(static_cast<double>(elapsed_ns) * multiplier / 1000.0);
+    return guest + elapsed_us + skip;
+}
+
+std::uint64_t VirtualClock::now() {
+    const std::uint64_t current = raw_now(skipped.load(std::memory_order_relaxed));
+    std::uint64_t previous = last.load(std::memory_order_relaxed);
+    while (current > previous) {
+        if (last.compare_exchange_weak(previous, current, std::memory_order_relaxed))
+            return current;
+    }
+    return previous;
+}
+
+void VirtualClock::rebase(double multiplier) {
+    const std::lock_guard<std::mutex> lock(rebase_mutex);
+    // Fold the time elapsed at the old speed into the guest base, so the clock stays continuous
+    const std::uint64_t current = now() - skipped.load(std::memory_order_relaxed);
+
+    generation.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    host_base.store(host_now_ns(), std::memory_order_relaxed);
+    guest_base.store(current, std::memory_order_relaxed);
+    speed.store(multiplier, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+void VirtualClock::set_speed(double multiplier) {
+    if (multiplier <= 0.0)
+        multiplier = 1.0;
+    rebase(multiplier);
+}
+
+double VirtualClock::get_speed() const {
+    return speed.load(std::memory_order_relaxed);
+}
+
+void VirtualClock::set_unlocked(bool unlocked) {
+    this->unlocked = unlocked;
+}
+
+bool VirtualClock::is_unlocked() const {
+    return unlocked;
+}
+
+void VirtualClock::add_running_threads(int count) {
+    if (running_threads.fetch_add(count, std::memory_order_acq_rel) + count > 0)
+        return;
+
+    // The guest went idle, the earliest sleeper can skip ahead now rather than at its next poll.
+    // Taking the lock makes sure no sleeper is between its check and its wait.
+    { const std::lock_guard<std::mutex> lock(sleep_mutex); }
+    sleep_cond.notify_all();
+}
+
+void VirtualClock::sleep_until(std::uint64_t deadline) {
+    const auto host_remaining = [&](std::uint64_t current) {
+        const double remaining_ns = static_cast<double>(deadline - current) * 1000.0 / get_speed();
+        return std::chrono::nanoseconds(static_cast<std::int64_t>(remaining_ns));
+    };
+
+    if (!unlocked) {
+        for (std::uint64_t current = now(); current < deadline; current = now())
+            std::this_thread::sleep_for(host_remaining(current));
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    const auto sleeper = sleepers.insert(deadline);
+    for (std::uint64_t current = now(); current < deadline; current = now()) {
+        if (unlocked && (running_threads.load(std::memory_order_acquire) <= 0) && (*sleepers.begin() == deadline)) {
+            // Nobody would see the time pass: move the whole clock to the deadline. Sleepers with the same
+            // deadline retry against the updated offset instead of stacking their jumps.
+            std::uint64_t skip = skipped.load(std::memory_order_relaxed);
+            while (true) {
+                const std::uint64_t raw = raw_now(skip);
+                if (raw >= deadline || skipped.compare_exchange_weak(skip, skip + (deadline - raw), std::memory_order_relaxed))
+                    break;
+            }
+            now();
+            break;
+        }
+
+        // A guest thread is running or an earlier deadline comes first, wait on the host until that changes
+        sleep_cond.wait_for(lock, std::min<std::chrono::nanoseconds>(host_remaining(current), UNLOCKED_POLL_INTERVAL));
+    }
+    sleepers.erase(sleeper);
+}
+
+void VirtualClock::sleep_for(std::uint64_t duration) {
+    sleep_until(now() + duration);
+}
+
+void VirtualClock::sleep_until_precise(std::uint64_t deadline, std::uint64_t spin_time) {
+    if (unlocked) {
+        sleep_until(deadline);
+        return;
+    }
+
+    if (deadline > spin_time)
+        sleep_until(deadline - spin_time);
+    while (now() < deadline)
+        std::this_thread::yield();
+}
@@ -15,14 +15,50 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <rtc/clock.h>
 #include <rtc/rtc.h>
 
 #include <util/log.h>
 
+static VirtualClock &guest_clock() {
+    static VirtualClock clock(std::chrono::time_point_cast<VitaClocks>(std::chrono::high_resolution_clock::now()).time_since_epoch().count());
+    return clock;
+}
+
 std::uint64_t rtc_ticks_since_epoch() {
-    const auto now = std::chrono::high_resolution_clock::now();
-    const auto now_timepoint = std::chrono::time_point_cast<VitaClocks>(now);
-    return now_timepoint.time_since_epoch().count();
+    return guest_clock().now();
+}
+
+void rtc_set_clock_speed(double multiplier) {
+    guest_clock().set_speed(multiplier);
+}
+
+double rtc_get_clock_speed() {
+    return guest_clock().get_speed();
+}
+
+void rtc_set_clock_unlocked(bool unlocked) {
+    guest_clock().set_unlocked(unlocked);
+}
+
+bool rtc_is_clock_unlocked() {
+    return guest_clock().is_unlocked();
+}
+
+void rtc_add_running_guest_threads(int count) {
+    guest_clock().add_running_threads(count);
+}
+
+void rtc_sleep_for(std::uint64_t us) {
+    guest_clock().sleep_for(us);
+}
+
+void rtc_sleep_until(std::uint64_t ticks_since_epoch) {
+    guest_clock().sleep_until(ticks_since_epoch);
+}
+
+void rtc_sleep_until_precise(std::uint64_t ticks_since_epoch, std::uint64_t spin_us) {
+    guest_clock().sleep_until_precise(ticks_since_epoch, spin_us);
 }
 
 std::uint64_t rtc_base_ticks() {
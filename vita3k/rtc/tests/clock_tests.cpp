@@ -0,0 +1,160 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <rtc/clock.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int THREAD_COUNT = 8;
+constexpr int READS_PER_THREAD = 20000;
+
+// Every thread publishes each value it reads into a shared high-water mark. A value read after another
+// thread published a higher one would mean the clock went backwards across threads.
+void check_ordering(VirtualClock &clock, bool sleep_between_reads) {
+    std::atomic<std::uint64_t> published{ 0 };
+    std::atomic<int> violations{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&, t]() {
+            std::uint64_t previous = 0;
+            for (int i = 0; i < READS_PER_THREAD; i++) {
+                const std::uint64_t seen = published.load(std::memory_order_acquire);
+                const std::uint64_t current = clock.now();
+                if (current < previous || current < seen)
+                    violations++;
+                previous = current;
+
+                std::uint64_t high = published.load(std::memory_order_relaxed);
+                while (current > high && !published.compare_exchange_weak(high, current, std::memory_order_release)) {
+                }
+
+                if (sleep_between_reads && (i % 64) == t)
+                    clock.sleep_for(100 + t);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(violations.load(), 0);
+}
+
+} // namespace
+
+TEST(clock, ordering_across_threads) {
+    VirtualClock clock(1000);
+    check_ordering(clock, false);
+}
+
+TEST(clock, ordering_across_threads_while_unlocked) {
+    VirtualClock clock(1000);
+    clock.set_unlocked(true);
+    check_ordering(clock, true);
+}
+
+TEST(clock, ordering_across_speed_changes) {
+    VirtualClock clock(1000);
+    std::atomic<bool> done{ false };
+    std::thread changer([&]() {
+        const double speeds[] = { 4.0, 0.25, 1.0, 16.0 };
+        for (int i = 0; !done; i++) {
+            clock.set_speed(speeds[i % 4]);
+            std::this_thread::yield();
+        }
+    });
+    check_ordering(clock, false);
+    done = true;
+    changer.join();
+}
+
+TEST(clock, unlocked_sleep_skips_ahead) {
+    VirtualClock clock(0);
+    clock.set_unlocked(true);
+
+    const auto host_start = VirtualClock::HostClock::now();
+    const std::uint64_t guest_start = clock.now();
+    for (int i = 0; i < 1000; i++)
+        clock.sleep_for(16667);
+    const auto host_elapsed = VirtualClock::HostClock::now() - host_start;
+
+    // 1000 frames worth of guest time must have passed, without waiting for them on the host
+    EXPECT_GE(clock.now() - guest_start, 1000u * 16667u);
+    EXPECT_LT(host_elapsed, std::chrono::microseconds(1000 * 16667));
+}
+
+TEST(clock, concurrent_unlocked_sleeps_do_not_stack) {
+    VirtualClock clock(0);
+    clock.set_unlocked(true);
+
+    const std::uint64_t deadline = clock.now() + 10'000'000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++)
+        threads.emplace_back([&]() { clock.sleep_until(deadline); });
+    for (auto &thread : threads)
+        thread.join();
+
+    // All sleepers share the same deadline: the clock only jumps once, stacked jumps would at least double it
+    EXPECT_GE(clock.now(), deadline);
+    EXPECT_LT(clock.now(), deadline + 10'000'000);
+}
+
+TEST(clock, unlocked_sleeps_wait_while_a_guest_thread_runs) {
+    VirtualClock clock(0);
+    clock.set_unlocked(true);
+    clock.add_running_threads(1);
+
+    // Paced on the host like a locked clock, skipping would make the running thread see time jump
+    const auto host_start = VirtualClock::HostClock::now();
+    clock.sleep_for(20'000);
+    EXPECT_GE(VirtualClock::HostClock::now() - host_start, std::chrono::microseconds(20'000));
+
+    // Once the guest goes idle, the pending sleeper skips ahead instead of waiting out its second
+    const std::uint64_t deadline = clock.now() + 1'000'000;
+    std::thread sleeper([&]() { clock.sleep_until(deadline); });
+    clock.add_running_threads(-1);
+    sleeper.join();
+    EXPECT_GE(clock.now(), deadline);
+    EXPECT_LT(VirtualClock::HostClock::now() - host_start, std::chrono::microseconds(500'000));
+}
+
+TEST(clock, speed_multiplier_scales_sleeps) {
+    VirtualClock clock(0);
+    clock.set_speed(10.0);
+
+    // Guest reads are nested between host reads, so the guest time elapsed is bounded by the inner and
+    // outer host intervals scaled by the multiplier, whatever the host scheduler does in between
+    const auto host_outer_start = VirtualClock::HostClock::now();
+    const std::uint64_t guest_start = clock.now();
+    const auto host_inner_start = VirtualClock::HostClock::now();
+    clock.sleep_for(500'000);
+    const auto host_inner_end = VirtualClock::HostClock::now();
+    const std::uint64_t guest_end = clock.now();
+    const auto host_outer_end = VirtualClock::HostClock::now();
+
+    const auto to_us = [](auto duration) { return std::chrono::duration_cast<std::chrono::microseconds>(duration).count(); };
+    const std::uint64_t guest_elapsed = guest_end - guest_start;
+    EXPECT_GE(guest_elapsed, 500'000u);
+    EXPECT_GE(guest_elapsed + 2, static_cast<std::uint64_t>(to_us(host_inner_end - host_inner_start) * 10));
+    EXPECT_LE(guest_elapsed, static_cast<std::uint64_t>(to_us(host_outer_end - host_outer_start) * 10 + 20));
+}
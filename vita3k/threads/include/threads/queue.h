@@ -69,6 +69,7 @@ public:
     }
 
     size_t size() {
+        std::unique_lock<std::mutex> mlock(mutex_);
         return queue_.size();
     }
 
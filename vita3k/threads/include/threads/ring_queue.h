@@ -0,0 +1,219 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Bounded lock-free queue for any number of producers and consumers (sequence numbered cells, after Dmitry Vyukov).
+// Pushing and popping never take a lock while the queue is neither full nor empty. A consumer that finds the queue
+// empty, or a producer that finds it full, registers itself and sleeps on a condition variable; the other side only
+// takes the lock to wake it when somebody is registered, so a busy queue costs a fence and a load per operation.
+template <typename T>
+class RingQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit RingQueue(std::size_t min_capacity) {
+        std::size_t capacity = 2;
+        while (capacity < min_capacity)
+            capacity <<= 1;
+
+        mask = capacity - 1;
+        cells = std::make_unique<Cell[]>(capacity);
+        for (std::size_t i = 0; i < capacity; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    RingQueue(const RingQueue &) = delete;
+    RingQueue &operator=(const RingQueue &) = delete;
+
+    bool try_push(const T &item) {
+        if (!enqueue(item))
+            return false;
+        wake(consumers_waiting, not_empty);
+        return true;
+    }
+
+    bool try_pop(T &item) {
+        if (!dequeue(item))
+            return false;
+        wake(producers_waiting, not_full);
+        return true;
+    }
+
+    // Waits while the queue is full. Returns false if the queue was aborted.
+    bool push(const T &item) {
+        for (int spin = 0; spin < SPIN_COUNT; spin++) {
+            if (try_push(item))
+                return true;
+            std::this_thread::yield();
+        }
+
+        bool pushed = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const WaiterGuard guard(producers_waiting);
+            not_full.wait(lock, [&]() { return (pushed = enqueue(item)) || aborted; });
+        }
+
+        if (pushed)
+            wake(consumers_waiting, not_empty);
+        return pushed;
+    }
+
+    // Waits up to timeout while the queue is empty. Returns false on timeout or if the queue was aborted.
+    template <typename Rep, typename Period>
+    bool pop(T &item, const std::chrono::duration<Rep, Period> &timeout) {
+        for (int spin = 0; spin < SPIN_COUNT; spin++) {
+            if (try_pop(item))
+                return true;
+            std::this_thread::yield();
+        }
+
+        bool popped = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const WaiterGuard guard(consumers_waiting);
+            not_empty.wait_for(lock, timeout, [&]() { return (popped = dequeue(item)) || aborted; });
+        }
+
+        if (popped)
+            wake(producers_waiting, not_full);
+        return popped;
+    }
+
+    // Approximate when other threads are pushing or popping
+    std::size_t size() const {
+        const std::size_t tail_pos = tail.load(std::memory_order_acquire);
+        const std::size_t head_pos = head.load(std::memory_order_acquire);
+        return (tail_pos > head_pos) ? tail_pos - head_pos : 0;
+    }
+
+    std::size_t capacity() const {
+        return mask + 1;
+    }
+
+    void abort() {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            aborted = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+private:
+    // Short waits are common when the other side is mid-operation, yielding a few times is cheaper than sleeping
+    static constexpr int SPIN_COUNT = 16;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence{ 0 };
+        T data{};
+    };
+
+    struct WaiterGuard {
+        explicit WaiterGuard(std::atomic<std::uint32_t> &count)
+            : count(count) {
+            count.fetch_add(1, std::memory_order_relaxed);
+            // Pairs with the fence in wake(): either the waker sees the count, or the waiter sees the new item
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        ~WaiterGuard() {
+            count.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        std::atomic<std::uint32_t> &count;
+    };
+
+    bool enqueue(const T &item) {
+        std::size_t pos = tail.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool dequeue(T &item) {
+        std::size_t pos = head.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false; // Empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(cell->data);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    void wake(const std::atomic<std::uint32_t> &waiting, std::condition_variable &cond) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) == 0)
+            return;
+        {
+            // The waiter checks the queue under the lock, so it is either before its check or already asleep
+            const std::lock_guard<std::mutex> lock(mutex);
+        }
+        // Each operation frees one slot or fills one cell, one waiter is enough
+        cond.notify_one();
+    }
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask;
+
+    // Producers and consumers write different lines
+    alignas(64) std::atomic<std::size_t> tail{ 0 };
+    alignas(64) std::atomic<std::size_t> head{ 0 };
+
+    alignas(64) std::atomic<std::uint32_t> consumers_waiting{ 0 };
+    std::atomic<std::uint32_t> producers_waiting{ 0 };
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    bool aborted = false;
+};
@@ -0,0 +1,119 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed size pool of host worker threads for CPU bound jobs (decryption, decompression, decoding...).
+// A task may itself submit more tasks and wait on them: wait() runs queued tasks on the calling
+// thread until the awaited future is ready, so nested use never deadlocks the pool.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = 0) {
+        if (thread_count == 0)
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+        workers.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; i++)
+            workers.emplace_back([this]() { worker_loop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            aborted = true;
+        }
+        cond.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    template <typename F>
+    auto submit(F &&f) -> std::future<decltype(f())> {
+        using Result = decltype(f());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        std::future<Result> result = task->get_future();
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task]() { (*task)(); });
+        }
+        cond.notify_one();
+        return result;
+    }
+
+    // Wait for a future obtained from submit(), helping with pending tasks in the meantime.
+    template <typename T>
+    T wait(std::future<T> &future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!run_one())
+                future.wait_for(std::chrono::microseconds(100));
+        }
+        return future.get();
+    }
+
+    size_t size() const {
+        return workers.size();
+    }
+
+private:
+    bool run_one() {
+        std::function<void()> task;
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (tasks.empty())
+                return false;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+        return true;
+    }
+
+    void worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this]() { return aborted || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool aborted = false;
+};
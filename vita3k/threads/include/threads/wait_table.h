@@ -0,0 +1,115 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+// Futex like table of waiters keyed by memory address, for memory written by one thread and polled by another.
+// The writer stores the new value first and then calls notify(). Waiters check their condition under the
+// bucket lock, so a store made before notify() is never missed. Addresses share a fixed set of buckets:
+// a collision only costs a spurious condition check. notify() on a bucket nobody waits on takes no lock.
+class WaitTable {
+public:
+    // Returns false when the table was aborted before the condition became true
+    template <typename Pred>
+    bool wait(const volatile void *address, Pred pred) {
+        Bucket &bucket = get_bucket(address);
+        const WaiterGuard guard(bucket);
+        std::unique_lock<std::mutex> lock(bucket.mutex);
+        bucket.cond.wait(lock, [&]() { return aborted || pred(); });
+        return !aborted;
+    }
+
+    // Returns false on timeout or abort
+    template <typename Pred, typename Rep, typename Period>
+    bool wait_for(const volatile void *address, const std::chrono::duration<Rep, Period> &timeout, Pred pred) {
+        Bucket &bucket = get_bucket(address);
+        const WaiterGuard guard(bucket);
+        std::unique_lock<std::mutex> lock(bucket.mutex);
+        return bucket.cond.wait_for(lock, timeout, [&]() { return aborted || pred(); }) && !aborted;
+    }
+
+    void notify(const volatile void *address) {
+        // Pairs with the waiter count increment: either the waiter sees the caller's store, or we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Bucket &bucket = get_bucket(address);
+        if (bucket.waiters.load(std::memory_order_relaxed) == 0)
+            return;
+        {
+            // Taking the lock orders the caller's store before the waiter's next check
+            const std::lock_guard<std::mutex> lock(bucket.mutex);
+        }
+        bucket.cond.notify_all();
+    }
+
+    void abort() {
+        aborted = true;
+        for (Bucket &bucket : buckets) {
+            {
+                const std::lock_guard<std::mutex> lock(bucket.mutex);
+            }
+            bucket.cond.notify_all();
+        }
+    }
+
+    // Lets waits block again after an abort, once nobody is left waiting on the aborted state
+    void reset() {
+        aborted = false;
+    }
+
+    bool is_aborted() const {
+        return aborted;
+    }
+
+private:
+    static constexpr size_t BUCKET_COUNT = 64;
+
+    struct Bucket {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::atomic<uint32_t> waiters{ 0 };
+    };
+
+    struct WaiterGuard {
+        explicit WaiterGuard(Bucket &bucket)
+            : bucket(bucket) {
+            bucket.waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        ~WaiterGuard() {
+            bucket.waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        Bucket &bucket;
+    };
+
+    Bucket &get_bucket(const volatile void *address) {
+        // Waited words are at least 4 bytes aligned, drop the low bits before hashing
+        const auto key = reinterpret_cast<std::uintptr_t>(address) >> 2;
+        return buckets[(key ^ (key >> 6) ^ (key >> 12)) % BUCKET_COUNT];
+    }
+
+    std::array<Bucket, BUCKET_COUNT> buckets;
+    std::atomic<bool> aborted{ false };
+};
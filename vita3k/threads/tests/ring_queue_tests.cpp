@@ -0,0 +1,289 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <threads/queue.h>
+#include <threads/ring_queue.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+TEST(ring_queue, capacity_and_order) {
+    RingQueue<int> queue(30);
+    EXPECT_EQ(queue.capacity(), 32u);
+
+    for (int i = 0; i < 32; i++)
+        EXPECT_TRUE(queue.try_push(i));
+    EXPECT_FALSE(queue.try_push(32));
+    EXPECT_EQ(queue.size(), 32u);
+
+    int item = -1;
+    for (int i = 0; i < 32; i++) {
+        EXPECT_TRUE(queue.try_pop(item));
+        EXPECT_EQ(item, i);
+    }
+    EXPECT_FALSE(queue.try_pop(item));
+    EXPECT_FALSE(queue.pop(item, std::chrono::milliseconds(1)));
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+TEST(ring_queue, abort_releases_consumer) {
+    RingQueue<int> queue(4);
+    std::thread consumer([&]() {
+        int item;
+        EXPECT_FALSE(queue.pop(item, std::chrono::seconds(10)));
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.abort();
+    consumer.join();
+}
+
+// Several producers, like guest threads submitting for different GXM contexts, and one consumer.
+// Every item arrives once and items of a producer stay in order.
+TEST(ring_queue, multiple_producers_keep_their_order) {
+    constexpr int PRODUCERS = 4;
+    constexpr std::uint32_t ITEMS = 100000;
+
+    RingQueue<std::uint64_t> queue(32);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p]() {
+            for (std::uint32_t i = 0; i < ITEMS; i++)
+                ASSERT_TRUE(queue.push((static_cast<std::uint64_t>(p) << 32) | i));
+        });
+    }
+
+    std::vector<std::uint32_t> next(PRODUCERS, 0);
+    for (std::uint64_t received = 0; received < PRODUCERS * ITEMS; received++) {
+        std::uint64_t item;
+        ASSERT_TRUE(queue.pop(item, std::chrono::seconds(10)));
+        const auto producer = static_cast<std::size_t>(item >> 32);
+        ASSERT_EQ(static_cast<std::uint32_t>(item), next[producer]);
+        next[producer]++;
+    }
+
+    for (auto &producer : producers)
+        producer.join();
+}
+
+// The consumer runs out of spins between pushes and goes to sleep, every push must wake it well before its timeout
+TEST(ring_queue, sleeping_consumer_is_woken) {
+    constexpr int ITEMS = 200;
+
+    RingQueue<int> queue(32);
+    std::thread consumer([&]() {
+        for (int i = 0; i < ITEMS; i++) {
+            int item = -1;
+            ASSERT_TRUE(queue.pop(item, std::chrono::seconds(10)));
+            EXPECT_EQ(item, i);
+        }
+    });
+
+    for (int i = 0; i < ITEMS; i++) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        ASSERT_TRUE(queue.push(i));
+    }
+    consumer.join();
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+// Producers that fill the queue sleep until the consumer frees a cell, and never go past the capacity
+TEST(ring_queue, full_queue_blocks_producers) {
+    constexpr int PRODUCERS = 4;
+    constexpr std::uint32_t ITEMS = 20000;
+
+    RingQueue<std::uint64_t> queue(4);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p]() {
+            for (std::uint32_t i = 0; i < ITEMS; i++)
+                ASSERT_TRUE(queue.push((static_cast<std::uint64_t>(p) << 32) | i));
+        });
+    }
+
+    std::vector<std::uint32_t> next(PRODUCERS, 0);
+    for (std::uint64_t received = 0; received < PRODUCERS * ITEMS; received++) {
+        EXPECT_LE(queue.size(), queue.capacity());
+        std::uint64_t item;
+        ASSERT_TRUE(queue.pop(item, std::chrono::seconds(10)));
+        const auto producer = static_cast<std::size_t>(item >> 32);
+        ASSERT_EQ(static_cast<std::uint32_t>(item), next[producer]);
+        next[producer]++;
+    }
+
+    for (auto &producer : producers)
+        producer.join();
+
+    // Everything pushed was popped, an aborted queue no longer blocks a producer on a full queue
+    std::uint64_t item;
+    EXPECT_FALSE(queue.try_pop(item));
+    for (std::uint64_t i = 0; i < queue.capacity(); i++)
+        ASSERT_TRUE(queue.try_push(i));
+    std::thread producer([&]() { EXPECT_FALSE(queue.push(0)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.abort();
+    producer.join();
+}
+
+// The benchmarks below compare RingQueue with the Queue the renderer used before. Their results are recorded as
+// test properties, see --gtest_output=xml.
+
+namespace {
+
+// CPU time consumed by the calling thread only
+std::chrono::microseconds thread_cpu_time() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    const auto to_us = [](const FILETIME &time) {
+        return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10;
+    };
+    return std::chrono::microseconds(to_us(kernel) + to_us(user));
+#else
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::microseconds(static_cast<int64_t>(ts.tv_sec) * 1'000'000 + ts.tv_nsec / 1000);
+#endif
+}
+
+struct LatencyResult {
+    std::vector<std::chrono::nanoseconds> latencies; // Sorted
+    std::chrono::microseconds consumer_cpu;
+};
+
+// Time between a push and the pop returning it, with the consumer waiting on an empty queue every time
+template <typename Push, typename Pop>
+LatencyResult measure_wake_latency(Push push, Pop pop) {
+    constexpr int SAMPLES = 500;
+
+    LatencyResult result;
+    result.latencies.reserve(SAMPLES);
+    std::thread consumer([&]() {
+        const auto cpu_start = thread_cpu_time();
+        for (int i = 0; i < SAMPLES; i++) {
+            const Clock::rep pushed_at = pop();
+            result.latencies.push_back(Clock::now() - Clock::time_point(Clock::duration(pushed_at)));
+        }
+        result.consumer_cpu = thread_cpu_time() - cpu_start;
+    });
+
+    for (int i = 0; i < SAMPLES; i++) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        push(Clock::now().time_since_epoch().count());
+    }
+    consumer.join();
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+void record_latency(const std::string &name, const LatencyResult &result) {
+    const auto &latencies = result.latencies;
+    const auto ns = [](std::chrono::nanoseconds time) { return static_cast<int>(time.count()); };
+    ::testing::Test::RecordProperty(name + "_median_ns", ns(latencies[latencies.size() / 2]));
+    ::testing::Test::RecordProperty(name + "_p99_ns", ns(latencies[latencies.size() * 99 / 100]));
+    ::testing::Test::RecordProperty(name + "_max_ns", ns(latencies.back()));
+    ::testing::Test::RecordProperty(name + "_consumer_cpu_us", static_cast<int>(result.consumer_cpu.count()));
+}
+
+template <typename Push, typename Pop>
+double measure_throughput(int producers, Push push, Pop pop) {
+    constexpr std::uint64_t ITEMS = 200000;
+
+    const auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&]() {
+            for (std::uint64_t i = 0; i < ITEMS; i++)
+                push(i);
+        });
+    }
+    for (std::uint64_t i = 0; i < producers * ITEMS; i++)
+        pop();
+    for (auto &thread : threads)
+        thread.join();
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return producers * ITEMS / seconds;
+}
+
+} // namespace
+
+TEST(ring_queue, wake_latency_benchmark) {
+    // Previous renderer loop: Queue::pop(3) in a loop, its timeout is in microseconds so it mostly polls
+    Queue<Clock::rep> queue;
+    queue.maxPendingCount_ = 32;
+    const auto queue_result = measure_wake_latency(
+        [&](Clock::rep value) { queue.push(value); },
+        [&]() {
+            std::unique_ptr<Clock::rep> item;
+            while (!(item = queue.pop(3))) {
+            }
+            return *item;
+        });
+    record_latency("queue", queue_result);
+
+    RingQueue<Clock::rep> ring(32);
+    const auto ring_result = measure_wake_latency(
+        [&](Clock::rep value) { ring.push(value); },
+        [&]() {
+            Clock::rep item = 0;
+            while (!ring.pop(item, std::chrono::milliseconds(3))) {
+            }
+            return item;
+        });
+    record_latency("ring_queue", ring_result);
+
+    // Generous bound, only catches a consumer that waits for its timeout instead of being woken
+    EXPECT_LT(ring_result.latencies[ring_result.latencies.size() / 2], std::chrono::milliseconds(1));
+}
+
+TEST(ring_queue, throughput_benchmark) {
+    for (const int producers : { 1, 4 }) {
+        Queue<std::uint64_t> queue;
+        queue.maxPendingCount_ = 32;
+        const double queue_rate = measure_throughput(
+            producers, [&](std::uint64_t value) { queue.push(value); }, [&]() { queue.pop(); });
+
+        RingQueue<std::uint64_t> ring(32);
+        const double ring_rate = measure_throughput(
+            producers, [&](std::uint64_t value) { ring.push(value); },
+            [&]() {
+                std::uint64_t item;
+                ring.pop(item, std::chrono::seconds(10));
+            });
+
+        const auto label = std::to_string(producers) + "_producers";
+        RecordProperty("queue_" + label + "_k_items_per_s", static_cast<int>(queue_rate / 1e3));
+        RecordProperty("ring_queue_" + label + "_k_items_per_s", static_cast<int>(ring_rate / 1e3));
+    }
+}
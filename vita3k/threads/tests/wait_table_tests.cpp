@@ -0,0 +1,216 @@
+// Vita3K emulator project
+// Copyright (C) 2021 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <threads/wait_table.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(wait_table, wakes_waiter_without_polling) {
+    constexpr int ROUNDS = 5;
+
+    WaitTable table;
+    volatile uint32_t notification = 0;
+
+    for (int round = 1; round <= ROUNDS; round++) {
+        std::atomic<int> checks{ 0 };
+        std::atomic<bool> woken{ false };
+
+        std::thread waiter([&]() {
+            EXPECT_TRUE(table.wait(&notification, [&]() {
+                checks++;
+                return notification == static_cast<uint32_t>(round);
+            }));
+            woken = true;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(woken);
+
+        notification = round;
+        table.notify(&notification);
+        waiter.join();
+
+        // One check on entry and one per wake up: a polling waiter would check thousands of times while asleep
+        EXPECT_TRUE(woken);
+        EXPECT_LE(checks, 4);
+    }
+}
+
+TEST(wait_table, unrelated_notify_does_not_wake) {
+    WaitTable table;
+    volatile uint32_t watched = 0;
+    volatile uint32_t other = 0;
+
+    std::atomic<bool> woken{ false };
+    std::thread waiter([&]() {
+        table.wait(&watched, [&]() { return watched == 1; });
+        woken = true;
+    });
+
+    other = 1;
+    table.notify(&other);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(woken);
+
+    watched = 1;
+    table.notify(&watched);
+    waiter.join();
+    EXPECT_TRUE(woken);
+}
+
+TEST(wait_table, abort_releases_waiters) {
+    WaitTable table;
+    volatile uint32_t never_written = 0;
+
+    std::thread waiter([&]() { EXPECT_FALSE(table.wait(&never_written, [&]() { return never_written == 1; })); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    table.abort();
+    waiter.join();
+    EXPECT_TRUE(table.is_aborted());
+}
+
+TEST(wait_table, reset_after_abort_blocks_again) {
+    WaitTable table;
+    volatile uint32_t notification = 0;
+
+    table.abort();
+    EXPECT_FALSE(table.wait_for(&notification, std::chrono::milliseconds(1), [&]() { return notification == 1; }));
+    table.reset();
+    EXPECT_FALSE(table.is_aborted());
+
+    std::atomic<bool> woken{ false };
+    std::thread waiter([&]() {
+        EXPECT_TRUE(table.wait(&notification, [&]() { return notification == 1; }));
+        woken = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(woken);
+
+    notification = 1;
+    table.notify(&notification);
+    waiter.join();
+    EXPECT_TRUE(woken);
+}
+
+TEST(wait_table, bounded_wait_sees_stores_without_notify) {
+    WaitTable table;
+    volatile uint32_t notification = 0;
+
+    // A store without notify() is what a guest CPU write looks like: only rechecking the value finds it
+    std::thread writer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        notification = 1;
+    });
+
+    int timeouts = 0;
+    while (!table.wait_for(&notification, std::chrono::milliseconds(1), [&]() { return notification == 1; })) {
+        ASSERT_FALSE(table.is_aborted());
+        timeouts++;
+    }
+    writer.join();
+    EXPECT_GT(timeouts, 0);
+}
+
+namespace {
+
+constexpr int CONTENDED_WAITERS = 32;
+constexpr int CONTENDED_ROUNDS = 200;
+
+struct ContentionResult {
+    uint64_t checks;
+};
+
+// Every waiter owns one status word and waits for it to reach each round number in turn, while a single
+// publisher thread completes the statuses one after the other, like the renderer completing commands.
+// The publisher waits for each waiter to acknowledge, so all the other waiters are asleep at every completion.
+template <typename Wait, typename Publish>
+ContentionResult run_contention(std::atomic<int> (&statuses)[CONTENDED_WAITERS], Wait wait, Publish publish) {
+    std::atomic<uint64_t> checks{ 0 };
+    std::atomic<int> ready{ 0 };
+    std::atomic<int> acks[CONTENDED_WAITERS] = {};
+
+    std::vector<std::thread> waiters;
+    for (int w = 0; w < CONTENDED_WAITERS; w++) {
+        waiters.emplace_back([&, w]() {
+            ready++;
+            for (int round = 1; round <= CONTENDED_ROUNDS; round++) {
+                wait(statuses[w], [&]() {
+                    checks.fetch_add(1, std::memory_order_relaxed);
+                    return statuses[w].load() >= round;
+                });
+                acks[w] = round;
+            }
+        });
+    }
+    while (ready < CONTENDED_WAITERS)
+        std::this_thread::yield();
+
+    for (int round = 1; round <= CONTENDED_ROUNDS; round++) {
+        for (int w = 0; w < CONTENDED_WAITERS; w++) {
+            publish(statuses[w], round);
+            while (acks[w] != round)
+                std::this_thread::yield();
+        }
+    }
+    for (auto &waiter : waiters)
+        waiter.join();
+
+    return { checks.load() };
+}
+
+} // namespace
+
+TEST(wait_table, targeted_wake_ups_under_contention) {
+    std::atomic<int> statuses[CONTENDED_WAITERS] = {};
+
+    // Previous scheme: one mutex and condition variable shared by every waiter, broadcast on each completion
+    std::mutex shared_mutex;
+    std::condition_variable shared_cond;
+    const ContentionResult shared = run_contention(
+        statuses,
+        [&](std::atomic<int> &, auto pred) {
+            std::unique_lock<std::mutex> lock(shared_mutex);
+            shared_cond.wait(lock, pred);
+        },
+        [&](std::atomic<int> &status, int value) {
+            const std::lock_guard<std::mutex> lock(shared_mutex);
+            status = value;
+            shared_cond.notify_all();
+        });
+
+    for (auto &status : statuses)
+        status = 0;
+
+    WaitTable table;
+    const ContentionResult keyed = run_contention(
+        statuses,
+        [&](std::atomic<int> &status, auto pred) { table.wait(&status, pred); },
+        [&](std::atomic<int> &status, int value) {
+            status.store(value, std::memory_order_release);
+            table.notify(&status);
+        });
+
+    // Targeted wake ups: waiters no longer re-check on completions that are not theirs
+    EXPECT_LT(keyed.checks, shared.checks);
+}
@@ -17,7 +17,10 @@
 
 #pragma once
 
+// Builds configured with STRIP_DEBUG_LOGS set this to SPDLOG_LEVEL_INFO in release, compiling out trace and debug logs
+#ifndef SPDLOG_ACTIVE_LEVEL
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
 
 #include <spdlog/spdlog.h>
 #include <util/exit_code.h>
@@ -35,6 +38,10 @@ namespace logging {
 ExitCode init(const Root &root_paths, bool use_stdout);
 void set_level(spdlog::level::level_enum log_level);
 ExitCode add_sink(const fs::path &log_path);
+// Waits for the queued messages to be written out and flushes the sinks, logging keeps working afterwards
+void flush();
+// Async signal safe version for crash paths: has a helper thread flush the log and waits a bounded time for it
+void flush_on_crash();
 
 #define LOG_TRACE SPDLOG_TRACE
 #define LOG_DEBUG SPDLOG_DEBUG
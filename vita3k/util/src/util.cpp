@@ -20,29 +20,126 @@
 #include <util/log.h>
 #include <util/string_utils.h>
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/msvc_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <codecvt> // std::codecvt_utf8
+#include <cstdlib>
+#include <exception>
 #include <iostream>
 #include <locale> // std::wstring_convert
 #include <memory>
 #include <set>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 
 #include <memory>
 #include <stdexcept>
 
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <time.h>
+#include <unistd.h>
+#endif
+
 namespace logging {
 
 static const fs::path &LOG_FILE_NAME = "vita3k.log";
 static const char *LOG_PATTERN = "%^[%H:%M:%S.%e] |%L| [%!]: %v%$";
+// Messages are written to the sinks by a single logging thread. When it falls this many messages behind,
+// new messages below error level are dropped rather than blocking the guest thread that logs them.
+static constexpr size_t LOG_QUEUE_SIZE = 8192;
+// How long flushing waits for the logging thread, which may be stuck if the process is crashing
+static constexpr auto FLUSH_TIMEOUT = std::chrono::seconds(1);
 std::vector<spdlog::sink_ptr> sinks;
 
+// Crash paths can't take the locks flushing needs, they wake this thread up to do it instead
+static std::atomic<bool> crash_flushed{ false };
+#ifdef WIN32
+static HANDLE crash_event = nullptr;
+#else
+static int crash_pipe[2] = { -1, -1 };
+#endif
+
+static void start_crash_flusher() {
+#ifdef WIN32
+    crash_event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!crash_event)
+        return;
+#else
+    if (pipe(crash_pipe) != 0)
+        return;
+#endif
+
+    std::thread([] {
+#ifdef WIN32
+        WaitForSingleObject(crash_event, INFINITE);
+#else
+        char byte;
+        while ((read(crash_pipe[0], &byte, 1) < 0) && (errno == EINTR)) {
+        }
+#endif
+        flush();
+        crash_flushed = true;
+    }).detach();
+}
+
+// Queues messages for the logging thread, errors always wait for room. Overrunning the oldest queued
+// message is not an option for the others, as the message it overruns may be an error.
+class Logger : public spdlog::logger {
+public:
+    Logger(const std::string &name, const std::shared_ptr<spdlog::details::thread_pool> &pool)
+        : spdlog::logger(name, begin(logging::sinks), end(logging::sinks))
+        , pool(pool)
+        , queue(std::make_shared<spdlog::async_logger>(name, begin(logging::sinks), end(logging::sinks), pool, spdlog::async_overflow_policy::block)) {
+        // This logger does the level filtering
+        queue->set_level(spdlog::level::trace);
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        if (msg.level < spdlog::level::err) {
+            const auto pool_ptr = pool.lock();
+            if (pool_ptr && pool_ptr->queue_size() >= LOG_QUEUE_SIZE)
+                return;
+        }
+
+        queue->log(msg.time, msg.source, msg.level, msg.payload);
+    }
+
+    void flush_() override {
+        // Only queues a flush request behind the messages that were logged so far
+        queue->flush();
+    }
+
+private:
+    std::weak_ptr<spdlog::details::thread_pool> pool;
+    std::shared_ptr<spdlog::async_logger> queue;
+};
+
 ExitCode init(const Root &root_paths, bool use_stdout) {
+    static bool exit_handlers_set = false;
+    if (!exit_handlers_set) {
+        exit_handlers_set = true;
+        start_crash_flusher();
+        std::atexit(flush);
+        std::set_terminate([] {
+            flush();
+            std::abort();
+        });
+    }
+
     sinks.clear();
     if (use_stdout)
         sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
@@ -80,20 +177,63 @@ ExitCode add_sink(const fs::path &log_path) {
     }
 #endif
 
-    spdlog::set_default_logger(std::make_shared<spdlog::logger>("vita3k logger", begin(sinks), end(sinks)));
+    if (!spdlog::thread_pool())
+        spdlog::init_thread_pool(LOG_QUEUE_SIZE, 1);
+
+    auto logger = std::make_shared<Logger>("vita3k logger", spdlog::thread_pool());
+    // Only queues a flush request, but errors still get to the file soon after they happen
+    logger->flush_on(spdlog::level::err);
+    spdlog::set_default_logger(logger);
     spdlog::set_pattern(LOG_PATTERN);
     return Success;
 }
 
-typedef std::set<std::string> NameSet;
-static std::mutex mutex;
+void flush() {
+    // The logging thread owns the queue, it only has to go through what was queued so far
+    const auto pool = spdlog::thread_pool();
+    const auto deadline = std::chrono::steady_clock::now() + FLUSH_TIMEOUT;
+    while (pool && (pool->queue_size() > 0) && (std::chrono::steady_clock::now() < deadline))
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    for (const auto &sink : sinks)
+        sink->flush();
+}
+
+void flush_on_crash() {
+#ifdef WIN32
+    if (!crash_event || !SetEvent(crash_event))
+        return;
+#else
+    const char byte = 0;
+    if ((crash_pipe[1] < 0) || (write(crash_pipe[1], &byte, 1) != 1))
+        return;
+#endif
+
+    for (int slice = 0; (slice < 100) && !crash_flushed; slice++) {
+#ifdef WIN32
+        Sleep(10);
+#else
+        const timespec wait = { 0, 10'000'000 };
+        nanosleep(&wait, nullptr);
+#endif
+    }
+}
+
+typedef std::set<std::string, std::less<>> NameSet;
+static std::shared_mutex mutex;
 static NameSet logged;
 
 int ret_error_impl(const char *name, const char *error_str, std::uint32_t error_val) {
-    bool inserted = false;
+    {
+        // Names that were already logged are looked up without allocating or taking the lock exclusively
+        const std::shared_lock<std::shared_mutex> lock(mutex);
+        if (logged.find(std::string_view(name)) != logged.end())
+            return error_val;
+    }
 
+    bool inserted = false;
     {
-        const std::lock_guard<std::mutex> lock(mutex);
+        const std::lock_guard<std::shared_mutex> lock(mutex);
         inserted = logged.insert(name).second;
     }
 